@@ -0,0 +1,77 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+/**
+ * \file rem-binary-to-text.cc
+ * \ingroup examples
+ * \brief Conversion of a binary REM file to the text output
+ *
+ * NrRadioEnvironmentMapHelper with the attribute OutputFormat set to Binary
+ * writes the values of the REM points to nr-rem-{simTag}.bin (see
+ * NrRemBinaryFile). This program converts that file to the text output of the
+ * helper, nr-rem-{simTag}.out, and writes the gnuplot script that plots it:
+ * \code{.unparsed}
+ *  $ ./ns3 run "rem-example --simTag=d --remBinary=true"
+ *  $ ./ns3 run "rem-binary-to-text --simTag=d"
+ *  $ gnuplot -p nr-rem-d-gnbs.txt nr-rem-d-ues.txt nr-rem-d-buildings.txt
+ *  nr-rem-d-plot-rem.gnuplot
+ * \endcode
+ *
+ * The file can also be converted while the REM is being generated, or after
+ * the simulation has been interrupted: the text output then includes only the
+ * columns of the map already calculated.
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/nr-module.h"
+
+#include <fstream>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string simTag = "";
+    std::string input = "";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("simTag", "The simTag of the REM, used for the names of the files", simTag);
+    cmd.AddValue("input",
+                 "The binary file to convert (by default, nr-rem-{simTag}.bin)",
+                 input);
+    cmd.Parse(argc, argv);
+
+    if (input.empty())
+    {
+        input = "nr-rem-" + simTag + ".bin";
+    }
+
+    NrRemBinaryFile remFile;
+    if (!remFile.Open(input))
+    {
+        std::cerr << "Can't read the REM binary file " << input << std::endl;
+        return 1;
+    }
+
+    std::string output = "nr-rem-" + simTag + ".out";
+    std::ofstream outFile(output.c_str());
+    if (!outFile.is_open())
+    {
+        std::cerr << "Can't open file " << output << std::endl;
+        return 1;
+    }
+    remFile.PrintText(outFile);
+    outFile.close();
+
+    const NrRemBinaryFile::Header& header = remFile.GetHeader();
+    NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile(simTag,
+                                                         header.m_xMin,
+                                                         remFile.GetX(header.m_numX - 1),
+                                                         header.m_yMin,
+                                                         remFile.GetY(header.m_numY - 1));
+    return 0;
+}
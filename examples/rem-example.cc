@@ -127,6 +127,11 @@ main(int argc, char* argv[])
     double yMax = 50.0;
     uint16_t yRes = 50;
     double z = 1.5;
+    uint32_t remWorkers = 1;
+    bool remBinary = false;
+    double remCheckpointPeriod = 0;
+    uint32_t remAdaptiveLevels = 0;
+    bool remStatistics = false;
 
     CommandLine cmd(__FILE__);
     cmd.AddValue("remMode",
@@ -204,6 +209,26 @@ main(int argc, char* argv[])
     cmd.AddValue("yMax", "The max y coordinate of the rem map", yMax);
     cmd.AddValue("yRes", "The resolution on the y axis of the rem map", yRes);
     cmd.AddValue("z", "The z coordinate of the rem map", z);
+    cmd.AddValue("remWorkers",
+                 "The number of workers that calculate the rem map in parallel "
+                 "(0 means one for each hardware thread)",
+                 remWorkers);
+    cmd.AddValue("remBinary",
+                 "Write the rem map to the binary file nr-rem-{simTag}.bin, that "
+                 "rem-binary-to-text converts to the text output",
+                 remBinary);
+    cmd.AddValue("remCheckpointPeriod",
+                 "The seconds between two checkpoints of the rem map, from which an "
+                 "interrupted run is resumed (0 disables the checkpoints)",
+                 remCheckpointPeriod);
+    cmd.AddValue("remAdaptiveLevels",
+                 "The levels of the adaptive sampling of the rem map (0 calculates "
+                 "every point of the map)",
+                 remAdaptiveLevels);
+    cmd.AddValue("remStatistics",
+                 "Write the statistics of the rem map to nr-rem-{simTag}-summary.txt, and "
+                 "the best server of each point to nr-rem-{simTag}-best-server.out",
+                 remStatistics);
 
     cmd.Parse(argc, argv);
 
@@ -581,6 +606,14 @@ main(int argc, char* argv[])
     remHelper->SetResY(yRes);
     remHelper->SetZ(z);
     remHelper->SetSimTag(simTag);
+    remHelper->SetNumWorkers(remWorkers);
+    if (remBinary)
+    {
+        remHelper->SetOutputFormat(NrRadioEnvironmentMapHelper::BINARY_OUTPUT);
+    }
+    remHelper->SetCheckpointPeriod(Seconds(remCheckpointPeriod));
+    remHelper->SetAdaptiveLevels(remAdaptiveLevels);
+    remHelper->SetStatistics(remStatistics);
 
     gnbNetDev.Get(0)
         ->GetObject<NrGnbNetDevice>()
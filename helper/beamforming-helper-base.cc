@@ -7,15 +7,24 @@
 #include "beamforming-helper-base.h"
 
 #include <ns3/beam-manager.h>
+#include <ns3/boolean.h>
+#include <ns3/double.h>
 #include <ns3/log.h>
+#include <ns3/mobility-model.h>
 #include <ns3/node.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-gnb-phy.h>
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/nr-ue-phy.h>
+#include <ns3/phased-array-model.h>
+#include <ns3/spectrum-channel.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/vector.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -37,10 +46,42 @@ BeamformingHelperBase::~BeamformingHelperBase()
 TypeId
 BeamformingHelperBase::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::BeamformingHelperBase").SetParent<Object>();
+    static TypeId tid =
+        TypeId("ns3::BeamformingHelperBase")
+            .SetParent<Object>()
+            .AddAttribute("BeamCache",
+                          "If true, the beamforming vectors of a pair of devices are reused "
+                          "until one of the devices moves or rotates more than the thresholds, "
+                          "or the channel matrix of the pair is regenerated. Meant for the "
+                          "algorithms that depend only on the positions and on the channel "
+                          "(e.g., the ideal ones)",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&BeamformingHelperBase::m_beamCacheEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("BeamCacheDistanceThreshold",
+                          "Distance (in m) that the gNB or the UE have to move from the "
+                          "positions of the cached beamforming vectors to invalidate them",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&BeamformingHelperBase::m_beamCacheDistanceThreshold),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("BeamCacheAngleThreshold",
+                          "Angle (in degrees) that the direction from the gNB to the UE, or the "
+                          "bearing or downtilt of the antenna of any of the devices, have to "
+                          "change to invalidate the cached beamforming vectors",
+                          DoubleValue(1.0),
+                          MakeDoubleAccessor(&BeamformingHelperBase::m_beamCacheAngleThreshold),
+                          MakeDoubleChecker<double>(0.0, 180.0));
     return tid;
 }
 
+void
+BeamformingHelperBase::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_beamCache.clear();
+    Object::DoDispose();
+}
+
 void
 BeamformingHelperBase::RunTask(const Ptr<NrGnbNetDevice>& gNbDev,
                                const Ptr<NrUeNetDevice>& ueDev,
@@ -50,8 +91,144 @@ BeamformingHelperBase::RunTask(const Ptr<NrGnbNetDevice>& gNbDev,
     NS_LOG_FUNCTION(this);
     NS_LOG_INFO(" Run beamforming task for gNB:" << gNbDev->GetNode()->GetId()
                                                  << " and UE:" << ueDev->GetNode()->GetId());
-    BeamformingVectorPair bfPair = GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+    if (!m_beamCacheEnabled)
+    {
+        BeamformingVectorPair bfPair = GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+        SaveBeamformingVectors(gNbDev, ueDev, gnbSpectrumPhy, ueSpectrumPhy, bfPair);
+        return;
+    }
+
+    BeamCacheEntry entry;
+    if (!LookUpBeamCache(gnbSpectrumPhy, ueSpectrumPhy, &entry))
+    {
+        entry.m_bfPair = GetBeamformingVectors(gnbSpectrumPhy, ueSpectrumPhy);
+        UpdateBeamCache(gnbSpectrumPhy, ueSpectrumPhy, entry);
+    }
+    SaveBeamformingVectors(gNbDev, ueDev, gnbSpectrumPhy, ueSpectrumPhy, entry.m_bfPair);
+}
 
+bool
+BeamformingHelperBase::LookUpBeamCache(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                       const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                       BeamCacheEntry* entry) const
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<MobilityModel> gnbMob = gnbSpectrumPhy->GetMobility();
+    Ptr<MobilityModel> ueMob = ueSpectrumPhy->GetMobility();
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+
+    entry->m_gnbPosition = gnbMob->GetPosition();
+    entry->m_uePosition = ueMob->GetPosition();
+
+    DoubleValue angle;
+    gnbAntenna->GetAttribute("BearingAngle", angle);
+    entry->m_gnbBearing = angle.Get();
+    gnbAntenna->GetAttribute("DowntiltAngle", angle);
+    entry->m_gnbDowntilt = angle.Get();
+    ueAntenna->GetAttribute("BearingAngle", angle);
+    entry->m_ueBearing = angle.Get();
+    ueAntenna->GetAttribute("DowntiltAngle", angle);
+    entry->m_ueDowntilt = angle.Get();
+
+    entry->m_channelGenerationTime = GetChannelGenerationTime(gnbSpectrumPhy, ueSpectrumPhy);
+
+    auto it = m_beamCache.find(std::make_pair(gnbSpectrumPhy, ueSpectrumPhy));
+    if (it == m_beamCache.end())
+    {
+        m_beamCacheMisses++;
+        return false;
+    }
+    const BeamCacheEntry& cached = it->second;
+
+    // Angle between the directions from the gNB to the UE, in degrees
+    Vector oldDirection = cached.m_uePosition - cached.m_gnbPosition;
+    Vector newDirection = entry->m_uePosition - entry->m_gnbPosition;
+    double directionChange = 0.0;
+    if (oldDirection.GetLength() > 0 && newDirection.GetLength() > 0)
+    {
+        double cosAngle = (oldDirection.x * newDirection.x + oldDirection.y * newDirection.y +
+                           oldDirection.z * newDirection.z) /
+                          (oldDirection.GetLength() * newDirection.GetLength());
+        directionChange = std::acos(std::clamp(cosAngle, -1.0, 1.0)) * 180.0 / M_PI;
+    }
+    double rotation = std::max({std::abs(entry->m_gnbBearing - cached.m_gnbBearing),
+                                std::abs(entry->m_gnbDowntilt - cached.m_gnbDowntilt),
+                                std::abs(entry->m_ueBearing - cached.m_ueBearing),
+                                std::abs(entry->m_ueDowntilt - cached.m_ueDowntilt)}) *
+                      180.0 / M_PI;
+
+    bool valid =
+        CalculateDistance(entry->m_gnbPosition, cached.m_gnbPosition) <=
+            m_beamCacheDistanceThreshold &&
+        CalculateDistance(entry->m_uePosition, cached.m_uePosition) <=
+            m_beamCacheDistanceThreshold &&
+        directionChange <= m_beamCacheAngleThreshold && rotation <= m_beamCacheAngleThreshold &&
+        entry->m_channelGenerationTime == cached.m_channelGenerationTime;
+    if (!valid)
+    {
+        m_beamCacheMisses++;
+        return false;
+    }
+
+    NS_LOG_INFO("Reusing the cached beamforming vectors");
+    m_beamCacheHits++;
+    entry->m_bfPair = cached.m_bfPair;
+    return true;
+}
+
+void
+BeamformingHelperBase::UpdateBeamCache(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                       const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                       const BeamCacheEntry& entry) const
+{
+    NS_LOG_FUNCTION(this);
+    BeamCacheEntry& cached = m_beamCache[std::make_pair(gnbSpectrumPhy, ueSpectrumPhy)];
+    cached = entry;
+    cached.m_channelGenerationTime = GetChannelGenerationTime(gnbSpectrumPhy, ueSpectrumPhy);
+}
+
+Time
+BeamformingHelperBase::GetChannelGenerationTime(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                                const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    if (threeGppSplm == nullptr)
+    {
+        return Seconds(0);
+    }
+    // The parameters are regenerated whenever the channel of the pair is
+    // updated, while a matrix evicted from the memory is regenerated from the
+    // same parameters. GetParams, unlike GetChannel, does not generate them
+    Ptr<const MatrixBasedChannelModel::ChannelParams> params =
+        threeGppSplm->GetChannelModel()->GetParams(gnbSpectrumPhy->GetMobility(),
+                                                   ueSpectrumPhy->GetMobility());
+    return params == nullptr ? NanoSeconds(-1) : params->m_generatedTime;
+}
+
+uint64_t
+BeamformingHelperBase::GetBeamCacheHits() const
+{
+    return m_beamCacheHits;
+}
+
+uint64_t
+BeamformingHelperBase::GetBeamCacheMisses() const
+{
+    return m_beamCacheMisses;
+}
+
+void
+BeamformingHelperBase::SaveBeamformingVectors(const Ptr<NrGnbNetDevice>& gNbDev,
+                                              const Ptr<NrUeNetDevice>& ueDev,
+                                              const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                              const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                              const BeamformingVectorPair& bfPair) const
+{
+    NS_LOG_FUNCTION(this);
     NS_ASSERT(bfPair.first.first.GetSize() && bfPair.second.first.GetSize());
     gnbSpectrumPhy->GetBeamManager()->SaveBeamformingVector(bfPair.first, ueDev);
     ueSpectrumPhy->GetBeamManager()->SaveBeamformingVector(bfPair.second, gNbDev);
@@ -5,10 +5,13 @@
 // SPDX-License-Identifier: GPL-2.0-only
 
 #include <ns3/beamforming-vector.h>
+#include <ns3/nstime.h>
 #include <ns3/object-factory.h>
 #include <ns3/object.h>
 #include <ns3/vector.h>
 
+#include <map>
+
 #ifndef SRC_NR_HELPER_BEAMFORMING_HELPER_BASE_H_
 #define SRC_NR_HELPER_BEAMFORMING_HELPER_BASE_H_
 
@@ -70,7 +73,66 @@ class BeamformingHelperBase : public Object
      */
     void SetBeamformingAlgorithmAttribute(const std::string& n, const AttributeValue& v);
 
+    /**
+     * \brief Get the number of beamforming tasks that reused the cached
+     * beamforming vectors
+     * \return the number of beam cache hits
+     */
+    uint64_t GetBeamCacheHits() const;
+
+    /**
+     * \brief Get the number of beamforming tasks that ran the beamforming
+     * algorithm while the beam cache was enabled
+     * \return the number of beam cache misses
+     */
+    uint64_t GetBeamCacheMisses() const;
+
   protected:
+    /**
+     * \brief The state of a pair of devices when its beamforming vectors were
+     * computed, and the vectors themselves
+     */
+    struct BeamCacheEntry
+    {
+        BeamformingVectorPair m_bfPair;  //!< The beamforming vectors of the pair
+        Vector m_gnbPosition;            //!< Position of the gNB
+        Vector m_uePosition;             //!< Position of the UE
+        double m_gnbBearing{0.0};        //!< Bearing angle of the gNB antenna (rad)
+        double m_gnbDowntilt{0.0};       //!< Downtilt angle of the gNB antenna (rad)
+        double m_ueBearing{0.0};         //!< Bearing angle of the UE antenna (rad)
+        double m_ueDowntilt{0.0};        //!< Downtilt angle of the UE antenna (rad)
+        Time m_channelGenerationTime{0}; //!< Generation time of the channel of the pair, if any
+    };
+
+    /**
+     * \brief Look up the beamforming vectors of a pair of devices in the beam
+     * cache. The cached vectors are valid if none of the devices moved or
+     * rotated more than the thresholds, and the channel of the pair was not
+     * updated since they were computed.
+     *
+     * The look up does not generate nor update the channel, so it does not
+     * draw random numbers: a channel that has to be updated invalidates the
+     * entry once it is updated, by a transmission or by the algorithm.
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [out] entry the current state of the pair and, if valid, the cached vectors
+     * \return true if the cached vectors are valid
+     */
+    bool LookUpBeamCache(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                         const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                         BeamCacheEntry* entry) const;
+
+    /**
+     * \brief Store an entry in the beam cache. The generation time of the
+     * channel is read again, as the algorithm may have generated it
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [in] entry the state of the pair, returned by LookUpBeamCache, and its vectors
+     */
+    void UpdateBeamCache(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                         const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                         const BeamCacheEntry& entry) const;
+
     /**
      * \brief This function runs the beamforming algorithm among the provided gNB and UE
      * device, and for a specified bwp index
@@ -95,8 +157,48 @@ class BeamformingHelperBase : public Object
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const = 0;
 
+    /**
+     * \brief Save the beamforming vectors of a pair of devices in their beam
+     * managers, and configure the UE to use its vector
+     * \param gNbDev a pointer to a gNB device
+     * \param ueDev a pointer to a UE device
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [in] bfPair the beamforming vector pair of the gNB and the UE
+     */
+    void SaveBeamformingVectors(const Ptr<NrGnbNetDevice>& gNbDev,
+                                const Ptr<NrUeNetDevice>& ueDev,
+                                const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                const BeamformingVectorPair& bfPair) const;
+
+    // inherited from Object
+    void DoDispose() override;
+
     ObjectFactory
         m_algorithmFactory; //!< Object factory that will be used to create beamforming algorithms
+
+    bool m_beamCacheEnabled{false};         //!< Reuse the vectors of unchanged pairs (attribute)
+    double m_beamCacheDistanceThreshold{0}; //!< Movement that invalidates an entry, in m
+    double m_beamCacheAngleThreshold{0};    //!< Rotation that invalidates an entry, in degrees
+
+  private:
+    /**
+     * \brief Get the generation time of the channel of a pair of devices,
+     * without generating it
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \return the generation time of the channel parameters of the pair with
+     * the 3GPP channel, -1 ns if they were not generated yet, or 0 with other
+     * channels
+     */
+    Time GetChannelGenerationTime(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                  const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const;
+
+    using SpectrumPhyPair = std::pair<Ptr<NrSpectrumPhy>, Ptr<NrSpectrumPhy>>;
+    mutable std::map<SpectrumPhyPair, BeamCacheEntry> m_beamCache; //!< The beam cache
+    mutable uint64_t m_beamCacheHits{0};   //!< Number of beam cache hits
+    mutable uint64_t m_beamCacheMisses{0}; //!< Number of beam cache misses
 };
 
 }; // namespace ns3
@@ -11,10 +11,12 @@
 #include <ns3/log.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-gnb-phy.h>
+#include <ns3/nr-parallel-for.h>
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/nr-ue-phy.h>
 #include <ns3/object-factory.h>
+#include <ns3/uinteger.h>
 #include <ns3/vector.h>
 
 namespace ns3
@@ -62,7 +64,17 @@ IdealBeamformingHelper::GetTypeId()
                           TimeValue(MilliSeconds(100)),
                           MakeTimeAccessor(&IdealBeamformingHelper::SetPeriodicity,
                                            &IdealBeamformingHelper::GetPeriodicity),
-                          MakeTimeChecker());
+                          MakeTimeChecker())
+            .AddAttribute("NumThreads",
+                          "Number of threads used to compute the beamforming vectors of the "
+                          "pairs of devices at each periodic update. 1 (the default) computes "
+                          "them sequentially, 0 uses one thread for each hardware thread. Only "
+                          "the algorithms that support it (e.g., CellScanBeamforming on a "
+                          "ThreeGppSpectrumPropagationLossModel) run concurrently; the results "
+                          "are the same for any number of threads",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&IdealBeamformingHelper::m_numThreads),
+                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
@@ -104,9 +116,74 @@ IdealBeamformingHelper::Run() const
     NS_LOG_INFO("Running the beamforming method. There are :"
                 << m_spectrumPhyPairToDevicePair.size() << " tasks.");
 
+    if (m_numThreads == 1)
+    {
+        for (const auto& task : m_spectrumPhyPairToDevicePair)
+        {
+            RunTask(task.second.first, task.second.second, task.first.first, task.first.second);
+        }
+        return;
+    }
+
+    // Gather the data of every pair in the simulation thread, in order (this is
+    // where the channels may be generated). The pairs found in the beam cache
+    // need no task
+    std::vector<IdealBeamformingAlgorithm::BeamformingTask> tasks;
+    std::vector<BeamCacheEntry> entries(m_spectrumPhyPairToDevicePair.size());
+    std::vector<bool> cached(entries.size(), false);
+    tasks.reserve(entries.size());
+    for (const auto& task : m_spectrumPhyPairToDevicePair)
+    {
+        size_t i = tasks.size();
+        if (m_beamCacheEnabled && LookUpBeamCache(task.first.first, task.first.second, &entries[i]))
+        {
+            cached[i] = true;
+            tasks.emplace_back(nullptr);
+            continue;
+        }
+        tasks.emplace_back(m_beamformingAlgorithm->PrepareBeamformingTask(task.first.first,
+                                                                          task.first.second));
+    }
+
+    // Compute the pairs concurrently
+    NrParallelFor(tasks.size(), m_numThreads, [&tasks, &entries](size_t i) {
+        if (tasks[i])
+        {
+            entries[i].m_bfPair = tasks[i]();
+        }
+    });
+
+    // Save the results in order. The pairs that the algorithm cannot compute
+    // concurrently are computed here, and the others are logged here, as the
+    // threads can not log
+    size_t i = 0;
     for (const auto& task : m_spectrumPhyPairToDevicePair)
     {
-        RunTask(task.second.first, task.second.second, task.first.first, task.first.second);
+        if (!cached[i])
+        {
+            if (!tasks[i])
+            {
+                entries[i].m_bfPair = GetBeamformingVectors(task.first.first, task.first.second);
+            }
+            else
+            {
+                NS_LOG_DEBUG("Beamforming vectors for gNB with node id: "
+                             << task.second.first->GetNode()->GetId()
+                             << " and UE with node id: " << task.second.second->GetNode()->GetId()
+                             << " are gNB beam " << entries[i].m_bfPair.first.second
+                             << " UE beam " << entries[i].m_bfPair.second.second);
+            }
+            if (m_beamCacheEnabled)
+            {
+                UpdateBeamCache(task.first.first, task.first.second, entries[i]);
+            }
+        }
+        SaveBeamformingVectors(task.second.first,
+                               task.second.second,
+                               task.first.first,
+                               task.first.second,
+                               entries[i].m_bfPair);
+        i++;
     }
 }
 
@@ -61,6 +61,10 @@ class IdealBeamformingHelper : public BeamformingHelperBase
 
     /**
      * \brief Run beamforming task
+     *
+     * With the attribute NumThreads different than 1, the data of every pair
+     * is gathered first, in order; then the beamforming vectors are computed
+     * concurrently, and finally they are saved in the beam managers, in order.
      */
     virtual void Run() const;
 
@@ -99,6 +103,8 @@ class IdealBeamformingHelper : public BeamformingHelperBase
         DevicePair; //!< The list of beamforming tasks to be executed
 
     std::map<SpectrumPhyPair, DevicePair> m_spectrumPhyPairToDevicePair;
+
+    uint32_t m_numThreads{1}; //!< Number of threads used by Run (attribute)
 };
 
 }; // namespace ns3
@@ -28,6 +28,7 @@
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/names.h>
 #include <ns3/nr-ch-access-manager.h>
+#include <ns3/nr-distance-spectrum-transmit-filter.h>
 #include <ns3/nr-gnb-mac.h>
 #include <ns3/nr-gnb-net-device.h>
 #include <ns3/nr-gnb-phy.h>
@@ -337,6 +338,17 @@ NrHelper::InitializeOperationBand(OperationBandInfo* band, uint8_t flags)
                 bwp->m_channel = m_channelFactory.Create<SpectrumChannel>();
                 bwp->m_channel->AddPropagationLossModel(bwp->m_propagation);
                 bwp->m_channel->AddPhasedArraySpectrumPropagationLossModel(bwp->m_3gppChannel);
+
+                // Drop the signals among far nodes before computing their propagation loss
+                auto distanceBasedSplm =
+                    DynamicCast<DistanceBasedThreeGppSpectrumPropagationLossModel>(
+                        bwp->m_3gppChannel);
+                if (distanceBasedSplm != nullptr && distanceBasedSplm->GetDropFarPairs())
+                {
+                    auto filter = CreateObject<NrDistanceSpectrumTransmitFilter>();
+                    filter->SetPropagationLossModel(distanceBasedSplm);
+                    bwp->m_channel->AddSpectrumTransmitFilter(filter);
+                }
             }
         }
     }
@@ -6,6 +6,7 @@
 
 #include "nr-radio-environment-map-helper.h"
 
+#include "nr-rem-statistics.h"
 #include "nr-spectrum-value-helper.h"
 
 #include <ns3/abort.h>
@@ -14,6 +15,7 @@
 #include <ns3/buildings-module.h>
 #include <ns3/config.h>
 #include <ns3/double.h>
+#include <ns3/hash.h>
 #include <ns3/integer.h>
 #include <ns3/log.h>
 #include <ns3/mobility-model.h>
@@ -22,14 +24,30 @@
 #include <ns3/nr-spectrum-phy.h>
 #include <ns3/nr-ue-net-device.h>
 #include <ns3/pointer.h>
+#include <ns3/rng-seed-manager.h>
 #include <ns3/simulator.h>
 #include <ns3/spectrum-converter.h>
 #include <ns3/string.h>
 #include <ns3/uinteger.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
 #include <ctime>
 #include <fstream>
 #include <limits>
+#include <new>
+#include <numeric>
+#include <sstream>
+#include <thread>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define NR_REM_WORKER_PROCESSES
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 namespace ns3
 {
@@ -51,6 +69,7 @@ void
 NrRadioEnvironmentMapHelper::DoDispose()
 {
     NS_LOG_FUNCTION(this);
+    m_remSpectrumLossModel = nullptr;
 }
 
 TypeId
@@ -155,7 +174,122 @@ NrRadioEnvironmentMapHelper::GetTypeId()
                 "depends on RRC message timing.",
                 TimeValue(MilliSeconds(100)),
                 MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetInstallationDelay),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("NumWorkers",
+                          "Number of workers that calculate the REM points in parallel "
+                          "(0 means one for each hardware thread). The workers are "
+                          "processes, each one with its own copy of the REM devices and "
+                          "propagation models, and the map is the same with any number of "
+                          "workers. Not supported on Windows, where the points are "
+                          "calculated sequentially.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetNumWorkers,
+                                               &NrRadioEnvironmentMapHelper::GetNumWorkers),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("StreamBase",
+                          "First random stream of the propagation models of the REM. The "
+                          "REM point i uses the block of streams that starts at StreamBase "
+                          "+ i * (streams per point), so StreamBase must be above the "
+                          "streams assigned to the simulation (e.g., by "
+                          "NrHelper::AssignStreams), or the REM channels are correlated "
+                          "with the ones of the simulation.",
+                          IntegerValue(int64_t{1} << 32),
+                          MakeIntegerAccessor(&NrRadioEnvironmentMapHelper::SetStreamBase,
+                                              &NrRadioEnvironmentMapHelper::GetStreamBase),
+                          MakeIntegerChecker<int64_t>(0))
+            .AddAttribute("OutputFormat",
+                          "Format of the file with the values of the REM points. Text "
+                          "writes nr-rem-${SimTag}.out and its gnuplot script when the map "
+                          "is complete. Binary writes nr-rem-${SimTag}.bin, a grid of float "
+                          "values that is updated each time a column of the map is "
+                          "complete, so that it keeps the columns calculated if the "
+                          "simulation is interrupted. The rem-binary-to-text example "
+                          "converts it to the text output. None writes no map, only the "
+                          "summary of the statistics (see Statistics).",
+                          EnumValue(NrRadioEnvironmentMapHelper::TEXT_OUTPUT),
+                          MakeEnumAccessor(&NrRadioEnvironmentMapHelper::SetOutputFormat,
+                                           &NrRadioEnvironmentMapHelper::GetOutputFormat),
+                          MakeEnumChecker(NrRadioEnvironmentMapHelper::TEXT_OUTPUT,
+                                          "Text",
+                                          NrRadioEnvironmentMapHelper::BINARY_OUTPUT,
+                                          "Binary",
+                                          NrRadioEnvironmentMapHelper::NO_OUTPUT,
+                                          "None"))
+            .AddAttribute("AdaptiveLevels",
+                          "Levels of the adaptive sampling of the map (0 calculates every "
+                          "point of the grid). The REM points are first calculated on a "
+                          "coarse grid, with one point every 2^AdaptiveLevels points along "
+                          "each axis. Then, each cell whose corners differ by more than "
+                          "AdaptiveThreshold is split in four, up to the points of the grid. "
+                          "The points not calculated are interpolated from the corners of "
+                          "their cell, and the points calculated are also written to "
+                          "nr-rem-${SimTag}-samples.out.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&NrRadioEnvironmentMapHelper::SetAdaptiveLevels,
+                                               &NrRadioEnvironmentMapHelper::GetAdaptiveLevels),
+                          MakeUintegerChecker<uint32_t>(0, 15))
+            .AddAttribute("AdaptiveThreshold",
+                          "Max difference (dB) of the SINR and of the RX power among the "
+                          "corners of a cell of the adaptive sampling for which the cell is "
+                          "not split, and its points are interpolated.",
+                          DoubleValue(3.0),
+                          MakeDoubleAccessor(&NrRadioEnvironmentMapHelper::SetAdaptiveThreshold,
+                                             &NrRadioEnvironmentMapHelper::GetAdaptiveThreshold),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("CheckpointPeriod",
+                          "Wall-clock time between two saves of the REM points calculated "
+                          "to the checkpoint file nr-rem-${SimTag}.checkpoint (0 disables "
+                          "the checkpoints). If the simulation is interrupted and run "
+                          "again with the same configuration of the REM, seed and run, "
+                          "the REM points of the checkpoint are not calculated again.",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&NrRadioEnvironmentMapHelper::SetCheckpointPeriod,
+                                           &NrRadioEnvironmentMapHelper::GetCheckpointPeriod),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("PathlossOnly",
+                          "Calculate the REM points only with the path loss (and the "
+                          "channel condition), without the antenna and beamforming gains "
+                          "and the fast fading of the spectrum propagation loss model. "
+                          "The REM points are then calculated with scalar powers instead "
+                          "of PSDs, which is much faster. The same calculation is used "
+                          "when the channel has no ThreeGppSpectrumPropagationLossModel.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrRadioEnvironmentMapHelper::SetPathlossOnly,
+                                              &NrRadioEnvironmentMapHelper::GetPathlossOnly),
+                          MakeBooleanChecker())
+            .AddAttribute("Statistics",
+                          "Write the statistics of the REM points to "
+                          "nr-rem-${SimTag}-summary.txt: the histograms of the SNR, SINR, "
+                          "SIR and RX power (those of the REM mode), the fraction of the "
+                          "points above each coverage threshold, and the fraction of the "
+                          "points served by each RTD. The best server of each point is "
+                          "also written to nr-rem-${SimTag}-best-server.out, unless "
+                          "OutputFormat is None. The summary is always written if "
+                          "OutputFormat is None.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrRadioEnvironmentMapHelper::SetStatistics,
+                                              &NrRadioEnvironmentMapHelper::GetStatistics),
+                          MakeBooleanChecker())
+            .AddAttribute("StatisticsBinWidth",
+                          "Width (dB) of the bins of the histograms of the statistics.",
+                          DoubleValue(0.5),
+                          MakeDoubleAccessor(&NrRadioEnvironmentMapHelper::SetStatisticsBinWidth,
+                                             &NrRadioEnvironmentMapHelper::GetStatisticsBinWidth),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()))
+            .AddAttribute("CoverageThresholds",
+                          "Thresholds (dB) of the coverage of the SNR, SINR and SIR in the "
+                          "statistics, separated by '|'.",
+                          StringValue("-5|0|5|10|20"),
+                          MakeStringAccessor(&NrRadioEnvironmentMapHelper::SetCoverageThresholds,
+                                             &NrRadioEnvironmentMapHelper::GetCoverageThresholds),
+                          MakeStringChecker())
+            .AddAttribute("RxPowerThresholds",
+                          "Thresholds (dBm) of the coverage of the RX power in the "
+                          "statistics, separated by '|'.",
+                          StringValue("-110|-100|-90|-80"),
+                          MakeStringAccessor(&NrRadioEnvironmentMapHelper::SetRxPowerThresholds,
+                                             &NrRadioEnvironmentMapHelper::GetRxPowerThresholds),
+                          MakeStringChecker());
     return tid;
 }
 
@@ -165,6 +299,56 @@ NrRadioEnvironmentMapHelper::SetRemMode(enum RemMode remMode)
     m_remMode = remMode;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetOutputFormat(enum RemOutputFormat outputFormat)
+{
+    m_outputFormat = outputFormat;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetAdaptiveLevels(uint32_t adaptiveLevels)
+{
+    m_adaptiveLevels = adaptiveLevels;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetAdaptiveThreshold(double adaptiveThreshold)
+{
+    m_adaptiveThreshold = adaptiveThreshold;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetCheckpointPeriod(const Time& checkpointPeriod)
+{
+    m_checkpointPeriod = checkpointPeriod;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetStatistics(bool statistics)
+{
+    m_statistics = statistics;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetStatisticsBinWidth(double binWidth)
+{
+    m_statisticsBinWidth = binWidth;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetCoverageThresholds(const std::string& thresholds)
+{
+    ParseThresholds(thresholds);
+    m_coverageThresholds = thresholds;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetRxPowerThresholds(const std::string& thresholds)
+{
+    ParseThresholds(thresholds);
+    m_rxPowerThresholds = thresholds;
+}
+
 void
 NrRadioEnvironmentMapHelper::SetSimTag(const std::string& simTag)
 {
@@ -225,12 +409,96 @@ NrRadioEnvironmentMapHelper::SetInstallationDelay(const Time& installationDelay)
     m_installationDelay = installationDelay;
 }
 
+void
+NrRadioEnvironmentMapHelper::SetNumWorkers(uint32_t numWorkers)
+{
+    m_numWorkers = numWorkers;
+}
+
+uint32_t
+NrRadioEnvironmentMapHelper::GetNumWorkers() const
+{
+    return m_numWorkers;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetStreamBase(int64_t streamBase)
+{
+    m_streamBase = streamBase;
+}
+
+int64_t
+NrRadioEnvironmentMapHelper::GetStreamBase() const
+{
+    return m_streamBase;
+}
+
+void
+NrRadioEnvironmentMapHelper::SetPathlossOnly(bool pathlossOnly)
+{
+    m_pathlossOnly = pathlossOnly;
+}
+
+bool
+NrRadioEnvironmentMapHelper::GetPathlossOnly() const
+{
+    return m_pathlossOnly;
+}
+
 NrRadioEnvironmentMapHelper::RemMode
 NrRadioEnvironmentMapHelper::GetRemMode() const
 {
     return m_remMode;
 }
 
+NrRadioEnvironmentMapHelper::RemOutputFormat
+NrRadioEnvironmentMapHelper::GetOutputFormat() const
+{
+    return m_outputFormat;
+}
+
+uint32_t
+NrRadioEnvironmentMapHelper::GetAdaptiveLevels() const
+{
+    return m_adaptiveLevels;
+}
+
+double
+NrRadioEnvironmentMapHelper::GetAdaptiveThreshold() const
+{
+    return m_adaptiveThreshold;
+}
+
+Time
+NrRadioEnvironmentMapHelper::GetCheckpointPeriod() const
+{
+    return m_checkpointPeriod;
+}
+
+bool
+NrRadioEnvironmentMapHelper::GetStatistics() const
+{
+    return m_statistics;
+}
+
+double
+NrRadioEnvironmentMapHelper::GetStatisticsBinWidth() const
+{
+    return m_statisticsBinWidth;
+}
+
+std::string
+NrRadioEnvironmentMapHelper::GetCoverageThresholds() const
+{
+    return m_coverageThresholds;
+}
+
+std::string
+NrRadioEnvironmentMapHelper::GetRxPowerThresholds() const
+{
+    return m_rxPowerThresholds;
+}
+
 double
 NrRadioEnvironmentMapHelper::GetMinX() const
 {
@@ -361,6 +629,7 @@ NrRadioEnvironmentMapHelper::ConfigureRtdList(const NetDeviceContainer& rtdDevs)
         rtd.antenna = m_deviceToAntenna.find(*netDevIt)->second;
 
         rtd.txPower = rtdPhy->GetTxPower();
+        rtd.nodeId = (*netDevIt)->GetNode()->GetId();
 
         NS_LOG_DEBUG("power of UE: " << rtd.txPower);
 
@@ -380,6 +649,44 @@ NrRadioEnvironmentMapHelper::ConfigureRtdList(const NetDeviceContainer& rtdDevs)
                   "spectrum as RRD device.");
 }
 
+void
+NrRadioEnvironmentMapHelper::ConfigureScalarCalculation()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_scalarCalc = false;
+    if (!m_pathlossOnly && m_remSpectrumLossModel)
+    {
+        return;
+    }
+    for (const auto& rtd : m_remDev)
+    {
+        if (rtd.spectrumModel->GetUid() != m_rrd.spectrumModel->GetUid())
+        {
+            NS_LOG_WARN("RTD device with different spectrum model, the REM is calculated only "
+                        "with the path loss, but with the PSDs of the devices");
+            return;
+        }
+    }
+
+    // With the same spectrum model, the TX PSDs (uniform power allocation) and
+    // the noise PSD are flat over the same RBs, and the REM can be calculated
+    // with their powers
+    m_scalarCalc = true;
+    m_noisePower = Integral(*m_noisePsd);
+    m_remBandwidth = 0;
+    for (auto band = m_rrd.spectrumModel->Begin(); band != m_rrd.spectrumModel->End(); ++band)
+    {
+        m_remBandwidth += band->fh - band->fl;
+    }
+    m_rrd.txPowerW = Integral(*GetTxPsd(m_rrd, m_rrd));
+    for (auto& rtd : m_remDev)
+    {
+        rtd.txPowerW = Integral(*GetTxPsd(rtd, m_rrd));
+    }
+    NS_LOG_INFO("REM points calculated with the path loss only, with scalar powers");
+}
+
 void
 NrRadioEnvironmentMapHelper::ConfigurePropagationModelsFactories(const Ptr<const NrPhy>& rtdPhy)
 {
@@ -389,6 +696,7 @@ NrRadioEnvironmentMapHelper::ConfigurePropagationModelsFactories(const Ptr<const
 
     /***** configure pathloss model factory *****/
     m_propagationLossModel = txSpectrumChannel->GetPropagationLossModel();
+    m_propagationLossModelFactory = ConfigureObjectFactory(m_propagationLossModel);
     /***** configure spectrum model factory *****/
     m_phasedArraySpectrumLossModel =
         txSpectrumChannel->GetPhasedArraySpectrumPropagationLossModel();
@@ -426,8 +734,17 @@ NrRadioEnvironmentMapHelper::ConfigurePropagationModelsFactories(const Ptr<const
     {
         if (spectrumLossModel->GetChannelModel())
         {
+            ObjectFactory spectrumLossModelFactory = ConfigureObjectFactory(spectrumLossModel);
             m_matrixBasedChannelModelFactory =
                 ConfigureObjectFactory(spectrumLossModel->GetChannelModel());
+            // The spectrum loss model is created only once: its long term components
+            // are cached per channel matrix, so with a new channel model at each
+            // calculation they are never reused among calculations
+            spectrumLossModelFactory.Set(
+                "ChannelModel",
+                PointerValue(m_matrixBasedChannelModelFactory.Create<MatrixBasedChannelModel>()));
+            m_remSpectrumLossModel =
+                spectrumLossModelFactory.Create<ThreeGppSpectrumPropagationLossModel>();
         }
         else
         {
@@ -438,7 +755,8 @@ NrRadioEnvironmentMapHelper::ConfigurePropagationModelsFactories(const Ptr<const
     else
     {
         NS_LOG_WARN("RemHelper currently only knows that ThreeGppSpectrumPropagationLossModel can "
-                    "have MatrixBasedChannelModel. Other models do not support it yet.");
+                    "have MatrixBasedChannelModel. Other models do not support it yet. The "
+                    "REM is calculated only with the path loss.");
     }
 }
 
@@ -599,6 +917,7 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
 
     ConfigureRrd(rrdDevice);
     ConfigureRtdList(rtdNetDev);
+    ConfigureScalarCalculation();
     CreateListOfRemPoints();
     if (m_remMode == COVERAGE_AREA)
     {
@@ -616,7 +935,23 @@ NrRadioEnvironmentMapHelper::DelayedInstall(const NetDeviceContainer& rtdNetDev,
     {
         NS_FATAL_ERROR("Unknown REM mode");
     }
-    PrintRemToFile();
+    if (m_statistics || m_outputFormat == NO_OUTPUT)
+    {
+        PrintRemStatisticsToFile();
+    }
+    if (m_outputFormat == BINARY_OUTPUT)
+    {
+        m_remFile.Close();
+        Finalize();
+    }
+    else if (m_outputFormat == TEXT_OUTPUT)
+    {
+        PrintRemToFile();
+    }
+    else
+    {
+        Finalize();
+    }
 
     std::ostringstream ossGnbs;
     ossGnbs << "nr-rem-" << m_simTag.c_str() << "-gnbs.txt";
@@ -642,9 +977,15 @@ NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
 
     NS_LOG_INFO("m_xStep: " << m_xStep << " m_yStep: " << m_yStep);
 
-    for (double x = m_xMin; x < m_xMax + 0.5 * m_xStep; x += m_xStep)
+    // The points of each column (x coordinate) of the grid are contiguous, so
+    // that the binary output can write a column when its points are done
+    m_numX = 0;
+    m_columnStart.clear();
+    for (double x = m_xMin; x < m_xMax + 0.5 * m_xStep; x += m_xStep, m_numX++)
     {
-        for (double y = m_yMin; y < m_yMax + 0.5 * m_yStep; y += m_yStep)
+        m_columnStart.push_back(m_rem.size());
+        m_numY = 0;
+        for (double y = m_yMin; y < m_yMax + 0.5 * m_yStep; y += m_yStep, m_numY++)
         {
             // In case a REM Point is in the same position as a rtd, ignore this point
             bool isPositionRtd = false;
@@ -664,11 +1005,20 @@ NrRadioEnvironmentMapHelper::CreateListOfRemPoints()
                 remPoint.pos.x = x;
                 remPoint.pos.y = y;
                 remPoint.pos.z = m_z;
+                remPoint.xIndex = m_numX;
+                remPoint.yIndex = m_numY;
 
                 m_rem.push_back(remPoint);
             }
         }
     }
+    m_columnStart.push_back(m_rem.size());
+
+    m_gridToRem.assign(static_cast<size_t>(m_numX) * m_numY, m_rem.size());
+    for (size_t index = 0; index < m_rem.size(); index++)
+    {
+        m_gridToRem[m_rem[index].xIndex * m_numY + m_rem[index].yIndex] = index;
+    }
 }
 
 void
@@ -696,7 +1046,78 @@ NrRadioEnvironmentMapHelper::ConfigureDirectPathBfv(RemDevice& device,
 Ptr<SpectrumValue>
 NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const
 {
-    PropagationModels tempPropModels = CreateTemporalPropagationModels();
+    return CalcRxPsdValue(CreateRemLink(device, otherDevice), device, otherDevice);
+}
+
+NrRadioEnvironmentMapHelper::RemLink
+NrRadioEnvironmentMapHelper::CreateRemLink(RemDevice& device, RemDevice& otherDevice) const
+{
+    RemLink link;
+    link.propModels = CreateTemporalPropagationModels();
+    // each link uses its own streams, see CalcRemPoint
+    m_nextStream += AssignStreams(link.propModels, m_nextStream);
+
+    Ptr<const SpectrumValue> convertedTxPsd = GetTxPsd(device, otherDevice);
+
+    // Copy TX PSD to RX PSD, they are now equal rxPsd == txPsd
+    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
+    rxParams->psd = convertedTxPsd->Copy();
+    double pathLossDb =
+        link.propModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
+    double pathGainLinear = DbToRatio(pathLossDb);
+
+    NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*convertedTxPsd)));
+    NS_LOG_DEBUG("PathlosDb:" << pathLossDb);
+
+    // Apply now calculated pathloss to rxPsd, now rxPsd < txPsd because we had some losses
+    *(rxParams->psd) *= pathGainLinear;
+
+    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(rxParams->psd))));
+
+    link.rxParams = rxParams;
+    return link;
+}
+
+Ptr<SpectrumValue>
+NrRadioEnvironmentMapHelper::CalcRxPsdValue(const RemLink& link,
+                                            const RemDevice& device,
+                                            const RemDevice& otherDevice) const
+{
+    // The spectrum loss model is shared by the links: use the channel model of this one
+    Ptr<ThreeGppSpectrumPropagationLossModel> spectrumLossModel =
+        link.propModels.remSpectrumLossModelCopy;
+    if (!spectrumLossModel || m_pathlossOnly)
+    {
+        // only the pathloss, e.g., if the RTDs have different spectrum models
+        // and the scalar calculation can't be used
+        return link.rxParams->psd->Copy();
+    }
+    if (spectrumLossModel->GetChannelModel() != link.propModels.remChannelModelCopy)
+    {
+        spectrumLossModel->SetAttribute("ChannelModel",
+                                        PointerValue(link.propModels.remChannelModelCopy));
+    }
+
+    // Now we call spectrum model, which in this keys add a beamforming gain
+    Ptr<SpectrumValue> rxPsd = spectrumLossModel->DoCalcRxPowerSpectralDensity(link.rxParams,
+                                                                               device.mob,
+                                                                               otherDevice.mob,
+                                                                               device.antenna,
+                                                                               otherDevice.antenna);
+
+    NS_LOG_DEBUG("RX power in dBm after fading: " << WToDbm(Integral(*rxPsd)));
+
+    return rxPsd;
+}
+
+Ptr<const SpectrumValue>
+NrRadioEnvironmentMapHelper::GetTxPsd(RemDevice& device, const RemDevice& otherDevice) const
+{
+    auto it = device.txPsds.find(otherDevice.spectrumModel->GetUid());
+    if (it != device.txPsds.end())
+    {
+        return it->second;
+    }
 
     std::vector<int> activeRbs;
     for (size_t rbId = 0; rbId < device.spectrumModel->GetNumBands(); rbId++)
@@ -729,32 +1150,29 @@ NrRadioEnvironmentMapHelper::CalcRxPsdValue(RemDevice& device, RemDevice& otherD
         convertedTxPsd = converter.Convert(txPsd);
     }
 
-    // Copy TX PSD to RX PSD, they are now equal rxPsd == txPsd
-    Ptr<SpectrumSignalParameters> rxParams = Create<SpectrumSignalParameters>();
-    rxParams->psd = convertedTxPsd->Copy();
-    double pathLossDb =
-        tempPropModels.remPropagationLossModelCopy->CalcRxPower(0, device.mob, otherDevice.mob);
-    double pathGainLinear = DbToRatio(pathLossDb);
-
-    NS_LOG_DEBUG("Tx power in dBm:" << WToDbm(Integral(*convertedTxPsd)));
-    NS_LOG_DEBUG("PathlosDb:" << pathLossDb);
-
-    // Apply now calculated pathloss to rxPsd, now rxPsd < txPsd because we had some losses
-    *(rxParams->psd) *= pathGainLinear;
-
-    NS_LOG_DEBUG("RX power in dBm after pathloss:" << WToDbm(Integral(*(rxParams->psd))));
-
-    // Now we call spectrum model, which in this keys add a beamforming gain
-    Ptr<SpectrumValue> rxPsd =
-        tempPropModels.remSpectrumLossModelCopy->DoCalcRxPowerSpectralDensity(rxParams,
-                                                                              device.mob,
-                                                                              otherDevice.mob,
-                                                                              device.antenna,
-                                                                              otherDevice.antenna);
-
-    NS_LOG_DEBUG("RX power in dBm after fading: " << WToDbm(Integral(*rxPsd)));
+    device.txPsds.emplace(otherDevice.spectrumModel->GetUid(), convertedTxPsd);
+    return convertedTxPsd;
+}
 
-    return rxPsd;
+double
+NrRadioEnvironmentMapHelper::CalcRxPower(const RemDevice& device,
+                                         const RemDevice& otherDevice) const
+{
+    // The pathloss and channel condition models of CreateRemLink, with the same
+    // streams, so that the pathloss is the same as in the calculation with PSDs
+    Ptr<ChannelConditionModel> condModel =
+        m_channelConditionModelFactory.Create<ChannelConditionModel>();
+    Ptr<ThreeGppPropagationLossModel> pathlossModel =
+        m_propagationLossModelFactory.Create<ThreeGppPropagationLossModel>();
+    pathlossModel->SetChannelConditionModel(condModel);
+    int64_t stream = m_nextStream;
+    stream += pathlossModel->AssignStreams(stream);
+    condModel->AssignStreams(stream);
+    // the streams of the channel model are not used, but the link reserves them
+    m_nextStream += m_streamsPerLink;
+
+    double pathLossDb = pathlossModel->CalcRxPower(0, device.mob, otherDevice.mob);
+    return device.txPowerW * DbToRatio(pathLossDb);
 }
 
 Ptr<SpectrumValue>
@@ -859,24 +1277,14 @@ NrRadioEnvironmentMapHelper::CalculateMaxSinr(
 {
     // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
     // interferers
+    std::vector<SpectrumValue> interferences = CalcInterferences(receivedPowerList);
+    auto interference = interferences.begin();
     std::list<double> sinrList;
-
-    for (std::list<Ptr<SpectrumValue>>::const_iterator it = receivedPowerList.begin();
-         it != receivedPowerList.end();
-         it++)
+    for (const auto& rxPower : receivedPowerList)
     {
-        // all signals - rxPower = interference
-        std::list<Ptr<SpectrumValue>> interferenceSignals;
-        std::list<Ptr<SpectrumValue>>::const_iterator tempit = it;
-
-        if (it != receivedPowerList.begin())
-        {
-            interferenceSignals.insert(interferenceSignals.begin(), receivedPowerList.begin(), it);
-        }
-
-        interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
-        NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sinrList.push_back(CalculateSinr(*it, interferenceSignals));
+        SpectrumValue sinr = (*rxPower) / (*interference + *m_noisePsd);
+        sinrList.push_back(RatioToDb(Sum(sinr) / sinr.GetSpectrumModel()->GetNumBands()));
+        ++interference;
     }
     return GetMaxValue(sinrList);
 }
@@ -885,101 +1293,192 @@ double
 NrRadioEnvironmentMapHelper::CalculateMaxSir(
     const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
 {
-    // we calculate sinr considering for each RTD as if it would be TX device, and the rest of RTDs
-    // interferers
-    std::list<double> sirList;
-
-    for (std::list<Ptr<SpectrumValue>>::const_iterator it = receivedPowerList.begin();
-         it != receivedPowerList.end();
-         it++)
+    if (receivedPowerList.size() == 1)
     {
-        // all signals - rxPower = interference
-        std::list<Ptr<SpectrumValue>> interferenceSignals;
-        std::list<Ptr<SpectrumValue>>::const_iterator tempit = it;
+        return CalculateSir(receivedPowerList.front(), {});
+    }
 
-        if (it != receivedPowerList.begin())
+    std::vector<SpectrumValue> interferences = CalcInterferences(receivedPowerList);
+    auto interference = interferences.begin();
+    std::list<double> sirList;
+    for (const auto& rxPower : receivedPowerList)
+    {
+        // without interference (e.g., the other RTDs are too far), as with a single RTD
+        if (Sum(*interference) > 0)
         {
-            interferenceSignals.insert(interferenceSignals.begin(), receivedPowerList.begin(), it);
+            SpectrumValue sir = (*rxPower) / (*interference);
+            sirList.push_back(RatioToDb(Sum(sir) / sir.GetSpectrumModel()->GetNumBands()));
         }
-
-        interferenceSignals.insert(interferenceSignals.end(), ++tempit, receivedPowerList.end());
-        NS_ASSERT(interferenceSignals.size() == receivedPowerList.size() - 1);
-        sirList.push_back(CalculateSir(*it, interferenceSignals));
+        else
+        {
+            sirList.push_back(CalculateSir(rxPower, {}));
+        }
+        ++interference;
     }
     return GetMaxValue(sirList);
 }
 
-void
-NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
+std::vector<SpectrumValue>
+NrRadioEnvironmentMapHelper::CalcInterferences(
+    const std::list<Ptr<SpectrumValue>>& receivedPowerList) const
 {
-    NS_LOG_FUNCTION(this);
-
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    // The interference of each signal is the sum of the signals before it and of
+    // the ones after it. Subtracting it from the sum of all the signals would
+    // cancel to 0 (or below) when it is much stronger than the others.
+    std::vector<SpectrumValue> interferences;
+    SpectrumValue before(m_rrd.spectrumModel);
+    for (const auto& rxPower : receivedPowerList)
+    {
+        interferences.push_back(before);
+        before += *rxPower;
+    }
+    SpectrumValue after(m_rrd.spectrumModel);
+    auto interference = interferences.rbegin();
+    for (auto rxPower = receivedPowerList.rbegin(); rxPower != receivedPowerList.rend();
+         ++rxPower, ++interference)
+    {
+        *interference += after;
+        after += **rxPower;
+    }
+    return interferences;
+}
 
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
+std::vector<double>
+NrRadioEnvironmentMapHelper::CalcInterferences(const std::vector<double>& rxPowers) const
+{
+    // as the PSD version, without subtracting each signal from the sum of all
+    std::vector<double> interferences(rxPowers.size(), 0.0);
+    double before = 0.0;
+    for (size_t i = 0; i < rxPowers.size(); i++)
+    {
+        interferences[i] = before;
+        before += rxPowers[i];
+    }
+    double after = 0.0;
+    for (size_t i = rxPowers.size(); i-- > 0;)
     {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        double sumSir = 0.0;
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+        interferences[i] += after;
+        after += rxPowers[i];
+    }
+    return interferences;
+}
 
-        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
-        buildingInfo->MakeConsistent(m_rrd.mob);
-        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+double
+NrRadioEnvironmentMapHelper::CalculateMaxSnr(const std::vector<double>& rxPowers) const
+{
+    // The PSDs of the signals and of the noise are flat, so the average of the
+    // SNR over the RBs is the ratio of the powers
+    return RatioToDb(*std::max_element(rxPowers.begin(), rxPowers.end()) / m_noisePower);
+}
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<Ptr<SpectrumValue>>
-                receivedPowerList; // RTD node id, rxPsd of the singal coming from that node
+double
+NrRadioEnvironmentMapHelper::CalculateMaxSinr(const std::vector<double>& rxPowers) const
+{
+    std::vector<double> interferences = CalcInterferences(rxPowers);
+    double maxSinr = 0.0;
+    for (size_t i = 0; i < rxPowers.size(); i++)
+    {
+        maxSinr = std::max(maxSinr, rxPowers[i] / (interferences[i] + m_noisePower));
+    }
+    return RatioToDb(maxSinr);
+}
 
-            for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
-                 ++itRtd)
-            {
-                // calculate received power from the current RTD device
-                receivedPowerList.push_back(CalcRxPsdValue(*itRtd, m_rrd));
-            } // end for std::list<RemDev>::iterator  (RTDs)
+double
+NrRadioEnvironmentMapHelper::CalculateMaxSir(const std::vector<double>& rxPowers) const
+{
+    if (rxPowers.size() == 1)
+    {
+        // as CalculateSir without interference: the average PSD of the signal
+        return RatioToDb(rxPowers.front() / m_remBandwidth);
+    }
+
+    std::vector<double> interferences = CalcInterferences(rxPowers);
+    double maxSirDb = std::numeric_limits<double>::lowest();
+    for (size_t i = 0; i < rxPowers.size(); i++)
+    {
+        // without interference, as with a single RTD
+        maxSirDb = std::max(maxSirDb,
+                            interferences[i] > 0 ? RatioToDb(rxPowers[i] / interferences[i])
+                                                 : RatioToDb(rxPowers[i] / m_remBandwidth));
+    }
+    return maxSirDb;
+}
 
-            sumSnr += CalculateMaxSnr(receivedPowerList);
-            sumSinr += CalculateMaxSinr(receivedPowerList);
-            sumSir += CalculateMaxSir(receivedPowerList);
+void
+NrRadioEnvironmentMapHelper::CalcBeamShapeRemMap()
+{
+    NS_LOG_FUNCTION(this);
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
+    CalcRemPoints(m_scalarCalc ? &NrRadioEnvironmentMapHelper::CalcScalarRemPoint
+                               : &NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint,
+                  m_numOfIterationsToAverage * m_remDev.size());
 
-            receivedPowerList.clear();
-        } // end for m_numOfIterationsToAverage  (Average)
+    auto remEndTime = std::chrono::system_clock::now();
+    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
+    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
+                << remElapsedSeconds.count() / 60 << " minutes.");
+}
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+void
+NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint(RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+    // the received power from each RTD, summed over the iterations (linear)
+    std::vector<double> serverPowers(m_remDev.size(), 0.0);
+    m_rrd.mob->SetPosition(remPoint.pos);
+
+    Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
+    buildingInfo->MakeConsistent(m_rrd.mob);
+    NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<Ptr<SpectrumValue>>
+            receivedPowerList; // RTD node id, rxPsd of the singal coming from that node
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+        for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
+             ++itRtd)
+        {
+            // calculate received power from the current RTD device
+            receivedPowerList.push_back(CalcRxPsdValue(*itRtd, m_rrd));
+        } // end for std::list<RemDev>::iterator  (RTDs)
 
-        NS_LOG_INFO("Avg snr value saved:" << itRemPoint->avgSnrDb);
-        NS_LOG_INFO("Avg sinr value saved:" << itRemPoint->avgSinrDb);
-        NS_LOG_INFO("Avg ipsd value saved (dBm):" << itRemPoint->avRxPowerDbm);
+        sumSnr += CalculateMaxSnr(receivedPowerList);
+        sumSinr += CalculateMaxSinr(receivedPowerList);
+        sumSir += CalculateMaxSir(receivedPowerList);
 
-        if (++remPointCounter == remSizeNextReport)
+        size_t rtdIndex = 0;
+        for (const auto& receivedPower : receivedPowerList)
         {
-            PrintProgressReport(&remSizeNextReport);
+            serverPowers[rtdIndex++] += Integral(*receivedPower);
         }
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(receivedPowerList));
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+        receivedPowerList.clear();
+    } // end for m_numOfIterationsToAverage  (Average)
+
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+    remPoint.bestServer = static_cast<uint32_t>(
+        std::max_element(serverPowers.begin(), serverPowers.end()) - serverPowers.begin());
+
+    NS_LOG_INFO("Avg snr value saved:" << remPoint.avgSnrDb);
+    NS_LOG_INFO("Avg sinr value saved:" << remPoint.avgSinrDb);
+    NS_LOG_INFO("Avg ipsd value saved (dBm):" << remPoint.avRxPowerDbm);
 }
 
 double
@@ -1039,132 +1538,738 @@ void
 NrRadioEnvironmentMapHelper::CalcCoverageAreaRemMap()
 {
     NS_LOG_FUNCTION(this);
-    uint16_t calcRxPsdCounter = 0;
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
-
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
-    {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
-
-        // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
-        // worst-case scenario
-        for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
-             ++itRtd)
-        {
-            ConfigureDirectPathBfv(*itRtd, m_rrd, itRtd->antenna);
-        }
 
-        std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
-                                           // each Iteration (linear)
+    // One link from each RTD, applied to every beam of the RRD
+    CalcRemPoints(m_scalarCalc ? &NrRadioEnvironmentMapHelper::CalcScalarRemPoint
+                               : &NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint,
+                  m_numOfIterationsToAverage * m_remDev.size());
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
-        {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+    auto remEndTime = std::chrono::system_clock::now();
+    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
+    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
+                << remElapsedSeconds.count() / 60 << " minutes.");
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcCoverageAreaRemPoint(RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    m_rrd.mob->SetPosition(remPoint.pos);
+
+    // all RTDs should point toward that RemPoint with DirectPah beam, this is definition of
+    // worst-case scenario
+    for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end(); ++itRtd)
+    {
+        ConfigureDirectPathBfv(*itRtd, m_rrd, itRtd->antenna);
+    }
+
+    std::list<double> rxPsdsListPerIt; // list to save the summed rxPower in each RemPoint for
+                                       // each Iteration (linear)
+    // the useful signal from each RTD, summed over the iterations (linear)
+    std::vector<double> serverPowers(m_remDev.size(), 0.0);
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+
+        std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
+                                                  // rxPowers per remPoint (linear)
 
-            std::list<Ptr<SpectrumValue>> rxPsdsList; // vector in which we will save the sum of
-                                                      // rxPowers per remPoint (linear)
+        // The pathloss, the channel condition and the channel matrix from each RTD do
+        // not depend on the beam of the RRD: they are generated once per iteration, and
+        // every beam of the RRD sees the same realization of the channel
+        std::vector<RemLink> links;
+        for (std::list<RemDevice>::iterator itRtd = m_remDev.begin(); itRtd != m_remDev.end();
+             ++itRtd)
+        {
+            links.push_back(CreateRemLink(*itRtd, m_rrd));
+        }
 
-            // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
-            // many beam configurations at RemPoint as many RTDs
-            for (std::list<RemDevice>::iterator itRtdBeam = m_remDev.begin();
-                 itRtdBeam != m_remDev.end();
-                 ++itRtdBeam)
+        // For each beam configuration at RemPoint/RRD we should calculate SINR, there are as
+        // many beam configurations at RemPoint as many RTDs
+        size_t beamIndex = 0;
+        for (std::list<RemDevice>::iterator itRtdBeam = m_remDev.begin();
+             itRtdBeam != m_remDev.end();
+             ++itRtdBeam, ++beamIndex)
+        {
+            // configure RRD beam toward RTD
+            ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
+
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
+
+            // For this configuration of beam at RRD, we need to calculate RX PSD,
+            // and in order to be able to calculate SINR for that beam,
+            // we need to calculate received PSD for each RTD using this beam at RRD
+            size_t linkIndex = 0;
+            for (std::list<RemDevice>::iterator itRtdCalc = m_remDev.begin();
+                 itRtdCalc != m_remDev.end();
+                 ++itRtdCalc, ++linkIndex)
             {
-                // configure RRD beam toward RTD
-                ConfigureDirectPathBfv(m_rrd, *itRtdBeam, m_rrd.antenna);
-
-                // Calculate the received power from this RTD for this RemPoint
-                Ptr<SpectrumValue> receivedPowerFromRtd = CalcRxPsdValue(*itRtdBeam, m_rrd);
-                // and put it to the list of the received powers for this RemPoint (to sum all
-                // later)
-                rxPsdsList.push_back(receivedPowerFromRtd);
-
-                NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
-                                           << " is Rxed in RemPoint with Rx Power in W: "
-                                           << (Integral(*receivedPowerFromRtd)));
-                NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*receivedPowerFromRtd)));
-
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
-
-                // For this configuration of beam at RRD, we need to calculate RX PSD,
-                // and in order to be able to calculate SINR for that beam,
-                // we need to calculate received PSD for each RTD using this beam at RRD
-                for (std::list<RemDevice>::iterator itRtdCalc = m_remDev.begin();
-                     itRtdCalc != m_remDev.end();
-                     ++itRtdCalc)
-                {
-                    // increase counter de calcRXPsd calls
-                    calcRxPsdCounter++;
-                    // calculate received power from the current RTD device
-                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(*itRtdCalc, m_rrd);
+                // calculate received power from the current RTD device
+                Ptr<SpectrumValue> receivedPower =
+                    CalcRxPsdValue(links[linkIndex], *itRtdCalc, m_rrd);
 
-                    // is this received power useful signal (from RTD for which I configured my
-                    // beam) or is interference signal
+                // is this received power useful signal (from RTD for which I configured my
+                // beam) or is interference signal
 
-                    if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc->dev->GetNode()->GetId())
+                if (itRtdBeam->dev->GetNode()->GetId() == itRtdCalc->dev->GetNode()->GetId())
+                {
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
                     }
-                    else
+                    usefulSignalRxPsd = receivedPower;
+                }
+                else
+                {
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
+
+            } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
+
+            // The received power from this RTD, with the RRD beam toward it, is put in
+            // the list of the received powers for this RemPoint (to sum all later)
+            rxPsdsList.push_back(usefulSignalRxPsd);
+            serverPowers[beamIndex] += Integral(*usefulSignalRxPsd);
+
+            NS_LOG_DEBUG("beam node: " << itRtdBeam->dev->GetNode()->GetId()
+                                       << " is Rxed in RemPoint with Rx Power in W: "
+                                       << (Integral(*usefulSignalRxPsd)));
+            NS_LOG_DEBUG("RxPower in dBm: " << WToDbm(Integral(*usefulSignalRxPsd)));
+
+            sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+
+        } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
+
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
+
+        // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
+        // Iteration (linear)
+        rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+
+    } // end for m_numOfIterationsToAverage  (Average)
+
+    // Sum the rxPower for all the Iterations (linear)
+    double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+    remPoint.bestServer = static_cast<uint32_t>(
+        std::max_element(serverPowers.begin(), serverPowers.end()) - serverPowers.begin());
+
+    NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << remPoint.avRxPowerDbm);
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemPoints(RemPointFunction calcRemPoint, uint64_t callsPerPoint)
+{
+    NS_LOG_FUNCTION(this << callsPerPoint);
+
+    // The streams of the propagation models of each REM point follow from its
+    // index, so that the map does not depend on the order of the points nor on
+    // the number of workers
+    PropagationModels propModels = CreateTemporalPropagationModels();
+    m_streamsPerLink = AssignStreams(propModels, 0);
+    m_streamsPerPoint = static_cast<int64_t>(callsPerPoint) * m_streamsPerLink;
+
+    uint32_t numWorkers = m_numWorkers;
+    if (numWorkers == 0)
+    {
+        numWorkers = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    numWorkers = static_cast<uint32_t>(std::min<size_t>(numWorkers, m_rem.size()));
+
+    if (m_outputFormat == BINARY_OUTPUT)
+    {
+        NrRemBinaryFile::Header header;
+        header.m_xMin = m_xMin;
+        header.m_yMin = m_yMin;
+        header.m_xStep = m_xStep;
+        header.m_yStep = m_yStep;
+        header.m_z = m_z;
+        header.m_numX = m_numX;
+        header.m_numY = m_numY;
+        header.m_metrics = {"SNR", "SINR", "RxPower", "SIR"};
+        std::ostringstream oss;
+        oss << "nr-rem-" << m_simTag.c_str() << ".bin";
+        NS_ABORT_MSG_UNLESS(m_remFile.Create(oss.str(), header), "Can't open file " << oss.str());
+        m_nextColumn = 0;
+    }
+
+    // The REM points saved in the checkpoint by a previous run are not calculated again
+    std::vector<bool> done(m_rem.size(), false);
+    if (m_checkpointPeriod.IsStrictlyPositive())
+    {
+        ResumeCheckpoint(&done);
+    }
+    std::vector<bool> saved = done;
+    auto isDone = [&done](size_t index) { return static_cast<bool>(done[index]); };
+
+#ifndef NR_REM_WORKER_PROCESSES
+    if (numWorkers > 1)
+    {
+        NS_LOG_WARN("REM workers are not supported on this platform, the REM points are "
+                    "calculated sequentially");
+        numWorkers = 1;
+    }
+#endif
+
+    m_remSizeNextReport = m_rem.size() / 100;
+    std::vector<RemCell> uniformCells;
+    if (m_adaptiveLevels == 0)
+    {
+        std::vector<size_t> indices(m_rem.size());
+        std::iota(indices.begin(), indices.end(), 0);
+        CalcRemPointList(calcRemPoint, numWorkers, indices, &done, &saved);
+    }
+    else
+    {
+        uniformCells = CalcAdaptiveRemPoints(calcRemPoint, numWorkers, &done, &saved);
+    }
+
+    // Save also the points that were resumed, but not the interpolated ones
+    if (m_checkpointPeriod.IsStrictlyPositive())
+    {
+        SaveCheckpoint(m_rem.data(), isDone, &saved, true);
+        m_checkpointFile.Close();
+    }
+    if (m_adaptiveLevels > 0)
+    {
+        PrintRemSamplesToFile(done);
+        InterpolateRemPoints(uniformCells, &done);
+    }
+    if (m_outputFormat == BINARY_OUTPUT)
+    {
+        WriteCompletedColumns(m_rem.data(), isDone);
+    }
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemPointList(RemPointFunction calcRemPoint,
+                                              uint32_t numWorkers,
+                                              const std::vector<size_t>& indices,
+                                              std::vector<bool>* done,
+                                              std::vector<bool>* saved)
+{
+    NS_LOG_FUNCTION(this << numWorkers << indices.size());
+
+    numWorkers = static_cast<uint32_t>(std::min<size_t>(numWorkers, indices.size()));
+    if (numWorkers > 1)
+    {
+#ifdef NR_REM_WORKER_PROCESSES
+        CalcRemPointsInWorkers(calcRemPoint, numWorkers, indices, done, saved);
+#endif
+        return;
+    }
+
+    auto isDone = [done](size_t index) { return static_cast<bool>((*done)[index]); };
+    uint64_t donePoints = std::count(done->begin(), done->end(), true);
+    for (size_t index : indices)
+    {
+        if ((*done)[index])
+        {
+            continue;
+        }
+        CalcRemPoint(calcRemPoint, index);
+        (*done)[index] = true;
+        if (m_outputFormat == BINARY_OUTPUT)
+        {
+            WriteCompletedColumns(m_rem.data(), isDone);
+        }
+        SaveCheckpoint(m_rem.data(), isDone, saved, false);
+
+        ++donePoints;
+        while (m_remSizeNextReport > 0 && donePoints >= m_remSizeNextReport)
+        {
+            PrintProgressReport(&m_remSizeNextReport);
+        }
+    }
+}
+
+std::vector<NrRadioEnvironmentMapHelper::RemCell>
+NrRadioEnvironmentMapHelper::CalcAdaptiveRemPoints(RemPointFunction calcRemPoint,
+                                                   uint32_t numWorkers,
+                                                   std::vector<bool>* done,
+                                                   std::vector<bool>* saved)
+{
+    NS_LOG_FUNCTION(this << numWorkers);
+
+    // The coarse grid takes one point every 2^AdaptiveLevels points of the
+    // grid along each axis, and the last point of the axis. An axis with a
+    // single point (resolution 0) has cells of width 0.
+    uint32_t coarseStep = 1U << m_adaptiveLevels;
+    auto coarseIndices = [coarseStep](uint32_t numPoints) {
+        std::vector<uint32_t> indices;
+        for (uint32_t i = 0; i < numPoints; i += coarseStep)
+        {
+            indices.push_back(i);
+        }
+        if (indices.size() == 1 || indices.back() != numPoints - 1)
+        {
+            indices.push_back(numPoints - 1);
+        }
+        return indices;
+    };
+    std::vector<uint32_t> xCoarse = coarseIndices(m_numX);
+    std::vector<uint32_t> yCoarse = coarseIndices(m_numY);
+    std::vector<RemCell> cells;
+    for (size_t i = 0; i + 1 < xCoarse.size(); i++)
+    {
+        for (size_t j = 0; j + 1 < yCoarse.size(); j++)
+        {
+            cells.push_back({xCoarse[i], xCoarse[i + 1], yCoarse[j], yCoarse[j + 1]});
+        }
+    }
+
+    // At each level, the corners of the cells are calculated (all together, so
+    // that they can be shared among the workers), and the cells whose corners
+    // are not uniform are split in four for the next level
+    std::vector<RemCell> uniformCells;
+    uint32_t level = 0;
+    while (!cells.empty())
+    {
+        std::vector<size_t> indices;
+        for (const RemCell& cell : cells)
+        {
+            for (uint32_t x : {cell.x0, cell.x1})
+            {
+                for (uint32_t y : {cell.y0, cell.y1})
+                {
+                    size_t index = m_gridToRem[x * m_numY + y];
+                    if (index < m_rem.size() && !(*done)[index])
                     {
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                        indices.push_back(index);
                     }
+                }
+            }
+        }
+        std::sort(indices.begin(), indices.end());
+        indices.erase(std::unique(indices.begin(), indices.end()), indices.end());
+        NS_LOG_INFO("Adaptive REM level " << level << ": " << cells.size() << " cells, "
+                                          << indices.size() << " new REM points");
+        CalcRemPointList(calcRemPoint, numWorkers, indices, done, saved);
+
+        std::vector<RemCell> nextCells;
+        for (const RemCell& cell : cells)
+        {
+            if (IsUniformCell(cell))
+            {
+                uniformCells.push_back(cell);
+                continue;
+            }
+            std::vector<uint32_t> xSplit{cell.x0, cell.x1};
+            std::vector<uint32_t> ySplit{cell.y0, cell.y1};
+            if (cell.x1 - cell.x0 > 1)
+            {
+                xSplit.insert(xSplit.begin() + 1, (cell.x0 + cell.x1) / 2);
+            }
+            if (cell.y1 - cell.y0 > 1)
+            {
+                ySplit.insert(ySplit.begin() + 1, (cell.y0 + cell.y1) / 2);
+            }
+            if (xSplit.size() == 2 && ySplit.size() == 2)
+            {
+                continue; // No points inside the cell: they are all calculated
+            }
+            for (size_t i = 0; i + 1 < xSplit.size(); i++)
+            {
+                for (size_t j = 0; j + 1 < ySplit.size(); j++)
+                {
+                    nextCells.push_back({xSplit[i], xSplit[i + 1], ySplit[j], ySplit[j + 1]});
+                }
+            }
+        }
+        cells = std::move(nextCells);
+        level++;
+    }
+    return uniformCells;
+}
 
-                } // end for std::list<RemDev>::iterator itRtdCalc (RTDs)
+bool
+NrRadioEnvironmentMapHelper::IsUniformCell(const RemCell& cell) const
+{
+    double minSinr = std::numeric_limits<double>::max();
+    double maxSinr = std::numeric_limits<double>::lowest();
+    double minRxPower = std::numeric_limits<double>::max();
+    double maxRxPower = std::numeric_limits<double>::lowest();
+    for (uint32_t x : {cell.x0, cell.x1})
+    {
+        for (uint32_t y : {cell.y0, cell.y1})
+        {
+            // A corner at the position of a RTD has no value: the cell is split
+            size_t index = m_gridToRem[x * m_numY + y];
+            if (index >= m_rem.size())
+            {
+                return false;
+            }
+            minSinr = std::min(minSinr, m_rem[index].avgSinrDb);
+            maxSinr = std::max(maxSinr, m_rem[index].avgSinrDb);
+            minRxPower = std::min(minRxPower, m_rem[index].avRxPowerDbm);
+            maxRxPower = std::max(maxRxPower, m_rem[index].avRxPowerDbm);
+        }
+    }
+    // A RTD inside the cell has a peak of the values that the corners don't
+    // show: the cell is split
+    const Vector& low = m_rem[m_gridToRem[cell.x0 * m_numY + cell.y0]].pos;
+    const Vector& high = m_rem[m_gridToRem[cell.x1 * m_numY + cell.y1]].pos;
+    for (const RemDevice& rtd : m_remDev)
+    {
+        Vector position = rtd.mob->GetPosition();
+        if (position.x >= low.x && position.x <= high.x && position.y >= low.y &&
+            position.y <= high.y)
+        {
+            return false;
+        }
+    }
+    // Equal values (also -inf) are uniform, and NaN values are not
+    double sinrRange = (maxSinr == minSinr) ? 0 : maxSinr - minSinr;
+    double rxPowerRange = (maxRxPower == minRxPower) ? 0 : maxRxPower - minRxPower;
+    return sinrRange <= m_adaptiveThreshold && rxPowerRange <= m_adaptiveThreshold;
+}
 
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+void
+NrRadioEnvironmentMapHelper::InterpolateRemPoints(const std::vector<RemCell>& uniformCells,
+                                                  std::vector<bool>* done)
+{
+    NS_LOG_FUNCTION(this << uniformCells.size());
 
-                NS_LOG_INFO("Done:" << (double)calcRxPsdCounter /
-                                           (m_rem.size() * m_numOfIterationsToAverage *
-                                            m_remDev.size() * m_remDev.size()) *
-                                           100
-                                    << " %."); // how many times will be called CalcRxPsdValues
+    // Bilinear interpolation (of the values in dB) of the corners of each
+    // uniform cell. A point on the edge of two cells takes the values of the
+    // first one.
+    for (const RemCell& cell : uniformCells)
+    {
+        const RemPoint& c00 = m_rem[m_gridToRem[cell.x0 * m_numY + cell.y0]];
+        const RemPoint& c01 = m_rem[m_gridToRem[cell.x0 * m_numY + cell.y1]];
+        const RemPoint& c10 = m_rem[m_gridToRem[cell.x1 * m_numY + cell.y0]];
+        const RemPoint& c11 = m_rem[m_gridToRem[cell.x1 * m_numY + cell.y1]];
+        for (uint32_t x = cell.x0; x <= cell.x1; x++)
+        {
+            for (uint32_t y = cell.y0; y <= cell.y1; y++)
+            {
+                size_t index = m_gridToRem[x * m_numY + y];
+                if (index >= m_rem.size() || (*done)[index])
+                {
+                    continue;
+                }
+                double u = cell.x1 > cell.x0
+                               ? static_cast<double>(x - cell.x0) / (cell.x1 - cell.x0)
+                               : 0;
+                double v = cell.y1 > cell.y0
+                               ? static_cast<double>(y - cell.y0) / (cell.y1 - cell.y0)
+                               : 0;
+                // the corners with weight 0 are skipped, so that an infinite
+                // value (e.g., the -inf dB of no signal) is only taken when used
+                auto interpolate = [u, v, &c00, &c01, &c10, &c11](double RemPoint::*value) {
+                    double sum = 0;
+                    for (const auto& [weight, corner] :
+                         {std::make_pair((1 - u) * (1 - v), &c00),
+                          std::make_pair((1 - u) * v, &c01),
+                          std::make_pair(u * (1 - v), &c10),
+                          std::make_pair(u * v, &c11)})
+                    {
+                        if (weight > 0)
+                        {
+                            sum += weight * corner->*value;
+                        }
+                    }
+                    return sum;
+                };
+                RemPoint& remPoint = m_rem[index];
+                remPoint.avgSnrDb = interpolate(&RemPoint::avgSnrDb);
+                remPoint.avgSinrDb = interpolate(&RemPoint::avgSinrDb);
+                remPoint.avgSirDb = interpolate(&RemPoint::avgSirDb);
+                remPoint.avRxPowerDbm = interpolate(&RemPoint::avRxPowerDbm);
+                // the best server can't be interpolated: the one of the nearest corner
+                remPoint.bestServer = u < 0.5 ? (v < 0.5 ? c00 : c01).bestServer
+                                              : (v < 0.5 ? c10 : c11).bestServer;
+                (*done)[index] = true;
+            }
+        }
+    }
+}
+
+void
+NrRadioEnvironmentMapHelper::CalcRemPoint(RemPointFunction calcRemPoint, size_t index)
+{
+    int64_t firstStream = m_streamBase + static_cast<int64_t>(index) * m_streamsPerPoint;
+    m_nextStream = firstStream;
+    (this->*calcRemPoint)(m_rem[index]);
+    NS_ASSERT_MSG(m_nextStream == firstStream + m_streamsPerPoint,
+                  "The REM point used a wrong number of random streams");
+}
 
-            } // end for std::list<RemDev>::iterator itRtdBeam (RTDs)
+#ifdef NR_REM_WORKER_PROCESSES
+void
+NrRadioEnvironmentMapHelper::CalcRemPointsInWorkers(RemPointFunction calcRemPoint,
+                                                    uint32_t numWorkers,
+                                                    const std::vector<size_t>& indices,
+                                                    std::vector<bool>* done,
+                                                    std::vector<bool>* saved)
+{
+    NS_LOG_FUNCTION(this << numWorkers << indices.size());
+
+    // Smart pointers, random streams and the building list of ns-3 are not
+    // thread-safe: each worker is a process, with a private copy of the REM
+    // devices and of the propagation models. The workers take the next point
+    // not yet taken, and write its values in an array shared by all of them,
+    // followed by a flag for each point that tells if the values are written.
+    struct WorkerProgress
+    {
+        std::atomic<uint64_t> nextPoint{0};  //!< Next REM point to be taken
+        std::atomic<uint64_t> donePoints{0}; //!< REM points calculated
+    };
+
+    size_t sharedSize = sizeof(WorkerProgress) + m_rem.size() * sizeof(RemPoint) +
+                        m_rem.size() * sizeof(std::atomic<uint8_t>);
+    void* shared =
+        mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    NS_ABORT_MSG_IF(shared == MAP_FAILED, "Could not allocate the memory of the REM workers");
+    auto progress = new (shared) WorkerProgress;
+    progress->donePoints = std::count(done->begin(), done->end(), true);
+    NS_ABORT_MSG_UNLESS(progress->nextPoint.is_lock_free(),
+                        "REM workers need lock-free atomic counters");
+    auto remPoints =
+        reinterpret_cast<RemPoint*>(static_cast<char*>(shared) + sizeof(WorkerProgress));
+    for (size_t index = 0; index < m_rem.size(); index++)
+    {
+        new (&remPoints[index]) RemPoint(m_rem[index]);
+    }
+    auto doneFlags = reinterpret_cast<std::atomic<uint8_t>*>(remPoints + m_rem.size());
+    for (size_t index = 0; index < m_rem.size(); index++)
+    {
+        new (&doneFlags[index]) std::atomic<uint8_t>((*done)[index] ? 1 : 0);
+    }
+    auto isDone = [doneFlags](size_t index) {
+        return doneFlags[index].load(std::memory_order_acquire) != 0;
+    };
+
+    // Only this process reports the progress of all the workers, writes the
+    // binary output and saves the checkpoints
+    auto work = [&](bool report) {
+        for (uint64_t next = progress->nextPoint++; next < indices.size();
+             next = progress->nextPoint++)
+        {
+            size_t index = indices[next];
+            if (isDone(index))
+            {
+                continue;
+            }
+            CalcRemPoint(calcRemPoint, index);
+            remPoints[index] = m_rem[index];
+            doneFlags[index].store(1, std::memory_order_release);
+            if (report && m_outputFormat == BINARY_OUTPUT)
+            {
+                WriteCompletedColumns(remPoints, isDone);
+            }
+            if (report)
+            {
+                SaveCheckpoint(remPoints, isDone, saved, false);
+            }
+            uint64_t done = ++progress->donePoints;
+            while (report && m_remSizeNextReport > 0 && done >= m_remSizeNextReport)
+            {
+                PrintProgressReport(&m_remSizeNextReport);
+            }
+        }
+    };
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+    std::cout.flush();
+    std::cerr.flush();
+    std::vector<pid_t> workers;
+    for (uint32_t worker = 1; worker < numWorkers; worker++)
+    {
+        pid_t pid = fork();
+        NS_ABORT_MSG_IF(pid < 0, "Could not create a REM worker");
+        if (pid == 0)
+        {
+            work(false);
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(0);
+        }
+        workers.push_back(pid);
+    }
+    work(true);
 
-            // Sum all the rxPowers (for this RemPoint) and put the result to the list for each
-            // Iteration (linear)
-            rxPsdsListPerIt.push_back(CalculateAggregatedIpsd(rxPsdsList));
+    bool failed = false;
+    for (pid_t pid : workers)
+    {
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR)
+        {
+        }
+        failed = failed || !WIFEXITED(status) || WEXITSTATUS(status) != 0;
+    }
+    NS_ABORT_MSG_IF(failed, "A REM worker did not complete its REM points");
 
-        } // end for m_numOfIterationsToAverage  (Average)
+    std::copy(remPoints, remPoints + m_rem.size(), m_rem.begin());
+    for (size_t index : indices)
+    {
+        (*done)[index] = true;
+    }
+    progress->~WorkerProgress();
+    munmap(shared, sharedSize);
+}
+#endif
 
-        // Sum the rxPower for all the Iterations (linear)
-        double rxPsdsAllIt = SumListElements(rxPsdsListPerIt);
+void
+NrRadioEnvironmentMapHelper::WriteCompletedColumns(const RemPoint* remPoints,
+                                                   const std::function<bool(size_t)>& isDone)
+{
+    bool written = false;
+    for (; m_nextColumn < m_numX; m_nextColumn++)
+    {
+        size_t begin = m_columnStart[m_nextColumn];
+        size_t end = m_columnStart[m_nextColumn + 1];
+        if (end > begin && !isDone(end - 1))
+        {
+            break;
+        }
+        // The points are taken in order, but the workers may complete them out of order
+        bool columnDone = true;
+        for (size_t index = begin; columnDone && index < end; index++)
+        {
+            columnDone = isDone(index);
+        }
+        if (!columnDone)
+        {
+            break;
+        }
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
-        // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
-        itRemPoint->avRxPowerDbm =
-            WToDbm(rxPsdsAllIt / static_cast<double>(m_numOfIterationsToAverage));
+        // The points skipped by the REM (e.g., at the position of a RTD) stay NaN
+        std::vector<std::vector<float>> values(
+            4,
+            std::vector<float>(m_numY, std::numeric_limits<float>::quiet_NaN()));
+        for (size_t index = begin; index < end; index++)
+        {
+            const RemPoint& remPoint = remPoints[index];
+            values[0][remPoint.yIndex] = static_cast<float>(remPoint.avgSnrDb);
+            values[1][remPoint.yIndex] = static_cast<float>(remPoint.avgSinrDb);
+            values[2][remPoint.yIndex] = static_cast<float>(remPoint.avRxPowerDbm);
+            values[3][remPoint.yIndex] = static_cast<float>(remPoint.avgSirDb);
+        }
+        for (size_t metric = 0; metric < values.size(); metric++)
+        {
+            m_remFile.WriteColumn(m_nextColumn, metric, values[metric]);
+        }
+        written = true;
+    }
+    if (written)
+    {
+        m_remFile.Flush();
+    }
+}
 
-        if (++remPointCounter == remSizeNextReport)
+uint64_t
+NrRadioEnvironmentMapHelper::GetConfigHash() const
+{
+    // Everything that changes the values of the REM points, given their index
+    std::ostringstream oss;
+    oss.precision(17);
+    oss << m_remMode << " " << m_xMin << " " << m_xMax << " " << m_xRes << " " << m_yMin << " "
+        << m_yMax << " " << m_yRes << " " << m_z << " " << m_numOfIterationsToAverage << " "
+        << m_streamBase << " " << m_streamsPerPoint << " " << RngSeedManager::GetSeed() << " "
+        << RngSeedManager::GetRun() << " " << m_rem.size() << " " << m_pathlossOnly;
+    oss << " " << m_propagationLossModelFactory << " " << m_channelConditionModelFactory << " "
+        << m_matrixBasedChannelModelFactory << " " << m_rrdPhy->GetNoiseFigure();
+    for (BuildingList::Iterator it = BuildingList::Begin(); it != BuildingList::End(); ++it)
+    {
+        oss << " " << (*it)->GetBoundaries() << " " << (*it)->GetBuildingType() << " "
+            << (*it)->GetExtWallsType() << " " << +(*it)->GetNFloors() << " "
+            << +(*it)->GetNRoomsX() << " " << +(*it)->GetNRoomsY();
+    }
+    std::list<const RemDevice*> devices{&m_rrd};
+    for (const auto& rtd : m_remDev)
+    {
+        devices.push_back(&rtd);
+    }
+    for (const RemDevice* device : devices)
+    {
+        oss << " " << device->mob->GetPosition() << " " << device->txPower << " "
+            << device->bandwidth << " " << device->frequency << " " << device->numerology << " "
+            << device->antenna->GetNumberOfElements();
+        // The attributes of the array (bearing, downtilt, spacing...) and of its element
+        Ptr<AntennaModel> element = ConstCast<AntennaModel>(device->antenna->GetAntennaElement());
+        oss << " " << ConfigureObjectFactory(device->antenna) << " "
+            << ConfigureObjectFactory(element);
+        PhasedArrayModel::ComplexVector w = device->antenna->GetBeamformingVector();
+        for (size_t i = 0; i < w.GetSize(); i++)
         {
-            PrintProgressReport(&remSizeNextReport);
+            oss << " " << w[i];
         }
+    }
+    return Hash64(oss.str());
+}
 
-        NS_LOG_DEBUG("itRemPoint->avRxPowerDb  in dB: " << itRemPoint->avRxPowerDbm);
+void
+NrRadioEnvironmentMapHelper::ResumeCheckpoint(std::vector<bool>* done)
+{
+    NS_LOG_FUNCTION(this);
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << ".checkpoint";
+    NS_ABORT_MSG_UNLESS(m_checkpointFile.Open(oss.str(), GetConfigHash(), m_rem.size(), 5),
+                        "Can't open file " << oss.str());
+    for (const auto& record : m_checkpointFile.GetResumedRecords())
+    {
+        RemPoint& remPoint = m_rem[record.m_index];
+        remPoint.avgSnrDb = record.m_values[0];
+        remPoint.avgSinrDb = record.m_values[1];
+        remPoint.avRxPowerDbm = record.m_values[2];
+        remPoint.avgSirDb = record.m_values[3];
+        remPoint.bestServer = static_cast<uint32_t>(record.m_values[4]);
+        (*done)[record.m_index] = true;
+    }
+    if (!m_checkpointFile.GetResumedRecords().empty())
+    {
+        std::cout << "\n REM resumed from " << oss.str() << " with "
+                  << m_checkpointFile.GetResumedRecords().size() << " points calculated."
+                  << std::endl;
+    }
+    m_lastCheckpoint = std::chrono::system_clock::now();
+}
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+void
+NrRadioEnvironmentMapHelper::SaveCheckpoint(const RemPoint* remPoints,
+                                            const std::function<bool(size_t)>& isDone,
+                                            std::vector<bool>* saved,
+                                            bool force)
+{
+    if (!m_checkpointPeriod.IsStrictlyPositive())
+    {
+        return;
+    }
+    auto now = std::chrono::system_clock::now();
+    std::chrono::duration<double> elapsed = now - m_lastCheckpoint;
+    if (!force && elapsed.count() < m_checkpointPeriod.GetSeconds())
+    {
+        return;
+    }
+
+    for (size_t index = 0; index < m_rem.size(); index++)
+    {
+        if (!(*saved)[index] && isDone(index))
+        {
+            const RemPoint& remPoint = remPoints[index];
+            m_checkpointFile.Append(index,
+                                    {remPoint.avgSnrDb,
+                                     remPoint.avgSinrDb,
+                                     remPoint.avRxPowerDbm,
+                                     remPoint.avgSirDb,
+                                     static_cast<double>(remPoint.bestServer)});
+            (*saved)[index] = true;
+        }
+    }
+    m_checkpointFile.Save();
+    m_lastCheckpoint = now;
 }
 
 void
@@ -1195,90 +2300,195 @@ NrRadioEnvironmentMapHelper::CalcUeCoverageRemMap()
 {
     NS_LOG_FUNCTION(this);
 
-    uint32_t remSizeNextReport = m_rem.size() / 100;
-    uint32_t remPointCounter = 0;
+    CalcRemPoints(m_scalarCalc ? &NrRadioEnvironmentMapHelper::CalcScalarUeCoverageRemPoint
+                               : &NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint,
+                  m_numOfIterationsToAverage * m_remDev.size() * m_remDev.size());
 
-    for (std::list<RemPoint>::iterator itRemPoint = m_rem.begin(); itRemPoint != m_rem.end();
-         ++itRemPoint)
-    {
-        // perform calculation m_numOfIterationsToAverage times and get the average value
-        double sumSnr = 0.0;
-        double sumSinr = 0.0;
-        m_rrd.mob->SetPosition(itRemPoint->pos);
+    auto remEndTime = std::chrono::system_clock::now();
+    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
+    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
+                << remElapsedSeconds.count() / 60 << " minutes.");
+}
 
-        for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+void
+NrRadioEnvironmentMapHelper::CalcUeCoverageRemPoint(RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    // the useful signal at each RTD, summed over the iterations (linear)
+    std::vector<double> serverPowers(m_remDev.size(), 0.0);
+    m_rrd.mob->SetPosition(remPoint.pos);
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
+        std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+
+        //"Associate" UE (RemPoint) with this RTD
+        size_t associatedIndex = 0;
+        for (std::list<RemDevice>::iterator itRtdAssociated = m_remDev.begin();
+             itRtdAssociated != m_remDev.end();
+             ++itRtdAssociated, ++associatedIndex)
         {
-            std::list<double> sinrsPerBeam; // vector in which we will save sinr per each RRD beam
-            std::list<double> snrsPerBeam;  // vector in which we will save snr per each RRD beam
+            // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
+            ConfigureDirectPathBfv(m_rrd, *itRtdAssociated, m_rrd.antenna);
+            // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
+            ConfigureDirectPathBfv(*itRtdAssociated, m_rrd, itRtdAssociated->antenna);
 
-            //"Associate" UE (RemPoint) with this RTD
-            for (std::list<RemDevice>::iterator itRtdAssociated = m_remDev.begin();
-                 itRtdAssociated != m_remDev.end();
-                 ++itRtdAssociated)
+            std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
+            Ptr<SpectrumValue> usefulSignalRxPsd;
+
+            for (std::list<RemDevice>::iterator itRtdInterferer = m_remDev.begin();
+                 itRtdInterferer != m_remDev.end();
+                 ++itRtdInterferer)
             {
-                // configure RRD (RemPoint) beam toward RTD (itRtdAssociated)
-                ConfigureDirectPathBfv(m_rrd, *itRtdAssociated, m_rrd.antenna);
-                // configure RTD (itRtdAssociated) beam toward RRD (RemPoint)
-                ConfigureDirectPathBfv(*itRtdAssociated, m_rrd, itRtdAssociated->antenna);
+                if (itRtdAssociated->dev->GetNode()->GetId() !=
+                    itRtdInterferer->dev->GetNode()->GetId())
+                {
+                    // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
+                    ConfigureDirectPathBfv(*itRtdInterferer,
+                                           *itRtdAssociated,
+                                           itRtdInterferer->antenna);
 
-                std::list<Ptr<SpectrumValue>> interferenceSignalsRxPsds;
-                Ptr<SpectrumValue> usefulSignalRxPsd;
+                    // calculate received power (interference) from the current RTD device
+                    Ptr<SpectrumValue> receivedPower =
+                        CalcRxPsdValue(*itRtdInterferer, *itRtdAssociated);
 
-                for (std::list<RemDevice>::iterator itRtdInterferer = m_remDev.begin();
-                     itRtdInterferer != m_remDev.end();
-                     ++itRtdInterferer)
+                    interferenceSignalsRxPsds.push_back(receivedPower); // interference
+                }
+                else
                 {
-                    if (itRtdAssociated->dev->GetNode()->GetId() !=
-                        itRtdInterferer->dev->GetNode()->GetId())
+                    // calculate received power (useful Signal) from the current RRD device
+                    Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, *itRtdAssociated);
+                    if (usefulSignalRxPsd != nullptr)
                     {
-                        // configure RTD (itRtdInterferer) beam toward RTD (itRtdAssociated)
-                        ConfigureDirectPathBfv(*itRtdInterferer,
-                                               *itRtdAssociated,
-                                               itRtdInterferer->antenna);
+                        NS_FATAL_ERROR("Already assigned usefulSignal!");
+                    }
+                    usefulSignalRxPsd = receivedPower;
+                }
 
-                        // calculate received power (interference) from the current RTD device
-                        Ptr<SpectrumValue> receivedPower =
-                            CalcRxPsdValue(*itRtdInterferer, *itRtdAssociated);
+            } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
 
-                        interferenceSignalsRxPsds.push_back(receivedPower); // interference
-                    }
-                    else
-                    {
-                        // calculate received power (useful Signal) from the current RRD device
-                        Ptr<SpectrumValue> receivedPower = CalcRxPsdValue(m_rrd, *itRtdAssociated);
-                        if (usefulSignalRxPsd != nullptr)
-                        {
-                            NS_FATAL_ERROR("Already assigned usefulSignal!");
-                        }
-                        usefulSignalRxPsd = receivedPower;
-                    }
+            serverPowers[associatedIndex] += Integral(*usefulSignalRxPsd);
+            sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
+            snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
 
-                } // end for std::list<RemDev>::iterator itRtdInterferer (RTD)
+        } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
 
-                sinrsPerBeam.push_back(CalculateSinr(usefulSignalRxPsd, interferenceSignalsRxPsds));
-                snrsPerBeam.push_back(CalculateSnr(usefulSignalRxPsd));
+        sumSnr += GetMaxValue(snrsPerBeam);
+        sumSinr += GetMaxValue(sinrsPerBeam);
 
-            } // end for std::list<RemDev>::iterator itRtdAssociated (RTD)
+    } // end for m_numOfIterationsToAverage  (Average)
 
-            sumSnr += GetMaxValue(snrsPerBeam);
-            sumSinr += GetMaxValue(sinrsPerBeam);
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.bestServer = static_cast<uint32_t>(
+        std::max_element(serverPowers.begin(), serverPowers.end()) - serverPowers.begin());
+}
 
-        } // end for m_numOfIterationsToAverage  (Average)
+void
+NrRadioEnvironmentMapHelper::CalcScalarRemPoint(RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    double sumSir = 0.0;
+    double sumRxPower = 0.0;
+    m_rrd.mob->SetPosition(remPoint.pos);
+
+    if (m_remMode == BEAM_SHAPE)
+    {
+        Ptr<MobilityBuildingInfo> buildingInfo = m_rrd.mob->GetObject<MobilityBuildingInfo>();
+        NS_ASSERT_MSG(buildingInfo, "buildingInfo is null");
+        buildingInfo->MakeConsistent(m_rrd.mob);
+    }
 
-        itRemPoint->avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
-        itRemPoint->avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    // the received power from each RTD, in the order of m_remDev, in this
+    // iteration and summed over the iterations (linear)
+    std::vector<double> rxPowers(m_remDev.size());
+    std::vector<double> serverPowers(m_remDev.size(), 0.0);
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        size_t rtdIndex = 0;
+        for (const auto& rtd : m_remDev)
+        {
+            rxPowers[rtdIndex++] = CalcRxPower(rtd, m_rrd);
+        }
 
-        if (++remPointCounter == remSizeNextReport)
+        sumSnr += CalculateMaxSnr(rxPowers);
+        sumSinr += CalculateMaxSinr(rxPowers);
+        if (m_remMode == BEAM_SHAPE)
         {
-            PrintProgressReport(&remSizeNextReport);
+            sumSir += CalculateMaxSir(rxPowers);
         }
+        sumRxPower += std::accumulate(rxPowers.begin(), rxPowers.end(), 0.0);
+        std::transform(rxPowers.begin(),
+                       rxPowers.end(),
+                       serverPowers.begin(),
+                       serverPowers.begin(),
+                       std::plus<double>());
+    }
 
-    } // end for std::list<RemPoint>::iterator  (RemPoints)
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    if (m_remMode == BEAM_SHAPE)
+    {
+        remPoint.avgSirDb = sumSir / static_cast<double>(m_numOfIterationsToAverage);
+    }
+    // do the average (for the rxPowers in each RemPoint) in linear and then convert to dBm
+    remPoint.avRxPowerDbm = WToDbm(sumRxPower / static_cast<double>(m_numOfIterationsToAverage));
+    remPoint.bestServer = static_cast<uint32_t>(
+        std::max_element(serverPowers.begin(), serverPowers.end()) - serverPowers.begin());
+}
 
-    auto remEndTime = std::chrono::system_clock::now();
-    std::chrono::duration<double> remElapsedSeconds = remEndTime - m_remStartTime;
-    NS_LOG_INFO("REM map created. Total time needed to create the REM map:"
-                << remElapsedSeconds.count() / 60 << " minutes.");
+void
+NrRadioEnvironmentMapHelper::CalcScalarUeCoverageRemPoint(RemPoint& remPoint)
+{
+    // perform calculation m_numOfIterationsToAverage times and get the average value
+    double sumSnr = 0.0;
+    double sumSinr = 0.0;
+    // the useful signal at each RTD, summed over the iterations (linear)
+    std::vector<double> serverPowers(m_remDev.size(), 0.0);
+    m_rrd.mob->SetPosition(remPoint.pos);
+
+    for (uint16_t i = 0; i < m_numOfIterationsToAverage; i++)
+    {
+        double maxSnr = 0.0;
+        double maxSinr = 0.0;
+
+        //"Associate" UE (RemPoint) with this RTD. The links are calculated in the
+        // order of CalcUeCoverageRemPoint, so that they get the same streams
+        size_t associatedIndex = 0;
+        for (const auto& rtdAssociated : m_remDev)
+        {
+            double usefulSignal = 0.0;
+            double interference = 0.0;
+            for (const auto& rtdInterferer : m_remDev)
+            {
+                if (rtdAssociated.dev->GetNode()->GetId() != rtdInterferer.dev->GetNode()->GetId())
+                {
+                    interference += CalcRxPower(rtdInterferer, rtdAssociated);
+                }
+                else
+                {
+                    usefulSignal = CalcRxPower(m_rrd, rtdAssociated);
+                }
+            }
+
+            serverPowers[associatedIndex++] += usefulSignal;
+            maxSnr = std::max(maxSnr, usefulSignal / m_noisePower);
+            maxSinr = std::max(maxSinr, usefulSignal / (interference + m_noisePower));
+        }
+
+        sumSnr += RatioToDb(maxSnr);
+        sumSinr += RatioToDb(maxSinr);
+    }
+
+    remPoint.avgSnrDb = sumSnr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.avgSinrDb = sumSinr / static_cast<double>(m_numOfIterationsToAverage);
+    remPoint.bestServer = static_cast<uint32_t>(
+        std::max_element(serverPowers.begin(), serverPowers.end()) - serverPowers.begin());
 }
 
 NrRadioEnvironmentMapHelper::PropagationModels
@@ -1286,31 +2496,53 @@ NrRadioEnvironmentMapHelper::CreateTemporalPropagationModels() const
 {
     NS_LOG_FUNCTION(this);
 
+    // The channel condition, propagation loss and channel models cache their
+    // state per pair of nodes, and the REM nodes are always the same: these
+    // models are created for each calculation, from the factories configured
+    // at the installation of the REM
     PropagationModels propModels;
     // create rem copy of channel condition
     Ptr<ChannelConditionModel> condModelCopy =
         m_channelConditionModelFactory.Create<ChannelConditionModel>();
 
     // create rem copy of propagation model
-    ObjectFactory propLossModelFactory = ConfigureObjectFactory(m_propagationLossModel);
     propModels.remPropagationLossModelCopy =
-        propLossModelFactory.Create<ThreeGppPropagationLossModel>();
+        m_propagationLossModelFactory.Create<ThreeGppPropagationLossModel>();
     propModels.remPropagationLossModelCopy->SetChannelConditionModel(condModelCopy);
 
-    // create rem copy of spectrum loss model
-    ObjectFactory spectrumLossModelFactory = ConfigureObjectFactory(m_phasedArraySpectrumLossModel);
-    if (spectrumLossModelFactory.IsTypeIdSet())
+    // give a new channel model to the rem copy of spectrum loss model
+    if (m_remSpectrumLossModel)
     {
         Ptr<MatrixBasedChannelModel> channelModelCopy =
             m_matrixBasedChannelModelFactory.Create<MatrixBasedChannelModel>();
         channelModelCopy->SetAttribute("ChannelConditionModel", PointerValue(condModelCopy));
-        spectrumLossModelFactory.Set("ChannelModel", PointerValue(channelModelCopy));
-        propModels.remSpectrumLossModelCopy =
-            spectrumLossModelFactory.Create<ThreeGppSpectrumPropagationLossModel>();
+        m_remSpectrumLossModel->SetAttribute("ChannelModel", PointerValue(channelModelCopy));
+        propModels.remSpectrumLossModelCopy = m_remSpectrumLossModel;
+        propModels.remChannelModelCopy = channelModelCopy;
     }
     return propModels;
 }
 
+int64_t
+NrRadioEnvironmentMapHelper::AssignStreams(const PropagationModels& propModels,
+                                           int64_t stream) const
+{
+    int64_t currentStream = stream;
+    currentStream += propModels.remPropagationLossModelCopy->AssignStreams(currentStream);
+    Ptr<ChannelConditionModel> condModel =
+        propModels.remPropagationLossModelCopy->GetChannelConditionModel();
+    if (condModel)
+    {
+        currentStream += condModel->AssignStreams(currentStream);
+    }
+    if (propModels.remSpectrumLossModelCopy)
+    {
+        currentStream += propModels.remSpectrumLossModelCopy->AssignStreams(currentStream);
+        currentStream += propModels.remChannelModelCopy->AssignStreams(currentStream);
+    }
+    return currentStream - stream;
+}
+
 void
 NrRadioEnvironmentMapHelper::PrintGnuplottableGnbListToFile(const std::string& filename)
 {
@@ -1404,7 +2636,7 @@ NrRadioEnvironmentMapHelper::PrintRemToFile()
         return;
     }
 
-    for (std::list<RemPoint>::iterator it = m_rem.begin(); it != m_rem.end(); ++it)
+    for (std::vector<RemPoint>::iterator it = m_rem.begin(); it != m_rem.end(); ++it)
     {
         outFile << it->pos.x << "\t" << it->pos.y << "\t" << it->pos.z << "\t" << it->avgSnrDb
                 << "\t" << it->avgSinrDb << "\t" << it->avRxPowerDbm << "\t" << it->avgSirDb << "\t"
@@ -1413,16 +2645,155 @@ NrRadioEnvironmentMapHelper::PrintRemToFile()
 
     outFile.close();
 
-    CreateCustomGnuplotFile();
+    CreateCustomGnuplotFile(m_simTag, m_xMin, m_xMax, m_yMin, m_yMax);
     Finalize();
 }
 
 void
-NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
+NrRadioEnvironmentMapHelper::PrintRemSamplesToFile(const std::vector<bool>& done)
+{
+    NS_LOG_FUNCTION(this);
+
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << "-samples.out";
+
+    std::ofstream outFile;
+    std::string outputFile = oss.str();
+    outFile.open(outputFile.c_str());
+
+    if (!outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << (outputFile));
+        return;
+    }
+
+    for (size_t index = 0; index < m_rem.size(); index++)
+    {
+        if (!done[index])
+        {
+            continue;
+        }
+        const RemPoint& remPoint = m_rem[index];
+        outFile << remPoint.pos.x << "\t" << remPoint.pos.y << "\t" << remPoint.pos.z << "\t"
+                << remPoint.avgSnrDb << "\t" << remPoint.avgSinrDb << "\t" << remPoint.avRxPowerDbm
+                << "\t" << remPoint.avgSirDb << "\t" << std::endl;
+    }
+
+    outFile.close();
+}
+
+void
+NrRadioEnvironmentMapHelper::PrintRemStatisticsToFile()
 {
     NS_LOG_FUNCTION(this);
+
+    // The statistics are computed from the values of the REM points, which are
+    // all in memory at the end of the REM (also when they were calculated by
+    // workers, resumed from a checkpoint or interpolated), so that the maps
+    // written to the disk never have to be read again
+    NrRemStatistics stats;
+    stats.SetBinWidth(m_statisticsBinWidth);
+    std::vector<double> coverageThresholds = ParseThresholds(m_coverageThresholds);
+    std::vector<std::pair<size_t, double RemPoint::*>> metrics;
+    metrics.emplace_back(stats.AddMetric("SNR", coverageThresholds), &RemPoint::avgSnrDb);
+    metrics.emplace_back(stats.AddMetric("SINR", coverageThresholds), &RemPoint::avgSinrDb);
+    if (m_remMode != UE_COVERAGE)
+    {
+        metrics.emplace_back(stats.AddMetric("RxPower", ParseThresholds(m_rxPowerThresholds)),
+                             &RemPoint::avRxPowerDbm);
+    }
+    if (m_remMode == BEAM_SHAPE)
+    {
+        metrics.emplace_back(stats.AddMetric("SIR", coverageThresholds), &RemPoint::avgSirDb);
+    }
+
+    for (const auto& remPoint : m_rem)
+    {
+        for (const auto& metric : metrics)
+        {
+            stats.AddValue(metric.first, remPoint.*metric.second);
+        }
+        stats.AddBestServer(remPoint.bestServer);
+    }
+
+    std::ostringstream oss;
+    oss << "nr-rem-" << m_simTag.c_str() << "-summary.txt";
+    std::ofstream outFile(oss.str().c_str());
+    if (!outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << oss.str());
+        return;
+    }
+    // The RTDs, by the index of the "server" lines
+    size_t rtdIndex = 0;
+    for (const auto& rtd : m_remDev)
+    {
+        outFile << "# RTD " << rtdIndex++ << ": node " << rtd.nodeId << " at "
+                << rtd.mob->GetPosition() << "\n";
+    }
+    stats.Print(outFile);
+    outFile.close();
+
+    if (m_outputFormat == NO_OUTPUT)
+    {
+        return;
+    }
+
+    // The best-server map, with the id of the node of the best RTD of each point
+    std::vector<uint32_t> nodeIds;
+    for (const auto& rtd : m_remDev)
+    {
+        nodeIds.push_back(rtd.nodeId);
+    }
+    std::ostringstream ossMap;
+    ossMap << "nr-rem-" << m_simTag.c_str() << "-best-server.out";
+    outFile.open(ossMap.str().c_str());
+    if (!outFile.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << ossMap.str());
+        return;
+    }
+    for (const auto& remPoint : m_rem)
+    {
+        outFile << remPoint.pos.x << "\t" << remPoint.pos.y << "\t" << remPoint.pos.z << "\t"
+                << nodeIds.at(remPoint.bestServer) << "\n";
+    }
+    outFile.close();
+}
+
+std::vector<double>
+NrRadioEnvironmentMapHelper::ParseThresholds(const std::string& thresholds)
+{
+    std::vector<double> values;
+    std::stringstream ss(thresholds);
+    std::string token;
+    while (std::getline(ss, token, '|'))
+    {
+        if (token.empty())
+        {
+            continue;
+        }
+        char* end = nullptr;
+        double value = std::strtod(token.c_str(), &end);
+        if (end == token.c_str() || *end != '\0')
+        {
+            NS_FATAL_ERROR("Threshold " << token << " not valid in " << thresholds);
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+void
+NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile(const std::string& simTag,
+                                                     double xMin,
+                                                     double xMax,
+                                                     double yMin,
+                                                     double yMax)
+{
+    NS_LOG_FUNCTION(simTag << xMin << xMax << yMin << yMax);
     std::ostringstream oss;
-    oss << "nr-rem-" << m_simTag.c_str() << "-plot-rem.gnuplot";
+    oss << "nr-rem-" << simTag.c_str() << "-plot-rem.gnuplot";
     std::string filename = oss.str();
 
     std::ofstream outFile;
@@ -1439,18 +2810,18 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set cblabel offset 3" << std::endl;
     outFile << "unset key" << std::endl;
     outFile << "set terminal png" << std::endl;
-    outFile << "set output \"nr-rem-" << m_simTag << "-snr.png\"" << std::endl;
+    outFile << "set output \"nr-rem-" << simTag << "-snr.png\"" << std::endl;
     outFile << "set size ratio -1" << std::endl;
     outFile << "set cbrange [-5:30]" << std::endl;
-    outFile << "set xrange [" << m_xMin << ":" << m_xMax << "]" << std::endl;
-    outFile << "set yrange [" << m_yMin << ":" << m_yMax << "]" << std::endl;
+    outFile << "set xrange [" << xMin << ":" << xMax << "]" << std::endl;
+    outFile << "set yrange [" << yMin << ":" << yMax << "]" << std::endl;
     outFile << "set xtics font \"Helvetica,17\"" << std::endl;
     outFile << "set ytics font \"Helvetica,17\"" << std::endl;
     outFile << "set cbtics font \"Helvetica,17\"" << std::endl;
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($4) with image"
+    outFile << "plot \"nr-rem-" << simTag << ".out\" using ($1):($2):($4) with image"
             << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
@@ -1459,18 +2830,18 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set cblabel offset 3" << std::endl;
     outFile << "unset key" << std::endl;
     outFile << "set terminal png" << std::endl;
-    outFile << "set output \"nr-rem-" << m_simTag << "-sinr.png\"" << std::endl;
+    outFile << "set output \"nr-rem-" << simTag << "-sinr.png\"" << std::endl;
     outFile << "set size ratio -1" << std::endl;
     outFile << "set cbrange [-5:30]" << std::endl;
-    outFile << "set xrange [" << m_xMin << ":" << m_xMax << "]" << std::endl;
-    outFile << "set yrange [" << m_yMin << ":" << m_yMax << "]" << std::endl;
+    outFile << "set xrange [" << xMin << ":" << xMax << "]" << std::endl;
+    outFile << "set yrange [" << yMin << ":" << yMax << "]" << std::endl;
     outFile << "set xtics font \"Helvetica,17\"" << std::endl;
     outFile << "set ytics font \"Helvetica,17\"" << std::endl;
     outFile << "set cbtics font \"Helvetica,17\"" << std::endl;
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($5) with image"
+    outFile << "plot \"nr-rem-" << simTag << ".out\" using ($1):($2):($5) with image"
             << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
@@ -1479,18 +2850,18 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set cblabel offset 3" << std::endl;
     outFile << "unset key" << std::endl;
     outFile << "set terminal png" << std::endl;
-    outFile << "set output \"nr-rem-" << m_simTag << "-ipsd.png\"" << std::endl;
+    outFile << "set output \"nr-rem-" << simTag << "-ipsd.png\"" << std::endl;
     outFile << "set size ratio -1" << std::endl;
     outFile << "set cbrange [-100:-20]" << std::endl;
-    outFile << "set xrange [" << m_xMin << ":" << m_xMax << "]" << std::endl;
-    outFile << "set yrange [" << m_yMin << ":" << m_yMax << "]" << std::endl;
+    outFile << "set xrange [" << xMin << ":" << xMax << "]" << std::endl;
+    outFile << "set yrange [" << yMin << ":" << yMax << "]" << std::endl;
     outFile << "set xtics font \"Helvetica,17\"" << std::endl;
     outFile << "set ytics font \"Helvetica,17\"" << std::endl;
     outFile << "set cbtics font \"Helvetica,17\"" << std::endl;
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($6) with image"
+    outFile << "plot \"nr-rem-" << simTag << ".out\" using ($1):($2):($6) with image"
             << std::endl;
 
     outFile << "set xlabel \"x-coordinate (m)\"" << std::endl;
@@ -1499,18 +2870,18 @@ NrRadioEnvironmentMapHelper::CreateCustomGnuplotFile()
     outFile << "set cblabel offset 3" << std::endl;
     outFile << "unset key" << std::endl;
     outFile << "set terminal png" << std::endl;
-    outFile << "set output \"nr-rem-" << m_simTag << "-sir.png\"" << std::endl;
+    outFile << "set output \"nr-rem-" << simTag << "-sir.png\"" << std::endl;
     outFile << "set size ratio -1" << std::endl;
     outFile << "set cbrange [-5:30]" << std::endl;
-    outFile << "set xrange [" << m_xMin << ":" << m_xMax << "]" << std::endl;
-    outFile << "set yrange [" << m_yMin << ":" << m_yMax << "]" << std::endl;
+    outFile << "set xrange [" << xMin << ":" << xMax << "]" << std::endl;
+    outFile << "set yrange [" << yMin << ":" << yMax << "]" << std::endl;
     outFile << "set xtics font \"Helvetica,17\"" << std::endl;
     outFile << "set ytics font \"Helvetica,17\"" << std::endl;
     outFile << "set cbtics font \"Helvetica,17\"" << std::endl;
     outFile << "set xlabel font \"Helvetica,17\"" << std::endl;
     outFile << "set ylabel font \"Helvetica,17\"" << std::endl;
     outFile << "set cblabel font \"Helvetica,17\"" << std::endl;
-    outFile << "plot \"nr-rem-" << m_simTag << ".out\" using ($1):($2):($7) with image"
+    outFile << "plot \"nr-rem-" << simTag << ".out\" using ($1):($2):($7) with image"
             << std::endl;
 
     outFile.close();
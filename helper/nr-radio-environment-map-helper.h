@@ -7,6 +7,9 @@
 #ifndef NR_RADIO_ENVIRONMENT_MAP_HELPER_H
 #define NR_RADIO_ENVIRONMENT_MAP_HELPER_H
 
+#include "nr-rem-binary-file.h"
+#include "nr-rem-checkpoint-file.h"
+
 #include "ns3/net-device-container.h"
 #include "ns3/nr-gnb-phy.h"
 #include "ns3/nr-ue-phy.h"
@@ -19,6 +22,8 @@
 
 #include <chrono>
 #include <fstream>
+#include <functional>
+#include <vector>
 
 namespace ns3
 {
@@ -100,6 +105,16 @@ class NrRadioEnvironmentMapHelper : public Object
         UE_COVERAGE
     };
 
+    /**
+     * \brief Format of the file with the values of the REM points
+     */
+    enum RemOutputFormat
+    {
+        TEXT_OUTPUT,   //!< nr-rem-SimTag.out and its gnuplot script, written at the end
+        BINARY_OUTPUT, //!< nr-rem-SimTag.bin (see NrRemBinaryFile), written column by column
+        NO_OUTPUT      //!< No map, only the summary of the statistics
+    };
+
     /**
      * \brief NrRadioEnvironmentMapHelper constructor
      */
@@ -125,6 +140,56 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void SetRemMode(enum RemMode remType);
 
+    /**
+     * \brief Set the format of the file with the values of the REM points
+     * \param outputFormat the format (text, binary or none)
+     */
+    void SetOutputFormat(enum RemOutputFormat outputFormat);
+
+    /**
+     * \brief Set the levels of the adaptive sampling of the map
+     * \param adaptiveLevels the number of levels (0 calculates every point of the grid)
+     */
+    void SetAdaptiveLevels(uint32_t adaptiveLevels);
+
+    /**
+     * \brief Set the max difference among the corners of a uniform cell of the
+     * adaptive sampling
+     * \param adaptiveThreshold the max difference of the SINR and of the RX power (dB)
+     */
+    void SetAdaptiveThreshold(double adaptiveThreshold);
+
+    /**
+     * \brief Set the wall-clock time between two checkpoints of the REM
+     * \param checkpointPeriod the time between two checkpoints (0 disables them)
+     */
+    void SetCheckpointPeriod(const Time& checkpointPeriod);
+
+    /**
+     * \brief Set whether the statistics of the REM points are written
+     * \param statistics true to write the summary of the statistics and the
+     * best-server map
+     */
+    void SetStatistics(bool statistics);
+
+    /**
+     * \brief Set the width of the bins of the histograms of the statistics
+     * \param binWidth the width of the bins (dB)
+     */
+    void SetStatisticsBinWidth(double binWidth);
+
+    /**
+     * \brief Set the thresholds of the coverage of the SNR, SINR and SIR
+     * \param thresholds the thresholds (dB), separated by '|'
+     */
+    void SetCoverageThresholds(const std::string& thresholds);
+
+    /**
+     * \brief Set the thresholds of the coverage of the RX power
+     * \param thresholds the thresholds (dBm), separated by '|'
+     */
+    void SetRxPowerThresholds(const std::string& thresholds);
+
     /**
      * \brief Set simTag that will be contatenated to
      * output file names
@@ -186,12 +251,87 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void SetInstallationDelay(const Time& installationDelay);
 
+    /**
+     * \brief Sets the number of workers that calculate the REM points in parallel
+     * \param numWorkers The number of workers (0 means one for each hardware thread)
+     */
+    void SetNumWorkers(uint32_t numWorkers);
+
+    /**
+     * \return Gets the number of workers that calculate the REM points
+     */
+    uint32_t GetNumWorkers() const;
+
+    /**
+     * \brief Sets the first random stream of the propagation models of the REM
+     * \param streamBase The first stream, above the streams of the simulation
+     */
+    void SetStreamBase(int64_t streamBase);
+
+    /**
+     * \return Gets the first random stream of the propagation models of the REM
+     */
+    int64_t GetStreamBase() const;
+
+    /**
+     * \brief Sets whether the REM points are calculated only with the path loss
+     * \param pathlossOnly true to ignore the antenna gains and the fast fading
+     */
+    void SetPathlossOnly(bool pathlossOnly);
+
+    /**
+     * \return Gets whether the REM points are calculated only with the path loss
+     */
+    bool GetPathlossOnly() const;
+
     /**
      * \brief Get the type of REM Map to be generated
      * \return The type of the map (BeamShape/CoverageArea/UeCoverage)
      */
     RemMode GetRemMode() const;
 
+    /**
+     * \brief Get the format of the file with the values of the REM points
+     * \return The format (text or binary)
+     */
+    RemOutputFormat GetOutputFormat() const;
+
+    /**
+     * \return Gets the levels of the adaptive sampling of the map
+     */
+    uint32_t GetAdaptiveLevels() const;
+
+    /**
+     * \return Gets the max difference (dB) among the corners of a uniform cell
+     */
+    double GetAdaptiveThreshold() const;
+
+    /**
+     * \brief Get the wall-clock time between two checkpoints of the REM
+     * \return The time between two checkpoints (0 if they are disabled)
+     */
+    Time GetCheckpointPeriod() const;
+
+    /**
+     * \return Gets whether the statistics of the REM points are written
+     */
+    bool GetStatistics() const;
+
+    /**
+     * \return Gets the width of the bins of the histograms of the statistics (dB)
+     */
+    double GetStatisticsBinWidth() const;
+
+    /**
+     * \return Gets the thresholds of the coverage of the SNR, SINR and SIR
+     */
+    std::string GetCoverageThresholds() const;
+
+    /**
+     * \return Gets the thresholds of the coverage of the RX power
+     */
+    std::string GetRxPowerThresholds() const;
+
     /**
      * \return Gets the value of the min x coordinate of the map
      */
@@ -271,6 +411,21 @@ class NrRadioEnvironmentMapHelper : public Object
                    const Ptr<NetDevice>& rrdDevice,
                    uint8_t bwpId);
 
+    /**
+     * \brief Creates the nr-rem-${SimTag}-plot-rem.gnuplot file, that plots the
+     * maps of nr-rem-${SimTag}.out
+     * \param simTag the simulation tag of the files
+     * \param xMin the min x coordinate of the map
+     * \param xMax the max x coordinate of the map
+     * \param yMin the min y coordinate of the map
+     * \param yMax the max y coordinate of the map
+     */
+    static void CreateCustomGnuplotFile(const std::string& simTag,
+                                        double xMin,
+                                        double xMax,
+                                        double yMin,
+                                        double yMax);
+
   private:
     /**
      * \brief This struct includes the coordinates of each Rem Point
@@ -283,6 +438,9 @@ class NrRadioEnvironmentMapHelper : public Object
         double avgSinrDb{0};
         double avgSirDb{0};
         double avRxPowerDbm{0};
+        uint32_t xIndex{0};     //!< Index of the column of the grid
+        uint32_t yIndex{0};     //!< Index of the row of the grid
+        uint32_t bestServer{0}; //!< Index in m_remDev of the RTD with the strongest signal
     };
 
     /**
@@ -296,10 +454,14 @@ class NrRadioEnvironmentMapHelper : public Object
         Ptr<MobilityModel> mob;
         Ptr<UniformPlanarArray> antenna;
         double txPower{0};
+        double txPowerW{0}; //!< Integral of the TX PSD, used by the scalar calculation
+        uint32_t nodeId{0}; //!< Id of the node of the RTD in the simulation
         double bandwidth{0};
         double frequency{0};
         uint16_t numerology{0};
         Ptr<const SpectrumModel> spectrumModel{};
+        //! TX PSD of the device, converted to the spectrum model (UID) of each receiver
+        std::map<SpectrumModelUid_t, Ptr<const SpectrumValue>> txPsds;
 
         RemDevice()
         {
@@ -323,8 +485,38 @@ class NrRadioEnvironmentMapHelper : public Object
     {
         Ptr<ThreeGppPropagationLossModel> remPropagationLossModelCopy;
         Ptr<ThreeGppSpectrumPropagationLossModel> remSpectrumLossModelCopy;
+        Ptr<MatrixBasedChannelModel> remChannelModelCopy; //!< Channel model of the calculation
+    };
+
+    /**
+     * \brief The channel between a transmitting and a receiving REM device:
+     * the propagation models, with their channel condition and channel matrix,
+     * and the TX PSD with the pathloss. The same link can be applied to
+     * several beams of the two devices.
+     */
+    struct RemLink
+    {
+        PropagationModels propModels;                 //!< The models of the link
+        Ptr<const SpectrumSignalParameters> rxParams; //!< The TX PSD with the pathloss
+    };
+
+    /**
+     * \brief A cell of the adaptive sampling, with the indexes of the columns
+     * and of the rows of its corners in the grid
+     */
+    struct RemCell
+    {
+        uint32_t x0{0}; //!< Column of the left corners
+        uint32_t x1{0}; //!< Column of the right corners
+        uint32_t y0{0}; //!< Row of the bottom corners
+        uint32_t y1{0}; //!< Row of the top corners
     };
 
+    /**
+     * \brief Function that calculates the values of a REM point
+     */
+    using RemPointFunction = void (NrRadioEnvironmentMapHelper::*)(RemPoint& remPoint);
+
     /**
      * \brief This method creates the list of Rem Points (coordinates) based on
      * the min/max coprdinates and the resolution defined by the user
@@ -384,11 +576,208 @@ class NrRadioEnvironmentMapHelper : public Object
     void CalcUeCoverageRemMap();
 
     /**
-     * \brief This method calculates the PSD
+     * \brief Calculates the values of a REM point of a BeamShape map
+     * \param remPoint the REM point
+     */
+    void CalcBeamShapeRemPoint(RemPoint& remPoint);
+
+    /**
+     * \brief Calculates the values of a REM point of a CoverageArea map
+     * \param remPoint the REM point
+     */
+    void CalcCoverageAreaRemPoint(RemPoint& remPoint);
+
+    /**
+     * \brief Calculates the values of a REM point of a UeCoverage map
+     * \param remPoint the REM point
+     */
+    void CalcUeCoverageRemPoint(RemPoint& remPoint);
+
+    /**
+     * \brief Calculates the values of a REM point of a BeamShape or of a
+     * CoverageArea map with the scalar calculation. Without the antenna gains,
+     * the beams of the devices do not change the received powers, and both maps
+     * take the best RTD as the useful signal.
+     * \param remPoint the REM point
+     */
+    void CalcScalarRemPoint(RemPoint& remPoint);
+
+    /**
+     * \brief Calculates the values of a REM point of a UeCoverage map with the
+     * scalar calculation
+     * \param remPoint the REM point
+     */
+    void CalcScalarUeCoverageRemPoint(RemPoint& remPoint);
+
+    /**
+     * \brief Decides whether the REM points are calculated with the scalar
+     * calculation, and prepares the powers it uses. The scalar calculation is
+     * used when only the path loss is applied (PathlossOnly, or no spectrum
+     * propagation loss model) and every RTD has the spectrum model of the RRD.
+     */
+    void ConfigureScalarCalculation();
+
+    /**
+     * \brief Calculates the values of every REM point, sequentially or with
+     * NumWorkers workers, and reports the progress
+     * \param calcRemPoint the function that calculates a REM point
+     * \param callsPerPoint the number of links created for each REM point
+     */
+    void CalcRemPoints(RemPointFunction calcRemPoint, uint64_t callsPerPoint);
+
+    /**
+     * \brief Calculates the values of a list of REM points, sequentially or
+     * with several workers, skipping the points already calculated
+     * \param calcRemPoint the function that calculates a REM point
+     * \param numWorkers the number of workers
+     * \param indices the indexes of the REM points
+     * \param done the REM points already calculated, updated
+     * \param saved the REM points saved in the checkpoint file
+     */
+    void CalcRemPointList(RemPointFunction calcRemPoint,
+                          uint32_t numWorkers,
+                          const std::vector<size_t>& indices,
+                          std::vector<bool>* done,
+                          std::vector<bool>* saved);
+
+    /**
+     * \brief Calculates the REM points of the adaptive sampling: the points of
+     * the coarse grid, and then the corners of the cells split at each level
+     * \param calcRemPoint the function that calculates a REM point
+     * \param numWorkers the number of workers
+     * \param done the REM points already calculated, updated
+     * \param saved the REM points saved in the checkpoint file
+     * \return The uniform cells, whose points have to be interpolated
+     */
+    std::vector<RemCell> CalcAdaptiveRemPoints(RemPointFunction calcRemPoint,
+                                               uint32_t numWorkers,
+                                               std::vector<bool>* done,
+                                               std::vector<bool>* saved);
+
+    /**
+     * \brief Tells if the SINR and the RX power of the corners of a cell differ
+     * at most by AdaptiveThreshold, and no RTD is inside the cell
+     * \param cell the cell, with its corners calculated
+     * \return true if the cell does not need to be split
+     */
+    bool IsUniformCell(const RemCell& cell) const;
+
+    /**
+     * \brief Interpolates the values of the REM points not calculated, from the
+     * corners of the uniform cells that include them
+     * \param uniformCells the uniform cells
+     * \param done the REM points calculated, updated with the interpolated ones
+     */
+    void InterpolateRemPoints(const std::vector<RemCell>& uniformCells, std::vector<bool>* done);
+
+    /**
+     * \brief Calculates the values of a REM point, with the random streams
+     * reserved for that point
+     * \param calcRemPoint the function that calculates a REM point
+     * \param index the index of the REM point
+     */
+    void CalcRemPoint(RemPointFunction calcRemPoint, size_t index);
+
+    /**
+     * \brief Calculates the values of every REM point with several worker
+     * processes, which share the array of the values
+     * \param calcRemPoint the function that calculates a REM point
+     * \param numWorkers the number of workers, including this process
+     * \param indices the indexes of the REM points
+     * \param done the REM points already calculated, updated when they are all done
+     * \param saved the REM points saved in the checkpoint file
+     */
+    void CalcRemPointsInWorkers(RemPointFunction calcRemPoint,
+                                uint32_t numWorkers,
+                                const std::vector<size_t>& indices,
+                                std::vector<bool>* done,
+                                std::vector<bool>* saved);
+
+    /**
+     * \brief Hash of the configuration of the REM (grid, mode, iterations,
+     * seed and run, attributes of the propagation models, buildings, noise
+     * figure, and configuration and antennas of the REM devices), which
+     * identifies the checkpoints that can be resumed
+     * \return The hash of the configuration
+     */
+    uint64_t GetConfigHash() const;
+
+    /**
+     * \brief Opens the checkpoint file, and takes the values of the REM points
+     * saved in it by a previous run with the same configuration
+     * \param done the REM points, set to true for the points resumed
+     */
+    void ResumeCheckpoint(std::vector<bool>* done);
+
+    /**
+     * \brief Saves to the checkpoint file the REM points calculated and not
+     * saved yet, if CheckpointPeriod has elapsed since the last checkpoint
+     * \param remPoints the REM points, in the order of m_rem
+     * \param isDone function that tells if the REM point of an index is calculated
+     * \param saved the REM points saved in the checkpoint file, updated
+     * \param force save even if CheckpointPeriod has not elapsed
+     */
+    void SaveCheckpoint(const RemPoint* remPoints,
+                        const std::function<bool(size_t)>& isDone,
+                        std::vector<bool>* saved,
+                        bool force);
+
+    /**
+     * \brief Writes to the binary file the next columns of the grid whose
+     * points are all calculated, in order
+     * \param remPoints the REM points, in the order of m_rem
+     * \param isDone function that tells if the REM point of an index is calculated
+     */
+    void WriteCompletedColumns(const RemPoint* remPoints,
+                               const std::function<bool(size_t)>& isDone);
+
+    /**
+     * \brief This method calculates the PSD, with a new link between the devices
      * \return The PSD (spectrumValue)
      */
     Ptr<SpectrumValue> CalcRxPsdValue(RemDevice& device, RemDevice& otherDevice) const;
 
+    /**
+     * \brief Creates the link between two devices: new propagation models
+     * (with the random streams of the calculation) and the pathloss
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
+     * \return The link
+     */
+    RemLink CreateRemLink(RemDevice& device, RemDevice& otherDevice) const;
+
+    /**
+     * \brief This method calculates the PSD over an existing link, with the
+     * current beamforming vectors of the devices. The channel matrix of the
+     * link is generated the first time, and reused by the next calls.
+     * \param link the link between the devices
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
+     * \return The PSD (spectrumValue)
+     */
+    Ptr<SpectrumValue> CalcRxPsdValue(const RemLink& link,
+                                      const RemDevice& device,
+                                      const RemDevice& otherDevice) const;
+
+    /**
+     * \brief Returns the TX PSD of a device, in the spectrum model of the
+     * receiver. The PSD is created (and converted, if needed) the first time,
+     * and then taken from the cache of the device.
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
+     * \return The TX PSD in the spectrum model of the receiver
+     */
+    Ptr<const SpectrumValue> GetTxPsd(RemDevice& device, const RemDevice& otherDevice) const;
+
+    /**
+     * \brief Calculates the received power with the path loss only, with the
+     * same models and random streams of a link of CreateRemLink
+     * \param device the transmitting device
+     * \param otherDevice the receiving device
+     * \return The received power (W)
+     */
+    double CalcRxPower(const RemDevice& device, const RemDevice& otherDevice) const;
+
     /**
      * \brief This function calculates the SNR.
      * \param usefulSignal The useful Signal
@@ -428,6 +817,46 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     double CalculateMaxSir(const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
 
+    /**
+     * \brief Scalar version of CalculateMaxSnr, with the received powers of flat
+     * PSDs: the average of the SNR over the RBs is the ratio of the powers
+     * \param rxPowers the received power (W) from each RTD
+     * \return The max snr (dB)
+     */
+    double CalculateMaxSnr(const std::vector<double>& rxPowers) const;
+
+    /**
+     * \brief Scalar version of CalculateMaxSinr, with the received powers of
+     * flat PSDs
+     * \param rxPowers the received power (W) from each RTD
+     * \return The max sinr (dB)
+     */
+    double CalculateMaxSinr(const std::vector<double>& rxPowers) const;
+
+    /**
+     * \brief Scalar version of CalculateMaxSir, with the received powers of
+     * flat PSDs
+     * \param rxPowers the received power (W) from each RTD
+     * \return The max sir (dB)
+     */
+    double CalculateMaxSir(const std::vector<double>& rxPowers) const;
+
+    /**
+     * \brief Calculates the interference of each received signal, i.e., the sum
+     * of the other signals, without subtracting the signal from the sum of all
+     * \param receivedPowerList the received PSD from each RTD
+     * \return the interference PSD of each RTD, in the same order
+     */
+    std::vector<SpectrumValue> CalcInterferences(
+        const std::list<Ptr<SpectrumValue>>& receivedPowerList) const;
+
+    /**
+     * \brief Scalar version of CalcInterferences
+     * \param rxPowers the received power (W) from each RTD
+     * \return the interference (W) of each RTD, in the same order
+     */
+    std::vector<double> CalcInterferences(const std::vector<double>& rxPowers) const;
+
     /**
      * \brief This function calculates the SINR for a given space of frequency-dependent
      * values (such as PSD).
@@ -483,10 +912,19 @@ class NrRadioEnvironmentMapHelper : public Object
     /**
      * \brief This method creates the temporal Propagation Models
      * \return The struct with the temporal propagation models (created for each
-     * rem point)
+     * calculation of the received PSD, except the spectrum loss model, which is
+     * reused with a new channel model)
      */
     PropagationModels CreateTemporalPropagationModels() const;
 
+    /**
+     * \brief Assigns the random streams of the temporal propagation models
+     * \param propModels the temporal propagation models
+     * \param stream the first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(const PropagationModels& propModels, int64_t stream) const;
+
     /**
      * \brief Prints REM generation progress report
      */
@@ -513,10 +951,25 @@ class NrRadioEnvironmentMapHelper : public Object
      */
     void PrintRemToFile();
 
-    /*
-     * Creates rem_plot${SimTag}.gnuplot file
+    /**
+     * \brief Prints the values of the REM points calculated by the adaptive
+     * sampling, before the interpolation of the others
+     * \param done the REM points calculated
+     */
+    void PrintRemSamplesToFile(const std::vector<bool>& done);
+
+    /**
+     * \brief Writes the summary of the statistics of the REM points and, if
+     * the map is written, the best-server map
      */
-    void CreateCustomGnuplotFile();
+    void PrintRemStatisticsToFile();
+
+    /**
+     * \brief Parses a list of thresholds
+     * \param thresholds the thresholds, separated by '|'
+     * \return The thresholds
+     */
+    static std::vector<double> ParseThresholds(const std::string& thresholds);
 
     /**
      * \brief Called when the map generation procedure has been completed.
@@ -540,7 +993,7 @@ class NrRadioEnvironmentMapHelper : public Object
                                 const Ptr<const UniformPlanarArray>& antenna);
 
     std::list<RemDevice> m_remDev; ///< List of REM Transmiting Devices (RTDs).
-    std::list<RemPoint> m_rem;     ///< List of REM points.
+    std::vector<RemPoint> m_rem;   ///< List of REM points.
 
     std::chrono::system_clock::time_point
         m_remStartTime; //!< Time at which REM generation has started
@@ -560,6 +1013,12 @@ class NrRadioEnvironmentMapHelper : public Object
 
     uint16_t m_numOfIterationsToAverage{1};
     Time m_installationDelay{Seconds(0)};
+    uint32_t m_numWorkers{1}; ///< The `NumWorkers` attribute.
+
+    int64_t m_streamBase{int64_t{1} << 32}; ///< The `StreamBase` attribute.
+    int64_t m_streamsPerPoint{0};           ///< Random streams used by each REM point
+    int64_t m_streamsPerLink{0};            ///< Random streams used by each link
+    mutable int64_t m_nextStream{0};        ///< Next random stream of the current REM point
 
     RemDevice m_rrd;
 
@@ -572,11 +1031,43 @@ class NrRadioEnvironmentMapHelper : public Object
     Ptr<PhasedArraySpectrumPropagationLossModel> m_phasedArraySpectrumLossModel;
     ObjectFactory m_channelConditionModelFactory;
     ObjectFactory m_matrixBasedChannelModelFactory;
+    ObjectFactory m_propagationLossModelFactory; ///< Factory of the REM propagation loss models
+    //! REM copy of the spectrum loss model, which gets a new channel model at each calculation
+    Ptr<ThreeGppSpectrumPropagationLossModel> m_remSpectrumLossModel;
 
     Ptr<SpectrumValue> m_noisePsd; // noise figure PSD that will be used for calculations
 
+    bool m_pathlossOnly{false}; ///< The `PathlossOnly` attribute.
+    bool m_scalarCalc{false};   ///< Whether the REM points use the scalar calculation
+    double m_noisePower{0};     ///< Integral of the noise PSD (W), for the scalar calculation
+    double m_remBandwidth{0};   ///< Bandwidth (Hz) of the RRD spectrum model
+
     std::string m_simTag; ///< The `SimTag` attribute.
 
+    RemOutputFormat m_outputFormat{TEXT_OUTPUT}; ///< The `OutputFormat` attribute.
+    uint32_t m_numX{0};                          ///< Number of columns of the grid
+    uint32_t m_numY{0};                          ///< Number of rows of the grid
+    std::vector<size_t> m_columnStart;           ///< Index in m_rem of the first point of columns
+    NrRemBinaryFile m_remFile;                   ///< The binary file, if OutputFormat is binary
+    uint32_t m_nextColumn{0};                    ///< Next column to write to the binary file
+
+    uint32_t m_adaptiveLevels{0};    ///< The `AdaptiveLevels` attribute.
+    double m_adaptiveThreshold{3.0}; ///< The `AdaptiveThreshold` attribute.
+    std::vector<size_t> m_gridToRem; ///< Index in m_rem of each grid point (m_rem.size() if none)
+    uint32_t m_remSizeNextReport{0}; ///< REM points done at the next progress report
+
+    bool m_statistics{false};         ///< The `Statistics` attribute.
+    double m_statisticsBinWidth{0.5}; ///< The `StatisticsBinWidth` attribute.
+    std::string m_coverageThresholds; ///< The `CoverageThresholds` attribute.
+    std::string m_rxPowerThresholds;  ///< The `RxPowerThresholds` attribute.
+
+    Time m_checkpointPeriod{Seconds(0)};  ///< The `CheckpointPeriod` attribute.
+    NrRemCheckpointFile m_checkpointFile; ///< The checkpoint file, if CheckpointPeriod is not 0
+    //! Wall-clock time of the last checkpoint
+    std::chrono::system_clock::time_point m_lastCheckpoint;
+
+    friend class NrRemHelperScalarTestCase;
+
 }; // end of `class NrRadioEnvironmentMapHelper`
 
 } // namespace ns3
@@ -0,0 +1,232 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rem-binary-file.h"
+
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRemBinaryFile");
+
+static const char NR_REM_MAGIC[8] = {'N', 'R', 'R', 'E', 'M', 0, 0, 0}; //!< Magic of the file
+static const uint32_t NR_REM_VERSION = 1; //!< Version of the format
+
+bool
+NrRemBinaryFile::Create(const std::string& filename, const Header& header)
+{
+    NS_LOG_FUNCTION(this << filename << header.m_numX << header.m_numY);
+
+    m_header = header;
+    m_values.clear();
+    m_file.open(filename.c_str(),
+                std::ios_base::in | std::ios_base::out | std::ios_base::binary |
+                    std::ios_base::trunc);
+    if (!m_file.is_open())
+    {
+        NS_LOG_ERROR("Can't open file " << filename);
+        return false;
+    }
+
+    m_file.write(NR_REM_MAGIC, sizeof(NR_REM_MAGIC));
+    m_file.write(reinterpret_cast<const char*>(&NR_REM_VERSION), sizeof(NR_REM_VERSION));
+    for (double value :
+         {header.m_xMin, header.m_yMin, header.m_xStep, header.m_yStep, header.m_z})
+    {
+        m_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    uint32_t numMetrics = static_cast<uint32_t>(header.m_metrics.size());
+    for (uint32_t value : {header.m_numX, header.m_numY, numMetrics})
+    {
+        m_file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+    for (const auto& metric : header.m_metrics)
+    {
+        uint32_t length = static_cast<uint32_t>(metric.size());
+        m_file.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_file.write(metric.data(), length);
+    }
+    m_dataOffset = m_file.tellp();
+
+    // Every value is NaN until its column is written
+    const std::vector<float> column(header.m_numY, std::numeric_limits<float>::quiet_NaN());
+    for (size_t metric = 0; metric < header.m_metrics.size(); metric++)
+    {
+        for (uint32_t xIndex = 0; xIndex < header.m_numX; xIndex++)
+        {
+            m_file.write(reinterpret_cast<const char*>(column.data()),
+                         column.size() * sizeof(float));
+        }
+    }
+    m_file.flush();
+    return m_file.good();
+}
+
+void
+NrRemBinaryFile::WriteColumn(uint32_t xIndex, size_t metric, const std::vector<float>& values)
+{
+    NS_ASSERT_MSG(xIndex < m_header.m_numX && metric < m_header.m_metrics.size(),
+                  "The column is out of the grid");
+    NS_ASSERT_MSG(values.size() == m_header.m_numY, "Wrong number of values for a column");
+    m_file.seekp(GetOffset(metric, xIndex, 0));
+    m_file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(float));
+}
+
+void
+NrRemBinaryFile::Flush()
+{
+    m_file.flush();
+}
+
+void
+NrRemBinaryFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file.is_open())
+    {
+        m_file.close();
+    }
+}
+
+bool
+NrRemBinaryFile::Open(const std::string& filename)
+{
+    NS_LOG_FUNCTION(this << filename);
+
+    m_file.open(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (!m_file.is_open())
+    {
+        NS_LOG_ERROR("Can't open file " << filename);
+        return false;
+    }
+
+    char magic[sizeof(NR_REM_MAGIC)];
+    uint32_t version = 0;
+    m_file.read(magic, sizeof(magic));
+    m_file.read(reinterpret_cast<char*>(&version), sizeof(version));
+    if (!m_file.good() || std::memcmp(magic, NR_REM_MAGIC, sizeof(magic)) != 0 ||
+        version != NR_REM_VERSION)
+    {
+        NS_LOG_ERROR("File " << filename << " is not a REM binary file of version "
+                             << NR_REM_VERSION);
+        return false;
+    }
+
+    Header header;
+    for (double* value : {&header.m_xMin, &header.m_yMin, &header.m_xStep, &header.m_yStep,
+                          &header.m_z})
+    {
+        m_file.read(reinterpret_cast<char*>(value), sizeof(*value));
+    }
+    uint32_t numMetrics = 0;
+    for (uint32_t* value : {&header.m_numX, &header.m_numY, &numMetrics})
+    {
+        m_file.read(reinterpret_cast<char*>(value), sizeof(*value));
+    }
+    for (uint32_t metric = 0; m_file.good() && metric < numMetrics; metric++)
+    {
+        uint32_t length = 0;
+        m_file.read(reinterpret_cast<char*>(&length), sizeof(length));
+        std::string name(length, ' ');
+        m_file.read(&name[0], length);
+        header.m_metrics.push_back(name);
+    }
+
+    m_header = header;
+    m_dataOffset = m_file.tellg();
+    m_values.resize(static_cast<size_t>(numMetrics) * header.m_numX * header.m_numY);
+    m_file.read(reinterpret_cast<char*>(m_values.data()), m_values.size() * sizeof(float));
+    if (!m_file.good())
+    {
+        NS_LOG_ERROR("File " << filename << " is truncated");
+        m_values.clear();
+        return false;
+    }
+    m_file.close();
+    return true;
+}
+
+const NrRemBinaryFile::Header&
+NrRemBinaryFile::GetHeader() const
+{
+    return m_header;
+}
+
+float
+NrRemBinaryFile::GetValue(size_t metric, uint32_t xIndex, uint32_t yIndex) const
+{
+    NS_ASSERT_MSG(metric < m_header.m_metrics.size() && xIndex < m_header.m_numX &&
+                      yIndex < m_header.m_numY,
+                  "The value is out of the grid");
+    return m_values.at((metric * m_header.m_numX + xIndex) * m_header.m_numY + yIndex);
+}
+
+double
+NrRemBinaryFile::GetX(uint32_t xIndex) const
+{
+    double x = m_header.m_xMin;
+    for (uint32_t i = 0; i < xIndex; i++)
+    {
+        x += m_header.m_xStep;
+    }
+    return x;
+}
+
+double
+NrRemBinaryFile::GetY(uint32_t yIndex) const
+{
+    double y = m_header.m_yMin;
+    for (uint32_t i = 0; i < yIndex; i++)
+    {
+        y += m_header.m_yStep;
+    }
+    return y;
+}
+
+void
+NrRemBinaryFile::PrintText(std::ostream& os) const
+{
+    double x = m_header.m_xMin;
+    for (uint32_t xIndex = 0; xIndex < m_header.m_numX; xIndex++, x += m_header.m_xStep)
+    {
+        double y = m_header.m_yMin;
+        for (uint32_t yIndex = 0; yIndex < m_header.m_numY; yIndex++, y += m_header.m_yStep)
+        {
+            bool hasValue = false;
+            for (size_t metric = 0; metric < m_header.m_metrics.size(); metric++)
+            {
+                hasValue = hasValue || !std::isnan(GetValue(metric, xIndex, yIndex));
+            }
+            if (!hasValue)
+            {
+                continue;
+            }
+
+            os << x << "\t" << y << "\t" << m_header.m_z << "\t";
+            for (size_t metric = 0; metric < m_header.m_metrics.size(); metric++)
+            {
+                os << GetValue(metric, xIndex, yIndex) << "\t";
+            }
+            os << "\n";
+        }
+    }
+}
+
+std::streamoff
+NrRemBinaryFile::GetOffset(size_t metric, uint32_t xIndex, uint32_t yIndex) const
+{
+    return m_dataOffset + static_cast<std::streamoff>(
+                              ((metric * m_header.m_numX + xIndex) * m_header.m_numY + yIndex) *
+                              sizeof(float));
+}
+
+} // namespace ns3
@@ -0,0 +1,149 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_REM_BINARY_FILE_H
+#define NR_REM_BINARY_FILE_H
+
+#include <fstream>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Binary file with the values of a REM, on a regular grid
+ *
+ * The file starts with a header:
+ *
+ * - the magic string "NRREM" followed by three zero bytes, and the version (uint32_t);
+ * - the min x and y coordinates, the steps along x and y, and the z coordinate (double);
+ * - the number of points along x and along y (uint32_t);
+ * - the number of metrics (uint32_t), and the name of each metric, as its
+ * length (uint32_t) followed by its characters.
+ *
+ * After the header there is a plane for each metric, in the order of the
+ * header, with a float value for each point of the grid. The values are
+ * stored by columns: the value of the point (xIndex, yIndex) is at position
+ * xIndex * numY + yIndex of the plane. The points of the grid without a value
+ * (not calculated yet, or skipped by the REM) are NaN. Numbers are stored in
+ * the byte order of the host.
+ *
+ * When the file is created, every value is NaN: the columns can then be
+ * written in any order, as soon as their values are available, so that the
+ * file keeps the columns already written if the REM is interrupted.
+ */
+class NrRemBinaryFile
+{
+  public:
+    /**
+     * \brief The description of the grid and of the metrics of the file
+     */
+    struct Header
+    {
+        double m_xMin{0};                   //!< The x coordinate of the first column
+        double m_yMin{0};                   //!< The y coordinate of the first row
+        double m_xStep{0};                  //!< The distance between two columns
+        double m_yStep{0};                  //!< The distance between two rows
+        double m_z{0};                      //!< The z coordinate of the grid
+        uint32_t m_numX{0};                 //!< The number of columns (points along x)
+        uint32_t m_numY{0};                 //!< The number of rows (points along y)
+        std::vector<std::string> m_metrics; //!< The names of the metrics
+    };
+
+    /**
+     * \brief Creates the file, with the header and every value set to NaN
+     * \param filename the name of the file
+     * \param header the header of the file
+     * \return false if the file could not be created
+     */
+    bool Create(const std::string& filename, const Header& header);
+
+    /**
+     * \brief Writes the values of a metric for a column of the grid
+     * \param xIndex the index of the column
+     * \param metric the index of the metric, in the order of the header
+     * \param values the value of each row (NaN if the point has no value)
+     */
+    void WriteColumn(uint32_t xIndex, size_t metric, const std::vector<float>& values);
+
+    /**
+     * \brief Writes to the disk the columns written up to now
+     */
+    void Flush();
+
+    /**
+     * \brief Closes the file
+     */
+    void Close();
+
+    /**
+     * \brief Opens an existing file, and reads its header and its values
+     * \param filename the name of the file
+     * \return false if the file could not be read
+     */
+    bool Open(const std::string& filename);
+
+    /**
+     * \return The header of the file
+     */
+    const Header& GetHeader() const;
+
+    /**
+     * \brief Returns a value read by Open
+     * \param metric the index of the metric
+     * \param xIndex the index of the column
+     * \param yIndex the index of the row
+     * \return The value (NaN if the point has no value)
+     */
+    float GetValue(size_t metric, uint32_t xIndex, uint32_t yIndex) const;
+
+    /**
+     * \brief Returns the x coordinate of a column. The coordinates are
+     * accumulated step by step, as the REM helper does, so that they are the
+     * same as in the text output.
+     * \param xIndex the index of the column
+     * \return The x coordinate
+     */
+    double GetX(uint32_t xIndex) const;
+
+    /**
+     * \brief Returns the y coordinate of a row, accumulated as GetX does
+     * \param yIndex the index of the row
+     * \return The y coordinate
+     */
+    double GetY(uint32_t yIndex) const;
+
+    /**
+     * \brief Prints the values read by Open as the text output of the REM:
+     * a line for each point with a value, with the x, y and z coordinates and
+     * then the metrics, separated by tabs
+     * \param os the output stream
+     */
+    void PrintText(std::ostream& os) const;
+
+  private:
+    /**
+     * \brief Position of a value in the file
+     * \param metric the index of the metric
+     * \param xIndex the index of the column
+     * \param yIndex the index of the row
+     * \return The offset from the beginning of the file, in bytes
+     */
+    std::streamoff GetOffset(size_t metric, uint32_t xIndex, uint32_t yIndex) const;
+
+    std::fstream m_file;            //!< The file
+    Header m_header;                //!< The header of the file
+    std::streamoff m_dataOffset{0}; //!< The size of the header, in bytes
+    std::vector<float> m_values;    //!< The values read by Open, plane after plane
+};
+
+} // namespace ns3
+
+#endif // NR_REM_BINARY_FILE_H
@@ -0,0 +1,130 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rem-checkpoint-file.h"
+
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRemCheckpointFile");
+
+/// Magic of the file
+static const char NR_REM_CHECKPOINT_MAGIC[8] = {'N', 'R', 'R', 'E', 'M', 'C', 'K', 'P'};
+
+bool
+NrRemCheckpointFile::Open(const std::string& filename,
+                          uint64_t configHash,
+                          uint64_t numPoints,
+                          uint64_t numValues)
+{
+    NS_LOG_FUNCTION(this << filename << configHash << numPoints << numValues);
+
+    m_numPoints = numPoints;
+    m_numValues = numValues;
+    m_resumed.clear();
+    m_pending.clear();
+
+    // Read the records of a previous run with the same configuration
+    bool resume = false;
+    std::streamoff validSize = 0;
+    std::ifstream inFile(filename.c_str(), std::ios_base::in | std::ios_base::binary);
+    if (inFile.is_open())
+    {
+        char magic[sizeof(NR_REM_CHECKPOINT_MAGIC)];
+        uint64_t header[3] = {0, 0, 0};
+        inFile.read(magic, sizeof(magic));
+        inFile.read(reinterpret_cast<char*>(header), sizeof(header));
+        resume = inFile.good() &&
+                 std::memcmp(magic, NR_REM_CHECKPOINT_MAGIC, sizeof(magic)) == 0 &&
+                 header[0] == configHash && header[1] == numPoints && header[2] == numValues;
+        validSize = inFile.tellg();
+
+        Record record;
+        record.m_values.resize(numValues);
+        while (resume)
+        {
+            inFile.read(reinterpret_cast<char*>(&record.m_index), sizeof(record.m_index));
+            inFile.read(reinterpret_cast<char*>(record.m_values.data()),
+                        numValues * sizeof(double));
+            if (!inFile.good() || record.m_index >= numPoints)
+            {
+                break;
+            }
+            m_resumed.push_back(record);
+            validSize = inFile.tellg();
+        }
+        inFile.close();
+        NS_LOG_INFO("Checkpoint " << filename << (resume ? " resumed with " : " ignored, ")
+                                  << m_resumed.size() << " REM points");
+    }
+
+    if (resume)
+    {
+        // Drop the last record, if it was not saved completely, and append
+        m_file.open(filename.c_str(), std::ios_base::in | std::ios_base::out |
+                                          std::ios_base::binary);
+        m_file.seekp(validSize);
+    }
+    else
+    {
+        m_file.open(filename.c_str(),
+                    std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+        uint64_t header[3] = {configHash, numPoints, numValues};
+        m_file.write(NR_REM_CHECKPOINT_MAGIC, sizeof(NR_REM_CHECKPOINT_MAGIC));
+        m_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        m_file.flush();
+    }
+    if (!m_file.is_open() || !m_file.good())
+    {
+        NS_LOG_ERROR("Can't open file " << filename);
+        return false;
+    }
+    return true;
+}
+
+const std::vector<NrRemCheckpointFile::Record>&
+NrRemCheckpointFile::GetResumedRecords() const
+{
+    return m_resumed;
+}
+
+void
+NrRemCheckpointFile::Append(uint64_t index, const std::vector<double>& values)
+{
+    NS_ASSERT_MSG(index < m_numPoints, "The REM point is out of the REM");
+    NS_ASSERT_MSG(values.size() == m_numValues, "Wrong number of values for a REM point");
+    const char* indexBytes = reinterpret_cast<const char*>(&index);
+    const char* valueBytes = reinterpret_cast<const char*>(values.data());
+    m_pending.insert(m_pending.end(), indexBytes, indexBytes + sizeof(index));
+    m_pending.insert(m_pending.end(), valueBytes, valueBytes + values.size() * sizeof(double));
+}
+
+void
+NrRemCheckpointFile::Save()
+{
+    NS_LOG_FUNCTION(this << m_pending.size());
+    m_file.write(m_pending.data(), m_pending.size());
+    m_file.flush();
+    m_pending.clear();
+}
+
+void
+NrRemCheckpointFile::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_file.is_open())
+    {
+        Save();
+        m_file.close();
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_REM_CHECKPOINT_FILE_H
+#define NR_REM_CHECKPOINT_FILE_H
+
+#include <fstream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Checkpoint file of a REM, with the values of the REM points already
+ * calculated
+ *
+ * The file starts with a header: the magic string "NRREMCKP", the hash of the
+ * configuration of the REM, the number of REM points and the number of values
+ * of each point (uint64_t). Then, it has a record for each REM point
+ * calculated: the index of the point (uint64_t) followed by its values
+ * (double). Numbers are stored in the byte order of the host.
+ *
+ * The records are only appended, so that a checkpoint interrupted while it is
+ * being saved loses at most the last record, which is ignored when the file
+ * is read.
+ */
+class NrRemCheckpointFile
+{
+  public:
+    /**
+     * \brief The values of a REM point
+     */
+    struct Record
+    {
+        uint64_t m_index{0};          //!< The index of the REM point
+        std::vector<double> m_values; //!< The values of the REM point
+    };
+
+    /**
+     * \brief Opens the checkpoint file of a REM. If the file exists and has
+     * been written by a REM with the same configuration, its records are read,
+     * and the new records are appended to them. Otherwise, the file is created
+     * (or overwritten) with no records.
+     * \param filename the name of the file
+     * \param configHash the hash of the configuration of the REM
+     * \param numPoints the number of REM points
+     * \param numValues the number of values of each REM point
+     * \return false if the file could not be opened
+     */
+    bool Open(const std::string& filename,
+              uint64_t configHash,
+              uint64_t numPoints,
+              uint64_t numValues);
+
+    /**
+     * \return The records read by Open, of the REM points calculated by a
+     * previous run of the REM
+     */
+    const std::vector<Record>& GetResumedRecords() const;
+
+    /**
+     * \brief Adds the values of a REM point, that are written at the next Save
+     * \param index the index of the REM point
+     * \param values the values of the REM point
+     */
+    void Append(uint64_t index, const std::vector<double>& values);
+
+    /**
+     * \brief Writes to the disk the records appended since the last Save
+     */
+    void Save();
+
+    /**
+     * \brief Saves the records appended, and closes the file
+     */
+    void Close();
+
+  private:
+    std::ofstream m_file;          //!< The file
+    uint64_t m_numPoints{0};       //!< The number of REM points
+    uint64_t m_numValues{0};       //!< The number of values of each REM point
+    std::vector<Record> m_resumed; //!< The records read by Open
+    std::vector<char> m_pending;   //!< The records appended and not saved yet, as in the file
+};
+
+} // namespace ns3
+
+#endif // NR_REM_CHECKPOINT_FILE_H
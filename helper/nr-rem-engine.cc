@@ -0,0 +1,371 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rem-engine.h"
+
+#include "nr-spectrum-value-helper.h"
+
+#include <ns3/abort.h>
+#include <ns3/beamforming-vector.h>
+#include <ns3/buildings-module.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/node.h>
+#include <ns3/three-gpp-propagation-loss-model.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+#include <complex>
+#include <utility>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRemEngine");
+
+void
+NrRemEngine::SetPropagationModels(const ObjectFactory& propagationLossModelFactory,
+                                  const ObjectFactory& channelConditionModelFactory)
+{
+    m_propagationLossModelFactory = propagationLossModelFactory;
+    m_channelConditionModelFactory = channelConditionModelFactory;
+}
+
+void
+NrRemEngine::SetSpectrum(const Ptr<const SpectrumModel>& spectrumModel, double noiseFigure)
+{
+    Ptr<SpectrumValue> noisePsd =
+        NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(noiseFigure, spectrumModel);
+    m_noisePower = Integral(*noisePsd);
+}
+
+void
+NrRemEngine::SetRxGain(double rxGainDb)
+{
+    m_rxGainDb = rxGainDb;
+}
+
+uint32_t
+NrRemEngine::AddTransmitter(const Vector& position,
+                            const Ptr<const UniformPlanarArray>& antenna,
+                            double txPower)
+{
+    NS_LOG_FUNCTION(this << position << txPower);
+    Transmitter transmitter;
+    transmitter.mob = CreateMobility(position);
+    transmitter.array = Copy(antenna);
+    transmitter.txPower = txPower;
+    DoubleValue downTilt;
+    transmitter.array->GetAttribute("DowntiltAngle", downTilt);
+    transmitter.downTilt = downTilt.Get();
+    m_transmitters.push_back(transmitter);
+    return static_cast<uint32_t>(m_transmitters.size() - 1);
+}
+
+void
+NrRemEngine::SetPoints(const std::vector<Vector>& points)
+{
+    m_points = points;
+}
+
+void
+NrRemEngine::SetGrid(double xMin,
+                     double xMax,
+                     uint16_t xRes,
+                     double yMin,
+                     double yMax,
+                     uint16_t yRes,
+                     double z)
+{
+    NS_ABORT_MSG_IF(xMax <= xMin || yMax <= yMin, "The max coordinates must exceed the min ones");
+    NS_ABORT_MSG_IF(xRes == 0 || yRes == 0, "Resolution must be higher than 0");
+
+    double xStep = (xMax - xMin) / xRes;
+    double yStep = (yMax - yMin) / yRes;
+    m_points.clear();
+    for (double x = xMin; x < xMax + 0.5 * xStep; x += xStep)
+    {
+        for (double y = yMin; y < yMax + 0.5 * yStep; y += yStep)
+        {
+            m_points.emplace_back(x, y, z);
+        }
+    }
+}
+
+const std::vector<Vector>&
+NrRemEngine::GetPoints() const
+{
+    return m_points;
+}
+
+int64_t
+NrRemEngine::AssignStreams(int64_t stream)
+{
+    m_firstStream = stream;
+    m_streamsAssigned = true;
+    m_streamsTransmitters = m_transmitters.size();
+    m_streamsPoints = m_points.size();
+    m_streamsPerPair = AssignModelStreams(CreatePropagationLossModel(), 0);
+    return m_streamsPerPair * static_cast<int64_t>(m_transmitters.size() * m_points.size());
+}
+
+void
+NrRemEngine::Precompute()
+{
+    NS_LOG_FUNCTION(this << m_transmitters.size() << m_points.size());
+    NS_ABORT_MSG_IF(m_transmitters.empty() || m_points.empty(),
+                    "The scenario needs transmitters and points");
+    NS_ABORT_MSG_UNLESS(m_streamsAssigned, "AssignStreams must be called before Precompute");
+    NS_ABORT_MSG_IF(m_transmitters.size() != m_streamsTransmitters ||
+                        m_points.size() != m_streamsPoints,
+                    "The transmitters or the points changed after AssignStreams: "
+                    "call it again");
+    NS_ABORT_MSG_IF(AssignModelStreams(CreatePropagationLossModel(), 0) != m_streamsPerPair,
+                    "The propagation models changed after AssignStreams: call it again");
+
+    if (!m_rxMob)
+    {
+        m_rxMob = CreateMobility(Vector(0, 0, 0));
+    }
+    Ptr<MobilityModel> rxMob = m_rxMob;
+    Ptr<MobilityBuildingInfo> rxBuildingInfo = rxMob->GetObject<MobilityBuildingInfo>();
+
+    size_t numPoints = m_points.size();
+    m_pathGains.assign(m_transmitters.size() * numPoints, 0.0);
+    m_angles.clear();
+    m_angles.reserve(m_transmitters.size() * numPoints);
+    m_gainCache.assign(m_transmitters.size(), {});
+    for (size_t transmitter = 0; transmitter < m_transmitters.size(); transmitter++)
+    {
+        const Transmitter& tx = m_transmitters[transmitter];
+        for (size_t point = 0; point < numPoints; point++)
+        {
+            rxMob->SetPosition(m_points[point]);
+            rxBuildingInfo->MakeConsistent(rxMob);
+
+            // The models cache the channel condition per pair of nodes, and the
+            // receiver is always the same node: a new model for each pair. The
+            // streams are in blocks by point, and by transmitter in each block.
+            size_t pair = transmitter * numPoints + point;
+            int64_t streamIndex = static_cast<int64_t>(point * m_transmitters.size() + transmitter);
+            Ptr<PropagationLossModel> model = CreatePropagationLossModel();
+            AssignModelStreams(model, m_firstStream + streamIndex * m_streamsPerPair);
+            m_pathGains[pair] = model->CalcRxPower(0, tx.mob, rxMob);
+            m_angles.emplace_back(m_points[point], tx.mob->GetPosition());
+        }
+    }
+}
+
+double
+NrRemEngine::GetPathGain(uint32_t transmitter, size_t point) const
+{
+    NS_ABORT_MSG_IF(m_pathGains.empty(), "Precompute has not been called");
+    return m_pathGains.at(transmitter * m_points.size() + point);
+}
+
+std::vector<NrRemEngine::PointResult>
+NrRemEngine::Evaluate(const Configuration& configuration) const
+{
+    NS_LOG_FUNCTION(this);
+    NS_ABORT_MSG_IF(m_pathGains.size() != m_transmitters.size() * m_points.size(),
+                    "Precompute has not been called after changing the scenario");
+    NS_ABORT_MSG_IF((!configuration.txPowers.empty() &&
+                     configuration.txPowers.size() != m_transmitters.size()) ||
+                        (!configuration.beams.empty() &&
+                         configuration.beams.size() != m_transmitters.size()) ||
+                        (!configuration.downTilts.empty() &&
+                         configuration.downTilts.size() != m_transmitters.size()),
+                    "The configuration must have a value for each transmitter");
+
+    size_t numPoints = m_points.size();
+    std::vector<double> rxPowers(m_transmitters.size() * numPoints, 0.0);
+    std::vector<double> bestPowers(numPoints, 0.0);
+    std::vector<PointResult> results(numPoints);
+    for (uint32_t transmitter = 0; transmitter < m_transmitters.size(); transmitter++)
+    {
+        const Transmitter& tx = m_transmitters[transmitter];
+        PhasedArrayModel::ComplexVector beam = configuration.beams.empty()
+                                                   ? tx.array->GetBeamformingVector()
+                                                   : configuration.beams[transmitter];
+        if (beam.GetSize() == 0)
+        {
+            UintegerValue numRows;
+            UintegerValue numColumns;
+            tx.array->GetAttribute("NumRows", numRows);
+            tx.array->GetAttribute("NumColumns", numColumns);
+            beam = CreateQuasiOmniBfv(numRows.Get(), numColumns.Get());
+        }
+        double downTilt = tx.downTilt;
+        if (!configuration.downTilts.empty())
+        {
+            downTilt = configuration.downTilts[transmitter];
+        }
+        const std::vector<double>& gains = GetAntennaGains(transmitter, beam, downTilt);
+
+        double txPower =
+            configuration.txPowers.empty() ? tx.txPower : configuration.txPowers[transmitter];
+        for (size_t point = 0; point < numPoints; point++)
+        {
+            size_t pair = transmitter * numPoints + point;
+            rxPowers[pair] =
+                std::pow(10.0, (txPower + m_pathGains[pair] + m_rxGainDb - 30) / 10) * gains[point];
+            if (transmitter == 0 || rxPowers[pair] > bestPowers[point])
+            {
+                bestPowers[point] = rxPowers[pair];
+                results[point].bestServer = transmitter;
+            }
+        }
+    }
+
+    // The best server has the max SNR and the max SINR among the transmitters.
+    // The interference is the sum of the other signals, and not the total minus
+    // the best signal, which cancels when the best signal dominates.
+    for (size_t point = 0; point < numPoints; point++)
+    {
+        double interference = 0;
+        for (uint32_t transmitter = 0; transmitter < m_transmitters.size(); transmitter++)
+        {
+            if (transmitter != results[point].bestServer)
+            {
+                interference += rxPowers[transmitter * numPoints + point];
+            }
+        }
+        results[point].snrDb = 10 * std::log10(bestPowers[point] / m_noisePower);
+        results[point].sinrDb =
+            10 * std::log10(bestPowers[point] / (interference + m_noisePower));
+        results[point].rxPowerDbm = 10 * std::log10(bestPowers[point] + interference) + 30;
+    }
+    return results;
+}
+
+Ptr<MobilityModel>
+NrRemEngine::CreateMobility(const Vector& position)
+{
+    // The propagation models use the node id as key of the pair
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+    mob->SetPosition(position);
+    node->AggregateObject(mob);
+    Ptr<MobilityBuildingInfo> buildingInfo = CreateObject<MobilityBuildingInfo>();
+    mob->AggregateObject(buildingInfo);
+    return mob;
+}
+
+Ptr<PropagationLossModel>
+NrRemEngine::CreatePropagationLossModel() const
+{
+    Ptr<PropagationLossModel> model =
+        m_propagationLossModelFactory.Create<PropagationLossModel>();
+    NS_ABORT_MSG_UNLESS(model, "The propagation loss model factory is not set");
+    Ptr<ThreeGppPropagationLossModel> threeGppModel =
+        DynamicCast<ThreeGppPropagationLossModel>(model);
+    if (threeGppModel && m_channelConditionModelFactory.IsTypeIdSet())
+    {
+        threeGppModel->SetChannelConditionModel(
+            m_channelConditionModelFactory.Create<ChannelConditionModel>());
+    }
+    return model;
+}
+
+int64_t
+NrRemEngine::AssignModelStreams(const Ptr<PropagationLossModel>& model, int64_t stream)
+{
+    int64_t currentStream = stream;
+    currentStream += model->AssignStreams(currentStream);
+    Ptr<ThreeGppPropagationLossModel> threeGppModel =
+        DynamicCast<ThreeGppPropagationLossModel>(model);
+    if (threeGppModel && threeGppModel->GetChannelConditionModel())
+    {
+        currentStream += threeGppModel->GetChannelConditionModel()->AssignStreams(currentStream);
+    }
+    return currentStream - stream;
+}
+
+const std::vector<double>&
+NrRemEngine::GetAntennaGains(uint32_t transmitter,
+                             const PhasedArrayModel::ComplexVector& beam,
+                             double downTilt) const
+{
+    std::vector<GainCacheEntry>& entries = m_gainCache[transmitter];
+    for (const auto& entry : entries)
+    {
+        if (entry.downTilt != downTilt || entry.beam.GetSize() != beam.GetSize())
+        {
+            continue;
+        }
+        bool sameBeam = true;
+        for (size_t element = 0; element < beam.GetSize() && sameBeam; element++)
+        {
+            sameBeam = entry.beam[element] == beam[element];
+        }
+        if (sameBeam)
+        {
+            return entry.gains;
+        }
+    }
+
+    const Transmitter& tx = m_transmitters[transmitter];
+    Ptr<UniformPlanarArray> array = tx.array;
+    if (downTilt != tx.downTilt)
+    {
+        // the antenna of the scenario is not changed
+        array = Copy<UniformPlanarArray>(tx.array);
+        array->SetAttribute("DowntiltAngle", DoubleValue(downTilt));
+    }
+    GainCacheEntry entry;
+    entry.beam = beam;
+    entry.downTilt = downTilt;
+    CalcAntennaGains(transmitter, array, beam, &entry.gains);
+    entries.push_back(std::move(entry));
+    return entries.back().gains;
+}
+
+void
+NrRemEngine::CalcAntennaGains(uint32_t transmitter,
+                              const Ptr<const UniformPlanarArray>& array,
+                              const PhasedArrayModel::ComplexVector& beam,
+                              std::vector<double>* gains) const
+{
+    size_t numElements = array->GetNumberOfElements();
+    NS_ABORT_MSG_IF(beam.GetSize() != numElements,
+                    "The beam of transmitter " << transmitter << " has " << beam.GetSize()
+                                               << " weights instead of " << numElements);
+
+    // The locations (in wavelengths) depend on the orientation of the antenna,
+    // and then on the downtilt of the configuration
+    std::vector<Vector> locations;
+    for (size_t element = 0; element < numElements; element++)
+    {
+        locations.push_back(array->GetElementLocation(element));
+    }
+
+    size_t numPoints = m_points.size();
+    gains->assign(numPoints, 0.0);
+    for (size_t point = 0; point < numPoints; point++)
+    {
+        const Angles& angles = m_angles[transmitter * numPoints + point];
+        std::pair<double, double> field = array->GetElementFieldPattern(angles);
+        double elementGain = field.first * field.first + field.second * field.second;
+
+        // Array factor of the beam: the weights of beamforming-vector.cc compensate
+        // the phase 2 * pi * (k . location) of the element towards direction k
+        double sinInclination = std::sin(angles.GetInclination());
+        Vector k(sinInclination * std::cos(angles.GetAzimuth()),
+                 sinInclination * std::sin(angles.GetAzimuth()),
+                 std::cos(angles.GetInclination()));
+        std::complex<double> arrayFactor = 0;
+        for (size_t element = 0; element < numElements; element++)
+        {
+            const Vector& loc = locations[element];
+            double phase = 2 * M_PI * (k.x * loc.x + k.y * loc.y + k.z * loc.z);
+            arrayFactor += beam[element] * std::polar(1.0, phase);
+        }
+        (*gains)[point] = elementGain * std::norm(arrayFactor);
+    }
+}
+
+} // namespace ns3
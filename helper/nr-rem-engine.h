@@ -0,0 +1,276 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_REM_ENGINE_H
+#define NR_REM_ENGINE_H
+
+#include <ns3/angles.h>
+#include <ns3/mobility-model.h>
+#include <ns3/object-factory.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/spectrum-value.h>
+#include <ns3/uniform-planar-array.h>
+#include <ns3/vector.h>
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Standalone REM engine, that evaluates many configurations of a
+ * scenario without a running simulation
+ *
+ * The scenario is described directly: the transmitters (position, antenna
+ * and TX power), the spectrum model and the noise figure of the receiver, the
+ * factories of the propagation loss and channel condition models, and the
+ * points of the map. Precompute calculates once the large-scale terms of each
+ * pair of transmitter and point: the path loss (with the channel condition and
+ * the shadowing of the models) and the direction of the point from the
+ * transmitter. Then, Evaluate calculates the map of a configuration (TX
+ * powers, beams and downtilts of the transmitters) only from these terms, so
+ * that sweeps of many configurations do not calculate again the path loss.
+ *
+ * The received power of a pair is the TX power, plus the gain of the antenna
+ * of the transmitter towards the point (element pattern and array factor of
+ * the beam), plus the path loss, plus the gain of the receiver. There is no
+ * fast fading. The transmitters share the spectrum model of the receiver,
+ * with flat PSDs, so the SNR and the SINR are the ratios of the powers.
+ *
+ * The propagation loss and channel condition models identify the ends of a
+ * link by the id of their node, so the engine is not fully standalone: each
+ * transmitter, and the receiver moved over the points, is a Node, which is
+ * added to the global NodeList. Creating an engine in a simulation therefore
+ * shifts the ids of the nodes created afterwards; create the nodes of the
+ * simulation first, or run the engine in a process without a simulation.
+ */
+class NrRemEngine
+{
+  public:
+    /**
+     * \brief The map of a configuration at a point
+     */
+    struct PointResult
+    {
+        double snrDb{0};        //!< SNR of the best server (dB)
+        double sinrDb{0};       //!< SINR of the best server (dB)
+        double rxPowerDbm{0};   //!< Sum of the received powers of the transmitters (dBm)
+        uint32_t bestServer{0}; //!< Index of the transmitter with the strongest signal
+    };
+
+    /**
+     * \brief The parameters of the transmitters evaluated by a configuration.
+     * An empty vector keeps the parameter of the scenario for every transmitter.
+     */
+    struct Configuration
+    {
+        std::vector<double> txPowers; //!< TX power of each transmitter (dBm)
+        //! Beamforming vector of each transmitter (empty: the one of its antenna)
+        std::vector<PhasedArrayModel::ComplexVector> beams;
+        std::vector<double> downTilts; //!< Downtilt angle of each transmitter antenna (rad)
+    };
+
+    /**
+     * \brief Sets the models of the path loss. If the propagation loss model is
+     * a ThreeGppPropagationLossModel, it gets a channel condition model of the
+     * channel condition factory. A new model is created for each pair of
+     * transmitter and point.
+     * \param propagationLossModelFactory the factory of the propagation loss model
+     * \param channelConditionModelFactory the factory of the channel condition
+     * model (without type id, for no channel condition model)
+     */
+    void SetPropagationModels(const ObjectFactory& propagationLossModelFactory,
+                              const ObjectFactory& channelConditionModelFactory);
+
+    /**
+     * \brief Sets the spectrum model and the noise figure of the receiver
+     * \param spectrumModel the spectrum model, shared by the transmitters
+     * \param noiseFigure the noise figure of the receiver (dB)
+     */
+    void SetSpectrum(const Ptr<const SpectrumModel>& spectrumModel, double noiseFigure);
+
+    /**
+     * \brief Sets the gain of the antenna of the receiver, the same towards
+     * every transmitter
+     * \param rxGainDb the gain (dBi)
+     */
+    void SetRxGain(double rxGainDb);
+
+    /**
+     * \brief Adds a transmitter, with a new node (see the class description)
+     * \param position the position of the transmitter
+     * \param antenna the antenna of the transmitter, which is copied
+     * \param txPower the TX power (dBm)
+     * \return The index of the transmitter
+     */
+    uint32_t AddTransmitter(const Vector& position,
+                            const Ptr<const UniformPlanarArray>& antenna,
+                            double txPower);
+
+    /**
+     * \brief Sets the points of the map
+     * \param points the positions of the points
+     */
+    void SetPoints(const std::vector<Vector>& points);
+
+    /**
+     * \brief Sets the points of the map on a grid, with the order of the REM
+     * helper: by columns (x), and by rows (y) in each column
+     * \param xMin the min x coordinate
+     * \param xMax the max x coordinate
+     * \param xRes the number of steps along x
+     * \param yMin the min y coordinate
+     * \param yMax the max y coordinate
+     * \param yRes the number of steps along y
+     * \param z the z coordinate
+     */
+    void SetGrid(double xMin,
+                 double xMax,
+                 uint16_t xRes,
+                 double yMin,
+                 double yMax,
+                 uint16_t yRes,
+                 double z);
+
+    /**
+     * \return The points of the map
+     */
+    const std::vector<Vector>& GetPoints() const;
+
+    /**
+     * \brief Assigns the random streams of the propagation models. Each pair
+     * of transmitter and point uses its own streams, which follow from the
+     * indexes of the pair: in blocks by point, and by transmitter in each
+     * block. The transmitters and the points must be set before, and it must
+     * be called before Precompute, and again after changing the number of
+     * transmitters or points, or the propagation models.
+     * \param stream the first stream index to use
+     * \return the number of stream indices assigned
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \brief Calculates the large-scale terms of every pair of transmitter and
+     * point. It must be called after setting the scenario, and again after
+     * changing it. It aborts if the transmitters, the points or the streams of
+     * the propagation models changed since AssignStreams, since the streams of
+     * the pairs would overlap the ones assigned after the engine.
+     */
+    void Precompute();
+
+    /**
+     * \brief Returns the path loss of a pair, calculated by Precompute
+     * \param transmitter the index of the transmitter
+     * \param point the index of the point
+     * \return The gain of the path loss (dB, negative)
+     */
+    double GetPathGain(uint32_t transmitter, size_t point) const;
+
+    /**
+     * \brief Calculates the map of a configuration, from the large-scale terms.
+     * The gains of the antennas are kept for each beam and downtilt of each
+     * transmitter, so that the configurations that only change the TX powers,
+     * or that repeat a beam, do not calculate them again.
+     * \param configuration the configuration of the transmitters
+     * \return The values of each point, in the order of the points
+     */
+    std::vector<PointResult> Evaluate(const Configuration& configuration) const;
+
+  private:
+    /**
+     * \brief A transmitter of the scenario
+     */
+    struct Transmitter
+    {
+        Ptr<MobilityModel> mob;        //!< The position, aggregated to a node
+        Ptr<UniformPlanarArray> array; //!< The antenna
+        double txPower{0};             //!< The TX power (dBm)
+        double downTilt{0};            //!< The downtilt angle of the antenna (rad)
+    };
+
+    /**
+     * \brief The gains of the antenna of a transmitter with a beam and a downtilt
+     */
+    struct GainCacheEntry
+    {
+        PhasedArrayModel::ComplexVector beam; //!< The beamforming vector
+        double downTilt{0};                   //!< The downtilt angle (rad)
+        std::vector<double> gains;            //!< The gain (linear) towards each point
+    };
+
+    /**
+     * \brief Creates a node with a constant position, and the building info
+     * needed by the channel condition models with buildings. The node is
+     * added to the NodeList, since the models use its id.
+     * \param position the position of the node
+     * \return The mobility model of the node
+     */
+    static Ptr<MobilityModel> CreateMobility(const Vector& position);
+
+    /**
+     * \brief Creates the propagation loss model of a pair, with its channel
+     * condition model
+     * \return The propagation loss model
+     */
+    Ptr<PropagationLossModel> CreatePropagationLossModel() const;
+
+    /**
+     * \brief Assigns the random streams of a propagation loss model and of its
+     * channel condition model, in the order of the REM helper
+     * \param model the propagation loss model
+     * \param stream the first stream index to use
+     * \return the number of stream indices assigned
+     */
+    static int64_t AssignModelStreams(const Ptr<PropagationLossModel>& model, int64_t stream);
+
+    /**
+     * \brief Returns the gains of the antenna of a transmitter towards each
+     * point, calculating them only if the beam and the downtilt are not cached
+     * \param transmitter the index of the transmitter
+     * \param beam the beamforming vector
+     * \param downTilt the downtilt angle of the antenna (rad)
+     * \return The gain (linear) towards each point
+     */
+    const std::vector<double>& GetAntennaGains(uint32_t transmitter,
+                                               const PhasedArrayModel::ComplexVector& beam,
+                                               double downTilt) const;
+
+    /**
+     * \brief Calculates the gain (linear) of the antenna of a transmitter
+     * towards each point, with a beamforming vector
+     * \param transmitter the index of the transmitter
+     * \param array the antenna, with the downtilt of the configuration
+     * \param beam the beamforming vector
+     * \param gains the gain towards each point, set
+     */
+    void CalcAntennaGains(uint32_t transmitter,
+                          const Ptr<const UniformPlanarArray>& array,
+                          const PhasedArrayModel::ComplexVector& beam,
+                          std::vector<double>* gains) const;
+
+    ObjectFactory m_propagationLossModelFactory;  //!< Factory of the propagation loss models
+    ObjectFactory m_channelConditionModelFactory; //!< Factory of the channel condition models
+    double m_noisePower{0};                       //!< Noise power of the receiver (W)
+    double m_rxGainDb{0};                         //!< Gain of the receiver (dBi)
+    std::vector<Transmitter> m_transmitters;      //!< The transmitters
+    std::vector<Vector> m_points;                 //!< The points of the map
+    int64_t m_firstStream{0};                     //!< First stream of the propagation models
+    int64_t m_streamsPerPair{0};                  //!< Streams used by each pair
+    bool m_streamsAssigned{false};                //!< Whether AssignStreams was called
+    size_t m_streamsTransmitters{0};              //!< Transmitters when AssignStreams was called
+    size_t m_streamsPoints{0};                    //!< Points when AssignStreams was called
+    Ptr<MobilityModel> m_rxMob;                   //!< The receiver, moved over the points
+
+    std::vector<double> m_pathGains; //!< Path loss (dB) of each pair, by transmitter
+    std::vector<Angles> m_angles;    //!< Angles of each point from each transmitter
+    //! Gains of the antennas, for each transmitter
+    mutable std::vector<std::vector<GainCacheEntry>> m_gainCache;
+};
+
+} // namespace ns3
+
+#endif // NR_REM_ENGINE_H
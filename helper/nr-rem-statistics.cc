@@ -0,0 +1,171 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rem-statistics.h"
+
+#include <ns3/assert.h>
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrRemStatistics");
+
+void
+NrRemStatistics::SetBinWidth(double binWidth)
+{
+    NS_ASSERT_MSG(binWidth > 0, "The width of the bins must be positive");
+    m_binWidth = binWidth;
+}
+
+size_t
+NrRemStatistics::AddMetric(const std::string& name, const std::vector<double>& thresholds)
+{
+    NS_LOG_FUNCTION(this << name << thresholds.size());
+    Metric metric;
+    metric.m_name = name;
+    metric.m_thresholds = thresholds;
+    metric.m_covered.assign(thresholds.size(), 0);
+    m_metrics.push_back(metric);
+    return m_metrics.size() - 1;
+}
+
+void
+NrRemStatistics::AddValue(size_t metric, double value)
+{
+    NS_ASSERT_MSG(metric < m_metrics.size(), "Unknown metric");
+    if (std::isnan(value))
+    {
+        return;
+    }
+
+    Metric& m = m_metrics[metric];
+    m.m_min = m.m_count == 0 ? value : std::min(m.m_min, value);
+    m.m_max = m.m_count == 0 ? value : std::max(m.m_max, value);
+    m.m_count++;
+    if (std::isinf(value))
+    {
+        m.m_infinite++;
+    }
+    else
+    {
+        m.m_sum += value;
+    }
+    // -inf (e.g., no received power) goes to the first bin that can be represented
+    double bin = std::max(std::floor(value / m_binWidth), -9.0e18);
+    m.m_bins[static_cast<int64_t>(std::min(bin, 9.0e18))]++;
+    for (size_t threshold = 0; threshold < m.m_thresholds.size(); threshold++)
+    {
+        if (value >= m.m_thresholds[threshold])
+        {
+            m.m_covered[threshold]++;
+        }
+    }
+}
+
+void
+NrRemStatistics::AddBestServer(uint32_t server)
+{
+    if (server >= m_servers.size())
+    {
+        m_servers.resize(server + 1, 0);
+    }
+    m_servers[server]++;
+}
+
+uint64_t
+NrRemStatistics::GetCount(size_t metric) const
+{
+    return m_metrics.at(metric).m_count;
+}
+
+uint64_t
+NrRemStatistics::GetInfiniteCount(size_t metric) const
+{
+    return m_metrics.at(metric).m_infinite;
+}
+
+double
+NrRemStatistics::GetMin(size_t metric) const
+{
+    return m_metrics.at(metric).m_min;
+}
+
+double
+NrRemStatistics::GetMax(size_t metric) const
+{
+    return m_metrics.at(metric).m_max;
+}
+
+double
+NrRemStatistics::GetMean(size_t metric) const
+{
+    const Metric& m = m_metrics.at(metric);
+    uint64_t finite = m.m_count - m.m_infinite;
+    return finite == 0 ? 0.0 : m.m_sum / finite;
+}
+
+const std::map<int64_t, uint64_t>&
+NrRemStatistics::GetHistogram(size_t metric) const
+{
+    return m_metrics.at(metric).m_bins;
+}
+
+double
+NrRemStatistics::GetCoverage(size_t metric, size_t threshold) const
+{
+    const Metric& m = m_metrics.at(metric);
+    return m.m_count == 0 ? 0.0 : static_cast<double>(m.m_covered.at(threshold)) / m.m_count;
+}
+
+const std::vector<uint64_t>&
+NrRemStatistics::GetBestServerCounts() const
+{
+    return m_servers;
+}
+
+void
+NrRemStatistics::Print(std::ostream& os) const
+{
+    for (size_t metric = 0; metric < m_metrics.size(); metric++)
+    {
+        const Metric& m = m_metrics[metric];
+        os << "metric\t" << m.m_name << "\t" << m.m_count << "\t" << m.m_min << "\t" << m.m_max
+           << "\t" << GetMean(metric) << "\t" << m.m_infinite << "\n";
+    }
+    for (size_t metric = 0; metric < m_metrics.size(); metric++)
+    {
+        const Metric& m = m_metrics[metric];
+        for (size_t threshold = 0; threshold < m.m_thresholds.size(); threshold++)
+        {
+            os << "coverage\t" << m.m_name << "\t" << m.m_thresholds[threshold] << "\t"
+               << GetCoverage(metric, threshold) << "\n";
+        }
+    }
+    for (const auto& m : m_metrics)
+    {
+        uint64_t below = 0;
+        for (const auto& bin : m.m_bins)
+        {
+            below += bin.second;
+            os << "histogram\t" << m.m_name << "\t" << bin.first * m_binWidth << "\t"
+               << (bin.first + 1) * m_binWidth << "\t" << bin.second << "\t"
+               << static_cast<double>(below) / m.m_count << "\n";
+        }
+    }
+    uint64_t numPoints = std::accumulate(m_servers.begin(), m_servers.end(), uint64_t{0});
+    for (size_t server = 0; server < m_servers.size(); server++)
+    {
+        os << "server\t" << server << "\t" << m_servers[server] << "\t"
+           << static_cast<double>(m_servers[server]) / numPoints << "\n";
+    }
+}
+
+} // namespace ns3
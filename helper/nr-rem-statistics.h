@@ -0,0 +1,153 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_REM_STATISTICS_H
+#define NR_REM_STATISTICS_H
+
+#include <map>
+#include <ostream>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup helper
+ * \brief Statistics of the values of the points of a REM
+ *
+ * For each metric (e.g., SINR), it keeps a histogram of the values, with bins
+ * of fixed width, and the number of values equal to or above each threshold
+ * of the metric (the coverage). It also counts the points served by each RTD
+ * (the best server). The values are not stored, so the memory does not depend
+ * on the number of points.
+ *
+ * The bin i of a histogram has the values in [i * binWidth, (i + 1) * binWidth),
+ * and only the bins with some value are kept.
+ */
+class NrRemStatistics
+{
+  public:
+    /**
+     * \brief Sets the width of the bins of the histograms. It must be set
+     * before adding the values.
+     * \param binWidth the width of the bins (in the unit of the metrics)
+     */
+    void SetBinWidth(double binWidth);
+
+    /**
+     * \brief Adds a metric
+     * \param name the name of the metric
+     * \param thresholds the thresholds of the coverage of the metric
+     * \return The index of the metric
+     */
+    size_t AddMetric(const std::string& name, const std::vector<double>& thresholds);
+
+    /**
+     * \brief Adds a value of a metric. NaN values are ignored. Infinite values
+     * (e.g., the -inf dB of a point without signal) are counted, but are not
+     * part of the mean.
+     * \param metric the index of the metric
+     * \param value the value
+     */
+    void AddValue(size_t metric, double value);
+
+    /**
+     * \brief Adds a point served by a RTD
+     * \param server the index of the RTD
+     */
+    void AddBestServer(uint32_t server);
+
+    /**
+     * \param metric the index of the metric
+     * \return The number of values of the metric
+     */
+    uint64_t GetCount(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \return The number of infinite values of the metric
+     */
+    uint64_t GetInfiniteCount(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \return The min value of the metric
+     */
+    double GetMin(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \return The max value of the metric
+     */
+    double GetMax(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \return The mean of the finite values of the metric (0 if none)
+     */
+    double GetMean(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \return The histogram of the metric: the number of values of each bin
+     */
+    const std::map<int64_t, uint64_t>& GetHistogram(size_t metric) const;
+
+    /**
+     * \param metric the index of the metric
+     * \param threshold the index of the threshold, in the order of AddMetric
+     * \return The fraction of the values of the metric equal to or above the threshold
+     */
+    double GetCoverage(size_t metric, size_t threshold) const;
+
+    /**
+     * \return The number of points served by each RTD
+     */
+    const std::vector<uint64_t>& GetBestServerCounts() const;
+
+    /**
+     * \brief Prints the statistics, a line for each value, with the values
+     * separated by tabs. The first value of a line tells its type:
+     *
+     * - "metric", name, number of values, min, max, mean of the finite values and
+     * number of infinite values;
+     * - "coverage", name of the metric, threshold and fraction of the values
+     * equal to or above the threshold;
+     * - "histogram", name of the metric, start and end of the bin, number of
+     * values of the bin and fraction of the values below its end (the CDF);
+     * - "server", index of the RTD, number and fraction of the points it serves.
+     *
+     * \param os the output stream
+     */
+    void Print(std::ostream& os) const;
+
+  private:
+    /**
+     * \brief The statistics of a metric
+     */
+    struct Metric
+    {
+        std::string m_name;                 //!< The name of the metric
+        std::vector<double> m_thresholds;   //!< The thresholds of the coverage
+        std::vector<uint64_t> m_covered;    //!< Values above each threshold
+        std::map<int64_t, uint64_t> m_bins; //!< The histogram
+        uint64_t m_count{0};                //!< The number of values
+        uint64_t m_infinite{0};             //!< The number of infinite values
+        double m_sum{0};                    //!< The sum of the finite values
+        double m_min{0};                    //!< The min value
+        double m_max{0};                    //!< The max value
+    };
+
+    double m_binWidth{1.0};          //!< The width of the bins of the histograms
+    std::vector<Metric> m_metrics;   //!< The metrics
+    std::vector<uint64_t> m_servers; //!< The points served by each RTD
+};
+
+} // namespace ns3
+
+#endif // NR_REM_STATISTICS_H
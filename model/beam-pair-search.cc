@@ -0,0 +1,198 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "beam-pair-search.h"
+
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <tuple>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("BeamPairSearch");
+
+BeamPairSearch::Result
+BeamPairSearch::Search(const std::vector<GridPosition>& gnbGrid,
+                       const std::vector<GridPosition>& ueGrid,
+                       const Config& config,
+                       const ScoreFunction& score,
+                       Stats* stats)
+{
+    if (config.m_log)
+    {
+        NS_LOG_FUNCTION(gnbGrid.size() << ueGrid.size() << config.m_hierarchical);
+    }
+    NS_ASSERT(!gnbGrid.empty() && !ueGrid.empty());
+
+    size_t numUeBeams = ueGrid.size();
+    std::vector<double> scores(gnbGrid.size() * numUeBeams, 0.0);
+    std::vector<bool> evaluated(scores.size(), false);
+    size_t numEvaluated = 0;
+
+    // Each pair is scored at most once
+    ScoreFunction memoizedScore = [&](size_t gnbBeam, size_t ueBeam) {
+        size_t index = gnbBeam * numUeBeams + ueBeam;
+        if (!evaluated[index])
+        {
+            scores[index] = score(gnbBeam, ueBeam);
+            evaluated[index] = true;
+            numEvaluated++;
+        }
+        return scores[index];
+    };
+
+    Result result = config.m_hierarchical
+                        ? SearchHierarchical(gnbGrid, ueGrid, config, memoizedScore, evaluated)
+                        : SearchExhaustive(gnbGrid.size(), numUeBeams, memoizedScore);
+    result.m_evaluated = numEvaluated;
+
+    if (stats != nullptr)
+    {
+        stats->m_searches++;
+        stats->m_evaluatedPairs += numEvaluated;
+        stats->m_totalPairs += scores.size();
+    }
+
+    if (config.m_hierarchical && config.m_checkAgainstExhaustive)
+    {
+        Result optimum = SearchExhaustive(gnbGrid.size(), numUeBeams, memoizedScore);
+        bool agree = optimum.m_found == result.m_found && optimum.m_gnbBeam == result.m_gnbBeam &&
+                     optimum.m_ueBeam == result.m_ueBeam;
+        if (config.m_log)
+        {
+            NS_LOG_INFO("Hierarchical search selected pair ("
+                        << result.m_gnbBeam << ", " << result.m_ueBeam << "), exhaustive ("
+                        << optimum.m_gnbBeam << ", " << optimum.m_ueBeam << ")");
+        }
+        if (stats != nullptr)
+        {
+            stats->m_checked++;
+            stats->m_agreements += agree ? 1 : 0;
+        }
+    }
+
+    return result;
+}
+
+BeamPairSearch::Result
+BeamPairSearch::SearchExhaustive(size_t numGnbBeams, size_t numUeBeams, const ScoreFunction& score)
+{
+    Result result;
+    for (size_t gnbBeam = 0; gnbBeam < numGnbBeams; gnbBeam++)
+    {
+        for (size_t ueBeam = 0; ueBeam < numUeBeams; ueBeam++)
+        {
+            double value = score(gnbBeam, ueBeam);
+            if (result.m_score < value)
+            {
+                result.m_found = true;
+                result.m_score = value;
+                result.m_gnbBeam = gnbBeam;
+                result.m_ueBeam = ueBeam;
+            }
+        }
+    }
+    return result;
+}
+
+BeamPairSearch::Result
+BeamPairSearch::SearchHierarchical(const std::vector<GridPosition>& gnbGrid,
+                                   const std::vector<GridPosition>& ueGrid,
+                                   const Config& config,
+                                   const ScoreFunction& score,
+                                   const std::vector<bool>& evaluated)
+{
+    uint16_t factor = std::max<uint16_t>(config.m_coarseStepFactor, 1);
+
+    // The coarse codebook takes one beam every factor positions, starting from
+    // the first row and column of the grid
+    auto coarseBeams = [factor](const std::vector<GridPosition>& grid) {
+        uint16_t minRow = grid.front().m_row;
+        uint16_t minCol = grid.front().m_col;
+        for (const auto& pos : grid)
+        {
+            minRow = std::min(minRow, pos.m_row);
+            minCol = std::min(minCol, pos.m_col);
+        }
+        std::vector<size_t> beams;
+        for (size_t i = 0; i < grid.size(); i++)
+        {
+            if ((grid[i].m_row - minRow) % factor == 0 && (grid[i].m_col - minCol) % factor == 0)
+            {
+                beams.push_back(i);
+            }
+        }
+        return beams;
+    };
+
+    // The fine beams around a coarse one
+    auto neighbours = [factor](const std::vector<GridPosition>& grid, size_t center) {
+        std::vector<size_t> beams;
+        for (size_t i = 0; i < grid.size(); i++)
+        {
+            if (std::abs(grid[i].m_row - grid[center].m_row) < factor &&
+                std::abs(grid[i].m_col - grid[center].m_col) < factor)
+            {
+                beams.push_back(i);
+            }
+        }
+        return beams;
+    };
+
+    // Stage one: all the coarse pairs
+    std::vector<std::tuple<double, size_t, size_t>> coarsePairs;
+    for (size_t gnbBeam : coarseBeams(gnbGrid))
+    {
+        for (size_t ueBeam : coarseBeams(ueGrid))
+        {
+            coarsePairs.emplace_back(score(gnbBeam, ueBeam), gnbBeam, ueBeam);
+        }
+    }
+
+    // Stage two: refine around the best candidates (in case of ties, the first ones)
+    std::stable_sort(coarsePairs.begin(), coarsePairs.end(), [](const auto& a, const auto& b) {
+        return std::get<0>(a) > std::get<0>(b);
+    });
+    size_t numCandidates = std::min<size_t>(config.m_numCandidates, coarsePairs.size());
+    for (size_t i = 0; i < numCandidates; i++)
+    {
+        const std::vector<size_t> ueBeams = neighbours(ueGrid, std::get<2>(coarsePairs[i]));
+        for (size_t gnbBeam : neighbours(gnbGrid, std::get<1>(coarsePairs[i])))
+        {
+            for (size_t ueBeam : ueBeams)
+            {
+                score(gnbBeam, ueBeam);
+            }
+        }
+    }
+
+    // Select among the evaluated pairs with the rule of the exhaustive search
+    Result result;
+    for (size_t gnbBeam = 0; gnbBeam < gnbGrid.size(); gnbBeam++)
+    {
+        for (size_t ueBeam = 0; ueBeam < ueGrid.size(); ueBeam++)
+        {
+            if (!evaluated[gnbBeam * ueGrid.size() + ueBeam])
+            {
+                continue;
+            }
+            double value = score(gnbBeam, ueBeam);
+            if (result.m_score < value)
+            {
+                result.m_found = true;
+                result.m_score = value;
+                result.m_gnbBeam = gnbBeam;
+                result.m_ueBeam = ueBeam;
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef SRC_NR_MODEL_BEAM_PAIR_SEARCH_H_
+#define SRC_NR_MODEL_BEAM_PAIR_SEARCH_H_
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup gnb-phy
+ * \brief Search of the best pair of beams of a gNB and a UE codebook
+ *
+ * The beams of each device are identified by their index in the codebook,
+ * and a ScoreFunction gives the metric of a pair (e.g., the average RX power).
+ * The search can be:
+ *
+ * - exhaustive: every pair is evaluated, gNB beam major, and the first pair
+ * with the highest (strictly positive) score is selected. This is the
+ * historical behavior of the cell scan algorithms;
+ * - hierarchical: like the SSB/CSI-RS beam management, a first stage
+ * evaluates the pairs of a coarse codebook, made by one beam every
+ * `coarseStepFactor` positions of the angular grid of each codebook. The
+ * second stage evaluates, for the best `numCandidates` coarse pairs, the
+ * beams of the fine codebook around them (less than `coarseStepFactor`
+ * positions away, in each direction of the grid). The best evaluated pair is
+ * selected with the same rule as the exhaustive search.
+ *
+ * With a factor f, K candidates and two dimensional grids of Ng and Nu beams,
+ * the first stage evaluates about (Ng / f^2) * (Nu / f^2) pairs, and the
+ * second one at most K * (2f - 1)^4 pairs (less on the edges of the grids and
+ * when the neighbourhoods of the candidates overlap). With a fixed factor the
+ * cost is then still proportional to Ng * Nu, only divided by about f^4. The
+ * two stages cost about the same when f is close to (Ng * Nu / (16 K))^(1/8),
+ * and then the search evaluates in the order of 8 * sqrt(K * Ng * Nu) pairs,
+ * i.e., O(sqrt(N)) per side: the factor has to grow with the codebooks to get
+ * this cost.
+ *
+ * Optionally, the hierarchical search can be checked against the exhaustive
+ * one, to collect statistics on how often it finds the same pair. The scores
+ * are computed at most once per pair, also when the check is enabled.
+ */
+class BeamPairSearch
+{
+  public:
+    /**
+     * \brief Position of a beam in the angular grid of its codebook
+     * (e.g., elevation index and sector)
+     */
+    struct GridPosition
+    {
+        uint16_t m_row{0}; //!< Row of the grid
+        uint16_t m_col{0}; //!< Column of the grid
+    };
+
+    /**
+     * \brief Function that returns the score of the pair (gNB beam, UE beam)
+     */
+    using ScoreFunction = std::function<double(size_t gnbBeam, size_t ueBeam)>;
+
+    /**
+     * \brief Configuration of the search
+     */
+    struct Config
+    {
+        bool m_hierarchical{false};           //!< Use the hierarchical search
+        uint16_t m_coarseStepFactor{2};       //!< Grid positions between two coarse beams
+        uint16_t m_numCandidates{2};          //!< Coarse pairs refined in the second stage
+        bool m_checkAgainstExhaustive{false}; //!< Run also the exhaustive search, for stats
+        bool m_log{true};                     //!< Log the search (NS_LOG is not thread-safe)
+    };
+
+    /**
+     * \brief Result of a search
+     */
+    struct Result
+    {
+        bool m_found{false};     //!< False if no pair has a score higher than 0
+        size_t m_gnbBeam{0};     //!< Index of the selected gNB beam (0 if not found)
+        size_t m_ueBeam{0};      //!< Index of the selected UE beam (0 if not found)
+        double m_score{0.0};     //!< Score of the selected pair
+        size_t m_evaluated{0};   //!< Number of pairs evaluated
+    };
+
+    /**
+     * \brief Statistics of the searches done by an algorithm
+     */
+    struct Stats
+    {
+        uint64_t m_searches{0};       //!< Number of searches
+        uint64_t m_evaluatedPairs{0}; //!< Number of pairs evaluated by the searches
+        uint64_t m_totalPairs{0};     //!< Number of pairs of the codebooks searched
+        uint64_t m_checked{0};        //!< Hierarchical searches checked against the exhaustive
+        uint64_t m_agreements{0};     //!< Checked searches that found the exhaustive optimum
+
+        /**
+         * \brief Accumulate the statistics of other searches
+         * \param other the other statistics
+         * \return a reference to these statistics
+         */
+        Stats& operator+=(const Stats& other)
+        {
+            m_searches += other.m_searches;
+            m_evaluatedPairs += other.m_evaluatedPairs;
+            m_totalPairs += other.m_totalPairs;
+            m_checked += other.m_checked;
+            m_agreements += other.m_agreements;
+            return *this;
+        }
+    };
+
+    /**
+     * \brief Search the best pair
+     * \param gnbGrid position of each gNB beam in the grid of the gNB codebook
+     * \param ueGrid position of each UE beam in the grid of the UE codebook
+     * \param config the configuration of the search
+     * \param score the function that scores a pair
+     * \param stats the statistics to update (can be nullptr)
+     * \return the result of the search
+     */
+    static Result Search(const std::vector<GridPosition>& gnbGrid,
+                         const std::vector<GridPosition>& ueGrid,
+                         const Config& config,
+                         const ScoreFunction& score,
+                         Stats* stats);
+
+  private:
+    /**
+     * \brief Evaluate every pair
+     * \param numGnbBeams number of gNB beams
+     * \param numUeBeams number of UE beams
+     * \param score the (memoized) score function
+     * \return the best pair
+     */
+    static Result SearchExhaustive(size_t numGnbBeams,
+                                   size_t numUeBeams,
+                                   const ScoreFunction& score);
+
+    /**
+     * \brief Evaluate the coarse pairs, and then the fine pairs around the best ones
+     * \param gnbGrid position of each gNB beam
+     * \param ueGrid position of each UE beam
+     * \param config the configuration of the search
+     * \param score the (memoized) score function
+     * \param evaluated the pairs already evaluated, gNB beam major
+     * \return the best pair
+     */
+    static Result SearchHierarchical(const std::vector<GridPosition>& gnbGrid,
+                                     const std::vector<GridPosition>& ueGrid,
+                                     const Config& config,
+                                     const ScoreFunction& score,
+                                     const std::vector<bool>& evaluated);
+};
+
+} // namespace ns3
+
+#endif /* SRC_NR_MODEL_BEAM_PAIR_SEARCH_H_ */
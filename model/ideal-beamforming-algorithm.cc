@@ -14,14 +14,19 @@
 #include "nr-ue-phy.h"
 
 #include <ns3/angles.h>
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/mobility-module.h>
 #include <ns3/multi-model-spectrum-channel.h>
 #include <ns3/node.h>
 #include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
 #include <ns3/uinteger.h>
 #include <ns3/uniform-planar-array.h>
 
+#include <cmath>
+#include <complex>
+
 namespace ns3
 {
 
@@ -39,6 +44,14 @@ IdealBeamformingAlgorithm::GetTypeId()
     return tid;
 }
 
+IdealBeamformingAlgorithm::BeamformingTask
+IdealBeamformingAlgorithm::PrepareBeamformingTask(
+    [[maybe_unused]] const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+    [[maybe_unused]] const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    return nullptr;
+}
+
 TypeId
 CellScanBeamforming::GetTypeId()
 {
@@ -51,7 +64,31 @@ CellScanBeamforming::GetTypeId()
                           DoubleValue(30),
                           MakeDoubleAccessor(&CellScanBeamforming::SetBeamSearchAngleStep,
                                              &CellScanBeamforming::GetBeamSearchAngleStep),
-                          MakeDoubleChecker<double>());
+                          MakeDoubleChecker<double>())
+            .AddAttribute("HierarchicalSearch",
+                          "If true, the beam pairs of a coarse codebook are evaluated first, and "
+                          "then the search is refined around the best ones. If false, every "
+                          "beam pair is evaluated",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CellScanBeamforming::m_hierarchicalSearch),
+                          MakeBooleanChecker())
+            .AddAttribute("CoarseStepFactor",
+                          "Number of BeamSearchAngleStep steps (and of sectors) between two beams "
+                          "of the coarse codebook of the hierarchical search",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&CellScanBeamforming::m_coarseStepFactor),
+                          MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute("NumCandidates",
+                          "Number of coarse beam pairs refined by the hierarchical search",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&CellScanBeamforming::m_numCandidates),
+                          MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute("CheckHierarchicalSearch",
+                          "If true, the hierarchical search is compared with the exhaustive one "
+                          "(evaluating every beam pair), to collect statistics of agreement",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&CellScanBeamforming::m_checkHierarchicalSearch),
+                          MakeBooleanChecker());
 
     return tid;
 }
@@ -68,9 +105,299 @@ CellScanBeamforming::GetBeamSearchAngleStep() const
     return m_beamSearchAngleStep;
 }
 
-BeamformingVectorPair
-CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
-                                           const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+BeamPairSearch::Stats
+CellScanBeamforming::GetBeamSearchStats() const
+{
+    std::lock_guard<std::mutex> lock(m_searchStatsMutex);
+    return m_searchStats;
+}
+
+const CellScanBeamforming::Codebook&
+CellScanBeamforming::GetCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                                 bool truncateTheta) const
+{
+    UintegerValue uintValue;
+    antenna->GetAttribute("NumRows", uintValue);
+    uint16_t numRows = static_cast<uint16_t>(uintValue.Get());
+
+    // The beams depend only on the element locations, on the number of rows
+    // (that defines the sectors) and on the elevations swept
+    std::vector<double> key{m_beamSearchAngleStep,
+                            truncateTheta ? 1.0 : 0.0,
+                            static_cast<double>(numRows)};
+    for (size_t i = 0; i < antenna->GetNumberOfElements(); i++)
+    {
+        Vector loc = antenna->GetElementLocation(i);
+        key.insert(key.end(), {loc.x, loc.y, loc.z});
+    }
+
+    auto it = m_codebooks.find(key);
+    if (it != m_codebooks.end())
+    {
+        return it->second;
+    }
+
+    Codebook codebook;
+    uint16_t thetaIndex = 0;
+    for (double theta = 60; theta < 121; thetaIndex++)
+    {
+        for (uint16_t sector = 0; sector <= numRows; sector++)
+        {
+            NS_ASSERT(sector < UINT16_MAX);
+            codebook.push_back({sector,
+                                theta,
+                                {thetaIndex, sector},
+                                CreateDirectionalBfv(antenna, sector, theta)});
+        }
+
+        double nextTheta = truncateTheta ? static_cast<uint16_t>(theta + m_beamSearchAngleStep)
+                                         : theta + m_beamSearchAngleStep;
+        NS_ABORT_MSG_IF(nextTheta <= theta,
+                        "BeamSearchAngleStep " << m_beamSearchAngleStep << " is too small");
+        theta = nextTheta;
+    }
+
+    NS_LOG_DEBUG("Generated a codebook of " << codebook.size() << " beams for an antenna of "
+                                            << antenna->GetNumberOfElements() << " elements");
+
+    return m_codebooks.emplace(std::move(key), std::move(codebook)).first->second;
+}
+
+BeamPairSearch::ScoreFunction
+CellScanBeamforming::GetChannelMatrixScore(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                           const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                           const Ptr<const SpectrumSignalParameters>& params,
+                                           const Codebook& gnbCodebook,
+                                           const Codebook& ueCodebook) const
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    if (threeGppSplm == nullptr)
+    {
+        return nullptr;
+    }
+
+    Ptr<MobilityModel> gnbMob = gnbSpectrumPhy->GetMobility();
+    Ptr<MobilityModel> ueMob = ueSpectrumPhy->GetMobility();
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+
+    // Probe: the first pair goes through the spectrum propagation loss model,
+    // and it has to match the value computed on the channel matrix. The beamforming
+    // vectors of the antennas are restored after the probe
+    PhasedArrayModel::ComplexVector gnbPreviousW = gnbAntenna->GetBeamformingVector();
+    PhasedArrayModel::ComplexVector uePreviousW = ueAntenna->GetBeamformingVector();
+    gnbAntenna->SetBeamformingVector(gnbCodebook.front().m_w);
+    ueAntenna->SetBeamformingVector(ueCodebook.front().m_w);
+    Ptr<SpectrumValue> probePsd =
+        threeGppSplm->CalcRxPowerSpectralDensity(params, gnbMob, ueMob, gnbAntenna, ueAntenna);
+    if (gnbPreviousW.GetSize() == gnbAntenna->GetNumberOfElements())
+    {
+        gnbAntenna->SetBeamformingVector(gnbPreviousW);
+    }
+    if (uePreviousW.GetSize() == ueAntenna->GetNumberOfElements())
+    {
+        ueAntenna->SetBeamformingVector(uePreviousW);
+    }
+    size_t nbands = probePsd->GetSpectrumModel()->GetNumBands();
+    double probePower = Sum(*probePsd) / nbands;
+
+    Ptr<MatrixBasedChannelModel> channelModel = threeGppSplm->GetChannelModel();
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+        channelModel->GetChannel(gnbMob, ueMob, gnbAntenna, ueAntenna);
+    Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams =
+        channelModel->GetParams(gnbMob, ueMob);
+
+    // Check if the channel matrix was generated considering the gNB as the
+    // s-node and the UE as the u-node or viceversa
+    bool isReverse = channelMatrix->IsReverse(gnbAntenna->GetId(), ueAntenna->GetId());
+    const Codebook& sCodebook = isReverse ? ueCodebook : gnbCodebook;
+    const Codebook& uCodebook = isReverse ? gnbCodebook : ueCodebook;
+
+    const MatrixBasedChannelModel::Complex3DVector& h = channelMatrix->m_channel;
+    size_t sSize = h.GetNumCols();
+    size_t numCluster = h.GetNumPages();
+    NS_ASSERT(uCodebook.front().m_w.GetSize() == h.GetNumRows());
+    NS_ASSERT(sCodebook.front().m_w.GetSize() == sSize);
+    NS_ASSERT(numCluster <= channelParams->m_delay.size());
+
+    // Doppler term of each cluster, as in ThreeGppSpectrumPropagationLossModel
+    // (speeds of the devices in the order in which they are passed to it)
+    Vector sSpeed = gnbMob->GetVelocity();
+    Vector uSpeed = ueMob->GetVelocity();
+    double factor = 2 * M_PI * Simulator::Now().GetSeconds() * threeGppSplm->GetFrequency() / 3e8;
+    bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
+    const auto& sincos = channelParams->m_cachedAngleSincos;
+    const auto& zoa = sincos[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                                             : MatrixBasedChannelModel::ZOD_INDEX];
+    const auto& zod = sincos[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                                             : MatrixBasedChannelModel::ZOA_INDEX];
+    const auto& aoa = sincos[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                                             : MatrixBasedChannelModel::AOD_INDEX];
+    const auto& aod = sincos[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                                             : MatrixBasedChannelModel::AOA_INDEX];
+    std::vector<std::complex<double>> doppler(numCluster);
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        double sinZoa = zoa[cIndex].first;
+        double sinZod = zod[cIndex].first;
+        double cosZoa = zoa[cIndex].second;
+        double cosZod = zod[cIndex].second;
+        double sinAoa = aoa[cIndex].first;
+        double sinAod = aod[cIndex].first;
+        double cosAoa = aoa[cIndex].second;
+        double cosAod = aod[cIndex].second;
+        double tempDoppler =
+            factor *
+            ((sinZoa * cosAoa * uSpeed.x + sinZoa * sinAoa * uSpeed.y + cosZoa * uSpeed.z) +
+             (sinZod * cosAod * sSpeed.x + sinZod * sinAod * sSpeed.y + cosZod * sSpeed.z) +
+             2 * channelParams->m_alpha[cIndex] * channelParams->m_D[cIndex]);
+        doppler[cIndex] = std::complex<double>(cos(tempDoppler), sin(tempDoppler));
+    }
+
+    // TX PSD and delay term of each RB and cluster
+    std::vector<double> txPsd(params->psd->ConstValuesBegin(), params->psd->ConstValuesEnd());
+    std::vector<std::complex<double>> delayTerm(nbands * numCluster);
+    auto sbit = params->psd->ConstBandsBegin();
+    for (size_t band = 0; band < nbands; band++, sbit++)
+    {
+        double fsb = (*sbit).fc; // center frequency of the sub-band
+        for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+            double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
+            delayTerm[band * numCluster + cIndex] = std::complex<double>(cos(delay), sin(delay));
+        }
+    }
+
+    // The product of each u-node beam with H, uH(beam, s, cluster), is computed at
+    // the first use of the beam (a hierarchical search does not use all of them).
+    // Then each pair only adds the s-node weights and the beamforming gain of each RB
+    BeamPairSearch::ScoreFunction score =
+        [channelMatrix,
+         isReverse,
+         sCodebook = &sCodebook,
+         uCodebook = &uCodebook,
+         txPsd = std::move(txPsd),
+         doppler = std::move(doppler),
+         delayTerm = std::move(delayTerm),
+         uH = std::vector<std::complex<double>>(uCodebook.size() * sSize * numCluster),
+         uHDone = std::vector<bool>(uCodebook.size(), false),
+         longTerm = std::vector<std::complex<double>>(numCluster)](size_t gnbBeam,
+                                                                   size_t ueBeam) mutable {
+            const MatrixBasedChannelModel::Complex3DVector& h = channelMatrix->m_channel;
+            size_t uSize = h.GetNumRows();
+            size_t sSize = h.GetNumCols();
+            size_t numCluster = h.GetNumPages();
+            size_t nbands = txPsd.size();
+            size_t sBeam = isReverse ? ueBeam : gnbBeam;
+            size_t uBeam = isReverse ? gnbBeam : ueBeam;
+
+            if (!uHDone[uBeam])
+            {
+                const PhasedArrayModel::ComplexVector& uW = (*uCodebook)[uBeam].m_w;
+                for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+                    {
+                        std::complex<double> rxSum(0, 0);
+                        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+                        {
+                            rxSum = rxSum + uW[uIndex] * h(uIndex, sIndex, cIndex);
+                        }
+                        uH[(uBeam * sSize + sIndex) * numCluster + cIndex] = rxSum;
+                    }
+                }
+                uHDone[uBeam] = true;
+            }
+
+            const PhasedArrayModel::ComplexVector& sW = (*sCodebook)[sBeam].m_w;
+            for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+            {
+                std::complex<double> txSum(0, 0);
+                for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+                {
+                    txSum = txSum + sW[sIndex] * uH[(uBeam * sSize + sIndex) * numCluster + cIndex];
+                }
+                longTerm[cIndex] = txSum;
+            }
+
+            double sum = 0;
+            for (size_t band = 0; band < nbands; band++)
+            {
+                double value = txPsd[band];
+                if (value != 0.00)
+                {
+                    std::complex<double> subbandGain(0.0, 0.0);
+                    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                    {
+                        subbandGain = subbandGain + longTerm[cIndex] * doppler[cIndex] *
+                                                        delayTerm[band * numCluster + cIndex];
+                    }
+                    value = value * std::norm(subbandGain);
+                }
+                sum += value;
+            }
+            return sum / nbands;
+        };
+
+    double power = score(0, 0);
+    if (std::abs(power - probePower) > 1e-12 * std::abs(probePower))
+    {
+        NS_LOG_WARN("The RX power computed on the channel matrix ("
+                    << power << ") differs from the one of the spectrum model (" << probePower
+                    << "): evaluating the beam pairs through the spectrum model");
+        return nullptr;
+    }
+
+    return score;
+}
+
+BeamPairSearch::ScoreFunction
+CellScanBeamforming::GetSpectrumModelScore(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                           const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                           const Ptr<const SpectrumSignalParameters>& params,
+                                           const Codebook& gnbCodebook,
+                                           const Codebook& ueCodebook) const
+{
+    NS_LOG_FUNCTION(this);
+
+    Ptr<const PhasedArraySpectrumPropagationLossModel> spectrumPropModel =
+        gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel();
+    Ptr<MobilityModel> gnbMob = gnbSpectrumPhy->GetMobility();
+    Ptr<MobilityModel> ueMob = ueSpectrumPhy->GetMobility();
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+
+    return [spectrumPropModel,
+            params,
+            gnbMob,
+            ueMob,
+            gnbAntenna,
+            ueAntenna,
+            gnbCodebook = &gnbCodebook,
+            ueCodebook = &ueCodebook](size_t gnbBeam, size_t ueBeam) {
+        gnbAntenna->SetBeamformingVector((*gnbCodebook)[gnbBeam].m_w);
+        ueAntenna->SetBeamformingVector((*ueCodebook)[ueBeam].m_w);
+
+        Ptr<SpectrumValue> rxPsd = spectrumPropModel->CalcRxPowerSpectralDensity(params,
+                                                                                 gnbMob,
+                                                                                 ueMob,
+                                                                                 gnbAntenna,
+                                                                                 ueAntenna);
+
+        size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
+        return Sum(*rxPsd) / nbands;
+    };
+}
+
+bool
+CellScanBeamforming::PrepareSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                   const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                                   bool channelMatrixOnly,
+                                   SearchInput* input) const
 {
     NS_ABORT_MSG_IF(gnbSpectrumPhy == nullptr || ueSpectrumPhy == nullptr,
                     "Something went wrong, gnb or UE PHY layer not set.");
@@ -105,128 +432,216 @@ CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrum
     Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
     fakeParams->psd = fakePsd->Copy();
 
-    double max = 0;
-    double maxTxTheta = 0;
-    double maxRxTheta = 0;
-    uint16_t maxTxSector = 0;
-    uint16_t maxRxSector = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
-
     UintegerValue uintValue;
     gnbSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-    uint32_t txNumRows = static_cast<uint32_t>(uintValue.Get());
+    input->m_gnbNumRows = static_cast<uint32_t>(uintValue.Get());
     ueSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-    uint32_t rxNumRows = static_cast<uint32_t>(uintValue.Get());
+    input->m_ueNumRows = static_cast<uint32_t>(uintValue.Get());
 
     NS_ASSERT(gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements() &&
               ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements());
 
-    uint16_t numRowsTx = static_cast<uint16_t>(txNumRows);
-    uint16_t numRowsRx = static_cast<uint16_t>(rxNumRows);
-    for (double txTheta = 60; txTheta < 121; txTheta = txTheta + m_beamSearchAngleStep)
+    // The UE elevations are truncated to integer values, as the search always did
+    const Codebook& gnbCodebook =
+        GetCodebook(gnbSpectrumPhy->GetBeamManager()->GetAntenna(), false);
+    const Codebook& ueCodebook = GetCodebook(ueSpectrumPhy->GetBeamManager()->GetAntenna(), true);
+    NS_ABORT_MSG_IF(gnbCodebook.front().m_w.GetSize() == 0 || ueCodebook.front().m_w.GetSize() == 0,
+                    "Beamforming vectors must be initialized in order to calculate "
+                    "the long term matrix.");
+    input->m_gnbCodebook = &gnbCodebook;
+    input->m_ueCodebook = &ueCodebook;
+
+    input->m_score =
+        GetChannelMatrixScore(gnbSpectrumPhy, ueSpectrumPhy, fakeParams, gnbCodebook, ueCodebook);
+    if (!input->m_score)
     {
-        for (uint16_t txSector = 0; txSector <= numRowsTx; txSector++)
+        if (channelMatrixOnly)
         {
-            NS_ASSERT(txSector < UINT16_MAX);
+            return false;
+        }
+        input->m_score = GetSpectrumModelScore(gnbSpectrumPhy,
+                                               ueSpectrumPhy,
+                                               fakeParams,
+                                               gnbCodebook,
+                                               ueCodebook);
+    }
+    return true;
+}
 
-            gnbSpectrumPhy->GetBeamManager()->SetSector(txSector, txTheta);
-            PhasedArrayModel::ComplexVector txW =
-                gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+BeamformingVectorPair
+CellScanBeamforming::SelectBeamPair(const SearchInput& input, bool log) const
+{
+    const Codebook& gnbCodebook = *input.m_gnbCodebook;
+    const Codebook& ueCodebook = *input.m_ueCodebook;
 
-            if (maxTxW.GetSize() == 0)
-            {
-                maxTxW = txW; // initialize maxTxW
-            }
+    std::vector<BeamPairSearch::GridPosition> gnbGrid;
+    std::vector<BeamPairSearch::GridPosition> ueGrid;
+    for (const auto& entry : gnbCodebook)
+    {
+        gnbGrid.push_back(entry.m_position);
+    }
+    for (const auto& entry : ueCodebook)
+    {
+        ueGrid.push_back(entry.m_position);
+    }
 
-            for (double rxTheta = 60; rxTheta < 121;
-                 rxTheta = static_cast<uint16_t>(rxTheta + m_beamSearchAngleStep))
+    BeamPairSearch::Stats stats;
+    BeamPairSearch::Result result = BeamPairSearch::Search(
+        gnbGrid,
+        ueGrid,
+        {m_hierarchicalSearch,
+         m_coarseStepFactor,
+         m_numCandidates,
+         m_checkHierarchicalSearch,
+         log},
+        [&](size_t gnbBeam, size_t ueBeam) {
+            double power = input.m_score(gnbBeam, ueBeam);
+            if (!log)
             {
-                for (uint16_t rxSector = 0; rxSector <= numRowsRx; rxSector++)
-                {
-                    NS_ASSERT(rxSector < UINT16_MAX);
-
-                    ueSpectrumPhy->GetBeamManager()->SetSector(rxSector, rxTheta);
-                    PhasedArrayModel::ComplexVector rxW =
-                        ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+                return power;
+            }
 
-                    if (maxRxW.GetSize() == 0)
-                    {
-                        maxRxW = rxW; // initialize maxRxW
-                    }
+            const CodebookEntry& tx = gnbCodebook[gnbBeam];
+            const CodebookEntry& rx = ueCodebook[ueBeam];
+            NS_LOG_LOGIC(" Rx power: "
+                         << power << "txTheta " << tx.m_theta << " rxTheta " << rx.m_theta
+                         << " tx sector "
+                         << (M_PI * static_cast<double>(tx.m_sector) /
+                                 static_cast<double>(input.m_gnbNumRows) -
+                             0.5 * M_PI) /
+                                (M_PI)*180
+                         << " rx sector "
+                         << (M_PI * static_cast<double>(rx.m_sector) /
+                                 static_cast<double>(input.m_ueNumRows) -
+                             0.5 * M_PI) /
+                                (M_PI)*180);
+            return power;
+        },
+        &stats);
 
-                    NS_ABORT_MSG_IF(txW.GetSize() == 0 || rxW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
+    {
+        std::lock_guard<std::mutex> lock(m_searchStatsMutex);
+        m_searchStats += stats;
+    }
 
-                    Ptr<SpectrumValue> rxPsd =
-                        gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
-                            fakeParams,
-                            gnbSpectrumPhy->GetMobility(),
-                            ueSpectrumPhy->GetMobility(),
-                            gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
-                    double power = Sum(*rxPsd) / nbands;
-
-                    NS_LOG_LOGIC(
-                        " Rx power: "
-                        << power << "txTheta " << txTheta << " rxTheta " << rxTheta << " tx sector "
-                        << (M_PI * static_cast<double>(txSector) / static_cast<double>(txNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180
-                        << " rx sector "
-                        << (M_PI * static_cast<double>(rxSector) / static_cast<double>(rxNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180);
-
-                    if (max < power)
-                    {
-                        max = power;
-                        maxTxSector = txSector;
-                        maxRxSector = rxSector;
-                        maxTxTheta = txTheta;
-                        maxRxTheta = rxTheta;
-                        maxTxW = txW;
-                        maxRxW = rxW;
-                    }
-                }
-            }
-        }
+    double maxTxTheta = 0;
+    double maxRxTheta = 0;
+    uint16_t maxTxSector = 0;
+    uint16_t maxRxSector = 0;
+    PhasedArrayModel::ComplexVector maxTxW = gnbCodebook.front().m_w;
+    PhasedArrayModel::ComplexVector maxRxW = ueCodebook.front().m_w;
+    if (result.m_found)
+    {
+        const CodebookEntry& tx = gnbCodebook[result.m_gnbBeam];
+        const CodebookEntry& rx = ueCodebook[result.m_ueBeam];
+        maxTxSector = tx.m_sector;
+        maxRxSector = rx.m_sector;
+        maxTxTheta = tx.m_theta;
+        maxRxTheta = rx.m_theta;
+        maxTxW = tx.m_w;
+        maxRxW = rx.m_w;
     }
 
+    NS_ASSERT(maxTxW.GetSize() && maxRxW.GetSize());
+
     BeamformingVector gnbBfv =
         BeamformingVector(std::make_pair(maxTxW, BeamId(maxTxSector, maxTxTheta)));
     BeamformingVector ueBfv =
         BeamformingVector(std::make_pair(maxRxW, BeamId(maxRxSector, maxRxTheta)));
+    return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
+}
 
-    NS_LOG_DEBUG(
-        "Beamforming vectors for gNB with node id: "
-        << gnbSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
-        << " and UE with node id: " << ueSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
-        << " are txTheta " << maxTxTheta << " rxTheta " << maxRxTheta << " tx sector "
-        << (M_PI * static_cast<double>(maxTxSector) / static_cast<double>(txNumRows) - 0.5 * M_PI) /
-               (M_PI)*180
-        << " rx sector "
-        << (M_PI * static_cast<double>(maxRxSector) / static_cast<double>(rxNumRows) - 0.5 * M_PI) /
-               (M_PI)*180);
+BeamformingVectorPair
+CellScanBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                           const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    SearchInput input;
+    PrepareSearch(gnbSpectrumPhy, ueSpectrumPhy, false, &input);
+    BeamformingVectorPair bfPair = SelectBeamPair(input, true);
+
+    double maxTxTheta = bfPair.first.second.GetElevation();
+    double maxRxTheta = bfPair.second.second.GetElevation();
+    uint16_t maxTxSector = bfPair.first.second.GetSector();
+    uint16_t maxRxSector = bfPair.second.second.GetSector();
+    NS_LOG_DEBUG("Beamforming vectors for gNB with node id: "
+                 << gnbSpectrumPhy->GetMobility()->GetObject<Node>()->GetId()
+                 << " and UE with node id: "
+                 << ueSpectrumPhy->GetMobility()->GetObject<Node>()->GetId() << " are txTheta "
+                 << maxTxTheta << " rxTheta " << maxRxTheta << " tx sector "
+                 << (M_PI * static_cast<double>(maxTxSector) /
+                         static_cast<double>(input.m_gnbNumRows) -
+                     0.5 * M_PI) /
+                        (M_PI)*180
+                 << " rx sector "
+                 << (M_PI * static_cast<double>(maxRxSector) /
+                         static_cast<double>(input.m_ueNumRows) -
+                     0.5 * M_PI) /
+                        (M_PI)*180);
+
+    return bfPair;
+}
 
-    NS_ASSERT(maxTxW.GetSize() && maxRxW.GetSize());
+IdealBeamformingAlgorithm::BeamformingTask
+CellScanBeamforming::PrepareBeamformingTask(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                            const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+{
+    NS_LOG_FUNCTION(this);
 
-    return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
+    // Only the search on the channel matrix works on its own data: through the
+    // spectrum model, each beam pair has to be set on the antennas
+    SearchInput input;
+    if (!PrepareSearch(gnbSpectrumPhy, ueSpectrumPhy, true, &input))
+    {
+        return nullptr;
+    }
+    return [this, input]() { return SelectBeamPair(input, false); };
 }
 
 TypeId
 CellScanBeamformingAzimuthZenith::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::CellScanBeamformingAzimuthZenith")
-                            .SetParent<IdealBeamformingAlgorithm>()
-                            .AddConstructor<CellScanBeamformingAzimuthZenith>();
+    static TypeId tid =
+        TypeId("ns3::CellScanBeamformingAzimuthZenith")
+            .SetParent<IdealBeamformingAlgorithm>()
+            .AddConstructor<CellScanBeamformingAzimuthZenith>()
+            .AddAttribute(
+                "HierarchicalSearch",
+                "If true, the beam pairs of a coarse codebook are evaluated first, and "
+                "then the search is refined around the best ones. If false, every "
+                "beam pair is evaluated",
+                BooleanValue(false),
+                MakeBooleanAccessor(&CellScanBeamformingAzimuthZenith::m_hierarchicalSearch),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "CoarseStepFactor",
+                "Number of azimuths (and of zeniths) between two beams of the coarse "
+                "codebook of the hierarchical search",
+                UintegerValue(2),
+                MakeUintegerAccessor(&CellScanBeamformingAzimuthZenith::m_coarseStepFactor),
+                MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute("NumCandidates",
+                          "Number of coarse beam pairs refined by the hierarchical search",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&CellScanBeamformingAzimuthZenith::m_numCandidates),
+                          MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute(
+                "CheckHierarchicalSearch",
+                "If true, the hierarchical search is compared with the exhaustive one "
+                "(evaluating every beam pair), to collect statistics of agreement",
+                BooleanValue(false),
+                MakeBooleanAccessor(&CellScanBeamformingAzimuthZenith::m_checkHierarchicalSearch),
+                MakeBooleanChecker());
 
     return tid;
 }
 
+BeamPairSearch::Stats
+CellScanBeamformingAzimuthZenith::GetBeamSearchStats() const
+{
+    std::lock_guard<std::mutex> lock(m_searchStatsMutex);
+    return m_searchStats;
+}
+
 BeamformingVectorPair
 CellScanBeamformingAzimuthZenith::GetBeamformingVectors(
     const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
@@ -265,85 +680,76 @@ CellScanBeamformingAzimuthZenith::GetBeamformingVectors(
     Ptr<SpectrumSignalParameters> fakeParams = Create<SpectrumSignalParameters>();
     fakeParams->psd = fakePsd->Copy();
 
-    double max = 0;
-    double maxTxAzimuth = 0;
-    double maxRxAzimuth = 0;
-    double maxTxZenith = 0;
-    double maxRxZenith = 0;
-    PhasedArrayModel::ComplexVector maxTxW;
-    PhasedArrayModel::ComplexVector maxRxW;
-
-    UintegerValue uintValue;
-    gnbSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-    ueSpectrumPhy->GetAntenna()->GetAttribute("NumRows", uintValue);
-
     NS_ASSERT(gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements() &&
               ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetNumberOfElements());
 
-    for (uint i = 0; i < m_azimuth.size(); i++)
+    // One beam for each azimuth and zenith, azimuth major
+    Ptr<const UniformPlanarArray> gnbArray = gnbSpectrumPhy->GetBeamManager()->GetAntenna();
+    Ptr<const UniformPlanarArray> ueArray = ueSpectrumPhy->GetBeamManager()->GetAntenna();
+    std::vector<BeamPairSearch::GridPosition> grid;
+    std::vector<PhasedArrayModel::ComplexVector> gnbCodebook;
+    std::vector<PhasedArrayModel::ComplexVector> ueCodebook;
+    for (uint16_t i = 0; i < m_azimuth.size(); i++)
     {
-        double azimuthTx = m_azimuth[i];
-        for (uint ii = 0; ii < m_zenith.size(); ii++)
+        for (uint16_t ii = 0; ii < m_zenith.size(); ii++)
         {
-            double zenithTx = m_zenith[ii];
-
-            gnbSpectrumPhy->GetBeamManager()->SetSectorAz(azimuthTx, zenithTx);
-            PhasedArrayModel::ComplexVector txW =
-                gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-            if (maxTxW.GetSize() == 0)
-            {
-                maxTxW = txW; // initialize maxTxW
-            }
-
-            for (uint iii = 0; iii < m_azimuth.size(); iii++)
-            {
-                double azimuthRx = m_azimuth[iii];
-                for (uint iiii = 0; iiii < m_zenith.size(); iiii++)
-                {
-                    double zenithRx = m_zenith[iiii];
-
-                    ueSpectrumPhy->GetBeamManager()->SetSectorAz(azimuthRx, zenithRx);
-                    PhasedArrayModel::ComplexVector rxW =
-                        ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    if (maxRxW.GetSize() == 0)
-                    {
-                        maxRxW = rxW; // initialize maxRxW
-                    }
+            grid.push_back({i, ii});
+            gnbCodebook.push_back(CreateDirectionalBfvAz(gnbArray, m_azimuth[i], m_zenith[ii]));
+            ueCodebook.push_back(CreateDirectionalBfvAz(ueArray, m_azimuth[i], m_zenith[ii]));
+            NS_ABORT_MSG_IF(gnbCodebook.back().GetSize() == 0 || ueCodebook.back().GetSize() == 0,
+                            "Beamforming vectors must be initialized in "
+                            "order to calculate the long term matrix.");
+        }
+    }
 
-                    NS_ABORT_MSG_IF(txW.GetSize() == 0 || rxW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in "
-                                    "order to calculate the long term matrix.");
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    BeamPairSearch::Stats stats;
+    BeamPairSearch::Result result = BeamPairSearch::Search(
+        grid,
+        grid,
+        {m_hierarchicalSearch, m_coarseStepFactor, m_numCandidates, m_checkHierarchicalSearch},
+        [&](size_t gnbBeam, size_t ueBeam) {
+            gnbAntenna->SetBeamformingVector(gnbCodebook[gnbBeam]);
+            ueAntenna->SetBeamformingVector(ueCodebook[ueBeam]);
+
+            Ptr<SpectrumValue> rxPsd = gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
+                fakeParams,
+                gnbSpectrumPhy->GetMobility(),
+                ueSpectrumPhy->GetMobility(),
+                gnbAntenna,
+                ueAntenna);
 
-                    Ptr<SpectrumValue> rxPsd =
-                        gnbThreeGppSpectrumPropModel->CalcRxPowerSpectralDensity(
-                            fakeParams,
-                            gnbSpectrumPhy->GetMobility(),
-                            ueSpectrumPhy->GetMobility(),
-                            gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
+            size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
+            double power = Sum(*rxPsd) / nbands;
 
-                    size_t nbands = rxPsd->GetSpectrumModel()->GetNumBands();
-                    double power = Sum(*rxPsd) / nbands;
+            NS_LOG_LOGIC(" Rx power: " << power << " azimuthTx " << m_azimuth[grid[gnbBeam].m_row]
+                                       << " zenithTx " << m_zenith[grid[gnbBeam].m_col]
+                                       << " azimuthRx " << m_azimuth[grid[ueBeam].m_row]
+                                       << " zenithRx " << m_zenith[grid[ueBeam].m_col]);
+            return power;
+        },
+        &stats);
 
-                    NS_LOG_LOGIC(" Rx power: " << power << " azimuthTx " << azimuthTx
-                                               << " zenithTx " << zenithTx << " azimuthRx "
-                                               << azimuthRx << " zenithRx " << zenithRx);
+    {
+        std::lock_guard<std::mutex> lock(m_searchStatsMutex);
+        m_searchStats += stats;
+    }
 
-                    if (max < power)
-                    {
-                        max = power;
-                        maxTxAzimuth = azimuthTx;
-                        maxRxAzimuth = azimuthRx;
-                        maxTxZenith = zenithTx;
-                        maxRxZenith = zenithRx;
-                        maxTxW = txW;
-                        maxRxW = rxW;
-                    }
-                }
-            }
-        }
+    double maxTxAzimuth = 0;
+    double maxRxAzimuth = 0;
+    double maxTxZenith = 0;
+    double maxRxZenith = 0;
+    PhasedArrayModel::ComplexVector maxTxW = gnbCodebook.front();
+    PhasedArrayModel::ComplexVector maxRxW = ueCodebook.front();
+    if (result.m_found)
+    {
+        maxTxAzimuth = m_azimuth[grid[result.m_gnbBeam].m_row];
+        maxTxZenith = m_zenith[grid[result.m_gnbBeam].m_col];
+        maxRxAzimuth = m_azimuth[grid[result.m_ueBeam].m_row];
+        maxRxZenith = m_zenith[grid[result.m_ueBeam].m_col];
+        maxTxW = gnbCodebook[result.m_gnbBeam];
+        maxRxW = ueCodebook[result.m_ueBeam];
     }
 
     BeamformingVector gnbBfv = BeamformingVector(
@@ -612,20 +1018,228 @@ DirectPathQuasiOmniBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>&
 TypeId
 OptimalCovMatrixBeamforming::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::OptimalCovMatrixBeamforming")
-                            .SetParent<IdealBeamformingAlgorithm>()
-                            .AddConstructor<OptimalCovMatrixBeamforming>();
+    static TypeId tid =
+        TypeId("ns3::OptimalCovMatrixBeamforming")
+            .SetParent<IdealBeamformingAlgorithm>()
+            .AddConstructor<OptimalCovMatrixBeamforming>()
+            .AddAttribute("MaxIterations",
+                          "Maximum number of iterations of the power iteration that computes "
+                          "the dominant eigenvector of the covariance matrices",
+                          UintegerValue(50),
+                          MakeUintegerAccessor(&OptimalCovMatrixBeamforming::m_maxIterations),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Tolerance",
+                          "The power iteration stops when the relative change of the "
+                          "eigenvalue estimate between two iterations is below this value",
+                          DoubleValue(1e-6),
+                          MakeDoubleAccessor(&OptimalCovMatrixBeamforming::m_tolerance),
+                          MakeDoubleChecker<double>(0));
 
     return tid;
 }
 
+bool
+OptimalCovMatrixBeamforming::PowerIteration(const MatrixProduct& product,
+                                            std::vector<std::complex<double>>* v,
+                                            double* eigenvalue) const
+{
+    NS_LOG_FUNCTION(this);
+
+    double norm = 0;
+    for (const auto& x : *v)
+    {
+        norm += std::norm(x);
+    }
+    if (norm == 0)
+    {
+        return false;
+    }
+    norm = std::sqrt(norm);
+    for (auto& x : *v)
+    {
+        x /= norm;
+    }
+
+    // With |v| = 1, |Av| converges to the dominant eigenvalue of A
+    double lambda = 0;
+    for (uint32_t iteration = 0; iteration < m_maxIterations; iteration++)
+    {
+        std::vector<std::complex<double>> next = product(*v);
+        norm = 0;
+        for (const auto& x : next)
+        {
+            norm += std::norm(x);
+        }
+        norm = std::sqrt(norm);
+        if (norm == 0)
+        {
+            return false;
+        }
+        for (auto& x : next)
+        {
+            x /= norm;
+        }
+        *v = std::move(next);
+
+        bool converged = std::abs(norm - lambda) <= m_tolerance * norm;
+        lambda = norm;
+        if (converged)
+        {
+            NS_LOG_LOGIC("Power iteration converged after " << iteration + 1 << " iterations");
+            break;
+        }
+    }
+
+    *eigenvalue = lambda;
+    return true;
+}
+
 BeamformingVectorPair
-OptimalCovMatrixBeamforming::GetBeamformingVectors(
-    [[maybe_unused]] const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
-    [[maybe_unused]] const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
+OptimalCovMatrixBeamforming::GetBeamformingVectors(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                                   const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const
 {
     NS_LOG_FUNCTION(this);
-    return BeamformingVectorPair();
+    NS_ABORT_MSG_IF(gnbSpectrumPhy == nullptr || ueSpectrumPhy == nullptr,
+                    "Something went wrong, gnb or UE PHY layer not set.");
+
+    Ptr<ThreeGppSpectrumPropagationLossModel> threeGppSplm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            gnbSpectrumPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    NS_ABORT_MSG_IF(threeGppSplm == nullptr,
+                    "OptimalCovMatrixBeamforming needs the channel matrix, i.e., a "
+                    "ThreeGppSpectrumPropagationLossModel");
+
+    Ptr<MobilityModel> gnbMob = gnbSpectrumPhy->GetMobility();
+    Ptr<MobilityModel> ueMob = ueSpectrumPhy->GetMobility();
+    Ptr<const UniformPlanarArray> gnbArray = gnbSpectrumPhy->GetBeamManager()->GetAntenna();
+    Ptr<const UniformPlanarArray> ueArray = ueSpectrumPhy->GetBeamManager()->GetAntenna();
+    Ptr<PhasedArrayModel> gnbAntenna = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<PhasedArrayModel> ueAntenna = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+
+    // The direct path vectors are the starting point of the power iteration, and
+    // the result if the channel has no power
+    PhasedArrayModel::ComplexVector gnbDirectPath = CreateDirectPathBfv(gnbMob, ueMob, gnbArray);
+    PhasedArrayModel::ComplexVector ueDirectPath = CreateDirectPathBfv(ueMob, gnbMob, ueArray);
+
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+        threeGppSplm->GetChannelModel()->GetChannel(gnbMob, ueMob, gnbAntenna, ueAntenna);
+
+    // G(ue, gnb, cluster) is H, or its transpose if the gNB is the u-node. As in
+    // ThreeGppSpectrumPropagationLossModel, the gain of the cluster c is u^T G_c w,
+    // where w and u are the gNB and UE beamforming vectors
+    const MatrixBasedChannelModel::Complex3DVector& h = channelMatrix->m_channel;
+    bool isReverse = channelMatrix->IsReverse(gnbAntenna->GetId(), ueAntenna->GetId());
+    size_t gnbSize = isReverse ? h.GetNumRows() : h.GetNumCols();
+    size_t ueSize = isReverse ? h.GetNumCols() : h.GetNumRows();
+    size_t numCluster = h.GetNumPages();
+    NS_ASSERT(gnbDirectPath.GetSize() == gnbSize && ueDirectPath.GetSize() == ueSize);
+    auto g = [&h, isReverse](size_t ue, size_t gnb, size_t cIndex) {
+        return isReverse ? h(gnb, ue, cIndex) : h(ue, gnb, cIndex);
+    };
+
+    // gNB vector: dominant eigenvector of the transmit covariance sum_c G_c^H G_c,
+    // multiplied by a vector without building the matrix
+    MatrixProduct txCovProduct = [&](const std::vector<std::complex<double>>& v) {
+        std::vector<std::complex<double>> out(gnbSize, 0.0);
+        for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+            for (size_t ue = 0; ue < ueSize; ue++)
+            {
+                std::complex<double> y(0, 0);
+                for (size_t gnb = 0; gnb < gnbSize; gnb++)
+                {
+                    y += g(ue, gnb, cIndex) * v[gnb];
+                }
+                for (size_t gnb = 0; gnb < gnbSize; gnb++)
+                {
+                    out[gnb] += std::conj(g(ue, gnb, cIndex)) * y;
+                }
+            }
+        }
+        return out;
+    };
+    std::vector<std::complex<double>> w(gnbSize);
+    for (size_t gnb = 0; gnb < gnbSize; gnb++)
+    {
+        w[gnb] = gnbDirectPath[gnb];
+    }
+    double txEigenvalue = 0;
+    if (!PowerIteration(txCovProduct, &w, &txEigenvalue))
+    {
+        NS_LOG_WARN("The channel has no power, using the direct path beamforming vectors");
+        return BeamformingVectorPair(
+            std::make_pair(std::make_pair(gnbDirectPath, BeamId::GetEmptyBeamId()),
+                           std::make_pair(ueDirectPath, BeamId::GetEmptyBeamId())));
+    }
+
+    // UE vector: matched filter to the effective channels y_c = G_c w, i.e., the
+    // dominant eigenvector of sum_c conj(y_c) y_c^T, starting from the strongest cluster
+    std::vector<std::complex<double>> y(numCluster * ueSize, 0.0);
+    size_t strongest = 0;
+    double strongestPower = -1;
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        double power = 0;
+        for (size_t ue = 0; ue < ueSize; ue++)
+        {
+            std::complex<double>& yc = y[cIndex * ueSize + ue];
+            for (size_t gnb = 0; gnb < gnbSize; gnb++)
+            {
+                yc += g(ue, gnb, cIndex) * w[gnb];
+            }
+            power += std::norm(yc);
+        }
+        if (power > strongestPower)
+        {
+            strongestPower = power;
+            strongest = cIndex;
+        }
+    }
+    MatrixProduct rxCovProduct = [&](const std::vector<std::complex<double>>& v) {
+        std::vector<std::complex<double>> out(ueSize, 0.0);
+        for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+        {
+            std::complex<double> gain(0, 0);
+            for (size_t ue = 0; ue < ueSize; ue++)
+            {
+                gain += y[cIndex * ueSize + ue] * v[ue];
+            }
+            for (size_t ue = 0; ue < ueSize; ue++)
+            {
+                out[ue] += std::conj(y[cIndex * ueSize + ue]) * gain;
+            }
+        }
+        return out;
+    };
+    std::vector<std::complex<double>> u(ueSize);
+    for (size_t ue = 0; ue < ueSize; ue++)
+    {
+        u[ue] = std::conj(y[strongest * ueSize + ue]);
+    }
+    double rxEigenvalue = 0;
+    [[maybe_unused]] bool found = PowerIteration(rxCovProduct, &u, &rxEigenvalue);
+    NS_ASSERT(found);
+
+    NS_LOG_DEBUG("Beamforming vectors for gNB with node id: "
+                 << gnbMob->GetObject<Node>()->GetId()
+                 << " and UE with node id: " << ueMob->GetObject<Node>()->GetId()
+                 << " have TX covariance eigenvalue " << txEigenvalue << " and gain "
+                 << rxEigenvalue);
+
+    PhasedArrayModel::ComplexVector gnbW(gnbSize);
+    for (size_t gnb = 0; gnb < gnbSize; gnb++)
+    {
+        gnbW[gnb] = w[gnb];
+    }
+    PhasedArrayModel::ComplexVector ueW(ueSize);
+    for (size_t ue = 0; ue < ueSize; ue++)
+    {
+        ueW[ue] = u[ue];
+    }
+
+    BeamformingVector gnbBfv = BeamformingVector(std::make_pair(gnbW, BeamId::GetEmptyBeamId()));
+    BeamformingVector ueBfv = BeamformingVector(std::make_pair(ueW, BeamId::GetEmptyBeamId()));
+    return BeamformingVectorPair(std::make_pair(gnbBfv, ueBfv));
 }
 
 } // namespace ns3
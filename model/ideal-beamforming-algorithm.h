@@ -8,15 +8,23 @@
 #define SRC_NR_MODEL_IDEAL_BEAMFORMING_ALGORITHM_H_
 
 #include "beam-id.h"
+#include "beam-pair-search.h"
 #include "beamforming-vector.h"
 
 #include <ns3/object.h>
 
+#include <complex>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <vector>
+
 namespace ns3
 {
 
 class SpectrumModel;
 class SpectrumValue;
+struct SpectrumSignalParameters;
 class NrGnbNetDevice;
 class NrUeNetDevice;
 class NrSpectrumPhy;
@@ -48,11 +56,55 @@ class IdealBeamformingAlgorithm : public Object
     virtual BeamformingVectorPair GetBeamformingVectors(
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const = 0;
+
+    /**
+     * \brief Computation of the beamforming vectors of a pair of devices that
+     * only uses data gathered in advance, and that can therefore run on any thread
+     */
+    using BeamformingTask = std::function<BeamformingVectorPair()>;
+
+    /**
+     * \brief Gather, in the simulation thread, everything that is needed to
+     * compute the beamforming vectors of a pair of devices (e.g., the channel
+     * matrix), and return the computation
+     *
+     * The returned task must not modify the devices (e.g., their antennas) nor
+     * any other simulation object, so that the tasks of different pairs can run
+     * concurrently. The default implementation returns an empty task, which means
+     * that the algorithm does not support it, and GetBeamformingVectors() has
+     * to be called in the simulation thread instead.
+     *
+     * \param [in] gnbSpectrumPhy gNb spectrum phy instance
+     * \param [in] ueSpectrumPhy UE spectrum phy instance
+     * \return the task, or an empty task
+     */
+    virtual BeamformingTask PrepareBeamformingTask(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                                   const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const;
 };
 
 /**
  * \ingroup gnb-phy
  * \brief The CellScanBeamforming class
+ *
+ * The gNB and the UE codebooks (one beam for each elevation and sector) are
+ * generated once per antenna configuration and cached. When the channel uses
+ * a ThreeGppSpectrumPropagationLossModel, the beam pairs are scored directly on
+ * the channel matrix H (u x s x clusters), fetched once per pair of devices:
+ * the products of the u-node codebook with H are computed once per u-node
+ * beam, and each pair only adds the s-node weights and the per-RB
+ * Doppler/delay terms, which are also computed once per pair of devices. The
+ * score of each beam pair is the same average RX power that the spectrum
+ * propagation loss model would return, and the pairs are evaluated in the same
+ * order, so the selected pair does not change. The first pair is also evaluated
+ * through the spectrum propagation loss model, and if the two values do not
+ * match (e.g., because the model is a subclass that changes the RX PSD), the
+ * search falls back to evaluate every pair through the model.
+ *
+ * By default every beam pair is evaluated. With the attribute HierarchicalSearch,
+ * the search is done in two stages as described in BeamPairSearch: the beams are
+ * placed in a grid (elevation, sector), the first stage evaluates one beam every
+ * CoarseStepFactor positions, and the second stage refines around the best
+ * NumCandidates coarse pairs. The pairs that are not visited are not computed.
  */
 class CellScanBeamforming : public IdealBeamformingAlgorithm
 {
@@ -73,6 +125,11 @@ class CellScanBeamforming : public IdealBeamformingAlgorithm
      */
     void SetBeamSearchAngleStep(double beamSearchAngleStep);
 
+    /**
+     * \return the statistics of the beam searches done so far
+     */
+    BeamPairSearch::Stats GetBeamSearchStats() const;
+
     /**
      * \brief constructor
      */
@@ -94,13 +151,134 @@ class CellScanBeamforming : public IdealBeamformingAlgorithm
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
 
+    /**
+     * \brief Prepare the search on the channel matrix. If the channel does not
+     * allow it (see the class description), the task is empty.
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE device
+     * \return the task that searches the beam pair
+     */
+    BeamformingTask PrepareBeamformingTask(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                                           const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
+
   private:
-    double m_beamSearchAngleStep{30}; //!< the beam search angle step attribute
+    /**
+     * \brief A beam of a codebook
+     */
+    struct CodebookEntry
+    {
+        uint16_t m_sector{0};                    //!< Sector of the beam
+        double m_theta{0};                       //!< Elevation of the beam
+        BeamPairSearch::GridPosition m_position; //!< Elevation index and sector of the beam
+        PhasedArrayModel::ComplexVector m_w;     //!< Beamforming vector of the beam
+    };
+
+    /**
+     * \brief The beams swept for one device, in the order of the search
+     */
+    using Codebook = std::vector<CodebookEntry>;
+
+    /**
+     * \brief What the search of the beam pair needs
+     */
+    struct SearchInput
+    {
+        const Codebook* m_gnbCodebook{nullptr}; //!< The gNB codebook
+        const Codebook* m_ueCodebook{nullptr};  //!< The UE codebook
+        BeamPairSearch::ScoreFunction m_score;  //!< The score of each beam pair
+        uint32_t m_gnbNumRows{0};               //!< Number of rows of the gNB antenna
+        uint32_t m_ueNumRows{0};                //!< Number of rows of the UE antenna
+    };
+
+    /**
+     * \brief Gather the codebooks and the score function of a pair of devices
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [in] channelMatrixOnly if true, do not fall back to the spectrum
+     * propagation loss model
+     * \param [out] input the codebooks and the score function
+     * \return false if channelMatrixOnly is true and the channel does not allow
+     * the computation on the channel matrix
+     */
+    bool PrepareSearch(const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+                       const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+                       bool channelMatrixOnly,
+                       SearchInput* input) const;
+
+    /**
+     * \brief Search the best beam pair
+     * \param input the codebooks and the score function
+     * \param log false if the search runs on a thread of NrParallelFor, where
+     * NS_LOG can not be used
+     * \return the beamforming vector pair of the gNB and the UE
+     */
+    BeamformingVectorPair SelectBeamPair(const SearchInput& input, bool log) const;
+
+    /**
+     * \brief Get the codebook of an antenna, generating it at the first use
+     * \param antenna the antenna array
+     * \param truncateTheta if true, the elevation is truncated to an integer
+     * at each step (as historically done for the UE beams)
+     * \return the codebook for the antenna configuration
+     */
+    const Codebook& GetCodebook(const Ptr<const UniformPlanarArray>& antenna,
+                                bool truncateTheta) const;
+
+    /**
+     * \brief Get the function that computes the average RX power of a beam pair
+     * on the channel matrix
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [in] params the signal parameters carrying the TX PSD
+     * \param [in] gnbCodebook the gNB codebook
+     * \param [in] ueCodebook the UE codebook
+     * \return the score function, or an empty function if the channel does not
+     * allow this computation
+     */
+    BeamPairSearch::ScoreFunction GetChannelMatrixScore(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+        const Ptr<const SpectrumSignalParameters>& params,
+        const Codebook& gnbCodebook,
+        const Codebook& ueCodebook) const;
+
+    /**
+     * \brief Get the function that computes the average RX power of a beam pair
+     * through the spectrum propagation loss model
+     * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
+     * \param [in] ueSpectrumPhy the spectrum phy of the UE
+     * \param [in] params the signal parameters carrying the TX PSD
+     * \param [in] gnbCodebook the gNB codebook
+     * \param [in] ueCodebook the UE codebook
+     * \return the score function
+     */
+    BeamPairSearch::ScoreFunction GetSpectrumModelScore(
+        const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
+        const Ptr<NrSpectrumPhy>& ueSpectrumPhy,
+        const Ptr<const SpectrumSignalParameters>& params,
+        const Codebook& gnbCodebook,
+        const Codebook& ueCodebook) const;
+
+    double m_beamSearchAngleStep{30};            //!< the beam search angle step attribute
+    bool m_hierarchicalSearch{false};            //!< the HierarchicalSearch attribute
+    uint16_t m_coarseStepFactor{2};              //!< the CoarseStepFactor attribute
+    uint16_t m_numCandidates{2};                 //!< the NumCandidates attribute
+    bool m_checkHierarchicalSearch{false};       //!< the CheckHierarchicalSearch attribute
+    mutable BeamPairSearch::Stats m_searchStats; //!< Statistics of the beam searches
+    mutable std::mutex m_searchStatsMutex;       //!< Protects m_searchStats
+    mutable std::map<std::vector<double>, Codebook>
+        m_codebooks; //!< Codebooks, indexed by antenna configuration and angle step
+
+    friend class NrChannelMatrixScoreTestCase;
 };
 
 /**
  * \ingroup gnb-phy
  * \brief The CellScanBeamformingAzimuthZenith class
+ *
+ * Both devices sweep a beam for each azimuth and zenith. As in
+ * CellScanBeamforming, the attribute HierarchicalSearch enables a two stage
+ * search, on the grid (azimuth, zenith).
  */
 class CellScanBeamformingAzimuthZenith : public IdealBeamformingAlgorithm
 {
@@ -111,6 +289,11 @@ class CellScanBeamformingAzimuthZenith : public IdealBeamformingAlgorithm
      */
     static TypeId GetTypeId();
 
+    /**
+     * \return the statistics of the beam searches done so far
+     */
+    BeamPairSearch::Stats GetBeamSearchStats() const;
+
     /**
      * \brief constructor
      */
@@ -135,6 +318,12 @@ class CellScanBeamformingAzimuthZenith : public IdealBeamformingAlgorithm
   private:
     std::vector<double> m_azimuth{-56.25, -33.75, -11.25, 11.25, 33.75, 56.25};
     std::vector<double> m_zenith{112.5, 157.5};
+    bool m_hierarchicalSearch{false};            //!< the HierarchicalSearch attribute
+    uint16_t m_coarseStepFactor{2};              //!< the CoarseStepFactor attribute
+    uint16_t m_numCandidates{2};                 //!< the NumCandidates attribute
+    bool m_checkHierarchicalSearch{false};       //!< the CheckHierarchicalSearch attribute
+    mutable BeamPairSearch::Stats m_searchStats; //!< Statistics of the beam searches
+    mutable std::mutex m_searchStatsMutex;       //!< Protects m_searchStats
 };
 
 /**
@@ -264,10 +453,20 @@ class DirectPathQuasiOmniBeamforming : public DirectPathBeamforming
 
 /**
  * \ingroup gnb-phy
- * \brief The OptimalCovMatrixBeamforming class not implemented yet.
- * TODO The idea was to port one of the initial beamforming methods that
- * were implemented in NYU/University of Padova mmwave module.
- * Method is based on a long term covariation matrix.
+ * \brief The OptimalCovMatrixBeamforming class
+ *
+ * The beamforming vectors are computed from the channel matrix H, without
+ * a codebook. The gNB vector is the dominant eigenvector of the transmit
+ * covariance matrix (the sum over the clusters of H^H H), and the UE vector is
+ * the matched filter to the resulting effective channel of each cluster (the
+ * dominant eigenvector of its covariance). The eigenvectors are computed with
+ * the power iteration, multiplying by the covariance matrix without building
+ * it, starting from the direct path vectors. The maximum number of iterations
+ * and the convergence tolerance are set through the attributes MaxIterations
+ * and Tolerance.
+ *
+ * It requires a ThreeGppSpectrumPropagationLossModel, and the returned beams
+ * do not have a beam ID (BeamId::GetEmptyBeamId()).
  */
 class OptimalCovMatrixBeamforming : public IdealBeamformingAlgorithm
 {
@@ -280,8 +479,7 @@ class OptimalCovMatrixBeamforming : public IdealBeamformingAlgorithm
 
     /**
      * \brief Function that generates the beamforming vectors for a pair of
-     * communicating devices by using the direct-path beamforming vector for gNB
-     * and quasi-omni beamforming vector for UEs
+     * communicating devices from the dominant eigenvectors of the channel covariance
      * \param [in] gnbSpectrumPhy the spectrum phy of the gNB
      * \param [in] ueSpectrumPhy the spectrum phy of the UE
      * \return the beamforming vector pair of the gNB and the UE
@@ -289,6 +487,30 @@ class OptimalCovMatrixBeamforming : public IdealBeamformingAlgorithm
     BeamformingVectorPair GetBeamformingVectors(
         const Ptr<NrSpectrumPhy>& gnbSpectrumPhy,
         const Ptr<NrSpectrumPhy>& ueSpectrumPhy) const override;
+
+  private:
+    /**
+     * \brief Function that multiplies a (covariance) matrix by a vector
+     */
+    using MatrixProduct = std::function<std::vector<std::complex<double>>(
+        const std::vector<std::complex<double>>&)>;
+
+    /**
+     * \brief Compute the dominant eigenvector of an Hermitian positive
+     * semi-definite matrix with the power iteration
+     * \param [in] product the product of the matrix by a vector
+     * \param [in,out] v the starting vector, and then the unit-norm eigenvector
+     * \param [out] eigenvalue the estimate of the dominant eigenvalue
+     * \return false if the matrix is null in the direction of the iterations
+     */
+    bool PowerIteration(const MatrixProduct& product,
+                        std::vector<std::complex<double>>* v,
+                        double* eigenvalue) const;
+
+    uint32_t m_maxIterations{50}; //!< the MaxIterations attribute
+    double m_tolerance{1e-6};     //!< the Tolerance attribute
+
+    friend class NrOptimalCovMatrixBeamformingTestCase;
 };
 
 } // namespace ns3
@@ -0,0 +1,55 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-compact-channel-matrix.h"
+
+#include <ns3/log.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrCompactChannelMatrix");
+
+NrCompactChannelMatrix::NrCompactChannelMatrix(
+    const MatrixBasedChannelModel::ChannelMatrix& channelMatrix)
+    : m_numRows(channelMatrix.m_channel.GetNumRows()),
+      m_numCols(channelMatrix.m_channel.GetNumCols()),
+      m_numPages(channelMatrix.m_channel.GetNumPages()),
+      m_antennaPair(channelMatrix.m_antennaPair),
+      m_nodeIds(channelMatrix.m_nodeIds),
+      m_generatedTime(channelMatrix.m_generatedTime)
+{
+    NS_LOG_FUNCTION(this << m_numRows << m_numCols << m_numPages);
+    m_real.resize(m_numRows * m_numCols * m_numPages);
+    m_imag.resize(m_real.size());
+    for (size_t page = 0; page < m_numPages; page++)
+    {
+        for (size_t col = 0; col < m_numCols; col++)
+        {
+            for (size_t row = 0; row < m_numRows; row++)
+            {
+                size_t index = (page * m_numCols + col) * m_numRows + row;
+                const std::complex<double>& h = channelMatrix.m_channel(row, col, page);
+                m_real[index] = static_cast<float>(h.real());
+                m_imag[index] = static_cast<float>(h.imag());
+            }
+        }
+    }
+}
+
+bool
+NrCompactChannelMatrix::IsReverse(uint32_t aId, uint32_t bId) const
+{
+    uint32_t sId = m_antennaPair.first;
+    uint32_t uId = m_antennaPair.second;
+    NS_ASSERT_MSG((sId == aId && uId == bId) || (sId == bId && uId == aId),
+                  "This channel matrix does not represent the channel among the antenna arrays "
+                  "with IDs "
+                      << aId << " and " << bId);
+    return (sId == bId && uId == aId);
+}
+
+} // namespace ns3
@@ -0,0 +1,134 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_COMPACT_CHANNEL_MATRIX_H
+#define NR_COMPACT_CHANNEL_MATRIX_H
+
+#include <ns3/matrix-based-channel-model.h>
+#include <ns3/nstime.h>
+
+#include <complex>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief Single-precision copy of a channel matrix
+ *
+ * It stores the coefficients H(u, s, c) of a MatrixBasedChannelModel::ChannelMatrix
+ * in single precision, with the real and imaginary parts in two separate arrays
+ * (in the same order of the Complex3DVector, u-index first), plus the data needed
+ * to use it in place of the original matrix (the antenna pair, the node ids and
+ * the generation time). It takes half of the memory of a deep copy of the channel
+ * matrix. The coefficients are read back in double precision, so the computations
+ * done with them accumulate in double precision.
+ *
+ * The relative error of each coefficient is at most 2^-24 (about 6e-8) of its
+ * magnitude, which is negligible with respect to the estimation error of the
+ * channel (e.g., the one of the SRS based estimation, with variance 1/SINR).
+ */
+class NrCompactChannelMatrix
+{
+  public:
+    /**
+     * \brief Create an empty matrix
+     */
+    NrCompactChannelMatrix() = default;
+
+    /**
+     * \brief Create a single-precision copy of a channel matrix
+     * \param channelMatrix the channel matrix
+     */
+    explicit NrCompactChannelMatrix(const MatrixBasedChannelModel::ChannelMatrix& channelMatrix);
+
+    /**
+     * \return the number of rows (elements of the u-antenna)
+     */
+    size_t GetNumRows() const
+    {
+        return m_numRows;
+    }
+
+    /**
+     * \return the number of columns (elements of the s-antenna)
+     */
+    size_t GetNumCols() const
+    {
+        return m_numCols;
+    }
+
+    /**
+     * \return the number of pages (clusters)
+     */
+    size_t GetNumPages() const
+    {
+        return m_numPages;
+    }
+
+    /**
+     * \brief Get a coefficient
+     * \param row the row (u-element) index
+     * \param col the column (s-element) index
+     * \param page the page (cluster) index
+     * \return the coefficient, in double precision
+     */
+    std::complex<double> operator()(size_t row, size_t col, size_t page) const
+    {
+        size_t index = (page * m_numCols + col) * m_numRows + row;
+        return {m_real[index], m_imag[index]};
+    }
+
+    /**
+     * \brief Check if the channel matrix has to be transposed for the pair (a, b),
+     * as MatrixBasedChannelModel::ChannelMatrix::IsReverse
+     * \param aId the ID of the antenna array of the node a
+     * \param bId the ID of the antenna array of the node b
+     * \return true if the matrix was generated with b as the s-node and a as the u-node
+     */
+    bool IsReverse(uint32_t aId, uint32_t bId) const;
+
+    /**
+     * \return the node ids (s-node, u-node) of the channel matrix
+     */
+    std::pair<uint32_t, uint32_t> GetNodeIds() const
+    {
+        return m_nodeIds;
+    }
+
+    /**
+     * \return the generation time of the channel matrix
+     */
+    Time GetGeneratedTime() const
+    {
+        return m_generatedTime;
+    }
+
+    /**
+     * \return the memory used by the coefficients, in bytes
+     */
+    size_t GetMemoryUsage() const
+    {
+        return (m_real.capacity() + m_imag.capacity()) * sizeof(float);
+    }
+
+  private:
+    std::vector<float> m_real;                   //!< Real part of the coefficients
+    std::vector<float> m_imag;                   //!< Imaginary part of the coefficients
+    size_t m_numRows{0};                         //!< Number of rows
+    size_t m_numCols{0};                         //!< Number of columns
+    size_t m_numPages{0};                        //!< Number of pages
+    std::pair<uint32_t, uint32_t> m_antennaPair; //!< Antenna ids (s-antenna, u-antenna)
+    std::pair<uint32_t, uint32_t> m_nodeIds;     //!< Node ids (s-node, u-node)
+    Time m_generatedTime;                        //!< Generation time of the channel matrix
+};
+
+} // namespace ns3
+
+#endif /* NR_COMPACT_CHANNEL_MATRIX_H */
@@ -59,6 +59,7 @@ NrGnbPhy::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     delete m_enbCphySapProvider;
+    m_uePhyByRnti.clear();
     NrPhy::DoDispose();
 }
 
@@ -617,7 +618,7 @@ NrGnbPhy::GetTxPower() const
 void
 NrGnbPhy::SetSubChannels(const std::vector<int>& rbIndexVector, uint8_t activeStreams)
 {
-    Ptr<SpectrumValue> txPsd = GetTxPowerSpectralDensity(rbIndexVector, activeStreams);
+    Ptr<const SpectrumValue> txPsd = GetTxPowerSpectralDensity(rbIndexVector, activeStreams);
     NS_ASSERT(txPsd);
     for (std::size_t streamIndex = 0; streamIndex < m_spectrumPhys.size(); streamIndex++)
     {
@@ -876,6 +877,7 @@ NrGnbPhy::RetrievePrepareEncodeCtrlMsgs()
     NS_LOG_FUNCTION(this);
     auto ctrlMsgs = PopCurrentSlotCtrlMsgs();
     ctrlMsgs.merge(RetrieveMsgsFromDCIs(m_currentSlot));
+    WakeUpUePhys(ctrlMsgs);
 
     if (m_netDevice != nullptr)
     {
@@ -891,6 +893,68 @@ NrGnbPhy::RetrievePrepareEncodeCtrlMsgs()
     }
 }
 
+void
+NrGnbPhy::WakeUpUePhys(const std::list<Ptr<NrControlMessage>>& ctrlMsgs)
+{
+    NS_LOG_FUNCTION(this);
+
+    for (const auto& msg : ctrlMsgs)
+    {
+        uint16_t rnti;
+        if (msg->GetMessageType() == NrControlMessage::DL_DCI)
+        {
+            rnti = DynamicCast<NrDlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        }
+        else if (msg->GetMessageType() == NrControlMessage::UL_DCI)
+        {
+            rnti = DynamicCast<NrUlDciMessage>(msg)->GetDciInfoElement()->m_rnti;
+        }
+        else
+        {
+            continue;
+        }
+
+        if (rnti == 0)
+        {
+            for (const auto& ueDev : m_deviceMap)
+            {
+                ueDev->GetPhy(GetBwpId())->WakeUp();
+            }
+        }
+        else
+        {
+            Ptr<NrUePhy> uePhy = GetUePhy(rnti);
+            if (uePhy != nullptr)
+            {
+                uePhy->WakeUp();
+            }
+        }
+    }
+}
+
+Ptr<NrUePhy>
+NrGnbPhy::GetUePhy(uint16_t rnti)
+{
+    NS_LOG_FUNCTION(this << rnti);
+
+    // RNTIs change on (re-)attachment, so verify the cached entry before using it
+    auto it = m_uePhyByRnti.find(rnti);
+    if (it != m_uePhyByRnti.end() && it->second->GetRnti() == rnti)
+    {
+        return it->second;
+    }
+
+    m_uePhyByRnti.clear();
+    for (const auto& ueDev : m_deviceMap)
+    {
+        Ptr<NrUePhy> uePhy = ueDev->GetPhy(GetBwpId());
+        m_uePhyByRnti[uePhy->GetRnti()] = uePhy;
+    }
+
+    it = m_uePhyByRnti.find(rnti);
+    return it != m_uePhyByRnti.end() ? it->second : nullptr;
+}
+
 void
 NrGnbPhy::GenerateAllocationStatistics(const SlotAllocInfo& allocInfo) const
 {
@@ -907,9 +971,7 @@ NrGnbPhy::GenerateAllocationStatistics(const SlotAllocInfo& allocInfo) const
 
     for (const auto& allocation : allocInfo.m_varTtiAllocInfo)
     {
-        uint32_t rbg = std::count(allocation.m_dci->m_rbgBitmask.begin(),
-                                  allocation.m_dci->m_rbgBitmask.end(),
-                                  1);
+        uint32_t rbg = allocation.m_dci->m_rbgBitmask.Count();
 
         // First: Store the RNTI of the UE in the active list
         if (allocation.m_dci->m_rnti != 0)
@@ -1041,6 +1103,7 @@ void
 NrGnbPhy::FillTheEvent()
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_slotVarTtis.empty(), "Variable TTIs of the previous slot not started");
 
     uint8_t lastSymStart = 0;
     bool useNextAllocationSameSymbol = true;
@@ -1059,7 +1122,7 @@ NrGnbPhy::FillTheEvent()
         }
 
         auto varTtiStart = GetSymbolPeriod() * allocation.m_dci->m_symStart;
-        Simulator::Schedule(varTtiStart, &NrGnbPhy::StartVarTti, this, allocation.m_dci);
+        m_slotVarTtis.push_back(allocation.m_dci);
         lastSymStart = allocation.m_dci->m_symStart;
 
         // If the allocation is DL, then don't schedule anything that is in the
@@ -1072,11 +1135,19 @@ NrGnbPhy::FillTheEvent()
         NS_LOG_INFO("Scheduled allocation " << *(allocation.m_dci) << " at " << varTtiStart);
     }
 
+    // One event for each distinct starting symbol; see StartVarTtis
+    if (!m_slotVarTtis.empty())
+    {
+        Simulator::Schedule(GetSymbolPeriod() * m_slotVarTtis.front()->m_symStart,
+                            &NrGnbPhy::StartVarTtis,
+                            this);
+    }
+
     m_currSlotAllocInfo.m_varTtiAllocInfo.clear();
 }
 
 void
-NrGnbPhy::StoreRBGAllocation(std::unordered_map<uint8_t, std::vector<uint8_t>>* map,
+NrGnbPhy::StoreRBGAllocation(std::unordered_map<uint8_t, NrRbBitmask>* map,
                              const std::shared_ptr<DciInfoElementTdma>& dci) const
 {
     NS_LOG_FUNCTION(this);
@@ -1088,12 +1159,7 @@ NrGnbPhy::StoreRBGAllocation(std::unordered_map<uint8_t, std::vector<uint8_t>>*
     }
     else
     {
-        auto& existingRBGBitmask = itAlloc->second;
-        NS_ASSERT(existingRBGBitmask.size() == dci->m_rbgBitmask.size());
-        for (uint32_t i = 0; i < existingRBGBitmask.size(); ++i)
-        {
-            existingRBGBitmask.at(i) = existingRBGBitmask.at(i) | dci->m_rbgBitmask.at(i);
-        }
+        itAlloc->second |= dci->m_rbgBitmask;
     }
 }
 
@@ -1335,7 +1401,7 @@ NrGnbPhy::UlData(const std::shared_ptr<DciInfoElementTdma>& dci)
                             dci->m_ndi.at(streamIndex),
                             dci->m_tbSize.at(streamIndex),
                             dci->m_mcs.at(streamIndex),
-                            FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask),
+                            FromRBGBitmaskToRBBitmask(dci->m_rbgBitmask),
                             dci->m_harqProcess,
                             dci->m_rv.at(streamIndex),
                             false,
@@ -1479,17 +1545,33 @@ NrGnbPhy::StartVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
         varTtiPeriod = UlSrs(dci);
     }
 
-    Simulator::Schedule(varTtiPeriod, &NrGnbPhy::EndVarTti, this, dci);
+    NS_LOG_DEBUG("DCI started at symbol " << static_cast<uint32_t>(dci->m_symStart)
+                                          << " will last for "
+                                          << static_cast<uint32_t>(dci->m_numSym)
+                                          << " symbols, until " << Simulator::Now() + varTtiPeriod);
 }
 
 void
-NrGnbPhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& lastDci)
+NrGnbPhy::StartVarTtis()
 {
-    NS_LOG_FUNCTION(this << Simulator::Now().GetSeconds());
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_slotVarTtis.empty());
+
+    uint8_t symStart = m_slotVarTtis.front()->m_symStart;
+    while (!m_slotVarTtis.empty() && m_slotVarTtis.front()->m_symStart == symStart)
+    {
+        auto dci = m_slotVarTtis.front();
+        m_slotVarTtis.pop_front();
+        StartVarTti(dci);
+    }
 
-    NS_LOG_DEBUG("DCI started at symbol "
-                 << static_cast<uint32_t>(lastDci->m_symStart) << " which lasted for "
-                 << static_cast<uint32_t>(lastDci->m_numSym) << " symbols finished");
+    if (!m_slotVarTtis.empty())
+    {
+        NS_ASSERT(m_slotVarTtis.front()->m_symStart > symStart);
+        Simulator::Schedule(GetSymbolPeriod() * (m_slotVarTtis.front()->m_symStart - symStart),
+                            &NrGnbPhy::StartVarTtis,
+                            this);
+    }
 }
 
 void
@@ -455,8 +455,8 @@ class NrGnbPhy : public NrPhy
      * This time can be a DL CTRL, a DL data, a UL data, or UL CTRL, with
      * any number of symbols (limited to the number of symbols per slot).
      *
-     * At the end of processing, schedule the method EndVarTtti that will finish
-     * the processing of the variable tti allocation.
+     * Nothing has to be done at the end of a variable TTI (the spectrum phy
+     * takes care of ending the transmission), so no event is scheduled for it.
      *
      * \see DlCtrl
      * \see UlCtrl
@@ -466,18 +466,16 @@ class NrGnbPhy : public NrPhy
     void StartVarTti(const std::shared_ptr<DciInfoElementTdma>& dci);
 
     /**
-     * \brief End the processing of a variable tti
-     * \param lastDci the DCI of the variable TTI that has just passed
+     * \brief Start all the variable TTIs of the slot that begin at the current symbol
      *
-     * The end of the variable tti indicates that the allocation has been
-     * transmitted/received. Depending on the variable tti left, the method
-     * will schedule another var tti (StartVarTti()) or will wait until the
-     * end of the slot (EndSlot()).
-     *
-     * \see StartVarTti
-     * \see EndSlot
+     * The variable TTIs of the slot are stored, sorted by starting symbol, in
+     * m_slotVarTtis by FillTheEvent(). This method starts (StartVarTti()) the
+     * ones that begin at the same symbol of the first one, and then schedules
+     * itself at the next starting symbol, if any. In this way, the PHY enters
+     * the simulator once per distinct starting symbol, instead of twice per
+     * variable TTI.
      */
-    void EndVarTti(const std::shared_ptr<DciInfoElementTdma>& lastDci);
+    void StartVarTtis();
 
     /**
      * \brief Transmit to the spectrum phy the data stored in pb
@@ -589,9 +587,9 @@ class NrGnbPhy : public NrPhy
     /**
      * \brief Effectively start the slot, as we have the channel.
      *
-     * For each variable TTI, schedule a call to StartVarTti.
+     * Store the variable TTIs of the slot, and schedule the first call to StartVarTtis.
      *
-     * \see StartVarTti.
+     * \see StartVarTtis.
      */
     void DoStartSlot();
 
@@ -615,7 +613,7 @@ class NrGnbPhy : public NrPhy
      * \param dci DCI
      *
      */
-    void StoreRBGAllocation(std::unordered_map<uint8_t, std::vector<uint8_t>>* map,
+    void StoreRBGAllocation(std::unordered_map<uint8_t, NrRbBitmask>* map,
                             const std::shared_ptr<DciInfoElementTdma>& dci) const;
 
     /**
@@ -705,6 +703,28 @@ class NrGnbPhy : public NrPhy
      */
     void RetrievePrepareEncodeCtrlMsgs();
 
+    /**
+     * \brief Wake up the PHY of the UEs addressed by the DCIs in the list
+     * \param ctrlMsgs the CTRL messages that will be sent in the current slot
+     *
+     * A UE that skips idle slots (NrUePhy attribute IdleSlotFastForward) has
+     * to process the slot in which it receives a DCI, as the allocation may
+     * start in the same slot (K0 = 0). A DCI with RNTI 0 wakes up all the UEs.
+     *
+     * This is a shortcut across the nodes: the gNB PHY calls NrUePhy::WakeUp()
+     * directly on the UE devices registered with RegisterUe(), as the DCI is
+     * only delivered through the spectrum channel once the UE is already
+     * processing the slot.
+     */
+    void WakeUpUePhys(const std::list<Ptr<NrControlMessage>>& ctrlMsgs);
+
+    /**
+     * \brief Get the PHY of the attached UE with the specified RNTI
+     * \param rnti the RNTI of the UE
+     * \return the UE PHY in the same BWP, or nullptr if there is no such UE
+     */
+    Ptr<NrUePhy> GetUePhy(uint16_t rnti);
+
     /**
      * \brief Prepare the RBG power distribution map for the allocations.
      *
@@ -730,13 +750,17 @@ class NrGnbPhy : public NrPhy
     std::set<uint64_t> m_ueAttached;             //!< Set of attached UE (by IMSI)
     std::set<uint16_t> m_ueAttachedRnti;         //!< Set of attached UE (by RNTI)
     std::vector<Ptr<NrUeNetDevice>> m_deviceMap; //!< Vector of UE devices
+    std::unordered_map<uint16_t, Ptr<NrUePhy>>
+        m_uePhyByRnti; //!< Cache of the UE PHYs (from m_deviceMap) indexed by RNTI
 
     LteRrcSap::SystemInformationBlockType1 m_sib1; //!< SIB1 message
     Time m_lastSlotStart;                          //!< Time at which the last slot started
     uint8_t m_currSymStart{0}; //!< Symbol at which the current allocation started
-    std::unordered_map<uint8_t, std::vector<uint8_t>>
+    std::deque<std::shared_ptr<DciInfoElementTdma>>
+        m_slotVarTtis; //!< DCIs of the current slot not started yet, sorted by symbol
+    std::unordered_map<uint8_t, NrRbBitmask>
         m_rbgAllocationPerSym; //!< RBG allocation in each sym
-    std::unordered_map<uint8_t, std::vector<uint8_t>>
+    std::unordered_map<uint8_t, NrRbBitmask>
         m_rbgAllocationPerSymDataStat; //!< RBG allocation in each sym, for statistics (UL and DL
                                        //!< included, only data)
 
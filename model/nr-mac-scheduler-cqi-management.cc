@@ -36,12 +36,12 @@ NrMacSchedulerCQIManagement::UlSBCQIReported(
     [[maybe_unused]] uint32_t tbs,
     const NrMacSchedSapProvider::SchedUlCqiInfoReqParameters& params,
     const std::shared_ptr<NrMacSchedulerUeInfo>& ueInfo,
-    const std::vector<uint8_t>& rbgMask,
+    const NrRbBitmask& rbgMask,
     uint32_t numRbPerRbg,
     const Ptr<const SpectrumModel>& model) const
 {
     NS_LOG_INFO(this);
-    NS_ASSERT(rbgMask.size() > 0);
+    NS_ASSERT(rbgMask.GetSize() > 0);
 
     NS_LOG_INFO("Computing SB CQI for UE " << ueInfo->m_rnti);
 
@@ -51,16 +51,12 @@ NrMacSchedulerCQIManagement::UlSBCQIReported(
 
     std::vector<int> rbAssignment(params.m_ulCqi.m_sinr.size(), 0);
 
-    for (uint32_t i = 0; i < rbgMask.size(); ++i)
-    {
-        if (rbgMask.at(i) == 1)
+    rbgMask.ForEachSet([&](std::size_t i) {
+        for (uint32_t k = 0; k < numRbPerRbg; ++k)
         {
-            for (uint32_t k = 0; k < numRbPerRbg; ++k)
-            {
-                rbAssignment[i * numRbPerRbg + k] = 1;
-            }
+            rbAssignment[i * numRbPerRbg + k] = 1;
         }
-    }
+    });
 
     SpectrumValue specVals(model);
     Values::iterator specIt = specVals.ValuesBegin();
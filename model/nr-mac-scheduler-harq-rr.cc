@@ -95,8 +95,7 @@ NrMacSchedulerHarqRr::ScheduleDlHarq(
             auto& dciInfoReTx = harqProcess.m_dciElement;
 
             long rbgAssigned =
-                std::count(dciInfoReTx->m_rbgBitmask.begin(), dciInfoReTx->m_rbgBitmask.end(), 1) *
-                dciInfoReTx->m_numSym;
+                static_cast<long>(dciInfoReTx->m_rbgBitmask.Count()) * dciInfoReTx->m_numSym;
             uint32_t rbgAvail = (GetBandwidthInRbg() - startingPoint->m_rbg) * symPerBeam;
 
             NS_LOG_INFO("Evaluating space to retransmit HARQ PID="
@@ -196,19 +195,17 @@ NrMacSchedulerHarqRr::ScheduleDlHarq(
                 ++rbgAssigned;
             }
 
-            NS_ABORT_IF(static_cast<unsigned long>(rbgAssigned) > dciInfoReTx->m_rbgBitmask.size());
+            NS_ABORT_IF(static_cast<unsigned long>(rbgAssigned) >
+                        dciInfoReTx->m_rbgBitmask.GetSize());
 
-            for (unsigned int i = 0; i < dciInfoReTx->m_rbgBitmask.size(); ++i)
+            NrRbBitmask rbgBitmask(dciInfoReTx->m_rbgBitmask.GetSize());
+            for (unsigned int i = startingPoint->m_rbg;
+                 i < startingPoint->m_rbg + rbgAssigned && i < rbgBitmask.GetSize();
+                 ++i)
             {
-                if (startingPoint->m_rbg <= i && i < startingPoint->m_rbg + rbgAssigned)
-                {
-                    dciInfoReTx->m_rbgBitmask.at(i) = 1;
-                }
-                else
-                {
-                    dciInfoReTx->m_rbgBitmask.at(i) = 0;
-                }
+                rbgBitmask.Set(i);
             }
+            dciInfoReTx->m_rbgBitmask = std::move(rbgBitmask);
 
             startingPoint->m_rbg += rbgAssigned;
 
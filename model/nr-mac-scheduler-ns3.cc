@@ -1125,10 +1125,10 @@ NrMacSchedulerNs3::PrependCtrlSym(uint8_t symStart,
                                   DciInfoElementTdma::DciFormat mode,
                                   std::deque<VarTtiAllocInfo>* allocations) const
 {
-    std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
+    NrRbBitmask rbgBitmask(GetBandwidthInRbg(), true);
 
-    NS_ASSERT_MSG(rbgBitmask.size() == GetBandwidthInRbg(),
-                  "bitmask size " << rbgBitmask.size() << " conf " << GetBandwidthInRbg());
+    NS_ASSERT_MSG(rbgBitmask.GetSize() == GetBandwidthInRbg(),
+                  "bitmask size " << rbgBitmask.GetSize() << " conf " << GetBandwidthInRbg());
     if (mode == DciInfoElementTdma::DL)
     {
         NS_ASSERT(allocations->size() == 0); // no previous allocations
@@ -1164,9 +1164,9 @@ NrMacSchedulerNs3::AppendCtrlSym(uint8_t symStart,
                                  DciInfoElementTdma::DciFormat mode,
                                  std::deque<VarTtiAllocInfo>* allocations) const
 {
-    std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
+    NrRbBitmask rbgBitmask(GetBandwidthInRbg(), true);
 
-    NS_ASSERT(rbgBitmask.size() == GetBandwidthInRbg());
+    NS_ASSERT(rbgBitmask.GetSize() == GetBandwidthInRbg());
     if (mode == DciInfoElementTdma::DL)
     {
         NS_ASSERT(allocations->size() == 0); // no previous allocations
@@ -2195,8 +2195,6 @@ NrMacSchedulerNs3::DoScheduleSrs(PointInFTPlane* spoint, SlotAllocInfo* allocInf
 
         NS_LOG_INFO("UE " << rnti << " assigned symbol " << +spoint->m_sym << " for SRS tx");
 
-        std::vector<uint8_t> rbgBitmask(GetBandwidthInRbg(), 1);
-
         spoint->m_sym--;
 
         // Due to MIMO implementation MCS, TB size, ndi, rv, are vectors
@@ -2216,7 +2214,7 @@ NrMacSchedulerNs3::DoScheduleSrs(PointInFTPlane* spoint, SlotAllocInfo* allocInf
                                                         DciInfoElementTdma::SRS,
                                                         GetBwpId(),
                                                         GetTpc());
-        dci->m_rbgBitmask = rbgBitmask;
+        dci->m_rbgBitmask = NrRbBitmask(GetBandwidthInRbg(), true);
 
         allocInfo->m_numSymAlloc += 1;
         allocInfo->m_varTtiAllocInfo.emplace_front(VarTtiAllocInfo(dci));
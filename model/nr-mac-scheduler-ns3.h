@@ -729,7 +729,7 @@ class NrMacSchedulerNs3 : public NrMacScheduler
                   uint8_t symStart,
                   uint8_t numSym,
                   uint8_t mcs,
-                  const std::vector<uint8_t>& rbgMask)
+                  const NrRbBitmask& rbgMask)
             : m_rnti(rnti),
               m_tbs(tbs),
               m_symStart(symStart),
@@ -739,12 +739,12 @@ class NrMacSchedulerNs3 : public NrMacScheduler
         {
         }
 
-        uint16_t m_rnti{0};             //!< Allocated RNTI
-        uint32_t m_tbs{0};              //!< Allocated TBS
-        uint8_t m_symStart{0};          //!< Sym start
-        uint8_t m_numSym{0};            //!< Allocated symbols
-        uint8_t m_mcs{0};               //!< MCS of the transmission
-        std::vector<uint8_t> m_rbgMask; //!< RBG Mask
+        uint16_t m_rnti{0};    //!< Allocated RNTI
+        uint32_t m_tbs{0};     //!< Allocated TBS
+        uint8_t m_symStart{0}; //!< Sym start
+        uint8_t m_numSym{0};   //!< Allocated symbols
+        uint8_t m_mcs{0};      //!< MCS of the transmission
+        NrRbBitmask m_rbgMask; //!< RBG Mask
     };
 
     /**
@@ -452,16 +452,16 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
     }
 
     uint32_t RBGNum = ueInfo->m_dlRBG / maxSym;
-    std::vector<uint8_t> rbgBitmask = GetDlNotchedRbgMask();
+    NrRbBitmask rbgBitmask(GetDlNotchedRbgMask());
 
-    if (rbgBitmask.size() == 0)
+    if (rbgBitmask.GetSize() == 0)
     {
-        rbgBitmask = std::vector<uint8_t>(GetBandwidthInRbg(), 1);
+        rbgBitmask = NrRbBitmask(GetBandwidthInRbg(), true);
     }
 
     // rbgBitmask is all 1s or have 1s in the place we are allowed to transmit.
 
-    NS_ASSERT(rbgBitmask.size() == GetBandwidthInRbg());
+    NS_ASSERT(rbgBitmask.GetSize() == GetBandwidthInRbg());
 
     uint32_t lastRbg = spoint->m_rbg;
 
@@ -469,7 +469,7 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
     // and the number of RBG assigned to the UE
     for (uint32_t i = 0; i < GetBandwidthInRbg(); ++i)
     {
-        if (i >= spoint->m_rbg && RBGNum > 0 && rbgBitmask[i] == 1)
+        if (i >= spoint->m_rbg && RBGNum > 0 && rbgBitmask.Test(i))
         {
             // assigned! Decrement RBGNum and continue the for
             RBGNum--;
@@ -479,7 +479,7 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
         {
             // Set to 0 the position < spoint->m_rbg OR the remaining RBG when
             // we already assigned the number of requested RBG
-            rbgBitmask[i] = 0;
+            rbgBitmask.Reset(i);
         }
     }
 
@@ -487,14 +487,8 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
         RBGNum == 0,
         "If you see this message, it means that the AssignRBG and CreateDci method are unaligned");
 
-    std::ostringstream oss;
-    for (const auto& x : rbgBitmask)
-    {
-        oss << std::to_string(x) << " ";
-    }
-
     NS_LOG_INFO("UE " << ueInfo->m_rnti << " assigned RBG from " << spoint->m_rbg << " with mask "
-                      << oss.str() << " for " << static_cast<uint32_t>(maxSym) << " SYM.");
+                      << rbgBitmask << " for " << static_cast<uint32_t>(maxSym) << " SYM.");
 
     std::shared_ptr<DciInfoElementTdma> dci =
         std::make_shared<DciInfoElementTdma>(ueInfo->m_rnti,
@@ -511,8 +505,7 @@ NrMacSchedulerOfdma::CreateDlDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
 
     dci->m_rbgBitmask = std::move(rbgBitmask);
 
-    NS_ASSERT(std::count(dci->m_rbgBitmask.begin(), dci->m_rbgBitmask.end(), 0) !=
-              GetBandwidthInRbg());
+    NS_ASSERT(dci->m_rbgBitmask.Any());
 
     spoint->m_rbg = lastRbg + 1;
 
@@ -538,16 +531,16 @@ NrMacSchedulerOfdma::CreateUlDci(PointInFTPlane* spoint,
     }
 
     uint32_t RBGNum = ueInfo->m_ulRBG / maxSym;
-    std::vector<uint8_t> rbgBitmask = GetUlNotchedRbgMask();
+    NrRbBitmask rbgBitmask(GetUlNotchedRbgMask());
 
-    if (rbgBitmask.size() == 0)
+    if (rbgBitmask.GetSize() == 0)
     {
-        rbgBitmask = std::vector<uint8_t>(GetBandwidthInRbg(), 1);
+        rbgBitmask = NrRbBitmask(GetBandwidthInRbg(), true);
     }
 
     // rbgBitmask is all 1s or have 1s in the place we are allowed to transmit.
 
-    NS_ASSERT(rbgBitmask.size() == GetBandwidthInRbg());
+    NS_ASSERT(rbgBitmask.GetSize() == GetBandwidthInRbg());
 
     uint32_t lastRbg = spoint->m_rbg;
     uint32_t assigned = RBGNum;
@@ -556,7 +549,7 @@ NrMacSchedulerOfdma::CreateUlDci(PointInFTPlane* spoint,
     // and the number of RBG assigned to the UE
     for (uint32_t i = 0; i < GetBandwidthInRbg(); ++i)
     {
-        if (i >= spoint->m_rbg && RBGNum > 0 && rbgBitmask[i] == 1)
+        if (i >= spoint->m_rbg && RBGNum > 0 && rbgBitmask.Test(i))
         {
             // assigned! Decrement RBGNum and continue the for
             RBGNum--;
@@ -566,7 +559,7 @@ NrMacSchedulerOfdma::CreateUlDci(PointInFTPlane* spoint,
         {
             // Set to 0 the position < spoint->m_rbg OR the remaining RBG when
             // we already assigned the number of requested RBG
-            rbgBitmask[i] = 0;
+            rbgBitmask.Reset(i);
         }
     }
 
@@ -600,15 +593,9 @@ NrMacSchedulerOfdma::CreateUlDci(PointInFTPlane* spoint,
 
     dci->m_rbgBitmask = std::move(rbgBitmask);
 
-    std::ostringstream oss;
-    for (auto x : dci->m_rbgBitmask)
-    {
-        oss << std::to_string(x) << " ";
-    }
-    NS_LOG_INFO("UE " << ueInfo->m_rnti << " DCI RBG mask: " << oss.str());
+    NS_LOG_INFO("UE " << ueInfo->m_rnti << " DCI RBG mask: " << dci->m_rbgBitmask);
 
-    NS_ASSERT(std::count(dci->m_rbgBitmask.begin(), dci->m_rbgBitmask.end(), 0) !=
-              GetBandwidthInRbg());
+    NS_ASSERT(dci->m_rbgBitmask.Any());
 
     spoint->m_rbg = lastRbg + 1;
 
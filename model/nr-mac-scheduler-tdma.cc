@@ -546,29 +546,23 @@ NrMacSchedulerTdma::CreateDci(NrMacSchedulerNs3::PointInFTPlane* spoint,
                                              GetBwpId(),
                                              GetTpc());
 
-    std::vector<uint8_t> rbgAssigned =
-        fmt == DciInfoElementTdma::DL ? GetDlNotchedRbgMask() : GetUlNotchedRbgMask();
+    NrRbBitmask rbgAssigned(fmt == DciInfoElementTdma::DL ? GetDlNotchedRbgMask()
+                                                          : GetUlNotchedRbgMask());
 
-    if (rbgAssigned.size() == 0)
+    if (rbgAssigned.GetSize() == 0)
     {
-        rbgAssigned = std::vector<uint8_t>(GetBandwidthInRbg(), 1);
+        rbgAssigned = NrRbBitmask(GetBandwidthInRbg(), true);
     }
 
-    NS_ASSERT(rbgAssigned.size() == GetBandwidthInRbg());
+    NS_ASSERT(rbgAssigned.GetSize() == GetBandwidthInRbg());
 
     dci->m_rbgBitmask = std::move(rbgAssigned);
 
-    std::ostringstream oss;
-    for (auto& x : dci->m_rbgBitmask)
-    {
-        oss << std::to_string(x) << " ";
-    }
-
     NS_LOG_INFO("UE " << ueInfo->m_rnti << " assigned RBG from " << spoint->m_rbg << " with mask "
-                      << oss.str() << " for " << static_cast<uint32_t>(numSym) << " SYM ");
+                      << dci->m_rbgBitmask << " for " << static_cast<uint32_t>(numSym)
+                      << " SYM ");
 
-    NS_ASSERT(std::count(dci->m_rbgBitmask.begin(), dci->m_rbgBitmask.end(), 0) !=
-              GetBandwidthInRbg());
+    NS_ASSERT(dci->m_rbgBitmask.Any());
 
     return dci;
 }
@@ -0,0 +1,190 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-parallel-for.h"
+
+#include <ns3/log.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrParallelFor");
+
+/**
+ * \ingroup utils
+ * \brief The threads of NrParallelFor. They are created when a call needs
+ * more threads than the pool has, and they wait for the items of the next
+ * call until the end of the program.
+ */
+class NrParallelForPool
+{
+  public:
+    /**
+     * \brief Stop and join the threads
+     */
+    ~NrParallelForPool();
+
+    /**
+     * \brief Get the pool of the process
+     * \return the pool
+     */
+    static NrParallelForPool& Get();
+
+    /**
+     * \brief Invoke a function for every index in [0, numItems), on the calling
+     * thread and numThreads - 1 threads of the pool
+     * \param numItems the number of items
+     * \param numThreads the number of threads, at least 2
+     * \param function the function to invoke with the index of each item
+     */
+    void Run(std::size_t numItems,
+             uint32_t numThreads,
+             const std::function<void(std::size_t)>& function);
+
+  private:
+    /**
+     * \brief The loop of a thread of the pool
+     * \param id the index of the thread in the pool
+     */
+    void WorkerLoop(uint32_t id);
+
+    /**
+     * \brief Invoke the function for the items not yet taken
+     */
+    void ProcessItems();
+
+    std::mutex m_runMutex;              //!< Serializes the calls to Run
+    std::mutex m_mutex;                 //!< Protects the state of the current call
+    std::condition_variable m_start;    //!< Notifies the threads of a call, or of the stop
+    std::condition_variable m_done;     //!< Notifies the caller that the threads are done
+    std::vector<std::thread> m_threads; //!< The threads of the pool
+    uint64_t m_generation{0};           //!< Number of calls to Run
+    uint32_t m_activeThreads{0};        //!< Threads of the pool working on the current call
+    uint32_t m_pendingThreads{0};       //!< Active threads that did not finish yet
+    bool m_stop{false};                 //!< The threads have to exit
+
+    const std::function<void(std::size_t)>* m_function{nullptr}; //!< Function of the call
+    std::size_t m_numItems{0};                                    //!< Items of the call
+    std::atomic<std::size_t> m_next{0};                           //!< Next item to take
+};
+
+NrParallelForPool::~NrParallelForPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_start.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+NrParallelForPool&
+NrParallelForPool::Get()
+{
+    static NrParallelForPool pool;
+    return pool;
+}
+
+void
+NrParallelForPool::Run(std::size_t numItems,
+                       uint32_t numThreads,
+                       const std::function<void(std::size_t)>& function)
+{
+    std::lock_guard<std::mutex> runLock(m_runMutex);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (m_threads.size() < numThreads - 1)
+    {
+        auto id = static_cast<uint32_t>(m_threads.size());
+        m_threads.emplace_back(&NrParallelForPool::WorkerLoop, this, id);
+    }
+    m_function = &function;
+    m_numItems = numItems;
+    m_next = 0;
+    m_activeThreads = numThreads - 1;
+    m_pendingThreads = m_activeThreads;
+    m_generation++;
+    lock.unlock();
+    m_start.notify_all();
+
+    ProcessItems();
+
+    lock.lock();
+    m_done.wait(lock, [this]() { return m_pendingThreads == 0; });
+    m_function = nullptr;
+}
+
+void
+NrParallelForPool::WorkerLoop(uint32_t id)
+{
+    uint64_t generation = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        // A call starts once all the threads of the previous one are done, so
+        // an active thread can not miss a call
+        m_start.wait(lock, [this, id, generation]() {
+            return m_stop || (m_generation != generation && id < m_activeThreads);
+        });
+        if (m_stop)
+        {
+            return;
+        }
+        generation = m_generation;
+        lock.unlock();
+        ProcessItems();
+        lock.lock();
+        if (--m_pendingThreads == 0)
+        {
+            m_done.notify_one();
+        }
+    }
+}
+
+void
+NrParallelForPool::ProcessItems()
+{
+    for (std::size_t i = m_next++; i < m_numItems; i = m_next++)
+    {
+        (*m_function)(i);
+    }
+}
+
+void
+NrParallelFor(std::size_t numItems,
+              uint32_t numThreads,
+              const std::function<void(std::size_t)>& function)
+{
+    if (numThreads == 0)
+    {
+        numThreads = std::max(std::thread::hardware_concurrency(), 1U);
+    }
+    numThreads = static_cast<uint32_t>(std::min<std::size_t>(numThreads, numItems));
+
+    NS_LOG_INFO("Processing " << numItems << " items with " << numThreads << " threads");
+
+    if (numThreads <= 1)
+    {
+        for (std::size_t i = 0; i < numItems; ++i)
+        {
+            function(i);
+        }
+        return;
+    }
+
+    NrParallelForPool::Get().Run(numItems, numThreads, function);
+}
+
+} // namespace ns3
@@ -0,0 +1,49 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_PARALLEL_FOR_H
+#define NR_PARALLEL_FOR_H
+
+#include <cstddef>
+#include <functional>
+#include <stdint.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief Invoke a function for every index in [0, numItems), on a set of threads
+ *
+ * The indexes are distributed dynamically: each thread takes the next index
+ * not yet taken, so items of different cost are balanced among the threads.
+ * The calling thread is one of the threads, and the function returns when all
+ * the items are done. With one thread (or one item), the items are processed
+ * in order on the calling thread. The other threads belong to a pool: they
+ * are created by the first call that needs them, and they wait for the items
+ * of the next calls, so that a call does not pay for creating threads. The
+ * threads of the pool are not inherited by a child process (fork): a child
+ * process can not call the function with more than one thread.
+ *
+ * The function is called concurrently, and it must not touch the simulator
+ * state that is not thread-safe: in particular, it must not copy or release
+ * ns-3 smart pointers (Ptr) shared with other items, draw random numbers,
+ * schedule events, log with NS_LOG (which is not thread-safe either) or call
+ * NrParallelFor. The typical use is to gather the data of every item in
+ * the simulation thread, compute the items in parallel, and then apply the
+ * results in the simulation thread, in order.
+ *
+ * \param numItems the number of items
+ * \param numThreads the number of threads; 0 means one for each hardware thread
+ * \param function the function to invoke with the index of each item
+ */
+void NrParallelFor(std::size_t numItems,
+                   uint32_t numThreads,
+                   const std::function<void(std::size_t)>& function);
+
+} // namespace ns3
+
+#endif // NR_PARALLEL_FOR_H
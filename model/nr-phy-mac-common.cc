@@ -253,37 +253,27 @@ operator<<(std::ostream& os, const DciInfoElementTdma& item)
     os << "|TYPE=" << item.m_type << "|BWP=" << +item.m_bwpIndex << "|HARQP=" << +item.m_harqProcess
        << "|RBG=";
 
-    uint16_t start = 65000;
-    uint16_t end = 0;
+    // Print the runs of consecutive RBGs as [start;end]
     bool canPrint = false;
-    for (uint32_t i = 0; i < item.m_rbgBitmask.size(); ++i)
-    {
-        if (item.m_rbgBitmask[i] == 1)
-        {
-            canPrint = true;
-        }
-
-        if (item.m_rbgBitmask[i] == 1 && end < i)
+    std::size_t start = 0;
+    std::size_t end = 0;
+    item.m_rbgBitmask.ForEachSet([&](std::size_t i) {
+        if (canPrint && i == end + 1)
         {
             end = i;
+            return;
         }
-        if (item.m_rbgBitmask[i] == 1 && start > i)
+        if (canPrint)
         {
-            start = i;
+            os << "[" << start << ";" << end << "]";
         }
-
-        if (item.m_rbgBitmask[i] == 0 && canPrint)
-        {
-            os << "[" << +start << ";" << +end << "]";
-            start = 65000;
-            end = 0;
-            canPrint = false;
-        }
-    }
+        start = end = i;
+        canPrint = true;
+    });
 
     if (canPrint)
     {
-        os << "[" << +start << ";" << +end << "]";
+        os << "[" << start << ";" << end << "]";
     }
 
     return os;
@@ -9,6 +9,7 @@
 #ifndef SRC_NR_MODEL_NR_PHY_MAC_COMMON_H
 #define SRC_NR_MODEL_NR_PHY_MAC_COMMON_H
 
+#include "nr-rb-bitmask.h"
 #include "sfnsf.h"
 
 #include <ns3/component-carrier.h>
@@ -170,7 +171,7 @@ struct DciInfoElementTdma
                        uint8_t numSym,
                        DciFormat format,
                        VarTtiType type,
-                       const std::vector<uint8_t>& rbgBitmask)
+                       const NrRbBitmask& rbgBitmask)
         : m_format(format),
           m_symStart(symStart),
           m_numSym(numSym),
@@ -259,8 +260,8 @@ struct DciInfoElementTdma
     const VarTtiType m_type{SRS};     //!< Var TTI type
     const uint8_t m_bwpIndex{0};      //!< BWP Index to identify to which BWP this DCI applies to.
     uint8_t m_harqProcess{0};         //!< HARQ process id
-    std::vector<uint8_t> m_rbgBitmask{}; //!< RBG mask: 0 if the RBG is not used, 1 otherwise
-    const uint8_t m_tpc{0};              //!< Tx power control command
+    NrRbBitmask m_rbgBitmask{};       //!< RBG mask: set if the RBG is used
+    const uint8_t m_tpc{0};           //!< Tx power control command
 };
 
 /**
@@ -13,4 +13,9 @@ NrPhySapProvider::~NrPhySapProvider()
 {
 }
 
+void
+NrPhySapProvider::RequestSlotIndication()
+{
+}
+
 } // namespace ns3
@@ -88,6 +88,17 @@ class NrPhySapProvider
      */
     virtual void NotifyConnectionSuccessful() = 0;
 
+    /**
+     * \brief Ask the PHY for a slot indication as soon as possible
+     *
+     * Called by the UE MAC when it has something to transmit (e.g., a
+     * scheduling request). A PHY that is skipping idle slots (see the
+     * NrUePhy attribute IdleSlotFastForward) resumes its slot loop at the
+     * next slot boundary; otherwise, the call has no effect. The default
+     * implementation does nothing.
+     */
+    virtual void RequestSlotIndication();
+
     /**
      * \brief Get the beam conf ID from the RNTI specified. Not in any standard.
      * \param rnti RNTI of the user
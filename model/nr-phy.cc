@@ -20,8 +20,10 @@
 
 #include "ns3/uniform-planar-array.h"
 #include <ns3/boolean.h>
+#include <ns3/uinteger.h>
 
 #include <algorithm>
+#include <functional>
 
 namespace ns3
 {
@@ -53,6 +55,8 @@ class NrMemberPhySapProvider : public NrPhySapProvider
 
     void NotifyConnectionSuccessful() override;
 
+    void RequestSlotIndication() override;
+
     uint16_t GetBwpId() const override;
 
     uint16_t GetCellId() const override;
@@ -118,6 +122,12 @@ NrMemberPhySapProvider::NotifyConnectionSuccessful()
     m_phy->NotifyConnectionSuccessful();
 }
 
+void
+NrMemberPhySapProvider::RequestSlotIndication()
+{
+    m_phy->WakeUp();
+}
+
 uint16_t
 NrMemberPhySapProvider::GetBwpId() const
 {
@@ -150,37 +160,94 @@ NrMemberPhySapProvider::GetRbNum() const
 
 /* ======= */
 
+/**
+ * \brief Initial size (in slots) of the slot allocation ring; it must be a power of two
+ *
+ * It covers the L1/L2 latency plus the K0/K1/K2 delays usually configured;
+ * if that is not the case, the ring grows automatically.
+ */
+static const std::size_t SLOT_ALLOC_INFO_RING_SIZE = 16;
+
 TypeId
 NrPhy::GetTypeId()
 {
-    static TypeId tid = TypeId("ns3::NrPhy").SetParent<Object>();
+    static TypeId tid =
+        TypeId("ns3::NrPhy")
+            .SetParent<Object>()
+            .AddAttribute("TxPsdCacheSize",
+                          "Maximum number of TX power spectral densities kept in the "
+                          "least-recently-used cache of the PHY. A value of 0 disables the cache, "
+                          "and the TX PSD is rebuilt for every transmission.",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&NrPhy::m_txPsdCacheSize),
+                          MakeUintegerChecker<uint32_t>());
 
     return tid;
 }
 
+/**
+ * \brief Compute the hash of the key of a TX PSD cache entry
+ * \param rbIndexVector the active RBs
+ * \param activeStreams the number of active streams
+ * \param allocationType the power allocation type
+ * \param txPower the TX power in dBm
+ * \return the hash of the key
+ */
+static std::size_t
+TxPsdCacheHash(const std::vector<int>& rbIndexVector,
+               uint8_t activeStreams,
+               NrSpectrumValueHelper::PowerAllocationType allocationType,
+               double txPower)
+{
+    std::size_t seed = std::hash<double>()(txPower);
+    auto combine = [&seed](std::size_t v) { seed ^= v + 0x9e3779b9 + (seed << 6) + (seed >> 2); };
+
+    combine(activeStreams);
+    combine(static_cast<std::size_t>(allocationType));
+    combine(rbIndexVector.size());
+    for (const auto& rb : rbIndexVector)
+    {
+        combine(static_cast<std::size_t>(rb));
+    }
+    return seed;
+}
+
 std::vector<int>
-NrPhy::FromRBGBitmaskToRBAssignment(const std::vector<uint8_t> rbgBitmask) const
+NrPhy::FromRBGBitmaskToRBAssignment(const NrRbBitmask& rbgBitmask) const
 {
+    const uint32_t numRbPerRbg = GetNumRbPerRbg();
     std::vector<int> ret;
+    ret.reserve(rbgBitmask.Count() * numRbPerRbg);
 
-    for (uint32_t i = 0; i < rbgBitmask.size(); ++i)
-    {
-        if (rbgBitmask.at(i) == 1)
+    rbgBitmask.ForEachSet([&ret, numRbPerRbg](std::size_t i) {
+        for (uint32_t k = 0; k < numRbPerRbg; ++k)
         {
-            for (uint32_t k = 0; k < GetNumRbPerRbg(); ++k)
-            {
-                ret.push_back((i * GetNumRbPerRbg()) + k);
-            }
+            ret.push_back(static_cast<int>((i * numRbPerRbg) + k));
         }
-    }
+    });
+
+    return ret;
+}
+
+NrRbBitmask
+NrPhy::FromRBGBitmaskToRBBitmask(const NrRbBitmask& rbgBitmask) const
+{
+    const uint32_t numRbPerRbg = GetNumRbPerRbg();
+    NrRbBitmask ret(rbgBitmask.GetSize() * numRbPerRbg);
+
+    rbgBitmask.ForEachSet([&ret, numRbPerRbg](std::size_t i) {
+        for (uint32_t k = 0; k < numRbPerRbg; ++k)
+        {
+            ret.Set((i * numRbPerRbg) + k);
+        }
+    });
 
-    NS_ASSERT(static_cast<uint32_t>(std::count(rbgBitmask.begin(), rbgBitmask.end(), 1) *
-                                    GetNumRbPerRbg()) == ret.size());
     return ret;
 }
 
 NrPhy::NrPhy()
     : m_currSlotAllocInfo(SfnSf(0, 0, 0, 0)),
+      m_slotAllocInfo(SLOT_ALLOC_INFO_RING_SIZE),
       m_tbDecodeLatencyUs(100.0)
 {
     NS_LOG_FUNCTION(this);
@@ -197,7 +264,10 @@ NrPhy::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     m_slotAllocInfo.clear();
+    m_slotAllocInfoCount = 0;
     m_controlMessageQueue.clear();
+    m_controlMessageQueueHead = 0;
+    InvalidateTxPsdCache();
     m_packetBurstMap.clear();
     m_ctrlMsgs.clear();
     m_tddPattern.clear();
@@ -320,6 +390,10 @@ NrPhy::DoSetCellId(uint16_t cellId)
 {
     NS_LOG_FUNCTION(this);
     m_cellId = cellId;
+    for (const auto& spectrumPhy : m_spectrumPhys)
+    {
+        spectrumPhy->UpdateIdealCtrlReceivers();
+    }
 }
 
 void
@@ -348,6 +422,7 @@ NrPhy::SetMacPdu(const Ptr<Packet>& p, const SfnSf& sfn, uint8_t symStart, uint8
     it->second->AddPacket(p);
     NS_LOG_INFO("Adding a packet for the Packet Burst of " << sfn << " at sym " << +symStart
                                                            << std::endl);
+    WakeUp();
 }
 
 void
@@ -356,6 +431,12 @@ NrPhy::NotifyConnectionSuccessful()
     NS_LOG_FUNCTION(this);
 }
 
+void
+NrPhy::WakeUp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
 Ptr<PacketBurst>
 NrPhy::GetPacketBurst(SfnSf sfn, uint8_t sym, uint8_t streamId)
 {
@@ -386,21 +467,82 @@ NrPhy::GetNoisePowerSpectralDensity()
                                                                   GetSpectrumModel());
 }
 
-Ptr<SpectrumValue>
+Ptr<const SpectrumValue>
 NrPhy::GetTxPowerSpectralDensity(const std::vector<int>& rbIndexVector, uint8_t activeStreams)
 {
     NS_LOG_FUNCTION(this);
-    Ptr<const SpectrumModel> sm = GetSpectrumModel();
     NS_ASSERT_MSG(activeStreams, "There should be at least one active stream.");
+
+    std::size_t hash = 0;
+    if (m_txPsdCacheSize > 0)
+    {
+        hash = TxPsdCacheHash(rbIndexVector, activeStreams, m_powerAllocationType, m_txPower);
+        auto range = m_txPsdCacheIndex.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            const auto& entry = *it->second;
+            if (entry.m_activeStreams == activeStreams && entry.m_txPower == m_txPower &&
+                entry.m_powerAllocationType == m_powerAllocationType &&
+                entry.m_rbIndexVector == rbIndexVector)
+            {
+                // Move the entry to the front: it is now the most recently used
+                m_txPsdCache.splice(m_txPsdCache.begin(), m_txPsdCache, it->second);
+                return entry.m_txPsd;
+            }
+        }
+    }
+
+    Ptr<const SpectrumModel> sm = GetSpectrumModel();
     // Convert txPower to linear units
     double txPowerLinear = pow(10, m_txPower / 10);
     // Share the total transmission power among active streams
     double txPowerPerStreamDbm = 10 * log10(txPowerLinear / activeStreams);
     // Pass the TX power per stream, each stream will have the same TX PSD
-    return NrSpectrumValueHelper::CreateTxPowerSpectralDensity(txPowerPerStreamDbm,
-                                                               rbIndexVector,
-                                                               sm,
-                                                               m_powerAllocationType);
+    Ptr<const SpectrumValue> txPsd =
+        NrSpectrumValueHelper::CreateTxPowerSpectralDensity(txPowerPerStreamDbm,
+                                                            rbIndexVector,
+                                                            sm,
+                                                            m_powerAllocationType);
+
+    if (m_txPsdCacheSize == 0)
+    {
+        return txPsd;
+    }
+
+    TxPsdCacheEntry entry;
+    entry.m_hash = hash;
+    entry.m_rbIndexVector = rbIndexVector;
+    entry.m_activeStreams = activeStreams;
+    entry.m_powerAllocationType = m_powerAllocationType;
+    entry.m_txPower = m_txPower;
+    entry.m_txPsd = txPsd;
+    m_txPsdCache.push_front(std::move(entry));
+    m_txPsdCacheIndex.emplace(hash, m_txPsdCache.begin());
+
+    while (m_txPsdCache.size() > m_txPsdCacheSize)
+    {
+        auto lru = std::prev(m_txPsdCache.end());
+        auto range = m_txPsdCacheIndex.equal_range(lru->m_hash);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == lru)
+            {
+                m_txPsdCacheIndex.erase(it);
+                break;
+            }
+        }
+        m_txPsdCache.erase(lru);
+    }
+
+    return txPsd;
+}
+
+void
+NrPhy::InvalidateTxPsdCache()
+{
+    NS_LOG_FUNCTION(this);
+    m_txPsdCacheIndex.clear();
+    m_txPsdCache.clear();
 }
 
 double
@@ -447,7 +589,12 @@ NrPhy::EnqueueCtrlMessage(const Ptr<NrControlMessage>& m)
 {
     NS_LOG_FUNCTION(this);
 
-    m_controlMessageQueue.at(m_controlMessageQueue.size() - 1).push_back(m);
+    NS_ASSERT(!m_controlMessageQueue.empty());
+    // The tail of the ring is the slot just before the head
+    std::size_t tail = (m_controlMessageQueueHead + m_controlMessageQueue.size() - 1) %
+                       m_controlMessageQueue.size();
+    m_controlMessageQueue.at(tail).push_back(m);
+    WakeUp();
 }
 
 void
@@ -455,16 +602,16 @@ NrPhy::EnqueueCtrlMsgNow(const Ptr<NrControlMessage>& msg)
 {
     NS_LOG_FUNCTION(this);
 
-    m_controlMessageQueue.at(0).push_back(msg);
+    m_controlMessageQueue.at(m_controlMessageQueueHead).push_back(msg);
+    WakeUp();
 }
 
 void
 NrPhy::EnqueueCtrlMsgNow(const std::list<Ptr<NrControlMessage>>& listOfMsgs)
 {
-    for (const auto& msg : listOfMsgs)
-    {
-        m_controlMessageQueue.at(0).push_back(msg);
-    }
+    auto& current = m_controlMessageQueue.at(m_controlMessageQueueHead);
+    current.insert(current.end(), listOfMsgs.begin(), listOfMsgs.end());
+    WakeUp();
 }
 
 void
@@ -548,6 +695,9 @@ NrPhy::DoUpdateRbNum()
     m_rbNum = static_cast<uint32_t>(realBw / rbWidth);
     NS_ASSERT(GetRbNum() > 0);
 
+    // The spectrum model changed: the cached TX PSDs are not valid anymore
+    InvalidateTxPsdCache();
+
     NS_LOG_INFO("Updated RbNum to " << GetRbNum());
 
     if (m_spectrumPhys.size())
@@ -608,11 +758,8 @@ NrPhy::InitializeMessageList()
 {
     NS_LOG_FUNCTION(this);
     m_controlMessageQueue.clear();
-
-    for (unsigned i = 0; i <= GetL1L2CtrlLatency(); i++)
-    {
-        m_controlMessageQueue.emplace_back();
-    }
+    m_controlMessageQueue.resize(GetL1L2CtrlLatency() + 1);
+    m_controlMessageQueueHead = 0;
 }
 
 std::list<Ptr<NrControlMessage>>
@@ -621,26 +768,14 @@ NrPhy::PopCurrentSlotCtrlMsgs()
     NS_LOG_FUNCTION(this);
     if (m_controlMessageQueue.empty())
     {
-        std::list<Ptr<NrControlMessage>> emptylist;
-        return (emptylist);
+        return {};
     }
 
-    if (m_controlMessageQueue.at(0).size() > 0)
-    {
-        std::list<Ptr<NrControlMessage>> ret = m_controlMessageQueue.front();
-        m_controlMessageQueue.erase(m_controlMessageQueue.begin());
-        std::list<Ptr<NrControlMessage>> newlist;
-        m_controlMessageQueue.push_back(newlist);
-        return (ret);
-    }
-    else
-    {
-        m_controlMessageQueue.erase(m_controlMessageQueue.begin());
-        std::list<Ptr<NrControlMessage>> newlist;
-        m_controlMessageQueue.push_back(newlist);
-        std::list<Ptr<NrControlMessage>> emptylist;
-        return (emptylist);
-    }
+    auto& current = m_controlMessageQueue.at(m_controlMessageQueueHead);
+    std::list<Ptr<NrControlMessage>> ret = std::move(current);
+    current.clear(); // the moved-from list is now the (empty) tail of the ring
+    m_controlMessageQueueHead = (m_controlMessageQueueHead + 1) % m_controlMessageQueue.size();
+    return ret;
 }
 
 void
@@ -696,39 +831,85 @@ NrPhy::GetPhySapProvider()
     return m_phySapProvider;
 }
 
+std::size_t
+NrPhy::GetSlotAllocInfoIndex(const SfnSf& sfnsf) const
+{
+    NS_ASSERT(!m_slotAllocInfo.empty());
+    return static_cast<std::size_t>(sfnsf.Normalize() & (m_slotAllocInfo.size() - 1));
+}
+
 void
-NrPhy::PushBackSlotAllocInfo(const SlotAllocInfo& slotAllocInfo)
+NrPhy::InsertSlotAllocInfo(SlotAllocInfo&& slotAllocInfo)
 {
     NS_LOG_FUNCTION(this);
+    NS_ASSERT(!m_slotAllocInfo.empty());
+    uint64_t slot = slotAllocInfo.m_sfnSf.Normalize();
+    if (m_slotAllocInfoCount == 0)
+    {
+        m_slotAllocInfoOldest = slot;
+        m_slotAllocInfoNewest = slot;
+    }
+    else
+    {
+        m_slotAllocInfoOldest = std::min(m_slotAllocInfoOldest, slot);
+        m_slotAllocInfoNewest = std::max(m_slotAllocInfoNewest, slot);
+    }
+    // The allocations must span less slots than the ring: then they can not
+    // collide, and the positions that follow the oldest one are in
+    // chronological order
+    while (m_slotAllocInfoNewest - m_slotAllocInfoOldest >= m_slotAllocInfo.size())
+    {
+        GrowSlotAllocInfoRing();
+    }
+    std::size_t index = GetSlotAllocInfoIndex(slotAllocInfo.m_sfnSf);
+    NS_ASSERT_MSG(!m_slotAllocInfo.at(index).m_valid,
+                  "Allocation for " << slotAllocInfo.m_sfnSf << " already present");
+    m_slotAllocInfo.at(index).m_valid = true;
+    m_slotAllocInfo.at(index).m_slotAllocInfo = std::move(slotAllocInfo);
+    ++m_slotAllocInfoCount;
+}
 
-    NS_LOG_DEBUG("setting info for slot " << slotAllocInfo.m_sfnSf);
+void
+NrPhy::GrowSlotAllocInfoRing()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<SlotAllocInfoRingEntry> oldRing(m_slotAllocInfo.size() * 2);
+    std::swap(oldRing, m_slotAllocInfo);
+    NS_LOG_INFO("Slot allocation ring grown to " << m_slotAllocInfo.size() << " slots");
 
-    // That's not so complex, as the list would typically be of 2 or 3 elements.
-    bool updated = false;
-    for (auto& alloc : m_slotAllocInfo)
+    // Two slots that are different modulo N are also different modulo 2N,
+    // so the content of the old ring can not collide in the new one
+    for (auto& entry : oldRing)
     {
-        if (alloc.m_sfnSf == slotAllocInfo.m_sfnSf)
+        if (entry.m_valid)
         {
-            NS_LOG_INFO("Merging inside existing allocation");
-            alloc.Merge(slotAllocInfo);
-            updated = true;
-            break;
+            std::size_t index = GetSlotAllocInfoIndex(entry.m_slotAllocInfo.m_sfnSf);
+            NS_ASSERT(!m_slotAllocInfo.at(index).m_valid);
+            m_slotAllocInfo.at(index).m_valid = true;
+            m_slotAllocInfo.at(index).m_slotAllocInfo = std::move(entry.m_slotAllocInfo);
         }
     }
-    if (!updated)
-    {
-        m_slotAllocInfo.push_back(slotAllocInfo);
-        m_slotAllocInfo.sort();
-        NS_LOG_INFO("Pushing allocation at the end of the list");
-    }
+}
+
+void
+NrPhy::PushBackSlotAllocInfo(const SlotAllocInfo& slotAllocInfo)
+{
+    NS_LOG_FUNCTION(this);
 
-    std::stringstream output;
+    NS_LOG_DEBUG("setting info for slot " << slotAllocInfo.m_sfnSf);
 
-    for (const auto& alloc : m_slotAllocInfo)
+    auto& entry = m_slotAllocInfo.at(GetSlotAllocInfoIndex(slotAllocInfo.m_sfnSf));
+    if (entry.m_valid && entry.m_slotAllocInfo.m_sfnSf == slotAllocInfo.m_sfnSf)
+    {
+        NS_LOG_INFO("Merging inside existing allocation");
+        entry.m_slotAllocInfo.Merge(slotAllocInfo);
+        NS_LOG_INFO(entry.m_slotAllocInfo);
+    }
+    else
     {
-        output << alloc;
+        NS_LOG_INFO("Storing a new allocation " << slotAllocInfo);
+        InsertSlotAllocInfo(SlotAllocInfo(slotAllocInfo));
     }
-    NS_LOG_INFO(output.str());
 }
 
 void
@@ -736,7 +917,23 @@ NrPhy::PushFrontSlotAllocInfo(const SfnSf& newSfnSf, const SlotAllocInfo& slotAl
 {
     NS_LOG_FUNCTION(this);
 
-    m_slotAllocInfo.push_front(slotAllocInfo);
+    // Move all the stored allocations out of the ring, in chronological order,
+    // after the one that has to go in front
+    std::vector<SlotAllocInfo> allocations;
+    allocations.reserve(m_slotAllocInfoCount + 1);
+    for (auto& entry : m_slotAllocInfo)
+    {
+        if (entry.m_valid)
+        {
+            allocations.emplace_back(std::move(entry.m_slotAllocInfo));
+            entry.m_slotAllocInfo.m_varTtiAllocInfo.clear();
+            entry.m_valid = false;
+        }
+    }
+    m_slotAllocInfoCount = 0;
+    std::sort(allocations.begin(), allocations.end());
+    allocations.insert(allocations.begin(), slotAllocInfo);
+
     SfnSf currentSfn = newSfnSf;
     std::unordered_map<uint64_t, Ptr<PacketBurst>>
         newBursts;                                 // map between new sfn and the packet burst
@@ -745,7 +942,7 @@ NrPhy::PushFrontSlotAllocInfo(const SfnSf& newSfnSf, const SlotAllocInfo& slotAl
     // all the slot allocations  (and their packet burst) have to be "adjusted":
     // directly modify the sfn for the allocation, and temporarly store the
     // burst (along with the new sfn) into newBursts.
-    for (auto it = m_slotAllocInfo.begin(); it != m_slotAllocInfo.end(); ++it)
+    for (auto it = allocations.begin(); it != allocations.end(); ++it)
     {
         auto slotSfn = it->m_sfnSf;
         for (const auto& alloc : it->m_varTtiAllocInfo)
@@ -781,6 +978,11 @@ NrPhy::PushFrontSlotAllocInfo(const SfnSf& newSfnSf, const SlotAllocInfo& slotAl
         currentSfn.Add(1);
     }
 
+    for (auto& alloc : allocations)
+    {
+        InsertSlotAllocInfo(std::move(alloc));
+    }
+
     for (const auto& burstPair : newBursts)
     {
         SfnSf old;
@@ -798,23 +1000,19 @@ NrPhy::SlotAllocInfoExists(const SfnSf& retVal) const
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(retVal.GetNumerology() == GetNumerology());
-    for (const auto& alloc : m_slotAllocInfo)
-    {
-        if (alloc.m_sfnSf == retVal)
-        {
-            return true;
-        }
-    }
-    return false;
+    const auto& entry = m_slotAllocInfo.at(GetSlotAllocInfoIndex(retVal));
+    return entry.m_valid && entry.m_slotAllocInfo.m_sfnSf == retVal;
 }
 
 SlotAllocInfo
 NrPhy::RetrieveSlotAllocInfo()
 {
     NS_LOG_FUNCTION(this);
-    SlotAllocInfo ret = *m_slotAllocInfo.begin();
-    m_slotAllocInfo.erase(m_slotAllocInfo.begin());
-    return ret;
+    NS_ASSERT(m_slotAllocInfoCount > 0);
+
+    const auto& first = m_slotAllocInfo.at(m_slotAllocInfoOldest & (m_slotAllocInfo.size() - 1));
+    NS_ASSERT(first.m_valid);
+    return RetrieveSlotAllocInfo(first.m_slotAllocInfo.m_sfnSf);
 }
 
 SlotAllocInfo
@@ -823,14 +1021,24 @@ NrPhy::RetrieveSlotAllocInfo(const SfnSf& sfnsf)
     NS_LOG_FUNCTION(" slot " << sfnsf);
     NS_ASSERT(sfnsf.GetNumerology() == GetNumerology());
 
-    for (auto allocIt = m_slotAllocInfo.begin(); allocIt != m_slotAllocInfo.end(); ++allocIt)
+    auto& entry = m_slotAllocInfo.at(GetSlotAllocInfoIndex(sfnsf));
+    if (entry.m_valid && entry.m_slotAllocInfo.m_sfnSf == sfnsf)
     {
-        if (allocIt->m_sfnSf == sfnsf)
+        SlotAllocInfo ret = std::move(entry.m_slotAllocInfo);
+        entry.m_slotAllocInfo.m_varTtiAllocInfo.clear();
+        entry.m_valid = false;
+        --m_slotAllocInfoCount;
+        if (m_slotAllocInfoCount > 0 && sfnsf.Normalize() == m_slotAllocInfoOldest)
         {
-            SlotAllocInfo ret = *allocIt;
-            m_slotAllocInfo.erase(allocIt);
-            return ret;
+            // The next allocation is the first valid position after this one:
+            // the positions skipped are slots without allocation
+            do
+            {
+                ++m_slotAllocInfoOldest;
+            } while (!m_slotAllocInfo.at(m_slotAllocInfoOldest & (m_slotAllocInfo.size() - 1))
+                          .m_valid);
         }
+        return ret;
     }
 
     NS_FATAL_ERROR("Didn't found the slot");
@@ -842,29 +1050,39 @@ NrPhy::PeekSlotAllocInfo(const SfnSf& sfnsf)
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(sfnsf.GetNumerology() == GetNumerology());
-    for (auto& alloc : m_slotAllocInfo)
-    {
-        if (alloc.m_sfnSf == sfnsf)
-        {
-            return alloc;
-        }
-    }
-
-    NS_FATAL_ERROR("Didn't found the slot");
+    auto& entry = m_slotAllocInfo.at(GetSlotAllocInfoIndex(sfnsf));
+    NS_ABORT_MSG_IF(!entry.m_valid || !(entry.m_slotAllocInfo.m_sfnSf == sfnsf),
+                    "Didn't found the slot");
+    return entry.m_slotAllocInfo;
 }
 
 size_t
 NrPhy::SlotAllocInfoSize() const
 {
     NS_LOG_FUNCTION(this);
-    return m_slotAllocInfo.size();
+    return m_slotAllocInfoCount;
 }
 
 bool
 NrPhy::IsCtrlMsgListEmpty() const
 {
     NS_LOG_FUNCTION(this);
-    return m_controlMessageQueue.empty() || m_controlMessageQueue.at(0).empty();
+    return m_controlMessageQueue.empty() ||
+           m_controlMessageQueue.at(m_controlMessageQueueHead).empty();
+}
+
+bool
+NrPhy::IsCtrlMsgQueueEmpty() const
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& msgs : m_controlMessageQueue)
+    {
+        if (!msgs.empty())
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 Ptr<const SpectrumModel>
@@ -33,23 +33,28 @@ class BeamConfId;
  *
  * \section phy_management_ctrl Management of the control message list
  *
- * The control message list is maintained as a list that has, always, a number
- * of element equals to the latency between PHY and MAC, plus one. The list
+ * The control message list is maintained as a ring buffer that has, always, a number
+ * of element equals to the latency between PHY and MAC, plus one. The ring
  * is initialized by a call to InitializeMessageList(). The messages
- * are enqueued by MAC at the end of the list through the method EnqueueCtrlMessage().
+ * are enqueued by MAC at the end of the ring through the method EnqueueCtrlMessage().
  * If the PHY has the necessity of adding a message, then it can use the
  * no-latency version of it, namely EnqueueCtrlMsgNow(). The messages for the
- * current slot (i.e., the messages at the front of the list) can be retrieved
- * with PopCurrentSlotCtrlMsgs(). To know if there are messages for the current
- * slot, use IsCtrlMsgListEmpty(). The list is stored in the variable
- * m_controlMessageQueue.
+ * current slot (i.e., the messages at the head of the ring) can be moved out
+ * with PopCurrentSlotCtrlMsgs(), which also advances the head. To know if there
+ * are messages for the current slot, use IsCtrlMsgListEmpty(). The ring is stored
+ * in the variable m_controlMessageQueue.
  *
  * \section phy_slot Management of the slot allocation list
  *
  * At the gNb, After the MAC does the slot allocation, it is saved in the PHY with the method
  * PushBackSlotAllocInfo(), and if an allocation for the same slot is already
  * present, the two will be merged together. The slot allocation is stored
- * inside the variable m_slotAllocInfo.
+ * inside the ring buffer m_slotAllocInfo, indexed by the normalized slot number
+ * modulo the ring size. The ring size is a power of two, large enough to hold the
+ * allocations for the L1/L2 latency and K0/K1/K2 delays; in the (unusual) case
+ * of allocations spanning more slots than the ring, the ring is doubled. The
+ * oldest allocation is tracked, so that RetrieveSlotAllocInfo() without
+ * arguments does not scan the ring.
  *
  * \section phy_mac_pdu Management of the MAC PDU that waits to be transmitted
  *
@@ -129,6 +134,18 @@ class NrPhy : public Object
      */
     void NotifyConnectionSuccessful();
 
+    /**
+     * \brief Resume the per-slot processing, if the PHY stopped it
+     *
+     * Called every time something is handed to the PHY for transmission
+     * (CTRL messages, MAC PDUs) and by the MAC through
+     * NrPhySapProvider::RequestSlotIndication(). The default implementation
+     * does nothing, as the PHY never skips slots.
+     *
+     * \see NrUePhy::WakeUp()
+     */
+    virtual void WakeUp();
+
     /**
      * \brief Configures TB decode latency
      * \param us decode latency
@@ -449,7 +466,17 @@ class NrPhy : public Object
      * <0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0> , and therefore the places in which there
      * is a 1 are from the 4th to the 11th, and that is reflected in the output)
      */
-    std::vector<int> FromRBGBitmaskToRBAssignment(const std::vector<uint8_t> rbgBitmask) const;
+    std::vector<int> FromRBGBitmaskToRBAssignment(const NrRbBitmask& rbgBitmask) const;
+
+    /**
+     * \brief Transform a MAC-made RBG bitmask into a RB bitmask
+     * \param rbgBitmask Bitmask which indicates the RBG in which there is a transmission
+     * \return the bitmask of the RB in which there is a transmission
+     *
+     * Same as FromRBGBitmaskToRBAssignment, but the output is kept compact. Use it
+     * when the RBs are only counted or iterated, e.g., for the expected TBs.
+     */
+    NrRbBitmask FromRBGBitmaskToRBBitmask(const NrRbBitmask& rbgBitmask) const;
 
     /**
      * \brief Protected function that is used to get the number of resource
@@ -482,9 +509,23 @@ class NrPhy : public Object
      * is updated to a particular value if the correspond RB index was inside the rbIndexVector,
      * or is left untouched otherwise.
      * \see NrSpectrumValueHelper::CreateTxPowerSpectralDensity
+     *
+     * The returned value is shared with the other users of the TX PSD cache,
+     * and therefore it must not be modified. The cache is keyed by the RB
+     * mask, the number of active streams, the power allocation type and the
+     * TX power, and it keeps (at most) TxPsdCacheSize entries, evicting the
+     * least recently used one.
+     */
+    Ptr<const SpectrumValue> GetTxPowerSpectralDensity(const std::vector<int>& rbIndexVector,
+                                                       uint8_t activeStreams);
+
+    /**
+     * \brief Drop all the TX PSDs stored in the cache
+     *
+     * Called when the spectrum model changes (bandwidth or numerology update).
+     * The TX power does not need it, since it is part of the key of the cache.
      */
-    Ptr<SpectrumValue> GetTxPowerSpectralDensity(const std::vector<int>& rbIndexVector,
-                                                 uint8_t activeStreams);
+    void InvalidateTxPsdCache();
 
     /**
      * \brief Store the slot allocation info at the front
@@ -538,6 +579,12 @@ class NrPhy : public Object
      */
     bool IsCtrlMsgListEmpty() const;
 
+    /**
+     * \brief Check if there are no control messages queued in any slot of the ring
+     * \return true if the whole control message ring is empty
+     */
+    bool IsCtrlMsgQueueEmpty() const;
+
     /**
      * \brief Enqueue a CTRL message without considering L1L2CtrlLatency
      * \param msg The message to enqueue
@@ -557,6 +604,8 @@ class NrPhy : public Object
     /**
      * \brief Extract and return the message list that is at the beginning of the queue
      * \return a list of control messages that are meant to be sent in the current slot
+     *
+     * The messages are moved out of the ring, and the head advances by one slot.
      */
     virtual std::list<Ptr<NrControlMessage>> PopCurrentSlotCtrlMsgs();
 
@@ -582,8 +631,61 @@ class NrPhy : public Object
     std::vector<LteNrTddSlotType> m_tddPattern = {F, F, F, F, F, F, F, F, F, F}; //!< Pattern
 
   private:
-    std::list<SlotAllocInfo> m_slotAllocInfo; //!< slot allocation info list
-    std::vector<std::list<Ptr<NrControlMessage>>> m_controlMessageQueue; //!< CTRL message queue
+    /**
+     * \brief Get the position of a slot in the slot allocation ring
+     * \param sfnsf the slot
+     * \return the index of the slot inside m_slotAllocInfo
+     */
+    std::size_t GetSlotAllocInfoIndex(const SfnSf& sfnsf) const;
+
+    /**
+     * \brief Store an allocation in the ring, growing the ring if the allocations
+     * span more slots than the ring
+     * \param slotAllocInfo the allocation to store (it must not exist already)
+     */
+    void InsertSlotAllocInfo(SlotAllocInfo&& slotAllocInfo);
+
+    /**
+     * \brief Double the size of the slot allocation ring, re-indexing its content
+     */
+    void GrowSlotAllocInfoRing();
+
+    /**
+     * \brief An element of the slot allocation ring
+     */
+    struct SlotAllocInfoRingEntry
+    {
+        bool m_valid{false};                    //!< true if the entry holds an allocation
+        SlotAllocInfo m_slotAllocInfo{SfnSf()}; //!< the allocation
+    };
+
+    /**
+     * \brief An entry of the TX PSD cache
+     */
+    struct TxPsdCacheEntry
+    {
+        std::size_t m_hash{0};            //!< Hash of the key fields
+        std::vector<int> m_rbIndexVector; //!< Active RBs
+        uint8_t m_activeStreams{0};       //!< Number of active streams
+        NrSpectrumValueHelper::PowerAllocationType m_powerAllocationType{
+            NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_USED}; //!< Power allocation type
+        double m_txPower{0.0};                                     //!< TX power in dBm
+        Ptr<const SpectrumValue> m_txPsd;                          //!< The cached TX PSD
+    };
+
+    using TxPsdCacheList = std::list<TxPsdCacheEntry>; //!< LRU list, most recent first
+
+    TxPsdCacheList m_txPsdCache; //!< TX PSD cache
+    std::unordered_multimap<std::size_t, TxPsdCacheList::iterator>
+        m_txPsdCacheIndex;          //!< Index over m_txPsdCache, keyed by the entry hash
+    uint32_t m_txPsdCacheSize{16}; //!< Max number of entries in the TX PSD cache (attribute)
+
+    std::vector<SlotAllocInfoRingEntry> m_slotAllocInfo; //!< slot allocation info ring
+    std::size_t m_slotAllocInfoCount{0}; //!< number of allocations stored in m_slotAllocInfo
+    uint64_t m_slotAllocInfoOldest{0};   //!< normalized slot of the oldest stored allocation
+    uint64_t m_slotAllocInfoNewest{0};   //!< upper bound of the slot of the newest allocation
+    std::vector<std::list<Ptr<NrControlMessage>>> m_controlMessageQueue; //!< CTRL message ring
+    std::size_t m_controlMessageQueueHead{0}; //!< position of the current slot in the CTRL ring
 
     Time m_tbDecodeLatencyUs{MicroSeconds(100)}; //!< transport block decode latency
     double m_centralFrequency{-1.0};             //!< Channel central frequency -- set by the helper
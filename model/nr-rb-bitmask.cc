@@ -0,0 +1,135 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-rb-bitmask.h"
+
+#include <ns3/assert.h>
+
+namespace ns3
+{
+
+NrRbBitmask::NrRbBitmask(std::size_t size, bool value)
+    : m_size(size)
+{
+    if (m_size > INLINE_BITS)
+    {
+        m_heap.resize(NumWords(), 0);
+    }
+
+    if (value)
+    {
+        uint64_t* words = Words();
+        for (std::size_t w = 0; w < NumWords(); ++w)
+        {
+            words[w] = ~uint64_t{0};
+        }
+        // Keep the bits beyond the size at 0, Count() and operator== rely on it
+        if (m_size % BITS_PER_WORD != 0)
+        {
+            words[NumWords() - 1] = (uint64_t{1} << (m_size % BITS_PER_WORD)) - 1;
+        }
+    }
+}
+
+NrRbBitmask::NrRbBitmask(const std::vector<uint8_t>& mask)
+    : NrRbBitmask(mask.size())
+{
+    for (std::size_t i = 0; i < mask.size(); ++i)
+    {
+        if (mask[i] != 0)
+        {
+            Set(i);
+        }
+    }
+}
+
+std::size_t
+NrRbBitmask::Count() const
+{
+    const uint64_t* words = Words();
+    std::size_t count = 0;
+    for (std::size_t w = 0; w < NumWords(); ++w)
+    {
+        count += static_cast<std::size_t>(__builtin_popcountll(words[w]));
+    }
+    return count;
+}
+
+bool
+NrRbBitmask::Any() const
+{
+    const uint64_t* words = Words();
+    for (std::size_t w = 0; w < NumWords(); ++w)
+    {
+        if (words[w] != 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<int>
+NrRbBitmask::GetSetIndexes() const
+{
+    std::vector<int> indexes;
+    indexes.reserve(Count());
+    ForEachSet([&indexes](std::size_t i) { indexes.push_back(static_cast<int>(i)); });
+    return indexes;
+}
+
+std::vector<uint8_t>
+NrRbBitmask::ToVector() const
+{
+    std::vector<uint8_t> mask(m_size, 0);
+    ForEachSet([&mask](std::size_t i) { mask[i] = 1; });
+    return mask;
+}
+
+NrRbBitmask&
+NrRbBitmask::operator|=(const NrRbBitmask& o)
+{
+    NS_ASSERT_MSG(m_size == o.m_size,
+                  "Cannot merge masks of different sizes: " << m_size << " and " << o.m_size);
+    uint64_t* words = Words();
+    const uint64_t* other = o.Words();
+    for (std::size_t w = 0; w < NumWords(); ++w)
+    {
+        words[w] |= other[w];
+    }
+    return *this;
+}
+
+bool
+NrRbBitmask::operator==(const NrRbBitmask& o) const
+{
+    if (m_size != o.m_size)
+    {
+        return false;
+    }
+    const uint64_t* words = Words();
+    const uint64_t* other = o.Words();
+    for (std::size_t w = 0; w < NumWords(); ++w)
+    {
+        if (words[w] != other[w])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::ostream&
+operator<<(std::ostream& os, const NrRbBitmask& mask)
+{
+    for (std::size_t i = 0; i < mask.GetSize(); ++i)
+    {
+        os << (mask.Test(i) ? 1 : 0);
+    }
+    return os;
+}
+
+} // namespace ns3
@@ -0,0 +1,208 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_RB_BITMASK_H
+#define NR_RB_BITMASK_H
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup utils
+ * \brief Compact bitmask of RBs (or RBGs)
+ *
+ * The allocation masks that travel from the scheduler to the PHYs (the
+ * DCI RBG bitmask, the per-symbol gNB allocation, the RB map of each
+ * expected TB) were stored as `std::vector<uint8_t>` with one byte per
+ * element, and were scanned linearly every time they were counted, merged
+ * or converted. This class stores one bit per element, packed in 64-bit
+ * words: counting is a popcount per word, merging is a bitwise OR per word
+ * and iterating over the set elements only visits the set bits.
+ *
+ * The storage is inline (no allocation) up to 320 elements, which covers
+ * the largest NR carrier (275 RBs). Larger masks, that the simulator allows
+ * (e.g., 100 MHz with numerology 0), transparently fall back to the heap.
+ *
+ * A mask can be built implicitly from a `std::vector<uint8_t>` with
+ * 0/1 values, the format used by the notching masks and by the previous
+ * versions of the API, and converted back with ToVector().
+ */
+class NrRbBitmask
+{
+  public:
+    /**
+     * \brief Build an empty mask (of size 0)
+     */
+    NrRbBitmask() = default;
+
+    /**
+     * \brief Build a mask of the specified size
+     * \param size number of elements
+     * \param value initial value of every element
+     */
+    explicit NrRbBitmask(std::size_t size, bool value = false);
+
+    /**
+     * \brief Build a mask from a vector of 0/1 values
+     * \param mask the vector; any value different than 0 sets the element
+     */
+    NrRbBitmask(const std::vector<uint8_t>& mask);
+
+    /**
+     * \return the number of elements in the mask (set or not)
+     */
+    std::size_t GetSize() const
+    {
+        return m_size;
+    }
+
+    /**
+     * \brief Set an element
+     * \param i index of the element
+     */
+    void Set(std::size_t i)
+    {
+        Words()[i / BITS_PER_WORD] |= (uint64_t{1} << (i % BITS_PER_WORD));
+    }
+
+    /**
+     * \brief Reset an element
+     * \param i index of the element
+     */
+    void Reset(std::size_t i)
+    {
+        Words()[i / BITS_PER_WORD] &= ~(uint64_t{1} << (i % BITS_PER_WORD));
+    }
+
+    /**
+     * \param i index of the element
+     * \return true if the element is set
+     */
+    bool Test(std::size_t i) const
+    {
+        return (Words()[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1;
+    }
+
+    /**
+     * \param i index of the element
+     * \return true if the element is set
+     */
+    bool operator[](std::size_t i) const
+    {
+        return Test(i);
+    }
+
+    /**
+     * \return the number of set elements
+     */
+    std::size_t Count() const;
+
+    /**
+     * \return true if at least one element is set
+     */
+    bool Any() const;
+
+    /**
+     * \brief Invoke a function for every set element, in increasing order
+     * \param f function taking the index of the element
+     */
+    template <typename F>
+    void ForEachSet(F&& f) const
+    {
+        const uint64_t* words = Words();
+        for (std::size_t w = 0; w < NumWords(); ++w)
+        {
+            uint64_t word = words[w];
+            while (word != 0)
+            {
+                f(w * BITS_PER_WORD + static_cast<std::size_t>(__builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+
+    /**
+     * \return the indexes of the set elements, in increasing order
+     */
+    std::vector<int> GetSetIndexes() const;
+
+    /**
+     * \return the mask as a vector of 0/1 values
+     */
+    std::vector<uint8_t> ToVector() const;
+
+    /**
+     * \brief Set all the elements that are set in the other mask
+     * \param o the other mask, of the same size
+     * \return a reference to this mask
+     */
+    NrRbBitmask& operator|=(const NrRbBitmask& o);
+
+    /**
+     * \param o the other mask
+     * \return true if the masks have the same size and the same set elements
+     */
+    bool operator==(const NrRbBitmask& o) const;
+
+    /**
+     * \param o the other mask
+     * \return true if the masks differ
+     */
+    bool operator!=(const NrRbBitmask& o) const
+    {
+        return !(*this == o);
+    }
+
+  private:
+    static constexpr std::size_t BITS_PER_WORD = 64;                  //!< Bits in a word
+    static constexpr std::size_t INLINE_WORDS = 5;                    //!< Words stored inline
+    static constexpr std::size_t INLINE_BITS = INLINE_WORDS * BITS_PER_WORD; //!< Inline bits
+
+    /**
+     * \return the number of words used by the mask
+     */
+    std::size_t NumWords() const
+    {
+        return (m_size + BITS_PER_WORD - 1) / BITS_PER_WORD;
+    }
+
+    /**
+     * \return the storage of the mask (inline or on the heap)
+     */
+    uint64_t* Words()
+    {
+        return m_size > INLINE_BITS ? m_heap.data() : m_inline.data();
+    }
+
+    /**
+     * \return the storage of the mask (inline or on the heap)
+     */
+    const uint64_t* Words() const
+    {
+        return m_size > INLINE_BITS ? m_heap.data() : m_inline.data();
+    }
+
+    std::size_t m_size{0};                          //!< Number of elements
+    std::array<uint64_t, INLINE_WORDS> m_inline{};  //!< Inline storage
+    std::vector<uint64_t> m_heap;                   //!< Storage for masks larger than INLINE_BITS
+};
+
+/**
+ * \brief Print the mask as a sequence of 0/1 values
+ * \param os output stream
+ * \param mask the mask to print
+ * \return the output stream
+ */
+std::ostream& operator<<(std::ostream& os, const NrRbBitmask& mask);
+
+} // namespace ns3
+
+#endif // NR_RB_BITMASK_H
@@ -19,12 +19,93 @@
 #include <ns3/lte-radio-bearer-tag.h>
 #include <ns3/trace-source-accessor.h>
 
+#include <algorithm>
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("NrSpectrumPhy");
 NS_OBJECT_ENSURE_REGISTERED(NrSpectrumPhy);
 
+NS_OBJECT_ENSURE_REGISTERED(NrSpectrumPhyList);
+
+TypeId
+NrSpectrumPhyList::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrSpectrumPhyList")
+                            .SetParent<Object>()
+                            .SetGroupName("Nr")
+                            .AddConstructor<NrSpectrumPhyList>();
+    return tid;
+}
+
+Ptr<NrSpectrumPhyList>
+NrSpectrumPhyList::GetOrCreate(const Ptr<SpectrumChannel>& channel)
+{
+    Ptr<NrSpectrumPhyList> list = channel->GetObject<NrSpectrumPhyList>();
+    if (list == nullptr)
+    {
+        list = CreateObject<NrSpectrumPhyList>();
+        channel->AggregateObject(list);
+    }
+    return list;
+}
+
+void
+NrSpectrumPhyList::Add(NrSpectrumPhy* phy)
+{
+    m_phys.push_back(phy);
+    m_indexValid = false;
+}
+
+void
+NrSpectrumPhyList::Remove(const NrSpectrumPhy* phy)
+{
+    m_phys.erase(std::remove(m_phys.begin(), m_phys.end(), phy), m_phys.end());
+    m_indexValid = false;
+}
+
+const std::vector<NrSpectrumPhy*>&
+NrSpectrumPhyList::GetPhys() const
+{
+    return m_phys;
+}
+
+const std::vector<NrSpectrumPhy*>&
+NrSpectrumPhyList::GetPhys(uint16_t cellId, uint8_t streamId, bool isEnb)
+{
+    if (!m_indexValid)
+    {
+        m_index.clear();
+        for (const auto& phy : m_phys)
+        {
+            if (phy->m_phy != nullptr)
+            {
+                m_index[Key(phy->GetCellId(), phy->GetStreamId(), phy->IsEnb())].push_back(phy);
+            }
+        }
+        m_indexValid = true;
+    }
+
+    auto it = m_index.find(Key(cellId, streamId, isEnb));
+    return it != m_index.end() ? it->second : m_noPhys;
+}
+
+void
+NrSpectrumPhyList::Invalidate()
+{
+    m_indexValid = false;
+}
+
+void
+NrSpectrumPhyList::DoDispose()
+{
+    m_phys.clear();
+    m_index.clear();
+    m_indexValid = false;
+    Object::DoDispose();
+}
+
 std::ostream&
 operator<<(std::ostream& os, const enum NrSpectrumPhy::State state)
 {
@@ -77,6 +158,11 @@ NrSpectrumPhy::DoDispose()
     NS_LOG_FUNCTION(this);
     if (m_channel)
     {
+        Ptr<NrSpectrumPhyList> list = m_channel->GetObject<NrSpectrumPhyList>();
+        if (list)
+        {
+            list->Remove(this);
+        }
         m_channel->Dispose();
     }
 
@@ -147,6 +233,13 @@ NrSpectrumPhy::GetTypeId()
                           DoubleValue(0.0),
                           MakeDoubleAccessor(&NrSpectrumPhy::SetInterStreamInterferenceRatio),
                           MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("IdealCtrl",
+                          "If true, DL CTRL and UL CTRL messages are delivered directly to "
+                          "their receivers instead of being transmitted through the channel. "
+                          "SRS are always transmitted through the channel.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrSpectrumPhy::m_idealCtrl),
+                          MakeBooleanChecker())
 
             .AddTraceSource("RxPacketTraceEnb",
                             "The no. of packets received and transmitted by the Base Station",
@@ -274,7 +367,19 @@ NrSpectrumPhy::GetMobility() const
 void
 NrSpectrumPhy::SetChannel(Ptr<SpectrumChannel> c)
 {
+    if (m_channel)
+    {
+        Ptr<NrSpectrumPhyList> list = m_channel->GetObject<NrSpectrumPhyList>();
+        if (list)
+        {
+            list->Remove(this);
+        }
+    }
     m_channel = c;
+    if (m_channel)
+    {
+        NrSpectrumPhyList::GetOrCreate(m_channel)->Add(this);
+    }
 }
 
 Ptr<const SpectrumModel>
@@ -380,7 +485,7 @@ NrSpectrumPhy::SetNoisePowerSpectralDensity(const Ptr<const SpectrumValue>& nois
 }
 
 void
-NrSpectrumPhy::SetTxPowerSpectralDensity(const Ptr<SpectrumValue>& TxPsd)
+NrSpectrumPhy::SetTxPowerSpectralDensity(const Ptr<const SpectrumValue>& TxPsd)
 {
     m_txPsd = TxPsd;
 }
@@ -415,8 +520,10 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
         {
             NS_LOG_INFO("Inter stream interference DATA signal. Interference Ratio "
                         << m_interStrInerfRatio);
-            (*params->psd) *= m_interStrInerfRatio;
-            Ptr<const SpectrumValue> rxPsdData = params->psd;
+            // The PSD may be shared with the TX PSD cache of the transmitter:
+            // scale a copy of it
+            Ptr<SpectrumValue> rxPsdData = params->psd->Copy();
+            (*rxPsdData) *= m_interStrInerfRatio;
             m_interferenceData->AddSignal(rxPsdData, duration);
             return;
         }
@@ -429,8 +536,8 @@ NrSpectrumPhy::StartRx(Ptr<SpectrumSignalParameters> params)
         {
             NS_LOG_INFO("Inter stream interference DL CTRL signal. Interference Ratio "
                         << m_interStrInerfRatio);
-            (*params->psd) *= m_interStrInerfRatio;
-            Ptr<const SpectrumValue> rxPsdDlCtrl = params->psd;
+            Ptr<SpectrumValue> rxPsdDlCtrl = params->psd->Copy();
+            (*rxPsdDlCtrl) *= m_interStrInerfRatio;
             m_interferenceCtrl->AddSignal(rxPsdDlCtrl, duration);
             return;
         }
@@ -601,7 +708,9 @@ NrSpectrumPhy::StartTxDataFrames(const Ptr<PacketBurst>& pb,
             Create<NrSpectrumSignalParametersDataFrame>();
         txParams->duration = duration;
         txParams->txPhy = this->GetObject<SpectrumPhy>();
-        txParams->psd = m_txPsd;
+        // The TX PSD is shared (and cached) by the PHY; the channel copies the
+        // signal parameters, and their PSD, before applying any loss to them
+        txParams->psd = ConstCast<SpectrumValue>(m_txPsd);
         txParams->packetBurst = pb;
         txParams->cellId = GetCellId();
         txParams->ctrlMsgList = ctrlMsgList;
@@ -663,18 +772,22 @@ NrSpectrumPhy::StartTxDlControlFrames(const std::list<Ptr<NrControlMessage>>& ct
     case IDLE: {
         NS_ASSERT(m_txPsd);
         ChangeState(TX, duration);
-        Ptr<NrSpectrumSignalParametersDlCtrlFrame> txParams =
-            Create<NrSpectrumSignalParametersDlCtrlFrame>();
-        txParams->duration = duration;
-        txParams->txPhy = GetObject<SpectrumPhy>();
-        txParams->psd = m_txPsd;
-        txParams->cellId = GetCellId();
-        txParams->pss = true;
-        txParams->ctrlMsgList = ctrlMsgList;
-
         m_txCtrlTrace(duration);
-        if (m_channel)
+
+        if (m_idealCtrl)
         {
+            StartTxIdealCtrl(ctrlMsgList, duration);
+        }
+        else if (m_channel)
+        {
+            Ptr<NrSpectrumSignalParametersDlCtrlFrame> txParams =
+                Create<NrSpectrumSignalParametersDlCtrlFrame>();
+            txParams->duration = duration;
+            txParams->txPhy = GetObject<SpectrumPhy>();
+            txParams->psd = ConstCast<SpectrumValue>(m_txPsd);
+            txParams->cellId = GetCellId();
+            txParams->pss = true;
+            txParams->ctrlMsgList = ctrlMsgList;
             m_channel->StartTx(txParams);
         }
         else
@@ -713,17 +826,21 @@ NrSpectrumPhy::StartTxUlControlFrames(const std::list<Ptr<NrControlMessage>>& ct
     case IDLE: {
         NS_ASSERT(m_txPsd);
         ChangeState(TX, duration);
-        Ptr<NrSpectrumSignalParametersUlCtrlFrame> txParams =
-            Create<NrSpectrumSignalParametersUlCtrlFrame>();
-        txParams->duration = duration;
-        txParams->txPhy = GetObject<SpectrumPhy>();
-        txParams->psd = m_txPsd;
-        txParams->cellId = GetCellId();
-        txParams->ctrlMsgList = ctrlMsgList;
-
         m_txCtrlTrace(duration);
-        if (m_channel)
+
+        if (m_idealCtrl && !IsOnlySrs(ctrlMsgList))
+        {
+            StartTxIdealCtrl(ctrlMsgList, duration);
+        }
+        else if (m_channel)
         {
+            Ptr<NrSpectrumSignalParametersUlCtrlFrame> txParams =
+                Create<NrSpectrumSignalParametersUlCtrlFrame>();
+            txParams->duration = duration;
+            txParams->txPhy = GetObject<SpectrumPhy>();
+            txParams->psd = ConstCast<SpectrumValue>(m_txPsd);
+            txParams->cellId = GetCellId();
+            txParams->ctrlMsgList = ctrlMsgList;
             m_channel->StartTx(txParams);
         }
         else
@@ -735,6 +852,58 @@ NrSpectrumPhy::StartTxUlControlFrames(const std::list<Ptr<NrControlMessage>>& ct
     }
 }
 
+void
+NrSpectrumPhy::StartTxIdealCtrl(const std::list<Ptr<NrControlMessage>>& ctrlMsgList,
+                                const Time& duration)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_channel)
+    {
+        NS_LOG_WARN("Working without channel (i.e., under test)");
+        return;
+    }
+
+    if (ctrlMsgList.empty())
+    {
+        return;
+    }
+
+    Ptr<NrSpectrumPhyList> list = m_channel->GetObject<NrSpectrumPhyList>();
+    NS_ASSERT(list != nullptr);
+
+    // Same conditions of StartRx(): UEs receive DL CTRL, gNBs receive UL CTRL,
+    // both only from their own cell and stream
+    for (const auto& phy : list->GetPhys(GetCellId(), m_streamId, !m_isEnb))
+    {
+        NS_LOG_LOGIC(this << " delivering " << ctrlMsgList.size() << " CTRL messages to "
+                          << phy);
+        if (phy->m_device)
+        {
+            Simulator::ScheduleWithContext(phy->m_device->GetNode()->GetId(),
+                                           duration,
+                                           &NrSpectrumPhy::EndRxIdealCtrl,
+                                           phy,
+                                           ctrlMsgList);
+        }
+        else
+        {
+            Simulator::Schedule(duration, &NrSpectrumPhy::EndRxIdealCtrl, phy, ctrlMsgList);
+        }
+    }
+}
+
+void
+NrSpectrumPhy::EndRxIdealCtrl(const std::list<Ptr<NrControlMessage>>& ctrlMsgList)
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_phyRxCtrlEndOkCallback)
+    {
+        m_phyRxCtrlEndOkCallback(ctrlMsgList, GetBwpId());
+    }
+}
+
 void
 NrSpectrumPhy::AddDataPowerChunkProcessor(const Ptr<LteChunkProcessor>& p)
 {
@@ -862,6 +1031,7 @@ void
 NrSpectrumPhy::InstallPhy(const Ptr<NrPhy>& phyModel)
 {
     m_phy = phyModel;
+    UpdateIdealCtrlReceivers();
 }
 
 void
@@ -894,7 +1064,7 @@ NrSpectrumPhy::AddExpectedTb(uint16_t rnti,
                              uint8_t ndi,
                              uint32_t size,
                              uint8_t mcs,
-                             const std::vector<int>& rbMap,
+                             const NrRbBitmask& rbMap,
                              uint8_t harqId,
                              uint8_t rv,
                              bool downlink,
@@ -941,6 +1111,7 @@ void
 NrSpectrumPhy::SetStreamId(uint8_t streamId)
 {
     m_streamId = streamId;
+    UpdateIdealCtrlReceivers();
 }
 
 uint8_t
@@ -1222,6 +1393,20 @@ void
 NrSpectrumPhy::SetIsEnb(bool isEnb)
 {
     m_isEnb = isEnb;
+    UpdateIdealCtrlReceivers();
+}
+
+void
+NrSpectrumPhy::UpdateIdealCtrlReceivers()
+{
+    if (m_channel)
+    {
+        Ptr<NrSpectrumPhyList> list = m_channel->GetObject<NrSpectrumPhyList>();
+        if (list)
+        {
+            list->Invalidate();
+        }
+    }
 }
 
 void
@@ -1272,17 +1457,16 @@ NrSpectrumPhy::EndRxData()
     {
         GetTBInfo(tbIt).m_sinrAvg = 0.0;
         GetTBInfo(tbIt).m_sinrMin = 99999999999;
-        for (const auto& rbIndex : GetTBInfo(tbIt).m_expected.m_rbBitmap)
-        {
+        GetTBInfo(tbIt).m_expected.m_rbBitmap.ForEachSet([&](std::size_t rbIndex) {
             GetTBInfo(tbIt).m_sinrAvg += m_sinrPerceived.ValuesAt(rbIndex);
             if (m_sinrPerceived.ValuesAt(rbIndex) < GetTBInfo(tbIt).m_sinrMin)
             {
                 GetTBInfo(tbIt).m_sinrMin = m_sinrPerceived.ValuesAt(rbIndex);
             }
-        }
+        });
 
         GetTBInfo(tbIt).m_sinrAvg =
-            GetTBInfo(tbIt).m_sinrAvg / GetTBInfo(tbIt).m_expected.m_rbBitmap.size();
+            GetTBInfo(tbIt).m_sinrAvg / GetTBInfo(tbIt).m_expected.m_rbBitmap.Count();
 
         NS_LOG_INFO("Finishing RX, sinrAvg=" << GetTBInfo(tbIt).m_sinrAvg << " sinrMin="
                                              << GetTBInfo(tbIt).m_sinrMin << " SinrAvg (dB) "
@@ -1325,11 +1509,13 @@ NrSpectrumPhy::EndRxData()
         }
 
         // Output is the output of the error model. From the TBLER we decide
-        // if the entire TB is corrupted or not
+        // if the entire TB is corrupted or not. The error models work on the
+        // list of RB indexes, which is gathered only here.
+        const std::vector<int> rbMap = GetTBInfo(tbIt).m_expected.m_rbBitmap.GetSetIndexes();
 
         GetTBInfo(tbIt).m_outputOfEM =
             m_errorModel->GetTbDecodificationStats(m_sinrPerceived,
-                                                   GetTBInfo(tbIt).m_expected.m_rbBitmap,
+                                                   rbMap,
                                                    GetTBInfo(tbIt).m_expected.m_tbSize,
                                                    GetTBInfo(tbIt).m_expected.m_mcs,
                                                    harqInfoList);
@@ -1342,7 +1528,7 @@ NrSpectrumPhy::EndRxData()
                                 << +GetTBInfo(tbIt).m_expected.m_harqProcessId << " size "
                                 << GetTBInfo(tbIt).m_expected.m_tbSize << " mcs "
                                 << (uint32_t)GetTBInfo(tbIt).m_expected.m_mcs << " bitmap "
-                                << GetTBInfo(tbIt).m_expected.m_rbBitmap.size()
+                                << GetTBInfo(tbIt).m_expected.m_rbBitmap.Count()
                                 << " rv from MAC: " << +GetTBInfo(tbIt).m_expected.m_rv
                                 << " elements in the history: " << harqInfoList.size() << " TBLER "
                                 << GetTBInfo(tbIt).m_outputOfEM->m_tbler << " corrupted "
@@ -1411,7 +1597,7 @@ NrSpectrumPhy::EndRxData()
             traceParams.m_bwpId = GetBwpId();
             traceParams.m_streamId = m_streamId;
             traceParams.m_rbAssignedNum =
-                static_cast<uint32_t>(GetTBInfo(*itTb).m_expected.m_rbBitmap.size());
+                static_cast<uint32_t>(GetTBInfo(*itTb).m_expected.m_rbBitmap.Count());
 
             if (enbRx)
             {
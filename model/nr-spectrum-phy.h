@@ -21,11 +21,94 @@
 #include <ns3/traced-callback.h>
 
 #include <functional>
+#include <map>
+#include <tuple>
+#include <vector>
 
 namespace ns3
 {
 
 class UniformPlanarArray;
+class NrSpectrumPhy;
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief The NrSpectrumPhy instances attached to a spectrum channel
+ *
+ * It is aggregated to the channel by the first NrSpectrumPhy attached to it,
+ * so that each channel keeps its own list, and it is used to find the receivers
+ * of the CTRL messages when the NrSpectrumPhy attribute IdealCtrl is true. The
+ * instances are added by NrSpectrumPhy::SetChannel() and removed when they are
+ * disposed or attached to another channel, so the list does not own them.
+ *
+ * The instances are indexed by cell ID, stream ID and side (gNB or UE). The
+ * index is built when it is needed, and it is invalidated when an instance is
+ * added or removed, and by NrSpectrumPhy::UpdateIdealCtrlReceivers() when the
+ * cell ID, the stream ID, the side or the PHY of an instance change.
+ */
+class NrSpectrumPhyList : public Object
+{
+  public:
+    /**
+     * \brief Get the object TypeId
+     * \return the object type id
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Get the list of a channel, aggregating a new one if it has none
+     * \param channel the channel
+     * \return the list of the channel
+     */
+    static Ptr<NrSpectrumPhyList> GetOrCreate(const Ptr<SpectrumChannel>& channel);
+
+    /**
+     * \brief Add a NrSpectrumPhy instance
+     * \param phy the instance
+     */
+    void Add(NrSpectrumPhy* phy);
+
+    /**
+     * \brief Remove a NrSpectrumPhy instance
+     * \param phy the instance
+     */
+    void Remove(const NrSpectrumPhy* phy);
+
+    /**
+     * \return The NrSpectrumPhy instances attached to the channel
+     */
+    const std::vector<NrSpectrumPhy*>& GetPhys() const;
+
+    /**
+     * \brief Get the instances of a cell, stream and side that have a PHY
+     * \param cellId the cell ID
+     * \param streamId the stream ID
+     * \param isEnb true for the gNB instances, false for the UE ones
+     * \return the instances, in the order in which they were added
+     */
+    const std::vector<NrSpectrumPhy*>& GetPhys(uint16_t cellId, uint8_t streamId, bool isEnb);
+
+    /**
+     * \brief Invalidate the index, after a change of the cell ID, stream ID,
+     * side or PHY of an instance
+     */
+    void Invalidate();
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief The key of the index: cell ID, stream ID and side
+     */
+    using Key = std::tuple<uint16_t, uint8_t, bool>;
+
+    std::vector<NrSpectrumPhy*> m_phys;                 //!< The NrSpectrumPhy instances
+    std::map<Key, std::vector<NrSpectrumPhy*>> m_index; //!< The instances of each key
+    bool m_indexValid{false};                           //!< False if m_index must be rebuilt
+    const std::vector<NrSpectrumPhy*> m_noPhys;         //!< Returned for a key without instances
+};
 
 /**
  * \ingroup ue-phy
@@ -58,6 +141,21 @@ class UniformPlanarArray;
  * pass the necessary information for the interference calculation and to
  * obtain the interference calculation results.
  *
+ * \section spectrum_phy_ideal_ctrl Ideal CTRL
+ *
+ * Since the CTRL channel is modelled as error-free, when the attribute IdealCtrl
+ * is true the DL CTRL and UL CTRL messages are not transmitted as signals through
+ * the spectrum channel, but delivered directly, at the end of the CTRL symbols,
+ * to the NrSpectrumPhy instances of the same channel, cell and stream that would
+ * have received them (the UEs for DL CTRL, the gNB for UL CTRL). SRS are still
+ * transmitted through the channel. Consequently, the measurements that are
+ * based on the reception of the DL CTRL signal (RSRP, PSS, DL CTRL SINR and
+ * pathloss traces) are not produced, and the CTRL signals are not considered for
+ * the channel sensing in unlicensed mode, nor as interference by the other
+ * cells. The receivers are found in the NrSpectrumPhyList aggregated to the
+ * channel, indexed by cell and stream: each CTRL transmission visits only the
+ * NrSpectrumPhy instances that receive it.
+ *
  * Also it has interface with HARQ module, to which it passes necessary
  * information for the HARQ feedback generation, which is then forwarded
  * to NrPhy.
@@ -71,6 +169,8 @@ class UniformPlanarArray;
  */
 class NrSpectrumPhy : public SpectrumPhy
 {
+    friend class NrSpectrumPhyList;
+
   public:
     /**
      * \brief Get the object TypeId
@@ -241,7 +341,7 @@ class NrSpectrumPhy : public SpectrumPhy
      * \param txPsd transmit power spectral density to be used for the upcoming transmissions by
      * this spectrum phy
      */
-    void SetTxPowerSpectralDensity(const Ptr<SpectrumValue>& txPsd);
+    void SetTxPowerSpectralDensity(const Ptr<const SpectrumValue>& txPsd);
     /*
      * \brief Returns the TX PSD
      * \return the TX PSD
@@ -382,7 +482,7 @@ class NrSpectrumPhy : public SpectrumPhy
      * \param ndi New data indicator (0 for retx)
      * \param size TB Size
      * \param mcs MCS of the transmission
-     * \param rbMap Resource Block map (PHY-ready vector of SINR indices)
+     * \param rbMap Resource Block map (set for the RBs carrying the TB)
      * \param harqId ID of the HARQ process in the MAC
      * \param rv Redundancy Version: number of times the HARQ has been retransmitted
      * \param downlink indicate if it is downling
@@ -394,7 +494,7 @@ class NrSpectrumPhy : public SpectrumPhy
                        uint8_t ndi,
                        uint32_t size,
                        uint8_t mcs,
-                       const std::vector<int>& rbMap,
+                       const NrRbBitmask& rbMap,
                        uint8_t harqId,
                        uint8_t rv,
                        bool downlink,
@@ -465,6 +565,13 @@ class NrSpectrumPhy : public SpectrumPhy
      * \param isEnb whether the spectrum PHY belongs to eNB or UE
      */
     void SetIsEnb(bool isEnb);
+    /**
+     * \brief Update the receivers of the ideal CTRL messages of the channel
+     *
+     * To be called when the cell ID of the PHY changes. The changes of the
+     * stream ID, of the side and of the PHY of this instance call it already.
+     */
+    void UpdateIdealCtrlReceivers();
     /**
      * \brief Get stream id of this NrSpectrumPhy
      *
@@ -573,6 +680,22 @@ class NrSpectrumPhy : public SpectrumPhy
      * state.
      */
     void EndRxSrs();
+    /**
+     * \brief Deliver the CTRL messages to their receivers without using the channel
+     * \param ctrlMsgList the CTRL messages to deliver
+     * \param duration the duration of the CTRL transmission
+     *
+     * Used instead of the channel when IdealCtrl is true. Receivers are the
+     * NrSpectrumPhy instances of the same channel, cell ID and stream ID, on the
+     * other side of the link (gNB for UL CTRL, UEs for DL CTRL).
+     */
+    void StartTxIdealCtrl(const std::list<Ptr<NrControlMessage>>& ctrlMsgList,
+                          const Time& duration);
+    /**
+     * \brief Receive CTRL messages delivered by StartTxIdealCtrl() and forward them to the PHY
+     * \param ctrlMsgList the received CTRL messages
+     */
+    void EndRxIdealCtrl(const std::list<Ptr<NrControlMessage>>& ctrlMsgList);
     /**
      * \brief Check if the channel is busy. If yes, updates the spectrum phy state.
      */
@@ -604,7 +727,7 @@ class NrSpectrumPhy : public SpectrumPhy
         ExpectedTb(uint8_t ndi,
                    uint32_t tbSize,
                    uint8_t mcs,
-                   const std::vector<int>& rbBitmap,
+                   const NrRbBitmask& rbBitmap,
                    uint8_t harqProcessId,
                    uint8_t rv,
                    bool isDownlink,
@@ -627,16 +750,16 @@ class NrSpectrumPhy : public SpectrumPhy
         ExpectedTb() = delete;
         ExpectedTb(const ExpectedTb& o) = default;
 
-        uint8_t m_ndi{0};            //!< New data indicator
-        uint32_t m_tbSize{0};        //!< TBSize
-        uint8_t m_mcs{0};            //!< MCS
-        std::vector<int> m_rbBitmap; //!< RB Bitmap
-        uint8_t m_harqProcessId{0};  //!< HARQ process ID (MAC)
-        uint8_t m_rv{0};             //!< RV
-        bool m_isDownlink{0};        //!< is Downlink?
-        uint8_t m_symStart{0};       //!< Sym start
-        uint8_t m_numSym{0};         //!< Num sym
-        SfnSf m_sfn;                 //!< SFN
+        uint8_t m_ndi{0};           //!< New data indicator
+        uint32_t m_tbSize{0};       //!< TBSize
+        uint8_t m_mcs{0};           //!< MCS
+        NrRbBitmask m_rbBitmap;     //!< RB Bitmap
+        uint8_t m_harqProcessId{0}; //!< HARQ process ID (MAC)
+        uint8_t m_rv{0};            //!< RV
+        bool m_isDownlink{0};       //!< is Downlink?
+        uint8_t m_symStart{0};      //!< Sym start
+        uint8_t m_numSym{0};        //!< Num sym
+        SfnSf m_sfn;                //!< SFN
     };
 
     struct TransportBlockInfo
@@ -693,7 +816,7 @@ class NrSpectrumPhy : public SpectrumPhy
     Ptr<NrInterference> m_interferenceSrs{
         nullptr}; //!< the interference object used to calculate the interference for this spectrum
                   //!< phy, exists only at gNB phy
-    Ptr<SpectrumValue> m_txPsd{nullptr};          //!< tx power spectral density
+    Ptr<const SpectrumValue> m_txPsd{nullptr};    //!< tx power spectral density (shared, read-only)
     Ptr<UniformRandomVariable> m_random{nullptr}; //!< the random variable used for TB decoding
 
     std::unordered_map<uint16_t, TransportBlockInfo>
@@ -771,6 +894,8 @@ class NrSpectrumPhy : public SpectrumPhy
     uint8_t m_streamId{UINT8_MAX}; //!< StreamId of this NrSpectrumPhy instance
     bool m_isEnb = false;
     double m_interStrInerfRatio{0.0}; //!< The inter-stream interference ratio.
+
+    bool m_idealCtrl{false}; //!< Deliver CTRL messages without the channel (attribute IdealCtrl)
 };
 
 } // namespace ns3
@@ -394,6 +394,8 @@ NrUeMac::DoReportBufferStatus(LteMacSapProvider::ReportBufferStatusParameters pa
     {
         NS_LOG_INFO("INACTIVE -> TO_SEND, bufSize " << GetTotalBufSize());
         m_srState = TO_SEND;
+        // The SR is sent in the next slot indication; make sure the PHY delivers it
+        m_phySapProvider->RequestSlotIndication();
     }
 }
 
@@ -173,6 +173,13 @@ NrUePhy::GetTypeId()
                           ObjectVectorValue(),
                           MakeObjectVectorAccessor(&NrUePhy::m_spectrumPhys),
                           MakeObjectVectorChecker<NrSpectrumPhy>())
+            .AddAttribute("IdleSlotFastForward",
+                          "If true, a connected UE with nothing scheduled or pending stops "
+                          "processing slots until a DCI for it, a CTRL message or a MAC PDU "
+                          "wakes it up. The SFN/SF is advanced arithmetically in between.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&NrUePhy::m_idleSlotFastForward),
+                          MakeBooleanChecker())
             .AddTraceSource("ReportUplinkTbSize",
                             "Report allocated uplink TB size for trace.",
                             MakeTraceSourceAccessor(&NrUePhy::m_reportUlTbSize),
@@ -288,7 +295,7 @@ NrUePhy::SetSubChannelsForTransmission(const std::vector<int>& mask,
 {
     // in uplink we currently support maximum 1 stream for DATA and CTRL, only SRS will be sent
     // using more than 1 stream
-    Ptr<SpectrumValue> txPsd = GetTxPowerSpectralDensity(mask, activeStreams);
+    Ptr<const SpectrumValue> txPsd = GetTxPowerSpectralDensity(mask, activeStreams);
     NS_ASSERT(txPsd);
 
     m_reportPowerSpectralDensity(m_currentSlot,
@@ -475,6 +482,8 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
 {
     NS_LOG_FUNCTION(this);
 
+    FastForwardSlots();
+
     if (msg->GetMessageType() == NrControlMessage::DL_DCI)
     {
         auto dciMsg = DynamicCast<NrDlDciMessage>(msg);
@@ -487,6 +496,13 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
             return; // DCI not for me
         }
 
+        if (m_sleeping)
+        {
+            // The gNB should have woken us up at the beginning of the slot
+            NS_LOG_WARN("UE" << m_rnti << " received a DL DCI while skipping slots");
+            WakeUp();
+        }
+
         SfnSf dciSfn = m_currentSlot;
         uint32_t k0Delay = dciMsg->GetKDelay();
         dciSfn.Add(k0Delay);
@@ -540,6 +556,12 @@ NrUePhy::PhyCtrlMessagesReceived(const Ptr<NrControlMessage>& msg)
             return; // DCI not for me
         }
 
+        if (m_sleeping)
+        {
+            NS_LOG_WARN("UE" << m_rnti << " received a UL DCI while skipping slots");
+            WakeUp();
+        }
+
         SfnSf ulSfnSf = m_currentSlot;
         uint32_t k2Delay = dciMsg->GetKDelay();
         ulSfnSf.Add(k2Delay);
@@ -749,6 +771,7 @@ NrUePhy::StartSlot(const SfnSf& s)
 
     // Call MAC before doing anything in PHY
     m_phySapUser->SlotIndication(m_currentSlot); // trigger mac
+    m_wakeUpRequested = false;
 
     // update the current slot object, and insert DL/UL CTRL allocations depending on the TDD
     // pattern
@@ -987,7 +1010,7 @@ NrUePhy::DlData(const std::shared_ptr<DciInfoElementTdma>& dci)
                                 dci->m_ndi.at(streamIndex),
                                 dci->m_tbSize.at(streamIndex),
                                 dci->m_mcs.at(streamIndex),
-                                FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask),
+                                FromRBGBitmaskToRBBitmask(dci->m_rbgBitmask),
                                 dci->m_harqProcess,
                                 dci->m_rv.at(streamIndex),
                                 true,
@@ -1002,7 +1025,7 @@ NrUePhy::DlData(const std::shared_ptr<DciInfoElementTdma>& dci)
                                  " symbols "
                               << +dci->m_symStart << "-" << +(dci->m_symStart + dci->m_numSym - 1)
                               << " num of rbg assigned: "
-                              << FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask).size()
+                              << dci->m_rbgBitmask.Count() * GetNumRbPerRbg()
                               << "\t start " << Simulator::Now() << " end "
                               << (Simulator::Now() + varTtiDuration));
         }
@@ -1015,15 +1038,13 @@ Time
 NrUePhy::UlData(const std::shared_ptr<DciInfoElementTdma>& dci)
 {
     NS_LOG_FUNCTION(this);
+    const std::vector<int> rbAssignment = FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask);
     if (m_enableUplinkPowerControl)
     {
-        m_txPower = m_powerControl->GetPuschTxPower(
-            (FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask)).size());
+        m_txPower = m_powerControl->GetPuschTxPower(rbAssignment.size());
     }
     // Currently uplink DATA is transmitted over only 1 stream
-    SetSubChannelsForTransmission(FromRBGBitmaskToRBAssignment(dci->m_rbgBitmask),
-                                  dci->m_numSym,
-                                  1);
+    SetSubChannelsForTransmission(rbAssignment, dci->m_numSym, 1);
     Time varTtiDuration = GetSymbolPeriod() * dci->m_numSym;
     std::list<Ptr<NrControlMessage>> ctrlMsg;
     // MIMO is not supported for UL yet.
@@ -1116,12 +1137,22 @@ NrUePhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
     if (m_currSlotAllocInfo.m_varTtiAllocInfo.size() == 0)
     {
         // end of slot
-        m_currentSlot.Add(1);
+        if (m_idleSlotFastForward && IsIdle())
+        {
+            // Keep m_currentSlot and m_lastSlotStart pointing to this slot;
+            // FastForwardSlots() will advance them when needed.
+            NS_LOG_INFO("UE" << m_rnti << " idle, skipping slots after " << m_currentSlot);
+            m_sleeping = true;
+        }
+        else
+        {
+            m_currentSlot.Add(1);
 
-        Simulator::Schedule(m_lastSlotStart + GetSlotPeriod() - Simulator::Now(),
-                            &NrUePhy::StartSlot,
-                            this,
-                            m_currentSlot);
+            Simulator::Schedule(m_lastSlotStart + GetSlotPeriod() - Simulator::Now(),
+                                &NrUePhy::StartSlot,
+                                this,
+                                m_currentSlot);
+        }
     }
     else
     {
@@ -1139,6 +1170,66 @@ NrUePhy::EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci)
     m_receptionEnabled = false;
 }
 
+bool
+NrUePhy::IsIdle() const
+{
+    return m_ulConfigured && m_rnti != 0 && !m_wakeUpRequested && SlotAllocInfoSize() == 0 &&
+           IsCtrlMsgQueueEmpty() && m_ctrlMsgs.empty() && m_packetBurstMap.empty() &&
+           m_dlHarqInfo.empty() && !m_lbtEvent.IsRunning() && m_channelStatus != REQUESTED;
+}
+
+void
+NrUePhy::FastForwardSlots()
+{
+    if (!m_sleeping)
+    {
+        return;
+    }
+
+    NS_ASSERT(Simulator::Now() >= m_lastSlotStart);
+    int64_t elapsed = (Simulator::Now() - m_lastSlotStart).GetTimeStep() /
+                      GetSlotPeriod().GetTimeStep();
+    if (elapsed > 0)
+    {
+        m_lastSlotStart += GetSlotPeriod() * elapsed;
+        m_currentSlot.Add(static_cast<uint32_t>(elapsed));
+    }
+}
+
+void
+NrUePhy::WakeUp()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (!m_idleSlotFastForward)
+    {
+        return;
+    }
+
+    if (!m_sleeping)
+    {
+        m_wakeUpRequested = true;
+        return;
+    }
+
+    FastForwardSlots();
+    m_sleeping = false;
+
+    // m_lastSlotStart is now the start of the slot that contains the current time:
+    // if that slot has just begun, process it, otherwise start from the next one.
+    SfnSf nextSlot = m_currentSlot;
+    Time nextSlotStart = m_lastSlotStart;
+    if (Simulator::Now() > m_lastSlotStart)
+    {
+        nextSlot.Add(1);
+        nextSlotStart += GetSlotPeriod();
+    }
+
+    NS_LOG_INFO("UE" << m_rnti << " waking up, next slot " << nextSlot << " at "
+                     << nextSlotStart);
+    Simulator::Schedule(nextSlotStart - Simulator::Now(), &NrUePhy::StartSlot, this, nextSlot);
+}
+
 void
 NrUePhy::PhyDataPacketReceived(const Ptr<Packet>& p)
 {
@@ -1274,6 +1365,8 @@ NrUePhy::EnqueueDlHarqFeedback(const DlHarqInfo& m)
     msg->SetSourceBwp(GetBwpId());
     msg->SetDlHarqFeedback(m);
 
+    FastForwardSlots();
+
     auto k1It = m_harqIdToK1Map.find(m.m_harqProcessId);
 
     NS_LOG_DEBUG("ReceiveLteDlHarqFeedback"
@@ -1377,12 +1470,14 @@ void
 NrUePhy::DoReset()
 {
     NS_LOG_FUNCTION(this);
+    WakeUp();
 }
 
 void
 NrUePhy::DoStartCellSearch(uint16_t dlEarfcn)
 {
     NS_LOG_FUNCTION(this << dlEarfcn);
+    WakeUp();
     DoSetInitialBandwidth();
 }
 
@@ -1409,6 +1504,7 @@ void
 NrUePhy::DoSynchronizeWithEnb(uint16_t cellId)
 {
     NS_LOG_FUNCTION(this << cellId);
+    WakeUp();
     DoSetCellId(cellId);
     DoSetInitialBandwidth();
 }
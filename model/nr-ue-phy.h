@@ -51,6 +51,17 @@ class NrUePowerControl;
  * To initialize the class, you must call also SetSpectrumPhy() and StartEventLoop().
  * Usually, this is taken care inside the helper.
  *
+ * \section ue_phy_fast_forward Idle slot fast-forward
+ *
+ * When the attribute IdleSlotFastForward is true, a connected UE that, at the
+ * end of a slot, has no allocations, no CTRL messages, no MAC PDUs and no HARQ
+ * feedback pending stops scheduling its slot events (StartSlot, StartVarTti,
+ * EndVarTti) and the MAC slot indication. While the UE sleeps, the SFN/SF is
+ * advanced arithmetically when needed. The slot loop is resumed at the next
+ * slot boundary by WakeUp(), which is called by the gNB PHY when it sends a
+ * DCI to the UE, by the MAC when it has an SR to send, and every time a CTRL
+ * message or a MAC PDU is enqueued in the PHY.
+ *
  * \see NrPhy::SetSpectrumPhy()
  * \see NrPhy::StartEventLoop()
  */
@@ -453,6 +464,16 @@ class NrUePhy : public NrPhy
                                 uint8_t subframe,
                                 uint16_t slot) override;
 
+    /**
+     * \brief Resume the slot loop at the next slot boundary
+     *
+     * If IdleSlotFastForward is enabled and the UE is skipping slots, schedule
+     * the start of the slot that begins at (or just after) the current time. If
+     * the UE is running the slot loop, prevent it from skipping slots until the
+     * next MAC slot indication has been delivered. Otherwise, do nothing.
+     */
+    void WakeUp() override;
+
     /**
      * \brief Called when rsReceivedPower is fired
      * \param power the power received
@@ -642,6 +663,22 @@ class NrUePhy : public NrPhy
      */
     void EndVarTti(const std::shared_ptr<DciInfoElementTdma>& dci);
 
+    /**
+     * \brief Check if the UE can skip the slots that follow the current one
+     * \return true if the UE is connected and has nothing scheduled or pending
+     */
+    bool IsIdle() const;
+
+    /**
+     * \brief Advance the SFN/SF of a sleeping UE up to the slot that contains
+     * the current time
+     *
+     * While the UE is sleeping, m_currentSlot and m_lastSlotStart refer to the
+     * last slot that has been processed (or computed by a previous call); the
+     * method does nothing if the UE is running the slot loop.
+     */
+    void FastForwardSlots();
+
     /**
      * \brief Set the Tx power spectral density based on the RB index vector
      * \param mask vector of the index of the RB (in SpectrumValue array)
@@ -839,6 +876,11 @@ class NrUePhy : public NrPhy
 
     SfnSf m_currentSlot;
 
+    bool m_idleSlotFastForward{false}; //!< Skip idle slots (attribute IdleSlotFastForward)
+    bool m_sleeping{false};            //!< True if the slot loop is suspended
+    bool m_wakeUpRequested{false};     //!< True if the UE must not sleep before the next
+                                       //!< slot indication
+
     /**
      * \brief Status of the channel for the PHY
      */
@@ -6,6 +6,7 @@
 
 #include "realistic-beamforming-algorithm.h"
 
+#include "beamforming-vector.h"
 #include "nr-gnb-net-device.h"
 #include "nr-gnb-phy.h"
 #include "nr-mac-scheduler-ns3.h"
@@ -82,7 +83,41 @@ RealisticBeamformingAlgorithm::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&RealisticBeamformingAlgorithm::SetUseSnrSrs,
                                               &RealisticBeamformingAlgorithm::UseSnrSrs),
-                          MakeBooleanChecker());
+                          MakeBooleanChecker())
+            .AddAttribute("HierarchicalSearch",
+                          "If true, the beam pairs of a coarse codebook are evaluated first, and "
+                          "then the search is refined around the best ones. If false, every "
+                          "beam pair is evaluated",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&RealisticBeamformingAlgorithm::m_hierarchicalSearch),
+                          MakeBooleanChecker())
+            .AddAttribute("CoarseStepFactor",
+                          "Number of BeamSearchAngleStep steps (and of sectors) between two beams "
+                          "of the coarse codebook of the hierarchical search",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&RealisticBeamformingAlgorithm::m_coarseStepFactor),
+                          MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute("NumCandidates",
+                          "Number of coarse beam pairs refined by the hierarchical search",
+                          UintegerValue(2),
+                          MakeUintegerAccessor(&RealisticBeamformingAlgorithm::m_numCandidates),
+                          MakeUintegerChecker<uint16_t>(1))
+            .AddAttribute(
+                "CheckHierarchicalSearch",
+                "If true, the hierarchical search is compared with the exhaustive one "
+                "(evaluating every beam pair), to collect statistics of agreement. The "
+                "estimated channel is the same for both searches",
+                BooleanValue(false),
+                MakeBooleanAccessor(&RealisticBeamformingAlgorithm::m_checkHierarchicalSearch),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "SinglePrecisionChannel",
+                "If true, the copies of the channel matrix saved for the delayed updates are "
+                "stored in single precision, halving their memory. The estimation of the long "
+                "term component is still computed in double precision",
+                BooleanValue(false),
+                MakeBooleanAccessor(&RealisticBeamformingAlgorithm::m_singlePrecisionChannel),
+                MakeBooleanChecker());
     return tid;
 }
 
@@ -137,6 +172,12 @@ RealisticBeamformingAlgorithm::UseSnrSrs() const
     return m_useSnrSrs;
 }
 
+BeamPairSearch::Stats
+RealisticBeamformingAlgorithm::GetBeamSearchStats() const
+{
+    return m_searchStats;
+}
+
 void
 RealisticBeamformingAlgorithm::NotifySrsSinrReport(uint16_t cellId, uint16_t rnti, double srsSinr)
 {
@@ -210,8 +251,16 @@ RealisticBeamformingAlgorithm::NotifySrsReport(uint16_t cellId, uint16_t rnti, d
             DelayedUpdateInfo dui;
             dui.updateTime = Simulator::Now() + conf.updateDelay;
             dui.srsSinr = m_maxSrsSinrPerSlot; // SNR or SINR
-            dui.channelMatrix = GetChannelMatrix();
-            m_delayedUpdateInfo.push(dui);
+            if (m_singlePrecisionChannel)
+            {
+                dui.channelMatrix = nullptr;
+                dui.compactChannelMatrix = NrCompactChannelMatrix(*GetChannelMatrix());
+            }
+            else
+            {
+                dui.channelMatrix = GetChannelMatrix();
+            }
+            m_delayedUpdateInfo.push(std::move(dui));
             // schedule delayed update
             Simulator::Schedule(conf.updateDelay,
                                 &RealisticBeamformingAlgorithm::NotifyHelper,
@@ -292,7 +341,6 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
                     "Beamforming method cannot be performed between two devices that are placed in "
                     "the same position.");
 
-    double max = 0;
     double maxTxTheta = 0;
     double maxRxTheta = 0;
     uint16_t maxTxSector = 0;
@@ -309,17 +357,22 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
     TriggerEventConf conf = GetTriggerEventConf();
     double srsSinr = 0;
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix = nullptr;
+    const NrCompactChannelMatrix* compactChannelMatrix = nullptr;
 
     if (conf.event == RealisticBfManager::DELAYED_UPDATE)
     {
         NS_ASSERT(m_delayedUpdateInfo.size());
-        DelayedUpdateInfo dui = m_delayedUpdateInfo.front();
+        const DelayedUpdateInfo& dui = m_delayedUpdateInfo.front();
         NS_ABORT_MSG_UNLESS(dui.updateTime == Simulator::Now(),
                             "Current time should be equal to the updateTime from the "
                             "DelayedUpdateInfo structure."); // sanity check that we are using
                                                              // correct dui
         srsSinr = dui.srsSinr;
         channelMatrix = dui.channelMatrix;
+        if (channelMatrix == nullptr)
+        {
+            compactChannelMatrix = &dui.compactChannelMatrix;
+        }
     }
     else
     {
@@ -327,69 +380,119 @@ RealisticBeamformingAlgorithm::GetBeamformingVectors()
         channelMatrix = GetChannelMatrix();
     }
 
+    // The beams of each device, in the order of the search: the grid position
+    // is (elevation index, sector), and the UE elevations are truncated
+    std::vector<BeamId> gnbBeams;
+    std::vector<BeamId> ueBeams;
+    std::vector<BeamPairSearch::GridPosition> gnbGrid;
+    std::vector<BeamPairSearch::GridPosition> ueGrid;
+    uint16_t thetaIndex = 0;
     for (double gnbTheta = 60; gnbTheta < 121; gnbTheta = gnbTheta + m_beamSearchAngleStep)
     {
         for (uint16_t gnbSector = 0; gnbSector <= gnbNumRows; gnbSector++)
         {
             NS_ASSERT(gnbSector < UINT16_MAX);
-            m_gnbSpectrumPhy->GetBeamManager()->SetSector(gnbSector, gnbTheta);
-            PhasedArrayModel::ComplexVector gnbW =
-                m_gnbSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
+            gnbBeams.emplace_back(gnbSector, gnbTheta);
+            gnbGrid.push_back({thetaIndex, gnbSector});
+        }
+        thetaIndex++;
+    }
+    thetaIndex = 0;
+    for (double ueTheta = 60; ueTheta < 121;
+         ueTheta = static_cast<uint16_t>(ueTheta + m_beamSearchAngleStep))
+    {
+        for (uint16_t ueSector = 0; ueSector <= ueNumRows; ueSector++)
+        {
+            NS_ASSERT(ueSector < UINT16_MAX);
+            ueBeams.emplace_back(ueSector, ueTheta);
+            ueGrid.push_back({thetaIndex, ueSector});
+        }
+        thetaIndex++;
+    }
 
-            for (double ueTheta = 60; ueTheta < 121;
-                 ueTheta = static_cast<uint16_t>(ueTheta + m_beamSearchAngleStep))
+    std::vector<PhasedArrayModel::ComplexVector> gnbCodebook;
+    std::vector<PhasedArrayModel::ComplexVector> ueCodebook;
+    for (const auto& beam : gnbBeams)
+    {
+        gnbCodebook.push_back(CreateDirectionalBfv(m_gnbSpectrumPhy->GetBeamManager()->GetAntenna(),
+                                                   beam.GetSector(),
+                                                   beam.GetElevation()));
+    }
+    for (const auto& beam : ueBeams)
+    {
+        ueCodebook.push_back(CreateDirectionalBfv(m_ueSpectrumPhy->GetBeamManager()->GetAntenna(),
+                                                  beam.GetSector(),
+                                                  beam.GetElevation()));
+    }
+
+    // The channel is estimated once per update, from the SRS report: every
+    // candidate pair is then scored against the same estimate
+    const MatrixBasedChannelModel::Complex3DVector estimatedChannel =
+        compactChannelMatrix != nullptr ? GetEstimatedChannel(*compactChannelMatrix, srsSinr)
+                                        : GetEstimatedChannel(channelMatrix, srsSinr);
+
+    // Check if the channel matrix was generated considering the gNB as the
+    // s-node and the UE as the u-node or viceversa
+    uint32_t gnbArrayId = m_gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetId();
+    uint32_t ueArrayId = m_ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetId();
+    bool isReverse = compactChannelMatrix != nullptr
+                         ? compactChannelMatrix->IsReverse(gnbArrayId, ueArrayId)
+                         : channelMatrix->IsReverse(gnbArrayId, ueArrayId);
+    const std::vector<PhasedArrayModel::ComplexVector>& uCodebook =
+        isReverse ? gnbCodebook : ueCodebook;
+
+    // The projection of the estimated channel on each u-node beam is computed
+    // the first time the beam is evaluated, and shared by all its pairs
+    std::vector<std::vector<std::complex<double>>> uProjections(uCodebook.size());
+
+    BeamPairSearch::Result result = BeamPairSearch::Search(
+        gnbGrid,
+        ueGrid,
+        {m_hierarchicalSearch, m_coarseStepFactor, m_numCandidates, m_checkHierarchicalSearch},
+        [&](size_t gnbBeam, size_t ueBeam) {
+            NS_ABORT_MSG_IF(gnbCodebook[gnbBeam].GetSize() == 0 ||
+                                ueCodebook[ueBeam].GetSize() == 0,
+                            "Beamforming vectors must be initialized in order to calculate "
+                            "the long term matrix.");
+            size_t uBeam = isReverse ? gnbBeam : ueBeam;
+            const PhasedArrayModel::ComplexVector& sW =
+                isReverse ? ueCodebook[ueBeam] : gnbCodebook[gnbBeam];
+            if (uProjections[uBeam].empty())
             {
-                for (uint16_t ueSector = 0; ueSector <= ueNumRows; ueSector++)
-                {
-                    NS_ASSERT(ueSector < UINT16_MAX);
-                    m_ueSpectrumPhy->GetBeamManager()->SetSector(ueSector, ueTheta);
-                    PhasedArrayModel::ComplexVector ueW =
-                        m_ueSpectrumPhy->GetBeamManager()->GetCurrentBeamformingVector();
-
-                    NS_ABORT_MSG_IF(gnbW.GetSize() == 0 || ueW.GetSize() == 0,
-                                    "Beamforming vectors must be initialized in order to calculate "
-                                    "the long term matrix.");
-
-                    const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
-                        GetEstimatedLongTermComponent(
-                            channelMatrix,
-                            gnbW,
-                            ueW,
-                            m_gnbSpectrumPhy->GetObject<MobilityModel>(),
-                            m_ueSpectrumPhy->GetObject<MobilityModel>(),
-                            srsSinr,
-                            m_gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
-                            m_ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>());
-
-                    double estimatedLongTermMetric =
-                        CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
-
-                    NS_LOG_LOGIC(
-                        " Estimated long term metric value: "
-                        << estimatedLongTermMetric << " gnb theta " << gnbTheta << " ue theta "
-                        << ueTheta << " gnb sector "
-                        << (M_PI * static_cast<double>(gnbSector) /
-                                static_cast<double>(gnbNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180
-                        << " ue sector "
-                        << (M_PI * static_cast<double>(ueSector) / static_cast<double>(ueNumRows) -
-                            0.5 * M_PI) /
-                               (M_PI)*180);
-
-                    if (max < estimatedLongTermMetric)
-                    {
-                        max = estimatedLongTermMetric;
-                        maxTxSector = gnbSector;
-                        maxRxSector = ueSector;
-                        maxTxTheta = gnbTheta;
-                        maxRxTheta = ueTheta;
-                        maxTxW = gnbW;
-                        maxRxW = ueW;
-                    }
-                }
+                uProjections[uBeam] = ProjectEstimatedChannel(estimatedChannel, uCodebook[uBeam]);
             }
-        }
+
+            const UniformPlanarArray::ComplexVector estimatedLongTermComponent =
+                GetEstimatedLongTermComponent(uProjections[uBeam], sW);
+
+            double estimatedLongTermMetric =
+                CalculateTheEstimatedLongTermMetric(estimatedLongTermComponent);
+
+            NS_LOG_LOGIC(" Estimated long term metric value: "
+                         << estimatedLongTermMetric << " gnb theta "
+                         << gnbBeams[gnbBeam].GetElevation() << " ue theta "
+                         << ueBeams[ueBeam].GetElevation() << " gnb sector "
+                         << (M_PI * static_cast<double>(gnbBeams[gnbBeam].GetSector()) /
+                                 static_cast<double>(gnbNumRows) -
+                             0.5 * M_PI) /
+                                (M_PI)*180
+                         << " ue sector "
+                         << (M_PI * static_cast<double>(ueBeams[ueBeam].GetSector()) /
+                                 static_cast<double>(ueNumRows) -
+                             0.5 * M_PI) /
+                                (M_PI)*180);
+            return estimatedLongTermMetric;
+        },
+        &m_searchStats);
+
+    if (result.m_found)
+    {
+        maxTxSector = gnbBeams[result.m_gnbBeam].GetSector();
+        maxRxSector = ueBeams[result.m_ueBeam].GetSector();
+        maxTxTheta = gnbBeams[result.m_gnbBeam].GetElevation();
+        maxRxTheta = ueBeams[result.m_ueBeam].GetElevation();
+        maxTxW = gnbCodebook[result.m_gnbBeam];
+        maxRxW = ueCodebook[result.m_ueBeam];
     }
 
     BeamformingVectorPair bfPair =
@@ -424,63 +527,100 @@ RealisticBeamformingAlgorithm::CalculateTheEstimatedLongTermMetric(
     return totalSum;
 }
 
-UniformPlanarArray::ComplexVector
-RealisticBeamformingAlgorithm::GetEstimatedLongTermComponent(
-    const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix,
-    const UniformPlanarArray::ComplexVector& aW,
-    const UniformPlanarArray::ComplexVector& bW,
-    Ptr<const MobilityModel> a,
-    Ptr<const MobilityModel> b,
-    double srsSinr,
-    Ptr<const PhasedArrayModel> aArray,
-    Ptr<const PhasedArrayModel> bArray) const
+template <typename ChannelCoefficients>
+MatrixBasedChannelModel::Complex3DVector
+RealisticBeamformingAlgorithm::EstimateChannel(const ChannelCoefficients& h, double srsSinr) const
 {
-    NS_LOG_FUNCTION(this);
-
-    // check if the channel matrix was generated considering a as the s-node and
-    // b as the u-node or viceversa
-    UniformPlanarArray::ComplexVector sW;
-    UniformPlanarArray::ComplexVector uW;
-    if (!channelMatrix->IsReverse(aArray->GetId(), bArray->GetId()))
-    {
-        sW = aW;
-        uW = bW;
-    }
-    else
-    {
-        sW = bW;
-        uW = aW;
-    }
+    size_t uAntenna = h.GetNumRows();
+    size_t sAntenna = h.GetNumCols();
+    size_t numCluster = h.GetNumPages();
 
-    uint16_t sAntenna = static_cast<uint16_t>(sW.GetSize());
-    uint16_t uAntenna = static_cast<uint16_t>(uW.GetSize());
-
-    NS_LOG_DEBUG("Calculate the estimation of the long term component with sAntenna: "
+    NS_LOG_DEBUG("Calculate the estimation of the channel with sAntenna: "
                  << sAntenna << " uAntenna: " << uAntenna);
     NS_ABORT_IF(srsSinr == 0);
 
     double varError = 1 / (srsSinr); // SINR the SINR from UL SRS reception
-    uint8_t numCluster = static_cast<uint8_t>(channelMatrix->m_channel.GetNumPages());
 
-    UniformPlanarArray::ComplexVector estimatedlongTerm(numCluster);
-    for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+    MatrixBasedChannelModel::Complex3DVector estimatedChannel(uAntenna, sAntenna, numCluster);
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
-        std::complex<double> txSum(0, 0);
-        for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
+        for (size_t sIndex = 0; sIndex < sAntenna; sIndex++)
         {
-            std::complex<double> rxSum(0, 0);
-            for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
+            for (size_t uIndex = 0; uIndex < uAntenna; uIndex++)
             {
                 // error is generated from the normal random variable with mean 0 and  variance
                 // varError*sqrt(1/2) for real/imaginary parts
                 std::complex<double> error =
                     std::complex<double>(m_normalRandomVariable->GetValue(0, sqrt(0.5) * varError),
                                          m_normalRandomVariable->GetValue(0, sqrt(0.5) * varError));
-                std::complex<double> hEstimate =
-                    channelMatrix->m_channel(uIndex, sIndex, cIndex) + error;
-                rxSum += uW[uIndex] * (hEstimate);
+                estimatedChannel(uIndex, sIndex, cIndex) = h(uIndex, sIndex, cIndex) + error;
             }
-            txSum = txSum + sW[sIndex] * rxSum;
+        }
+    }
+    return estimatedChannel;
+}
+
+MatrixBasedChannelModel::Complex3DVector
+RealisticBeamformingAlgorithm::GetEstimatedChannel(
+    const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix,
+    double srsSinr) const
+{
+    NS_LOG_FUNCTION(this);
+    return EstimateChannel(channelMatrix->m_channel, srsSinr);
+}
+
+MatrixBasedChannelModel::Complex3DVector
+RealisticBeamformingAlgorithm::GetEstimatedChannel(const NrCompactChannelMatrix& channelMatrix,
+                                                   double srsSinr) const
+{
+    NS_LOG_FUNCTION(this);
+    return EstimateChannel(channelMatrix, srsSinr);
+}
+
+std::vector<std::complex<double>>
+RealisticBeamformingAlgorithm::ProjectEstimatedChannel(
+    const MatrixBasedChannelModel::Complex3DVector& estimatedChannel,
+    const UniformPlanarArray::ComplexVector& uW) const
+{
+    size_t uAntenna = estimatedChannel.GetNumRows();
+    size_t sAntenna = estimatedChannel.GetNumCols();
+    size_t numCluster = estimatedChannel.GetNumPages();
+    NS_ASSERT_MSG(uW.GetSize() == uAntenna,
+                  "The beamforming vector does not match the channel matrix");
+
+    std::vector<std::complex<double>> uProjection(numCluster * sAntenna);
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        for (size_t sIndex = 0; sIndex < sAntenna; sIndex++)
+        {
+            std::complex<double> rxSum(0, 0);
+            for (size_t uIndex = 0; uIndex < uAntenna; uIndex++)
+            {
+                rxSum += uW[uIndex] * estimatedChannel(uIndex, sIndex, cIndex);
+            }
+            uProjection[cIndex * sAntenna + sIndex] = rxSum;
+        }
+    }
+    return uProjection;
+}
+
+UniformPlanarArray::ComplexVector
+RealisticBeamformingAlgorithm::GetEstimatedLongTermComponent(
+    const std::vector<std::complex<double>>& uProjection,
+    const UniformPlanarArray::ComplexVector& sW) const
+{
+    size_t sAntenna = sW.GetSize();
+    NS_ASSERT_MSG(sAntenna > 0 && uProjection.size() % sAntenna == 0,
+                  "The beamforming vector does not match the channel matrix");
+    size_t numCluster = uProjection.size() / sAntenna;
+
+    UniformPlanarArray::ComplexVector estimatedlongTerm(numCluster);
+    for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+    {
+        std::complex<double> txSum(0, 0);
+        for (size_t sIndex = 0; sIndex < sAntenna; sIndex++)
+        {
+            txSum = txSum + sW[sIndex] * uProjection[cIndex * sAntenna + sIndex];
         }
         estimatedlongTerm[cIndex] = txSum;
     }
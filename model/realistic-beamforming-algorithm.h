@@ -8,6 +8,8 @@
 #define SRC_NR_MODEL_REALISTIC_BEAMFORMING_ALGORITHM_H_
 
 #include "beam-id.h"
+#include "beam-pair-search.h"
+#include "nr-compact-channel-matrix.h"
 #include "nr-gnb-net-device.h"
 #include "nr-spectrum-phy.h"
 #include "nr-ue-net-device.h"
@@ -25,6 +27,7 @@ class SpectrumModel;
 class SpectrumValue;
 class RealisticBeamformingHelper;
 class NrRealisticBeamformingTestCase;
+class NrRealisticBeamformingSearchTestCase;
 
 /**
  * \ingroup gnb-phy
@@ -51,6 +54,7 @@ class RealisticBeamformingAlgorithm : public Object
 {
     friend RealisticBeamformingHelper;
     friend NrRealisticBeamformingTestCase;
+    friend NrRealisticBeamformingSearchTestCase;
 
   public:
     /*
@@ -64,7 +68,9 @@ class RealisticBeamformingAlgorithm : public Object
         double srsSinr;  //!< SRS SINR/SNR value
         Ptr<const MatrixBasedChannelModel::ChannelMatrix>
             channelMatrix; //!< saved deep copy of the channel matrix at the time instant when the
-                           //!< SRS is received
+                           //!< SRS is received (nullptr if it is saved in single precision)
+        NrCompactChannelMatrix compactChannelMatrix; //!< saved single-precision copy of the
+                                                     //!< channel matrix, if SinglePrecisionChannel
     };
 
     /*
@@ -174,6 +180,11 @@ class RealisticBeamformingAlgorithm : public Object
      */
     bool UseSnrSrs() const;
 
+    /**
+     * \return the statistics of the beam searches done so far
+     */
+    BeamPairSearch::Stats GetBeamSearchStats() const;
+
   private:
     /**
      * \brief Private function that is used to obtain the number of SRS symbols per slot
@@ -220,26 +231,59 @@ class RealisticBeamformingAlgorithm : public Object
      */
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> GetChannelMatrix() const;
     /**
-     * \brief Calculates an estimation of the long term component based on the channel measurements
+     * \brief Calculates the estimation of the channel based on the SRS report,
+     * by adding to each coefficient of the channel matrix H an estimation error
      * \param channelMatrix the channel matrix H
-     * \param aW the beamforming vector of the first device
-     * \param bW the beamforming vector of the second device
-     * \param a the first node mobility model
-     * \param b the second node mobility model
-     * \param srsSinr the SRS report to be used to estimate the long term component metric
-     * \param aArray the antenna array of the first device
-     * \param bArray the antenna array of the second device
-     * \return the estimated long term component
+     * \param srsSinr the SRS report that determines the variance of the error
+     * \return the estimated channel, with the same dimensions of H
      */
-    UniformPlanarArray::ComplexVector GetEstimatedLongTermComponent(
+    MatrixBasedChannelModel::Complex3DVector GetEstimatedChannel(
         const Ptr<const MatrixBasedChannelModel::ChannelMatrix>& channelMatrix,
-        const UniformPlanarArray::ComplexVector& aW,
-        const UniformPlanarArray::ComplexVector& bW,
-        Ptr<const MobilityModel> a,
-        Ptr<const MobilityModel> b,
-        double srsSinr,
-        Ptr<const PhasedArrayModel> aArray,
-        Ptr<const PhasedArrayModel> bArray) const;
+        double srsSinr) const;
+
+    /**
+     * \brief Calculates the estimation of the channel based on the SRS report,
+     * from a single-precision copy of the channel matrix
+     * \param channelMatrix the single-precision channel matrix H
+     * \param srsSinr the SRS report that determines the variance of the error
+     * \return the estimated channel, with the same dimensions of H
+     */
+    MatrixBasedChannelModel::Complex3DVector GetEstimatedChannel(
+        const NrCompactChannelMatrix& channelMatrix,
+        double srsSinr) const;
+
+    /**
+     * \brief Estimation of the channel, common to the double and single-precision
+     * channel matrices
+     * \param h the coefficients of the channel matrix, accessed as h(u, s, c)
+     * \param srsSinr the SRS report that determines the variance of the error
+     * \return the estimated channel
+     */
+    template <typename ChannelCoefficients>
+    MatrixBasedChannelModel::Complex3DVector EstimateChannel(const ChannelCoefficients& h,
+                                                             double srsSinr) const;
+
+    /**
+     * \brief Projects the estimated channel on the beamforming vector of the
+     * u-node, i.e., computes sum_u uW[u] H(u, s, c) for each s and c
+     * \param estimatedChannel the estimated channel
+     * \param uW the beamforming vector of the u-node
+     * \return the projection, cluster major (numClusters x numS values)
+     */
+    std::vector<std::complex<double>> ProjectEstimatedChannel(
+        const MatrixBasedChannelModel::Complex3DVector& estimatedChannel,
+        const UniformPlanarArray::ComplexVector& uW) const;
+
+    /**
+     * \brief Calculates the estimation of the long term component of a beam
+     * pair, from the projection of the estimated channel on the u-node beam
+     * \param uProjection the estimated channel projected on the u-node beam
+     * \param sW the beamforming vector of the s-node
+     * \return the estimated long term component, per cluster
+     */
+    UniformPlanarArray::ComplexVector GetEstimatedLongTermComponent(
+        const std::vector<std::complex<double>>& uProjection,
+        const UniformPlanarArray::ComplexVector& sW) const;
 
     /*
      * \brief Calculates the total metric based on the each element of the long term component
@@ -258,6 +302,12 @@ class RealisticBeamformingAlgorithm : public Object
     double m_beamSearchAngleStep{30}; //!< The beam angle step that will be used to define the set
                                       //!< of beams for which will be estimated the channel
     bool m_useSnrSrs{true};           //!< SRS SNR used as measurement (attribute)
+    bool m_hierarchicalSearch{false}; //!< the HierarchicalSearch attribute
+    uint16_t m_coarseStepFactor{2};   //!< the CoarseStepFactor attribute
+    uint16_t m_numCandidates{2};      //!< the NumCandidates attribute
+    bool m_checkHierarchicalSearch{false}; //!< the CheckHierarchicalSearch attribute
+    bool m_singlePrecisionChannel{false};  //!< the SinglePrecisionChannel attribute
+    BeamPairSearch::Stats m_searchStats;   //!< Statistics of the beam searches
     // variable members, counters, and saving values
     double m_maxSrsSinrPerSlot{
         0}; //!< the maximum SRS SINR/SNR per slot in Watts, e.g. if there are 4 SRS symbols per UE,
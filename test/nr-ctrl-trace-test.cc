@@ -0,0 +1,292 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-ctrl-trace-test.h"
+
+#include <ns3/applications-module.h>
+#include <ns3/internet-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+#include <ns3/point-to-point-helper.h>
+#include <ns3/rng-seed-manager.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+bool
+NrCtrlTraceTestCase::CtrlEvent::operator==(const CtrlEvent& o) const
+{
+    return timeNs == o.timeNs && sfnSf == o.sfnSf && cellId == o.cellId && type == o.type &&
+           rnti == o.rnti && symStart == o.symStart && numSym == o.numSym && mcs == o.mcs &&
+           tbSize == o.tbSize;
+}
+
+NrCtrlTraceTestCase::NrCtrlTraceTestCase(const std::string& name,
+                                         const std::string& option,
+                                         const std::vector<Vector>& gnbPositions,
+                                         const std::vector<UeConf>& ues,
+                                         Time simTime)
+    : TestCase(name),
+      m_gnbPositions(gnbPositions),
+      m_option(option),
+      m_ues(ues),
+      m_simTime(simTime)
+{
+}
+
+void
+NrCtrlTraceTestCase::CheckRuns([[maybe_unused]] const RunResult& reference,
+                               [[maybe_unused]] const RunResult& withOption)
+{
+}
+
+size_t
+NrCtrlTraceTestCase::Count(const RunResult& r, uint8_t type)
+{
+    return std::count_if(r.events.begin(), r.events.end(), [type](const CtrlEvent& e) {
+        return e.type == type;
+    });
+}
+
+void
+NrCtrlTraceTestCase::UePhyRxCtrl(SfnSf sfnSf,
+                                 uint16_t cellId,
+                                 [[maybe_unused]] uint16_t rnti,
+                                 [[maybe_unused]] uint8_t bwpId,
+                                 Ptr<NrControlMessage> msg)
+{
+    std::shared_ptr<DciInfoElementTdma> dci;
+    if (msg->GetMessageType() == NrControlMessage::DL_DCI)
+    {
+        dci = DynamicCast<NrDlDciMessage>(msg)->GetDciInfoElement();
+    }
+    else if (msg->GetMessageType() == NrControlMessage::UL_DCI)
+    {
+        dci = DynamicCast<NrUlDciMessage>(msg)->GetDciInfoElement();
+    }
+    else
+    {
+        return;
+    }
+
+    m_result->events.push_back({Simulator::Now().GetNanoSeconds(),
+                                sfnSf.GetEncoding(),
+                                cellId,
+                                static_cast<uint8_t>(msg->GetMessageType()),
+                                dci->m_rnti,
+                                dci->m_symStart,
+                                dci->m_numSym,
+                                dci->m_mcs.empty() ? uint8_t{0} : dci->m_mcs.front(),
+                                dci->m_tbSize.empty() ? 0 : dci->m_tbSize.front()});
+}
+
+void
+NrCtrlTraceTestCase::UeMacTxCtrl(SfnSf sfnSf,
+                                 uint16_t cellId,
+                                 uint16_t rnti,
+                                 [[maybe_unused]] uint8_t bwpId,
+                                 Ptr<NrControlMessage> msg)
+{
+    if (msg->GetMessageType() == NrControlMessage::SR ||
+        msg->GetMessageType() == NrControlMessage::BSR)
+    {
+        m_result->events.push_back({Simulator::Now().GetNanoSeconds(),
+                                    sfnSf.GetEncoding(),
+                                    cellId,
+                                    static_cast<uint8_t>(msg->GetMessageType()),
+                                    rnti,
+                                    0,
+                                    0,
+                                    0,
+                                    0});
+    }
+}
+
+NrCtrlTraceTestCase::RunResult
+NrCtrlTraceTestCase::RunScenario(bool enabled)
+{
+    RunResult result;
+    m_result = &result;
+
+    // Both runs must draw the same random numbers
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    RngSeedManager::ResetNextStreamIndex();
+
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(m_gnbPositions.size());
+    ueNodes.Create(m_ues.size());
+
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    for (const auto& position : m_gnbPositions)
+    {
+        positionAlloc->Add(position);
+    }
+    for (const auto& ue : m_ues)
+    {
+        positionAlloc->Add(ue.position);
+    }
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbPhyAttribute("Numerology", UintegerValue(1));
+    ConfigureOption(nrHelper, enabled);
+
+    NetDeviceContainer gnbNetDev = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t stream = 1;
+    stream += nrHelper->AssignStreams(gnbNetDev, stream);
+    nrHelper->AssignStreams(ueNetDev, stream);
+    for (uint32_t i = 0; i < gnbNetDev.GetN(); i++)
+    {
+        DynamicCast<NrGnbNetDevice>(gnbNetDev.Get(i))->UpdateConfig();
+    }
+    for (uint32_t i = 0; i < ueNetDev.GetN(); i++)
+    {
+        Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice>(ueNetDev.Get(i));
+        ueDev->UpdateConfig();
+        ueDev->GetPhy(0)->TraceConnectWithoutContext(
+            "UePhyRxedCtrlMsgsTrace",
+            MakeCallback(&NrCtrlTraceTestCase::UePhyRxCtrl, this));
+        ueDev->GetMac(0)->TraceConnectWithoutContext(
+            "UeMacTxedCtrlMsgsTrace",
+            MakeCallback(&NrCtrlTraceTestCase::UeMacTxCtrl, this));
+    }
+
+    Ptr<Node> pgw = epcHelper->GetPgwNode();
+    NodeContainer remoteHostContainer;
+    remoteHostContainer.Create(1);
+    Ptr<Node> remoteHost = remoteHostContainer.Get(0);
+    InternetStackHelper internet;
+    internet.Install(remoteHostContainer);
+
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Gb/s")));
+    p2ph.SetDeviceAttribute("Mtu", UintegerValue(2500));
+    p2ph.SetChannelAttribute("Delay", TimeValue(Seconds(0.010)));
+    NetDeviceContainer internetDevices = p2ph.Install(pgw, remoteHost);
+    Ipv4AddressHelper ipv4h;
+    ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer internetIpIfaces = ipv4h.Assign(internetDevices);
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4StaticRouting> remoteHostStaticRouting =
+        ipv4RoutingHelper.GetStaticRouting(remoteHost->GetObject<Ipv4>());
+    remoteHostStaticRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"), Ipv4Mask("255.0.0.0"), 1);
+    internet.Install(ueNodes);
+    Ipv4InterfaceContainer ueIpIface = epcHelper->AssignUeIpv4Address(ueNetDev);
+
+    uint16_t dlPort = 1234;
+    uint16_t ulPort = 1235;
+    ApplicationContainer dlServerApps;
+    UdpServerHelper ulServer(ulPort);
+    ApplicationContainer ulServerApps = ulServer.Install(remoteHost);
+    for (uint32_t i = 0; i < ueNodes.GetN(); i++)
+    {
+        const UeConf& ue = m_ues.at(i);
+        Ptr<Ipv4StaticRouting> ueStaticRouting =
+            ipv4RoutingHelper.GetStaticRouting(ueNodes.Get(i)->GetObject<Ipv4>());
+        ueStaticRouting->SetDefaultRoute(epcHelper->GetUeDefaultGatewayAddress(), 1);
+
+        ApplicationContainer clientApps;
+        if (!ue.dlInterval.IsZero())
+        {
+            UdpServerHelper dlServer(dlPort);
+            dlServerApps.Add(dlServer.Install(ueNodes.Get(i)));
+
+            UdpClientHelper dlClient(ueIpIface.GetAddress(i), dlPort);
+            dlClient.SetAttribute("Interval", TimeValue(ue.dlInterval));
+            dlClient.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+            dlClient.SetAttribute("PacketSize", UintegerValue(ue.packetSize));
+            clientApps.Add(dlClient.Install(remoteHost));
+        }
+        if (!ue.ulInterval.IsZero())
+        {
+            UdpClientHelper ulClient(internetIpIfaces.GetAddress(1), ulPort);
+            ulClient.SetAttribute("Interval", TimeValue(ue.ulInterval));
+            ulClient.SetAttribute("MaxPackets", UintegerValue(0xFFFFFFFF));
+            ulClient.SetAttribute("PacketSize", UintegerValue(ue.packetSize));
+            clientApps.Add(ulClient.Install(ueNodes.Get(i)));
+        }
+        clientApps.Start(ue.start);
+        clientApps.Stop(ue.stop);
+    }
+    dlServerApps.Start(Seconds(0));
+    ulServerApps.Start(Seconds(0));
+
+    nrHelper->AttachToClosestEnb(ueNetDev, gnbNetDev);
+
+    Simulator::Stop(m_simTime);
+    Simulator::Run();
+
+    for (uint32_t i = 0; i < dlServerApps.GetN(); i++)
+    {
+        result.dlReceived += DynamicCast<UdpServer>(dlServerApps.Get(i))->GetReceived();
+    }
+    result.ulReceived = DynamicCast<UdpServer>(ulServerApps.Get(0))->GetReceived();
+    result.eventCount = Simulator::GetEventCount();
+    Simulator::Destroy();
+
+    m_result = nullptr;
+    return result;
+}
+
+void
+NrCtrlTraceTestCase::DoRun()
+{
+    RunResult reference = RunScenario(false);
+    RunResult withOption = RunScenario(true);
+
+    NS_TEST_ASSERT_MSG_GT(Count(reference, NrControlMessage::DL_DCI), 0, "No DL DCI received");
+    NS_TEST_ASSERT_MSG_GT(Count(reference, NrControlMessage::UL_DCI), 0, "No UL DCI received");
+    NS_TEST_ASSERT_MSG_GT(Count(reference, NrControlMessage::SR), 0, "No SR sent");
+    NS_TEST_ASSERT_MSG_GT(Count(reference, NrControlMessage::BSR), 0, "No BSR sent");
+    NS_TEST_ASSERT_MSG_GT(reference.dlReceived, 0, "No DL packet received");
+    NS_TEST_ASSERT_MSG_GT(reference.ulReceived, 0, "No UL packet received");
+
+    NS_TEST_ASSERT_MSG_EQ(withOption.dlReceived,
+                          reference.dlReceived,
+                          m_option << " changed the DL packets received");
+    NS_TEST_ASSERT_MSG_EQ(withOption.ulReceived,
+                          reference.ulReceived,
+                          m_option << " changed the UL packets received");
+    NS_TEST_ASSERT_MSG_EQ(withOption.events.size(),
+                          reference.events.size(),
+                          m_option << " changed the number of DCIs, SRs and BSRs");
+    for (size_t i = 0; i < reference.events.size() && i < withOption.events.size(); i++)
+    {
+        const CtrlEvent& e = reference.events[i];
+        NS_TEST_ASSERT_MSG_EQ(withOption.events[i] == e,
+                              true,
+                              m_option << " changed the CTRL message " << i << " (type "
+                                       << +e.type << ", cell " << e.cellId << ", RNTI "
+                                       << e.rnti << " at " << e.timeNs << " ns)");
+    }
+
+    CheckRuns(reference, withOption);
+}
+
+} // namespace ns3
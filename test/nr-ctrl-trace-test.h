@@ -0,0 +1,182 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_CTRL_TRACE_TEST_H
+#define NR_CTRL_TRACE_TEST_H
+
+#include <ns3/nstime.h>
+#include <ns3/ptr.h>
+#include <ns3/test.h>
+#include <ns3/vector.h>
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+class NrHelper;
+class NrControlMessage;
+class SfnSf;
+
+/**
+ * \file nr-ctrl-trace-test.h
+ * \ingroup test
+ *
+ * \brief Base test case for the options that must not change the behaviour of
+ * the simulation, only its cost. The same scenario is run with the option
+ * disabled and enabled, and the test checks that the UEs receive the same DL
+ * and UL DCIs (same time, SFN/SF, cell, RNTI, symbols, MCS and TB size), send
+ * the same SRs and BSRs, and that the same packets are received.
+ */
+
+/**
+ * \ingroup test
+ * \brief Runs a scenario with and without an option and compares the CTRL traces
+ *
+ * The gNBs and the UEs are placed at the given positions, and each UE is
+ * attached to the closest gNB. Every UE receives DL packets from and sends UL
+ * packets to a remote host, with its own intervals and start time. Derived
+ * classes enable or disable the option in ConfigureOption(), and can add
+ * checks on the two runs in CheckRuns().
+ */
+class NrCtrlTraceTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief The position and the traffic of a UE
+     */
+    struct UeConf
+    {
+        Vector position;     //!< Position of the UE
+        Time dlInterval;     //!< Interval between DL packets, zero for no DL traffic
+        Time ulInterval;     //!< Interval between UL packets, zero for no UL traffic
+        uint32_t packetSize; //!< Size of the DL and UL packets
+        Time start;          //!< Start of the traffic
+        Time stop;           //!< End of the traffic
+    };
+
+    /**
+     * \brief A CTRL message received or sent by a UE
+     *
+     * SRs and BSRs have no allocation, so their symbols, MCS and TB size are
+     * zero.
+     */
+    struct CtrlEvent
+    {
+        int64_t timeNs;   //!< Time of the event
+        uint64_t sfnSf;   //!< Encoded SFN/SF of the UE at the event
+        uint16_t cellId;  //!< Cell of the UE
+        uint8_t type;     //!< Type of the CTRL message
+        uint16_t rnti;    //!< RNTI of the UE
+        uint8_t symStart; //!< First symbol of the allocation
+        uint8_t numSym;   //!< Number of symbols of the allocation
+        uint8_t mcs;      //!< MCS of the first stream
+        uint32_t tbSize;  //!< TB size of the first stream
+
+        /**
+         * \param o the other event
+         * \return true if the events are equal
+         */
+        bool operator==(const CtrlEvent& o) const;
+    };
+
+    /**
+     * \brief The results of a run
+     */
+    struct RunResult
+    {
+        std::vector<CtrlEvent> events; //!< DL/UL DCIs received and SRs/BSRs sent by the UEs
+        uint64_t dlReceived{0};        //!< DL packets received by the UEs
+        uint64_t ulReceived{0};        //!< UL packets received by the remote host
+        uint64_t eventCount{0};        //!< Simulator events executed by the run
+    };
+
+    /**
+     * \brief Create the test case
+     * \param name the name of the test case
+     * \param option the name of the option, used in the error messages
+     * \param gnbPositions the positions of the gNBs
+     * \param ues the positions and the traffic of the UEs
+     * \param simTime the duration of the simulation
+     */
+    NrCtrlTraceTestCase(const std::string& name,
+                        const std::string& option,
+                        const std::vector<Vector>& gnbPositions,
+                        const std::vector<UeConf>& ues,
+                        Time simTime);
+
+  protected:
+    /**
+     * \brief Enable or disable the option under test
+     * \param nrHelper the helper, before the devices are installed
+     * \param enabled true for the run with the option
+     */
+    virtual void ConfigureOption(const Ptr<NrHelper>& nrHelper, bool enabled) = 0;
+
+    /**
+     * \brief Additional checks on the two runs, after the comparison of the traces
+     * \param reference the run without the option
+     * \param withOption the run with the option
+     */
+    virtual void CheckRuns(const RunResult& reference, const RunResult& withOption);
+
+    /**
+     * \param r the results of a run
+     * \param type the type of CTRL message
+     * \return The number of CTRL messages of the given type in the run
+     */
+    static size_t Count(const RunResult& r, uint8_t type);
+
+    std::vector<Vector> m_gnbPositions; //!< Positions of the gNBs
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Run the scenario
+     * \param enabled true to enable the option
+     * \return The results of the run
+     */
+    RunResult RunScenario(bool enabled);
+
+    /**
+     * \brief Records the DCIs received by a UE PHY
+     * \param sfnSf the SFN/SF of the UE
+     * \param cellId the cell id
+     * \param rnti the RNTI
+     * \param bwpId the BWP id
+     * \param msg the CTRL message
+     */
+    void UePhyRxCtrl(SfnSf sfnSf,
+                     uint16_t cellId,
+                     uint16_t rnti,
+                     uint8_t bwpId,
+                     Ptr<NrControlMessage> msg);
+
+    /**
+     * \brief Records the SRs and BSRs sent by a UE MAC
+     * \param sfnSf the SFN/SF of the UE
+     * \param cellId the cell id
+     * \param rnti the RNTI
+     * \param bwpId the BWP id
+     * \param msg the CTRL message
+     */
+    void UeMacTxCtrl(SfnSf sfnSf,
+                     uint16_t cellId,
+                     uint16_t rnti,
+                     uint8_t bwpId,
+                     Ptr<NrControlMessage> msg);
+
+    std::string m_option;         //!< Name of the option under test
+    std::vector<UeConf> m_ues;    //!< Positions and traffic of the UEs
+    Time m_simTime;               //!< Duration of the simulation
+    RunResult* m_result{nullptr}; //!< The results of the current run
+};
+
+} // namespace ns3
+
+#endif // NR_CTRL_TRACE_TEST_H
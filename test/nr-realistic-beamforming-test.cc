@@ -39,6 +39,12 @@ NS_LOG_COMPONENT_DEFINE("NrRealisticBeamformingTest");
  * the Doppler, and frequency-selectivity) while realistic beamforming
  * algorithm only estimates the long-term component of the fading.
  * Hence, then slight variations on the best beam selection may appear.
+ *
+ * A second test checks the search of the realistic beamforming algorithm,
+ * which projects the estimated channel on each beam of the u-node: for a fixed
+ * seed, and thus the same estimated channel, it has to select the same beams as
+ * the evaluation of every pair directly on the estimated channel, as the
+ * algorithm did before the projection.
  */
 
 class NrRealisticBeamformingTestSuite : public TestSuite
@@ -62,6 +68,18 @@ class NrRealisticBeamformingTestCase : public TestCase
     }; //!< the test execution mode type
 };
 
+class NrRealisticBeamformingSearchTestCase : public TestCase
+{
+  public:
+    NrRealisticBeamformingSearchTestCase()
+        : TestCase("RealisticBeamforming search on the projected channel")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
 /**
  * TestSuite
  */
@@ -79,6 +97,7 @@ NrRealisticBeamformingTestSuite::NrRealisticBeamformingTestSuite()
     AddTestCase(new NrRealisticBeamformingTestCase("RealisticBeamforming basic test case",
                                                    durationExtensive),
                 durationExtensive);
+    AddTestCase(new NrRealisticBeamformingSearchTestCase(), durationQuick);
 }
 
 /**
@@ -312,6 +331,151 @@ NrRealisticBeamformingTestCase::DoRun()
     Simulator::Destroy();
 }
 
+void
+NrRealisticBeamformingSearchTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(1);
+    ueNodes.Create(1);
+
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0.0, 10)); // gNB
+    positionAlloc->Add(Vector(10, 10, 1.5)); // UE
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    CcBwpCreator::SimpleOperationBandConf bandConf(29e9, 100e6, 1, BandwidthPartInfo::UMa_LoS);
+    CcBwpCreator ccBwpCreator;
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement",
+                                     PointerValue(CreateObject<IsotropicAntennaModel>()));
+    nrHelper->SetUeAntennaAttribute("AntennaElement",
+                                    PointerValue(CreateObject<IsotropicAntennaModel>()));
+    nrHelper->SetGnbBeamManagerTypeId(RealisticBfManager::GetTypeId());
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    nrHelper->AssignStreams(ueDevs, randomStream);
+    Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice>(gnbDevs.Get(0));
+    Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice>(ueDevs.Get(0));
+    gnbDev->UpdateConfig();
+    ueDev->UpdateConfig();
+
+    Ptr<NrSpectrumPhy> gnbSpectrumPhy = gnbDev->GetPhy(0)->GetSpectrumPhy(0);
+    Ptr<NrSpectrumPhy> ueSpectrumPhy = ueDev->GetPhy(0)->GetSpectrumPhy(0);
+    Ptr<RealisticBeamformingAlgorithm> realisticBeamforming =
+        CreateObject<RealisticBeamformingAlgorithm>();
+    realisticBeamforming
+        ->Install(gnbDev, ueDev, gnbSpectrumPhy, ueSpectrumPhy, gnbDev->GetScheduler(0));
+
+    // The codebooks of the search
+    Ptr<const UniformPlanarArray> gnbArray = gnbSpectrumPhy->GetBeamManager()->GetAntenna();
+    Ptr<const UniformPlanarArray> ueArray = ueSpectrumPhy->GetBeamManager()->GetAntenna();
+    double step = realisticBeamforming->GetBeamSearchAngleStep();
+    std::vector<BeamformingVector> gnbCodebook;
+    std::vector<BeamformingVector> ueCodebook;
+    for (double theta = 60; theta < 121; theta = theta + step)
+    {
+        for (uint16_t sector = 0; sector <= 4; sector++)
+        {
+            gnbCodebook.emplace_back(CreateDirectionalBfv(gnbArray, sector, theta),
+                                     BeamId(sector, theta));
+        }
+    }
+    for (double theta = 60; theta < 121; theta = static_cast<uint16_t>(theta + step))
+    {
+        for (uint16_t sector = 0; sector <= 2; sector++)
+        {
+            ueCodebook.emplace_back(CreateDirectionalBfv(ueArray, sector, theta),
+                                    BeamId(sector, theta));
+        }
+    }
+
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix =
+        realisticBeamforming->GetChannelMatrix();
+    uint32_t gnbArrayId = gnbSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetId();
+    uint32_t ueArrayId = ueSpectrumPhy->GetAntenna()->GetObject<PhasedArrayModel>()->GetId();
+    bool isReverse = channelMatrix->IsReverse(gnbArrayId, ueArrayId);
+
+    for (double srsSinrDb : {40.0, 0.0, -10.0})
+    {
+        double srsSinr = std::pow(10.0, 0.1 * srsSinrDb);
+        realisticBeamforming->m_maxSrsSinrPerSlot = srsSinr;
+
+        // The estimated channel of the search, drawn from the same stream
+        realisticBeamforming->AssignStreams(100);
+        MatrixBasedChannelModel::Complex3DVector estimatedChannel =
+            realisticBeamforming->GetEstimatedChannel(channelMatrix, srsSinr);
+        realisticBeamforming->AssignStreams(100);
+        BeamformingVectorPair bfPair = realisticBeamforming->GetBeamformingVectors();
+
+        // Every pair evaluated directly on the estimated channel, in the order of
+        // the exhaustive search
+        double bestMetric = 0;
+        BeamId bestGnbBeam;
+        BeamId bestUeBeam;
+        for (const auto& gnbBeam : gnbCodebook)
+        {
+            for (const auto& ueBeam : ueCodebook)
+            {
+                const PhasedArrayModel::ComplexVector& sW =
+                    isReverse ? ueBeam.first : gnbBeam.first;
+                const PhasedArrayModel::ComplexVector& uW =
+                    isReverse ? gnbBeam.first : ueBeam.first;
+                size_t numCluster = estimatedChannel.GetNumPages();
+                UniformPlanarArray::ComplexVector longTerm(numCluster);
+                for (size_t cIndex = 0; cIndex < numCluster; cIndex++)
+                {
+                    std::complex<double> txSum(0, 0);
+                    for (size_t sIndex = 0; sIndex < sW.GetSize(); sIndex++)
+                    {
+                        std::complex<double> rxSum(0, 0);
+                        for (size_t uIndex = 0; uIndex < uW.GetSize(); uIndex++)
+                        {
+                            rxSum += uW[uIndex] * estimatedChannel(uIndex, sIndex, cIndex);
+                        }
+                        txSum += sW[sIndex] * rxSum;
+                    }
+                    longTerm[cIndex] = txSum;
+                }
+                double metric = realisticBeamforming->CalculateTheEstimatedLongTermMetric(longTerm);
+                if (metric > bestMetric)
+                {
+                    bestMetric = metric;
+                    bestGnbBeam = gnbBeam.second;
+                    bestUeBeam = ueBeam.second;
+                }
+            }
+        }
+
+        NS_TEST_ASSERT_MSG_EQ(bfPair.first.second,
+                              bestGnbBeam,
+                              "Different gNB beam with SRS SINR " << srsSinrDb << " dB");
+        NS_TEST_ASSERT_MSG_EQ(bfPair.second.second,
+                              bestUeBeam,
+                              "Different UE beam with SRS SINR " << srsSinrDb << " dB");
+    }
+
+    Simulator::Destroy();
+}
+
 // Do not forget to allocate an instance of this TestSuite
 static NrRealisticBeamformingTestSuite nrTestSuite;
 
@@ -0,0 +1,122 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beam-pair-search.h>
+#include <ns3/test.h>
+
+#include <cmath>
+
+/**
+ * \file nr-test-beam-pair-search.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for BeamPairSearch. The score of a pair is a smooth
+ * function with a single peak in the grids of the two devices. The test checks
+ * that the exhaustive search evaluates every pair and finds the peak, and that
+ * the hierarchical search finds the same pair evaluating fewer pairs, and
+ * reports the agreement in the statistics.
+ */
+namespace ns3
+{
+
+class TestBeamPairSearchTestCase : public TestCase
+{
+  public:
+    TestBeamPairSearchTestCase(uint16_t coarseStepFactor, const std::string& name)
+        : TestCase(name),
+          m_coarseStepFactor(coarseStepFactor)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint16_t m_coarseStepFactor{1};
+};
+
+void
+TestBeamPairSearchTestCase::DoRun()
+{
+    // 5 x 9 gNB beams and 3 x 5 UE beams, as a cell scan with a 4x8 and a 2x4 array
+    std::vector<BeamPairSearch::GridPosition> gnbGrid;
+    std::vector<BeamPairSearch::GridPosition> ueGrid;
+    for (uint16_t row = 0; row < 5; ++row)
+    {
+        for (uint16_t col = 0; col < 9; ++col)
+        {
+            gnbGrid.push_back({row, col});
+        }
+    }
+    for (uint16_t row = 0; row < 3; ++row)
+    {
+        for (uint16_t col = 0; col < 5; ++col)
+        {
+            ueGrid.push_back({row, col});
+        }
+    }
+
+    BeamPairSearch::Stats stats;
+    for (uint16_t peak = 0; peak < 20; ++peak)
+    {
+        double gnbRow = peak % 5;
+        double gnbCol = (peak * 7) % 9;
+        double ueRow = peak % 3;
+        double ueCol = (peak * 3) % 5;
+        auto score = [&](size_t gnbBeam, size_t ueBeam) {
+            double d = std::pow(gnbGrid[gnbBeam].m_row - gnbRow, 2) +
+                       std::pow(gnbGrid[gnbBeam].m_col - gnbCol, 2) +
+                       std::pow(ueGrid[ueBeam].m_row - ueRow, 2) +
+                       std::pow(ueGrid[ueBeam].m_col - ueCol, 2);
+            return std::exp(-d / 4);
+        };
+
+        BeamPairSearch::Result exhaustive =
+            BeamPairSearch::Search(gnbGrid, ueGrid, {}, score, nullptr);
+        NS_TEST_ASSERT_MSG_EQ(exhaustive.m_found, true, "The exhaustive search found no pair");
+        NS_TEST_ASSERT_MSG_EQ(exhaustive.m_evaluated,
+                              gnbGrid.size() * ueGrid.size(),
+                              "The exhaustive search should evaluate every pair");
+        NS_TEST_ASSERT_MSG_EQ(exhaustive.m_gnbBeam,
+                              static_cast<size_t>(gnbRow * 9 + gnbCol),
+                              "Wrong gNB beam");
+        NS_TEST_ASSERT_MSG_EQ(exhaustive.m_ueBeam,
+                              static_cast<size_t>(ueRow * 5 + ueCol),
+                              "Wrong UE beam");
+
+        BeamPairSearch::Config config{true, m_coarseStepFactor, 2, true};
+        BeamPairSearch::Result hierarchical =
+            BeamPairSearch::Search(gnbGrid, ueGrid, config, score, &stats);
+        NS_TEST_ASSERT_MSG_EQ(hierarchical.m_gnbBeam, exhaustive.m_gnbBeam, "Wrong gNB beam");
+        NS_TEST_ASSERT_MSG_EQ(hierarchical.m_ueBeam, exhaustive.m_ueBeam, "Wrong UE beam");
+        if (m_coarseStepFactor > 1)
+        {
+            NS_TEST_ASSERT_MSG_LT(hierarchical.m_evaluated,
+                                  exhaustive.m_evaluated,
+                                  "The hierarchical search should evaluate fewer pairs");
+        }
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(stats.m_searches, 20, "Wrong number of searches");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_checked, 20, "Wrong number of checked searches");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_agreements, 20, "Every search should agree");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_totalPairs,
+                          20 * gnbGrid.size() * ueGrid.size(),
+                          "Wrong number of pairs");
+}
+
+class TestBeamPairSearch : public TestSuite
+{
+  public:
+    TestBeamPairSearch()
+        : TestSuite("nr-test-beam-pair-search", UNIT)
+    {
+        AddTestCase(new TestBeamPairSearchTestCase(1, "Beam pair search, coarse step 1"), QUICK);
+        AddTestCase(new TestBeamPairSearchTestCase(2, "Beam pair search, coarse step 2"), QUICK);
+    }
+};
+
+static TestBeamPairSearch testBeamPairSearch; //!< BeamPairSearch test
+
+} // namespace ns3
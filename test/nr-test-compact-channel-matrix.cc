@@ -0,0 +1,116 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-compact-channel-matrix.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * \file nr-test-compact-channel-matrix.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrCompactChannelMatrix. The test fills a channel
+ * matrix with coefficients of different magnitudes, and checks that the
+ * single-precision copy keeps the dimensions and the antenna pair, uses half
+ * of the memory, and that the error of each coefficient and of the
+ * beamforming gain of each cluster, computed in double precision with the
+ * copy, is within the single-precision accuracy (a relative error of at most
+ * 2^-24 for each coefficient).
+ */
+namespace ns3
+{
+
+class TestCompactChannelMatrixTestCase : public TestCase
+{
+  public:
+    TestCompactChannelMatrixTestCase()
+        : TestCase("Single-precision copy of a channel matrix")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestCompactChannelMatrixTestCase::DoRun()
+{
+    const size_t numRows = 4;
+    const size_t numCols = 16;
+    const size_t numPages = 12;
+
+    MatrixBasedChannelModel::ChannelMatrix channelMatrix;
+    channelMatrix.m_channel = MatrixBasedChannelModel::Complex3DVector(numRows, numCols, numPages);
+    channelMatrix.m_antennaPair = std::make_pair(3, 7);
+    channelMatrix.m_nodeIds = std::make_pair(1, 2);
+    for (size_t page = 0; page < numPages; page++)
+    {
+        // The power of the clusters spans several orders of magnitude
+        double amplitude = std::pow(10.0, -0.5 * page);
+        for (size_t col = 0; col < numCols; col++)
+        {
+            for (size_t row = 0; row < numRows; row++)
+            {
+                double phase = 0.7 * row + 1.3 * col + 2.1 * page;
+                channelMatrix.m_channel(row, col, page) =
+                    amplitude * std::complex<double>(std::cos(phase), std::sin(phase));
+            }
+        }
+    }
+
+    NrCompactChannelMatrix compact(channelMatrix);
+    NS_TEST_ASSERT_MSG_EQ(compact.GetNumRows(), numRows, "Wrong number of rows");
+    NS_TEST_ASSERT_MSG_EQ(compact.GetNumCols(), numCols, "Wrong number of columns");
+    NS_TEST_ASSERT_MSG_EQ(compact.GetNumPages(), numPages, "Wrong number of pages");
+    NS_TEST_ASSERT_MSG_EQ(compact.IsReverse(3, 7), false, "Wrong direction");
+    NS_TEST_ASSERT_MSG_EQ(compact.IsReverse(7, 3), true, "Wrong direction");
+    NS_TEST_ASSERT_MSG_EQ(compact.GetMemoryUsage(),
+                          numRows * numCols * numPages * sizeof(std::complex<double>) / 2,
+                          "The copy should use half of the memory of the double coefficients");
+
+    for (size_t page = 0; page < numPages; page++)
+    {
+        // Relative error of each coefficient, with respect to its magnitude
+        double maxError = 0;
+        std::complex<double> gain(0, 0);
+        std::complex<double> compactGain(0, 0);
+        for (size_t col = 0; col < numCols; col++)
+        {
+            std::complex<double> sW = std::polar(1 / std::sqrt(numCols), -1.3 * col);
+            for (size_t row = 0; row < numRows; row++)
+            {
+                std::complex<double> uW = std::polar(1 / std::sqrt(numRows), -0.7 * row);
+                std::complex<double> h = channelMatrix.m_channel(row, col, page);
+                maxError =
+                    std::max(maxError, std::abs(compact(row, col, page) - h) / std::abs(h));
+                gain += uW * h * sW;
+                compactGain += uW * compact(row, col, page) * sW;
+            }
+        }
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(maxError,
+                                    std::pow(2.0, -24),
+                                    "Coefficient error beyond the single precision");
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(std::abs(compactGain - gain),
+                                    std::abs(gain) * 1e-6,
+                                    "Beamforming gain error beyond the single precision");
+    }
+}
+
+class TestCompactChannelMatrix : public TestSuite
+{
+  public:
+    TestCompactChannelMatrix()
+        : TestSuite("nr-test-compact-channel-matrix", UNIT)
+    {
+        AddTestCase(new TestCompactChannelMatrixTestCase(), QUICK);
+    }
+};
+
+static TestCompactChannelMatrix testCompactChannelMatrix; //!< NrCompactChannelMatrix test
+
+} // namespace ns3
@@ -0,0 +1,222 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/antenna-module.h>
+#include <ns3/core-module.h>
+#include <ns3/distance-based-three-gpp-spectrum-propagation-loss-model.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-distance-spectrum-transmit-filter.h>
+#include <ns3/nr-module.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+
+/**
+ * \file nr-test-distance-spectrum-transmit-filter.cc
+ * \ingroup test
+ *
+ * \brief Testing for DistanceBasedThreeGppSpectrumPropagationLossModel and
+ * NrDistanceSpectrumTransmitFilter. A gNB, a UE nearer than MaxDistance and a
+ * UE farther than MaxDistance are installed on a band whose spectrum
+ * propagation loss model is the distance based one, without running the
+ * simulation.
+ *
+ * The test checks that NrHelper installs the filter in the spectrum channel
+ * only if DropFarPairs is true, and that the filter drops the signals of the
+ * far UE but not the ones of the near UE. It also checks that the model
+ * returns for the near UE the PSD of ThreeGppSpectrumPropagationLossModel on
+ * the same channel, and for the far UE 0 PSD or, with FarPairsPathlossOnly,
+ * the PSD without fast fading and beamforming gain.
+ */
+namespace ns3
+{
+
+class NrDistanceSpectrumTransmitFilterTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param dropFarPairs the DropFarPairs attribute of the model
+     */
+    NrDistanceSpectrumTransmitFilterTestCase(bool dropFarPairs)
+        : TestCase(std::string("Distance based spectrum model, DropFarPairs ") +
+                   (dropFarPairs ? "true" : "false")),
+          m_dropFarPairs(dropFarPairs)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    bool m_dropFarPairs; //!< The DropFarPairs attribute of the model
+};
+
+void
+NrDistanceSpectrumTransmitFilterTestCase::DoRun()
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    const double maxDistance = 100;
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(1);
+    ueNodes.Create(2);
+
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 10));     // gNB
+    positionAlloc->Add(Vector(30, 20, 1.5));  // near UE
+    positionAlloc->Add(Vector(300, 50, 1.5)); // far UE
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, ueNodes));
+
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->SetPhasedArraySpectrumPropagationLossModelTypeId(
+        DistanceBasedThreeGppSpectrumPropagationLossModel::GetTypeId());
+    nrHelper->SetPhasedArraySpectrumPropagationLossModelAttribute("MaxDistance",
+                                                                  DoubleValue(maxDistance));
+    nrHelper->SetPhasedArraySpectrumPropagationLossModelAttribute("DropFarPairs",
+                                                                  BooleanValue(m_dropFarPairs));
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9, 20e6, 1, BandwidthPartInfo::UMa_LoS);
+    CcBwpCreator ccBwpCreator;
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement",
+                                     PointerValue(CreateObject<IsotropicAntennaModel>()));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(1));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("AntennaElement",
+                                    PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    NetDeviceContainer gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueDevs = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(gnbDevs, randomStream);
+    nrHelper->AssignStreams(ueDevs, randomStream);
+    DynamicCast<NrGnbNetDevice>(gnbDevs.Get(0))->UpdateConfig();
+    for (auto it = ueDevs.Begin(); it != ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+
+    Ptr<NrSpectrumPhy> gnbPhy = nrHelper->GetGnbPhy(gnbDevs.Get(0), 0)->GetSpectrumPhy(0);
+    Ptr<NrSpectrumPhy> nearPhy = nrHelper->GetUePhy(ueDevs.Get(0), 0)->GetSpectrumPhy(0);
+    Ptr<NrSpectrumPhy> farPhy = nrHelper->GetUePhy(ueDevs.Get(1), 0)->GetSpectrumPhy(0);
+    Ptr<SpectrumChannel> channel = gnbPhy->GetSpectrumChannel();
+    Ptr<DistanceBasedThreeGppSpectrumPropagationLossModel> splm =
+        DynamicCast<DistanceBasedThreeGppSpectrumPropagationLossModel>(
+            channel->GetPhasedArraySpectrumPropagationLossModel());
+    NS_TEST_ASSERT_MSG_EQ((splm != nullptr),
+                          true,
+                          "The spectrum propagation loss model should be the distance based one");
+    NS_TEST_ASSERT_MSG_EQ(splm->IsWithinMaxDistance(gnbPhy->GetMobility(), nearPhy->GetMobility()),
+                          true,
+                          "The near UE should be within MaxDistance");
+    NS_TEST_ASSERT_MSG_EQ(splm->IsWithinMaxDistance(gnbPhy->GetMobility(), farPhy->GetMobility()),
+                          false,
+                          "The far UE should be beyond MaxDistance");
+
+    // The signal of the gNB
+    std::vector<int> activeRbs;
+    for (size_t rbId = 0; rbId < gnbPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+    {
+        activeRbs.push_back(rbId);
+    }
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
+        0.0,
+        activeRbs,
+        gnbPhy->GetRxSpectrumModel(),
+        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
+    params->txPhy = gnbPhy;
+
+    // The filter is installed by NrHelper only with DropFarPairs
+    Ptr<NrDistanceSpectrumTransmitFilter> filter =
+        DynamicCast<NrDistanceSpectrumTransmitFilter>(channel->GetSpectrumTransmitFilter());
+    NS_TEST_ASSERT_MSG_EQ((filter != nullptr),
+                          m_dropFarPairs,
+                          "The filter should be installed if and only if DropFarPairs is true");
+    if (filter != nullptr)
+    {
+        NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, nearPhy),
+                              false,
+                              "The signal to the near UE should not be dropped");
+        NS_TEST_ASSERT_MSG_EQ(filter->Filter(params, farPhy),
+                              true,
+                              "The signal to the far UE should be dropped");
+    }
+
+    // The near UE gets the full model, computed on the same channel
+    Ptr<PhasedArrayModel> gnbAntenna = gnbPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<ThreeGppSpectrumPropagationLossModel> fullSplm =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    fullSplm->SetAttribute("ChannelModel", PointerValue(splm->GetChannelModel()));
+    Ptr<SpectrumValue> nearPsd =
+        splm->CalcRxPowerSpectralDensity(params,
+                                         gnbPhy->GetMobility(),
+                                         nearPhy->GetMobility(),
+                                         gnbAntenna,
+                                         nearPhy->GetAntenna()->GetObject<PhasedArrayModel>());
+    Ptr<SpectrumValue> fullPsd =
+        fullSplm->CalcRxPowerSpectralDensity(params,
+                                             gnbPhy->GetMobility(),
+                                             nearPhy->GetMobility(),
+                                             gnbAntenna,
+                                             nearPhy->GetAntenna()->GetObject<PhasedArrayModel>());
+    NS_TEST_ASSERT_MSG_GT(Sum(*nearPsd), 0, "The near UE should receive the signal");
+    for (size_t i = 0; i < nearPsd->GetValuesN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ_TOL((*nearPsd)[i],
+                                  (*fullPsd)[i],
+                                  1e-9 * (*fullPsd)[i],
+                                  "The near UE should get the full model in band " << i);
+    }
+
+    // The far UE gets 0 PSD or, with FarPairsPathlossOnly, the TX PSD
+    Ptr<PhasedArrayModel> farAntenna = farPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    Ptr<SpectrumValue> farPsd = splm->CalcRxPowerSpectralDensity(params,
+                                                                 gnbPhy->GetMobility(),
+                                                                 farPhy->GetMobility(),
+                                                                 gnbAntenna,
+                                                                 farAntenna);
+    NS_TEST_ASSERT_MSG_EQ(Sum(*farPsd), 0, "The far UE should receive 0 PSD");
+    splm->SetAttribute("FarPairsPathlossOnly", BooleanValue(true));
+    farPsd = splm->CalcRxPowerSpectralDensity(params,
+                                              gnbPhy->GetMobility(),
+                                              farPhy->GetMobility(),
+                                              gnbAntenna,
+                                              farAntenna);
+    for (size_t i = 0; i < farPsd->GetValuesN(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ((*farPsd)[i],
+                              (*params->psd)[i],
+                              "The far UE should receive the PSD without fast fading in band "
+                                  << i);
+    }
+
+    Simulator::Destroy();
+}
+
+class NrDistanceSpectrumTransmitFilterTestSuite : public TestSuite
+{
+  public:
+    NrDistanceSpectrumTransmitFilterTestSuite()
+        : TestSuite("nr-test-distance-spectrum-transmit-filter", UNIT)
+    {
+        AddTestCase(new NrDistanceSpectrumTransmitFilterTestCase(false), QUICK);
+        AddTestCase(new NrDistanceSpectrumTransmitFilterTestCase(true), QUICK);
+    }
+};
+
+static NrDistanceSpectrumTransmitFilterTestSuite
+    nrDistanceSpectrumTransmitFilterTestSuite; //!< Distance based spectrum model test suite
+
+} // namespace ns3
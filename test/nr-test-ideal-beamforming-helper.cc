@@ -0,0 +1,486 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/antenna-module.h>
+#include <ns3/channel-condition-model.h>
+#include <ns3/core-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+#include <ns3/three-gpp-channel-model-param.h>
+#include <ns3/three-gpp-channel-model.h>
+#include <ns3/three-gpp-spectrum-propagation-loss-model.h>
+
+#include <cmath>
+
+/**
+ * \file nr-test-ideal-beamforming-helper.cc
+ * \ingroup test
+ *
+ * \brief Testing for IdealBeamformingHelper and CellScanBeamforming. A gNB and
+ * some UEs are installed on a 3GPP channel, without running the simulation,
+ * and their beamforming vectors are computed with cell scan.
+ *
+ * The beam cache test checks that a pair is a miss the first time and a hit
+ * while it does not change, and that the entry is invalidated when the channel
+ * of the pair is updated, when the UE moves more than the threshold, and when
+ * the antenna of the gNB rotates. It also checks that a look up does not
+ * update the channel, and that disposing the helper releases the entries.
+ *
+ * The parallel test computes the vectors of several UEs with the sequential
+ * Run and with the concurrent one (NumThreads), and checks that they are equal,
+ * also with a ThreeGppChannelModelParam whose MaxCacheBytes fits only one
+ * channel matrix, so that the matrices of the prepared tasks are evicted before
+ * the tasks are run.
+ *
+ * The channel matrix score test checks that the RX power of every beam pair of
+ * the codebooks, computed by CellScanBeamforming on the channel matrix, is the
+ * one computed by ThreeGppSpectrumPropagationLossModel, for a channel matrix
+ * generated from the gNB to the UE and for one generated in reverse.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Base class of the IdealBeamformingHelper tests, which creates the
+ * scenario
+ */
+class NrIdealBeamformingHelperTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param name the name of the test case
+     */
+    NrIdealBeamformingHelperTestCase(const std::string& name)
+        : TestCase(name)
+    {
+    }
+
+  protected:
+    /**
+     * \brief Create a gNB at (0, 0, 10) with a 4x4 array and UEs with a 2x2
+     * array, with isotropic elements, on a 28 GHz UMa LoS band
+     * \param uePositions the positions of the UEs
+     * \param channelModel the TypeId name of the channel model
+     */
+    void CreateScenario(const std::vector<Vector>& uePositions,
+                        const std::string& channelModel = "ns3::ThreeGppChannelModel");
+
+    /**
+     * \brief Get the 3GPP channel model of the band
+     * \return the channel model
+     */
+    Ptr<ThreeGppChannelModel> GetChannelModel() const;
+
+    NodeContainer m_ueNodes;      //!< The UE nodes
+    NetDeviceContainer m_gnbDevs; //!< The gNB device
+    NetDeviceContainer m_ueDevs;  //!< The UE devices
+    Ptr<NrSpectrumPhy> m_gnbPhy;  //!< The spectrum phy of the gNB
+};
+
+void
+NrIdealBeamformingHelperTestCase::CreateScenario(const std::vector<Vector>& uePositions,
+                                                 const std::string& channelModel)
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    NodeContainer gnbNodes;
+    gnbNodes.Create(1);
+    m_ueNodes = NodeContainer();
+    m_ueNodes.Create(uePositions.size());
+
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 10));
+    for (const auto& position : uePositions)
+    {
+        positionAlloc->Add(position);
+    }
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(NodeContainer(gnbNodes, m_ueNodes));
+
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->SetPhasedArraySpectrumPropagationLossModelAttribute("ChannelModel",
+                                                                  StringValue(channelModel));
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9, 20e6, 1, BandwidthPartInfo::UMa_LoS);
+    CcBwpCreator ccBwpCreator;
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(4));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement",
+                                     PointerValue(CreateObject<IsotropicAntennaModel>()));
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("AntennaElement",
+                                    PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    m_gnbDevs = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    m_ueDevs = nrHelper->InstallUeDevice(m_ueNodes, allBwps);
+    int64_t randomStream = 1;
+    randomStream += nrHelper->AssignStreams(m_gnbDevs, randomStream);
+    nrHelper->AssignStreams(m_ueDevs, randomStream);
+
+    for (auto it = m_gnbDevs.Begin(); it != m_gnbDevs.End(); ++it)
+    {
+        DynamicCast<NrGnbNetDevice>(*it)->UpdateConfig();
+    }
+    for (auto it = m_ueDevs.Begin(); it != m_ueDevs.End(); ++it)
+    {
+        DynamicCast<NrUeNetDevice>(*it)->UpdateConfig();
+    }
+    m_gnbPhy = nrHelper->GetGnbPhy(m_gnbDevs.Get(0), 0)->GetSpectrumPhy(0);
+}
+
+Ptr<ThreeGppChannelModel>
+NrIdealBeamformingHelperTestCase::GetChannelModel() const
+{
+    Ptr<ThreeGppSpectrumPropagationLossModel> splm =
+        DynamicCast<ThreeGppSpectrumPropagationLossModel>(
+            m_gnbPhy->GetSpectrumChannel()->GetPhasedArraySpectrumPropagationLossModel());
+    NS_ASSERT(splm != nullptr);
+    return DynamicCast<ThreeGppChannelModel>(splm->GetChannelModel());
+}
+
+/**
+ * \brief Tests the beam cache of IdealBeamformingHelper
+ */
+class NrBeamCacheTestCase : public NrIdealBeamformingHelperTestCase
+{
+  public:
+    NrBeamCacheTestCase()
+        : NrIdealBeamformingHelperTestCase("Beam cache of the ideal beamforming helper")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrBeamCacheTestCase::DoRun()
+{
+    CreateScenario({Vector(10, 10, 1.5)});
+    Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice>(m_gnbDevs.Get(0));
+    Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice>(m_ueDevs.Get(0));
+    Ptr<NrSpectrumPhy> uePhy = ueDev->GetPhy(0)->GetSpectrumPhy(0);
+    Ptr<MobilityModel> gnbMob = m_gnbPhy->GetMobility();
+    Ptr<MobilityModel> ueMob = uePhy->GetMobility();
+    Ptr<ThreeGppChannelModel> channelModel = GetChannelModel();
+
+    Ptr<IdealBeamformingHelper> bfHelper = CreateObject<IdealBeamformingHelper>();
+    bfHelper->SetAttribute("BeamCache", BooleanValue(true));
+    bfHelper->SetAttribute("BeamCacheDistanceThreshold", DoubleValue(1.0));
+    bfHelper->SetAttribute("BeamCacheAngleThreshold", DoubleValue(1.0));
+    bfHelper->SetBeamformingMethod(CellScanBeamforming::GetTypeId());
+
+    // The first computation of the pair is a miss
+    bfHelper->AddBeamformingTask(gnbDev, ueDev);
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheMisses(), 1, "The new pair should be a miss");
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheHits(), 0, "Unexpected hit");
+    Ptr<const MatrixBasedChannelModel::ChannelParams> params =
+        channelModel->GetParams(gnbMob, ueMob);
+    NS_TEST_ASSERT_MSG_EQ((params != nullptr), true, "The algorithm should generate the channel");
+
+    // A new channel condition updates the channel the next time it is used,
+    // which the look up must not do
+    channelModel->SetChannelConditionModel(CreateObject<NeverLosChannelConditionModel>());
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheHits(), 1, "The unchanged pair should be a hit");
+    NS_TEST_ASSERT_MSG_EQ(channelModel->GetParams(gnbMob, ueMob),
+                          params,
+                          "The look up should not update the channel");
+
+    // The channel is updated (e.g., by a transmission), which invalidates the entry
+    channelModel->GetChannel(gnbMob,
+                             ueMob,
+                             m_gnbPhy->GetAntenna()->GetObject<PhasedArrayModel>(),
+                             uePhy->GetAntenna()->GetObject<PhasedArrayModel>());
+    NS_TEST_ASSERT_MSG_NE(channelModel->GetParams(gnbMob, ueMob),
+                          params,
+                          "The channel should have been updated");
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheMisses(), 2, "The updated channel should miss");
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheHits(), 2, "The new entry should be a hit");
+
+    // A movement below the threshold, away from the gNB, keeps the entry
+    Vector direction = ueMob->GetPosition() - gnbMob->GetPosition();
+    double length = direction.GetLength();
+    Vector position = ueMob->GetPosition();
+    ueMob->SetPosition(Vector(position.x + 0.5 * direction.x / length,
+                              position.y + 0.5 * direction.y / length,
+                              position.z + 0.5 * direction.z / length));
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheHits(), 3, "A small movement should be a hit");
+
+    // A movement above the threshold invalidates it
+    ueMob->SetPosition(Vector(position.x + 5, position.y, position.z));
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheMisses(), 3, "The UE movement should miss");
+
+    // And so does a rotation of the gNB antenna
+    m_gnbPhy->GetAntenna()->SetAttribute("BearingAngle", DoubleValue(10 * M_PI / 180));
+    bfHelper->Run();
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheMisses(), 4, "The gNB rotation should miss");
+    NS_TEST_ASSERT_MSG_EQ(bfHelper->GetBeamCacheHits(), 3, "Unexpected hit");
+
+    // The entries hold the spectrum phys until the helper is disposed
+    uint32_t references = m_gnbPhy->GetReferenceCount();
+    bfHelper->Dispose();
+    NS_TEST_ASSERT_MSG_LT(m_gnbPhy->GetReferenceCount(),
+                          references,
+                          "Disposing the helper should release the beam cache");
+
+    m_gnbPhy = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Tests that IdealBeamformingHelper::Run selects the same beams with
+ * one and with several threads
+ */
+class NrParallelBeamformingTestCase : public NrIdealBeamformingHelperTestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param boundedCache whether the channel matrices are bounded to one
+     */
+    NrParallelBeamformingTestCase(bool boundedCache)
+        : NrIdealBeamformingHelperTestCase(
+              std::string("Sequential and concurrent ideal beamforming") +
+              (boundedCache ? ", bounded channel matrix cache" : "")),
+          m_boundedCache(boundedCache)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    bool m_boundedCache; //!< Whether the channel matrices are bounded to one
+
+    /**
+     * \brief The beams of a pair of devices
+     */
+    struct Beams
+    {
+        BeamId gnbBeam;                       //!< The beam of the gNB
+        BeamId ueBeam;                        //!< The beam of the UE
+        PhasedArrayModel::ComplexVector gnbW; //!< The weights of the gNB
+        PhasedArrayModel::ComplexVector ueW;  //!< The weights of the UE
+    };
+
+    /**
+     * \brief Run a helper on all the UEs
+     * \param numThreads the value of NumThreads
+     * \return the beams of each UE
+     */
+    std::vector<Beams> RunHelper(uint32_t numThreads);
+};
+
+std::vector<NrParallelBeamformingTestCase::Beams>
+NrParallelBeamformingTestCase::RunHelper(uint32_t numThreads)
+{
+    Ptr<IdealBeamformingHelper> bfHelper = CreateObject<IdealBeamformingHelper>();
+    bfHelper->SetAttribute("NumThreads", UintegerValue(numThreads));
+    bfHelper->SetBeamformingMethod(CellScanBeamforming::GetTypeId());
+    Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice>(m_gnbDevs.Get(0));
+    Ptr<BeamManager> gnbBeamManager = m_gnbPhy->GetBeamManager();
+    for (uint32_t i = 0; i < m_ueDevs.GetN(); i++)
+    {
+        // The task is run sequentially when it is added: the vectors are then
+        // replaced, so that Run has to compute them again
+        Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice>(m_ueDevs.Get(i));
+        Ptr<BeamManager> ueBeamManager = ueDev->GetPhy(0)->GetSpectrumPhy(0)->GetBeamManager();
+        bfHelper->AddBeamformingTask(gnbDev, ueDev);
+        gnbBeamManager->SaveBeamformingVector(
+            BeamformingVector(gnbBeamManager->GetCurrentBeamformingVector(), OMNI_BEAM_ID),
+            ueDev);
+        ueBeamManager->SaveBeamformingVector(
+            BeamformingVector(ueBeamManager->GetCurrentBeamformingVector(), OMNI_BEAM_ID),
+            gnbDev);
+    }
+
+    bfHelper->Run();
+
+    std::vector<Beams> beams;
+    for (uint32_t i = 0; i < m_ueDevs.GetN(); i++)
+    {
+        Ptr<NetDevice> ueDev = m_ueDevs.Get(i);
+        Ptr<BeamManager> ueBeamManager =
+            DynamicCast<NrUeNetDevice>(ueDev)->GetPhy(0)->GetSpectrumPhy(0)->GetBeamManager();
+        beams.push_back({gnbBeamManager->GetBeamId(ueDev),
+                         ueBeamManager->GetBeamId(gnbDev),
+                         gnbBeamManager->GetBeamformingVector(ueDev),
+                         ueBeamManager->GetBeamformingVector(gnbDev)});
+    }
+    bfHelper->Dispose();
+    return beams;
+}
+
+void
+NrParallelBeamformingTestCase::DoRun()
+{
+    CreateScenario({Vector(10, 10, 1.5),
+                    Vector(-20, 5, 1.5),
+                    Vector(30, -15, 1.5),
+                    Vector(-5, -25, 1.5),
+                    Vector(15, 40, 1.5),
+                    Vector(-35, -10, 1.5),
+                    Vector(50, 20, 1.5)},
+                   m_boundedCache ? "ns3::ThreeGppChannelModelParam"
+                                  : "ns3::ThreeGppChannelModel");
+    Ptr<ThreeGppChannelModelParam> channelModelParam =
+        DynamicCast<ThreeGppChannelModelParam>(GetChannelModel());
+    if (m_boundedCache)
+    {
+        // Only the matrix just accessed is kept
+        NS_TEST_ASSERT_MSG_EQ((channelModelParam != nullptr),
+                              true,
+                              "The channel model should be ThreeGppChannelModelParam");
+        channelModelParam->SetAttribute("MaxCacheBytes", UintegerValue(1));
+    }
+
+    std::vector<Beams> sequential = RunHelper(1);
+    std::vector<Beams> concurrent = RunHelper(3);
+    NS_TEST_ASSERT_MSG_EQ(concurrent.size(), sequential.size(), "Wrong number of pairs");
+    for (size_t i = 0; i < sequential.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_NE(sequential[i].gnbBeam,
+                              OMNI_BEAM_ID,
+                              "Run should have computed the vectors");
+        NS_TEST_ASSERT_MSG_EQ(concurrent[i].gnbBeam, sequential[i].gnbBeam, "Different gNB beam");
+        NS_TEST_ASSERT_MSG_EQ(concurrent[i].ueBeam, sequential[i].ueBeam, "Different UE beam");
+        NS_TEST_ASSERT_MSG_EQ((concurrent[i].gnbW == sequential[i].gnbW),
+                              true,
+                              "Different gNB weights");
+        NS_TEST_ASSERT_MSG_EQ((concurrent[i].ueW == sequential[i].ueW),
+                              true,
+                              "Different UE weights");
+    }
+
+    // A second concurrent run reuses the threads of the first one
+    std::vector<Beams> again = RunHelper(3);
+    for (size_t i = 0; i < sequential.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(again[i].gnbBeam, sequential[i].gnbBeam, "Different gNB beam");
+        NS_TEST_ASSERT_MSG_EQ(again[i].ueBeam, sequential[i].ueBeam, "Different UE beam");
+    }
+
+    if (m_boundedCache)
+    {
+        NS_TEST_ASSERT_MSG_GT(channelModelParam->GetCacheStats().m_evictions,
+                              m_ueDevs.GetN(),
+                              "The matrices of the prepared tasks should have been evicted");
+    }
+
+    m_gnbPhy = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \brief Tests the score of the beam pairs that CellScanBeamforming computes on
+ * the channel matrix against ThreeGppSpectrumPropagationLossModel
+ */
+class NrChannelMatrixScoreTestCase : public NrIdealBeamformingHelperTestCase
+{
+  public:
+    NrChannelMatrixScoreTestCase()
+        : NrIdealBeamformingHelperTestCase("Cell scan score on the channel matrix")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrChannelMatrixScoreTestCase::DoRun()
+{
+    CreateScenario({Vector(10, 10, 1.5), Vector(-20, 5, 1.5)});
+    Ptr<PhasedArrayModel> gnbAntenna = m_gnbPhy->GetAntenna()->GetObject<PhasedArrayModel>();
+
+    // The matrix of the second UE is generated with the UE as the s-node
+    Ptr<NrSpectrumPhy> reversePhy =
+        DynamicCast<NrUeNetDevice>(m_ueDevs.Get(1))->GetPhy(0)->GetSpectrumPhy(0);
+    Ptr<PhasedArrayModel> reverseAntenna = reversePhy->GetAntenna()->GetObject<PhasedArrayModel>();
+    GetChannelModel()->GetChannel(reversePhy->GetMobility(),
+                                  m_gnbPhy->GetMobility(),
+                                  reverseAntenna,
+                                  gnbAntenna);
+
+    // The TX PSD of the search
+    std::vector<int> activeRbs;
+    for (size_t rbId = 0; rbId < m_gnbPhy->GetRxSpectrumModel()->GetNumBands(); rbId++)
+    {
+        activeRbs.push_back(rbId);
+    }
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = NrSpectrumValueHelper::CreateTxPowerSpectralDensity(
+        0.0,
+        activeRbs,
+        m_gnbPhy->GetRxSpectrumModel(),
+        NrSpectrumValueHelper::UNIFORM_POWER_ALLOCATION_BW);
+
+    Ptr<CellScanBeamforming> algorithm = CreateObject<CellScanBeamforming>();
+    const auto& gnbCodebook =
+        algorithm->GetCodebook(m_gnbPhy->GetBeamManager()->GetAntenna(), false);
+    for (uint32_t i = 0; i < m_ueDevs.GetN(); i++)
+    {
+        Ptr<NrSpectrumPhy> uePhy =
+            DynamicCast<NrUeNetDevice>(m_ueDevs.Get(i))->GetPhy(0)->GetSpectrumPhy(0);
+        const auto& ueCodebook =
+            algorithm->GetCodebook(uePhy->GetBeamManager()->GetAntenna(), true);
+        BeamPairSearch::ScoreFunction matrixScore =
+            algorithm->GetChannelMatrixScore(m_gnbPhy, uePhy, params, gnbCodebook, ueCodebook);
+        NS_TEST_ASSERT_MSG_EQ((matrixScore != nullptr),
+                              true,
+                              "The score should be computed on the channel matrix");
+        BeamPairSearch::ScoreFunction modelScore =
+            algorithm->GetSpectrumModelScore(m_gnbPhy, uePhy, params, gnbCodebook, ueCodebook);
+
+        for (size_t gnbBeam = 0; gnbBeam < gnbCodebook.size(); gnbBeam++)
+        {
+            for (size_t ueBeam = 0; ueBeam < ueCodebook.size(); ueBeam++)
+            {
+                double expected = modelScore(gnbBeam, ueBeam);
+                NS_TEST_ASSERT_MSG_EQ_TOL(matrixScore(gnbBeam, ueBeam),
+                                          expected,
+                                          1e-9 * expected,
+                                          "Different score of the pair (" << gnbBeam << ", "
+                                                                          << ueBeam << ") of UE "
+                                                                          << i);
+            }
+        }
+    }
+
+    m_gnbPhy = nullptr;
+    Simulator::Destroy();
+}
+
+class NrIdealBeamformingHelperTestSuite : public TestSuite
+{
+  public:
+    NrIdealBeamformingHelperTestSuite()
+        : TestSuite("nr-test-ideal-beamforming-helper", UNIT)
+    {
+        AddTestCase(new NrBeamCacheTestCase(), QUICK);
+        AddTestCase(new NrParallelBeamformingTestCase(false), QUICK);
+        AddTestCase(new NrParallelBeamformingTestCase(true), QUICK);
+        AddTestCase(new NrChannelMatrixScoreTestCase(), QUICK);
+    }
+};
+
+static NrIdealBeamformingHelperTestSuite
+    nrIdealBeamformingHelperTestSuite; //!< IdealBeamformingHelper test suite
+
+} // namespace ns3
@@ -0,0 +1,104 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-ctrl-trace-test.h"
+
+#include <ns3/nr-module.h>
+
+#include <set>
+
+/**
+ * \file nr-test-ideal-ctrl.cc
+ * \ingroup test
+ *
+ * \brief System-testing for the NrSpectrumPhy attribute IdealCtrl. The
+ * scenario of NrCtrlTraceTestCase is run with the CTRL messages transmitted
+ * through the channel and delivered directly, and the test checks that the UEs
+ * receive the same DCIs (so that the scheduling is the same) and send the same
+ * SRs and BSRs, and that the same packets are received.
+ *
+ * In the first case two UEs exchange DL and UL traffic with one gNB. In the
+ * second case there are two cells on the same channel, each one with two UEs:
+ * the test also checks that every cell scheduled its UEs, so that the CTRL
+ * messages of a cell are delivered only to its own UEs and gNB.
+ */
+namespace ns3
+{
+
+class NrIdealCtrlTestCase : public NrCtrlTraceTestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param name the name of the test case
+     * \param gnbPositions the positions of the gNBs
+     * \param ues the positions and the traffic of the UEs
+     */
+    NrIdealCtrlTestCase(const std::string& name,
+                        const std::vector<Vector>& gnbPositions,
+                        const std::vector<UeConf>& ues)
+        : NrCtrlTraceTestCase(name, "The ideal CTRL", gnbPositions, ues, MilliSeconds(700))
+    {
+    }
+
+  private:
+    void ConfigureOption(const Ptr<NrHelper>& nrHelper, bool enabled) override
+    {
+        nrHelper->SetGnbSpectrumAttribute("IdealCtrl", BooleanValue(enabled));
+        nrHelper->SetUeSpectrumAttribute("IdealCtrl", BooleanValue(enabled));
+    }
+
+    void CheckRuns([[maybe_unused]] const RunResult& reference,
+                   const RunResult& withOption) override
+    {
+        std::set<uint16_t> cells;
+        for (const auto& e : withOption.events)
+        {
+            if (e.type == NrControlMessage::DL_DCI || e.type == NrControlMessage::UL_DCI)
+            {
+                cells.insert(e.cellId);
+            }
+        }
+        NS_TEST_ASSERT_MSG_EQ(cells.size(),
+                              m_gnbPositions.size(),
+                              "Every cell should send DCIs with the ideal CTRL");
+    }
+};
+
+/**
+ * \param position the position of the UE
+ * \return A UE with DL and UL traffic between 400 and 600 ms
+ */
+static NrCtrlTraceTestCase::UeConf
+IdealCtrlUe(const Vector& position)
+{
+    return {position, MilliSeconds(2), MilliSeconds(5), 300, MilliSeconds(400), MilliSeconds(600)};
+}
+
+class NrIdealCtrlTestSuite : public TestSuite
+{
+  public:
+    NrIdealCtrlTestSuite()
+        : TestSuite("nr-test-ideal-ctrl", SYSTEM)
+    {
+        AddTestCase(new NrIdealCtrlTestCase("Ideal CTRL",
+                                            {Vector(0, 0, 10)},
+                                            {IdealCtrlUe(Vector(0, 20, 1.5)),
+                                             IdealCtrlUe(Vector(30, -10, 1.5))}),
+                    QUICK);
+        AddTestCase(new NrIdealCtrlTestCase("Ideal CTRL, two cells",
+                                            {Vector(0, 0, 10), Vector(100, 0, 10)},
+                                            {IdealCtrlUe(Vector(0, 20, 1.5)),
+                                             IdealCtrlUe(Vector(30, -10, 1.5)),
+                                             IdealCtrlUe(Vector(100, 20, 1.5)),
+                                             IdealCtrlUe(Vector(70, -10, 1.5))}),
+                    QUICK);
+    }
+};
+
+static NrIdealCtrlTestSuite nrIdealCtrlTestSuite; //!< Ideal CTRL test
+
+} // namespace ns3
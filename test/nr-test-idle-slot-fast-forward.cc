@@ -0,0 +1,96 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-ctrl-trace-test.h"
+
+#include <ns3/nr-module.h>
+
+/**
+ * \file nr-test-idle-slot-fast-forward.cc
+ * \ingroup test
+ *
+ * \brief System-testing for the NrUePhy attribute IdleSlotFastForward. The
+ * scenario of NrCtrlTraceTestCase is run with and without the fast-forward,
+ * and the test checks that the UEs receive the same DCIs and send the same SRs
+ * and BSRs, at the same time and SFN/SF, and that the fast-forward executed
+ * fewer events.
+ *
+ * In the first case a UE receives sparse DL packets and sends sparse UL
+ * packets, aligned to the slots. In the second case the packets are not
+ * aligned to the slots and a UE has only UL traffic, which starts after a long
+ * idle period: the UE wakes up in the middle of a fast-forwarded slot to send
+ * its SR, and another UE, with DL traffic only, is woken up by the DCIs of the
+ * gNB.
+ */
+namespace ns3
+{
+
+class NrIdleSlotFastForwardTestCase : public NrCtrlTraceTestCase
+{
+  public:
+    /**
+     * \brief Create the test case
+     * \param name the name of the test case
+     * \param ues the positions and the traffic of the UEs
+     */
+    NrIdleSlotFastForwardTestCase(const std::string& name, const std::vector<UeConf>& ues)
+        : NrCtrlTraceTestCase(name,
+                              "The fast-forward",
+                              {Vector(0, 0, 10)},
+                              ues,
+                              MilliSeconds(900))
+    {
+    }
+
+  private:
+    void ConfigureOption(const Ptr<NrHelper>& nrHelper, bool enabled) override
+    {
+        nrHelper->SetUePhyAttribute("IdleSlotFastForward", BooleanValue(enabled));
+    }
+
+    void CheckRuns(const RunResult& reference, const RunResult& withOption) override
+    {
+        NS_TEST_ASSERT_MSG_LT(withOption.eventCount,
+                              reference.eventCount,
+                              "The fast-forward did not skip any slot event");
+    }
+};
+
+class NrIdleSlotFastForwardTestSuite : public TestSuite
+{
+  public:
+    NrIdleSlotFastForwardTestSuite()
+        : TestSuite("nr-test-idle-slot-fast-forward", SYSTEM)
+    {
+        AddTestCase(new NrIdleSlotFastForwardTestCase("Idle slot fast-forward",
+                                                      {{Vector(0, 20, 1.5),
+                                                        MilliSeconds(20),
+                                                        MilliSeconds(30),
+                                                        100,
+                                                        MilliSeconds(400),
+                                                        MilliSeconds(800)}}),
+                    QUICK);
+        // Intervals and start times that are not multiple of the slot (0.5 ms)
+        AddTestCase(new NrIdleSlotFastForwardTestCase("Idle slot fast-forward, wake-up in a gap",
+                                                      {{Vector(0, 20, 1.5),
+                                                        MicroSeconds(27100),
+                                                        Time(0),
+                                                        100,
+                                                        MicroSeconds(400071),
+                                                        MilliSeconds(800)},
+                                                       {Vector(30, -10, 1.5),
+                                                        Time(0),
+                                                        MicroSeconds(51300),
+                                                        100,
+                                                        MicroSeconds(600137),
+                                                        MilliSeconds(800)}}),
+                    QUICK);
+    }
+};
+
+static NrIdleSlotFastForwardTestSuite nrIdleSlotFastForwardTestSuite; //!< Fast-forward test
+
+} // namespace ns3
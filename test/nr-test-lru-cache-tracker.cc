@@ -0,0 +1,192 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/channel-condition-model.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/node.h>
+#include <ns3/nr-lru-cache-tracker.h>
+#include <ns3/pointer.h>
+#include <ns3/simulator.h>
+#include <ns3/string.h>
+#include <ns3/test.h>
+#include <ns3/three-gpp-channel-model-param.h>
+#include <ns3/uinteger.h>
+#include <ns3/uniform-planar-array.h>
+
+/**
+ * \file nr-test-lru-cache-tracker.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrLruCacheTracker. The test accesses a set of
+ * entries and checks that the least recently used ones are evicted when the
+ * limit is exceeded, that the entry just accessed is never evicted, and the
+ * statistics of the cache. A second test bounds the channel matrices of a
+ * ThreeGppChannelModelParam, and checks that an evicted matrix is not modified,
+ * and that it is regenerated equal to the original when it is needed again,
+ * and that the eviction of the channel parameters of a pair of nodes evicts
+ * its matrices.
+ */
+namespace ns3
+{
+
+class TestLruCacheTrackerTestCase : public TestCase
+{
+  public:
+    TestLruCacheTrackerTestCase()
+        : TestCase("LRU cache tracker")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestLruCacheTrackerTestCase::DoRun()
+{
+    NrLruCacheTracker tracker(300);
+    NS_TEST_ASSERT_MSG_EQ(tracker.Access(1, 100, false).empty(), true, "Nothing to evict");
+    NS_TEST_ASSERT_MSG_EQ(tracker.Access(2, 100, false).empty(), true, "Nothing to evict");
+    NS_TEST_ASSERT_MSG_EQ(tracker.Access(3, 100, false).empty(), true, "Nothing to evict");
+    NS_TEST_ASSERT_MSG_EQ(tracker.Access(1, 100, true).empty(), true, "Nothing to evict");
+
+    // 2 is now the least recently used entry
+    std::vector<uint64_t> evicted = tracker.Access(4, 100, false);
+    NS_TEST_ASSERT_MSG_EQ(evicted.size(), 1, "One entry should be evicted");
+    NS_TEST_ASSERT_MSG_EQ(evicted[0], 2, "The least recently used entry should be evicted");
+
+    // An entry larger than the limit evicts all the others, but not itself
+    evicted = tracker.Access(5, 500, false);
+    NS_TEST_ASSERT_MSG_EQ((evicted == std::vector<uint64_t>{3, 1, 4}), true, "Wrong evictions");
+
+    const NrLruCacheTracker::Stats& stats = tracker.GetStats();
+    NS_TEST_ASSERT_MSG_EQ(stats.m_hits, 1, "Wrong number of hits");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_misses, 5, "Wrong number of misses");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_evictions, 4, "Wrong number of evictions");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_entries, 1, "Wrong number of entries");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_bytes, 500, "Wrong size");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_peakBytes, 800, "Wrong peak size");
+
+    tracker.Remove(5);
+    NS_TEST_ASSERT_MSG_EQ(stats.m_bytes, 0, "The cache should be empty");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_evictions, 4, "A removal is not an eviction");
+
+    // Without limit, nothing is evicted
+    tracker.SetMaxBytes(0);
+    for (uint64_t key = 0; key < 100; key++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(tracker.Access(key, 1000, false).empty(), true, "No limit");
+    }
+    NS_TEST_ASSERT_MSG_EQ(stats.m_entries, 100, "Wrong number of entries");
+}
+
+class TestChannelModelParamCacheTestCase : public TestCase
+{
+  public:
+    TestChannelModelParamCacheTestCase()
+        : TestCase("Channel matrix cache of ThreeGppChannelModelParam")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Creates a channel model in the UMi-StreetCanyon scenario, with all
+     * the nodes in LOS
+     * \return the channel model
+     */
+    Ptr<ThreeGppChannelModelParam> CreateChannelModel() const;
+};
+
+Ptr<ThreeGppChannelModelParam>
+TestChannelModelParamCacheTestCase::CreateChannelModel() const
+{
+    Ptr<ThreeGppChannelModelParam> channelModel = CreateObject<ThreeGppChannelModelParam>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    channelModel->AssignStreams(1);
+    return channelModel;
+}
+
+void
+TestChannelModelParamCacheTestCase::DoRun()
+{
+    std::vector<Ptr<MobilityModel>> mobs;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (const Vector& position : {Vector(0, 0, 10), Vector(20, 5, 1.5), Vector(-10, 30, 1.5)})
+    {
+        Ptr<Node> node = CreateObject<Node>();
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(position);
+        node->AggregateObject(mob);
+        mobs.push_back(mob);
+        Ptr<PhasedArrayModel> antenna = CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumRows",
+            UintegerValue(2),
+            "NumColumns",
+            UintegerValue(2));
+        antennas.push_back(antenna);
+    }
+
+    // The limit fits only one of the matrices
+    Ptr<ThreeGppChannelModelParam> channelModel = CreateChannelModel();
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> first =
+        channelModel->GetChannel(mobs[0], mobs[1], antennas[0], antennas[1]);
+    MatrixBasedChannelModel::Complex3DVector original = first->m_channel;
+    const NrLruCacheTracker::Stats& stats = channelModel->GetCacheStats();
+    channelModel->SetAttribute("MaxCacheBytes", UintegerValue(stats.m_bytes + 1));
+
+    channelModel->GetChannel(mobs[0], mobs[2], antennas[0], antennas[2]);
+    NS_TEST_ASSERT_MSG_EQ(stats.m_evictions, 1, "The first matrix should be evicted");
+    NS_TEST_ASSERT_MSG_EQ(stats.m_entries, 1, "Only one matrix should be kept");
+    NS_TEST_ASSERT_MSG_EQ((first->m_channel == original),
+                          true,
+                          "The evicted matrix should not be modified");
+
+    Ptr<const MatrixBasedChannelModel::ChannelMatrix> regenerated =
+        channelModel->GetChannel(mobs[0], mobs[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_EQ(stats.m_misses, 3, "The evicted matrix should be regenerated");
+    NS_TEST_ASSERT_MSG_EQ((regenerated->m_channel == original),
+                          true,
+                          "The regenerated matrix should be equal to the evicted one");
+
+    // The limit fits the parameters of only one pair of nodes
+    channelModel = CreateChannelModel();
+    channelModel->SetAttribute("MaxChannelParams", UintegerValue(1));
+    channelModel->GetChannel(mobs[0], mobs[1], antennas[0], antennas[1]);
+    channelModel->GetChannel(mobs[0], mobs[2], antennas[0], antennas[2]);
+    NS_TEST_ASSERT_MSG_EQ(channelModel->GetParamsCacheStats().m_evictions,
+                          1,
+                          "The parameters of the first pair should be evicted");
+    NS_TEST_ASSERT_MSG_EQ(channelModel->GetCacheStats().m_entries,
+                          1,
+                          "The matrix of the first pair should be evicted with its parameters");
+    channelModel->GetChannel(mobs[0], mobs[1], antennas[0], antennas[1]);
+    NS_TEST_ASSERT_MSG_EQ(channelModel->GetParamsCacheStats().m_misses,
+                          3,
+                          "The parameters of the first pair should be generated again");
+
+    Simulator::Destroy();
+}
+
+class TestLruCacheTracker : public TestSuite
+{
+  public:
+    TestLruCacheTracker()
+        : TestSuite("nr-test-lru-cache-tracker", UNIT)
+    {
+        AddTestCase(new TestLruCacheTrackerTestCase(), QUICK);
+        AddTestCase(new TestChannelModelParamCacheTestCase(), QUICK);
+    }
+};
+
+static TestLruCacheTracker testLruCacheTracker; //!< NrLruCacheTracker test
+
+} // namespace ns3
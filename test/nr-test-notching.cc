@@ -225,30 +225,21 @@ TestNotchingGnbMac::DoSchedConfigIndication(NrMacSchedSapUser::SchedConfigIndPar
 
         if (m_verboseMac)
         {
-            std::ostringstream oss;
-            for (auto& x : varTtiAllocInfo.m_dci->m_rbgBitmask)
-            {
-                oss << std::to_string(x) << " ";
-            }
-
             std::cout << "UE " << varTtiAllocInfo.m_dci->m_rnti << " assigned RBG"
-                      << " with mask: " << oss.str() << std::endl;
+                      << " with mask: " << varTtiAllocInfo.m_dci->m_rbgBitmask << std::endl;
         }
 
-        NS_ASSERT_MSG(varTtiAllocInfo.m_dci->m_rbgBitmask.size() == m_inputMask.size(),
+        NS_ASSERT_MSG(varTtiAllocInfo.m_dci->m_rbgBitmask.GetSize() == m_inputMask.size(),
                       "dci bitmask is not of same size as the mask");
 
-        unsigned zeroes = std::count(varTtiAllocInfo.m_dci->m_rbgBitmask.begin(),
-                                     varTtiAllocInfo.m_dci->m_rbgBitmask.end(),
-                                     0);
-
-        NS_ASSERT_MSG(zeroes != m_inputMask.size(), "dci rbgBitmask is filled with zeros");
+        NS_ASSERT_MSG(varTtiAllocInfo.m_dci->m_rbgBitmask.Any(),
+                      "dci rbgBitmask is filled with zeros");
 
-        for (unsigned index = 0; index < varTtiAllocInfo.m_dci->m_rbgBitmask.size(); index++)
+        for (unsigned index = 0; index < varTtiAllocInfo.m_dci->m_rbgBitmask.GetSize(); index++)
         {
             if (m_inputMask[index] == 0)
             {
-                NS_ASSERT_MSG(varTtiAllocInfo.m_dci->m_rbgBitmask[index] == 0,
+                NS_ASSERT_MSG(!varTtiAllocInfo.m_dci->m_rbgBitmask.Test(index),
                               "dci is diff from mask");
             }
         }
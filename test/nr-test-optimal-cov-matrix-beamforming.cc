@@ -0,0 +1,178 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/double.h>
+#include <ns3/ideal-beamforming-algorithm.h>
+#include <ns3/test.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+#include <complex>
+#include <string>
+#include <vector>
+
+/**
+ * \file nr-test-optimal-cov-matrix-beamforming.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for the power iteration of OptimalCovMatrixBeamforming.
+ * The matrix is the transmit covariance sum_c G_c^H G_c of a small channel,
+ * with 2 UE and 2 gNB elements and 3 clusters, multiplied by a vector without
+ * building it, as the algorithm does. The test checks that the eigenvector and
+ * the eigenvalue are the ones found by a brute-force search of the unit vector
+ * with the highest gain, that one iteration (MaxIterations = 1, or a Tolerance
+ * of 1) gives the normalized product by the starting vector, and that a null
+ * matrix or starting vector are detected.
+ */
+namespace ns3
+{
+
+class NrOptimalCovMatrixBeamformingTestCase : public TestCase
+{
+  public:
+    NrOptimalCovMatrixBeamformingTestCase()
+        : TestCase("Power iteration of OptimalCovMatrixBeamforming")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrOptimalCovMatrixBeamformingTestCase::DoRun()
+{
+    using Vec = std::vector<std::complex<double>>;
+    const std::complex<double> j(0, 1);
+    // G_c(ue, gnb)
+    const std::vector<std::vector<Vec>> g = {{{1.0, 0.5 * j}, {0.2, -0.3}},
+                                             {{0.1 + 0.4 * j, 0.7}, {0.0, 0.2 * j}},
+                                             {{0.3, -0.2}, {0.5 * j, 0.1}}};
+    auto covProduct = [&g](const Vec& v) {
+        Vec out(2, 0.0);
+        for (const auto& gc : g)
+        {
+            for (const auto& row : gc)
+            {
+                std::complex<double> y = row[0] * v[0] + row[1] * v[1];
+                out[0] += std::conj(row[0]) * y;
+                out[1] += std::conj(row[1]) * y;
+            }
+        }
+        return out;
+    };
+    // The gain v^H A v of a unit vector
+    auto gain = [&covProduct](const Vec& v) {
+        Vec av = covProduct(v);
+        return std::real(std::conj(v[0]) * av[0] + std::conj(v[1]) * av[1]);
+    };
+
+    // Brute force: the unit vectors (cos t, sin t e^jp) cover all the directions
+    // up to a phase
+    double bestGain = 0;
+    Vec best;
+    for (int tIndex = 0; tIndex <= 400; tIndex++)
+    {
+        double t = tIndex * M_PI / 2 / 400;
+        for (int pIndex = 0; pIndex < 800; pIndex++)
+        {
+            double p = pIndex * 2 * M_PI / 800;
+            Vec v = {std::cos(t), std::sin(t) * std::exp(j * p)};
+            double value = gain(v);
+            if (value > bestGain)
+            {
+                bestGain = value;
+                best = v;
+            }
+        }
+    }
+
+    Ptr<OptimalCovMatrixBeamforming> algorithm = CreateObject<OptimalCovMatrixBeamforming>();
+    Vec v = {1.0, 0.0};
+    double eigenvalue = 0;
+    NS_TEST_ASSERT_MSG_EQ(algorithm->PowerIteration(covProduct, &v, &eigenvalue),
+                          true,
+                          "The power iteration failed");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::norm(v[0]) + std::norm(v[1]), 1, 1e-12, "Not a unit vector");
+    NS_TEST_ASSERT_MSG_EQ_TOL(eigenvalue, bestGain, 1e-4 * bestGain, "Wrong eigenvalue");
+    NS_TEST_ASSERT_MSG_EQ_TOL(gain(v), bestGain, 1e-4 * bestGain, "Wrong gain of the vector");
+    NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(std::conj(v[0]) * best[0] + std::conj(v[1]) * best[1]),
+                              1,
+                              1e-4,
+                              "The eigenvector differs from the brute-force one");
+
+    // One iteration gives A v0 / |A v0|, with |A v0| as the eigenvalue
+    Vec v0 = {0.6, 0.8 * j};
+    Vec av0 = covProduct(v0);
+    double norm = std::sqrt(std::norm(av0[0]) + std::norm(av0[1]));
+    for (bool tolerance : {false, true})
+    {
+        algorithm = CreateObject<OptimalCovMatrixBeamforming>();
+        if (tolerance)
+        {
+            algorithm->SetAttribute("Tolerance", DoubleValue(1.0));
+        }
+        else
+        {
+            algorithm->SetAttribute("MaxIterations", UintegerValue(1));
+        }
+        std::string attribute = tolerance ? "Tolerance 1" : "MaxIterations 1";
+        v = v0;
+        NS_TEST_ASSERT_MSG_EQ(algorithm->PowerIteration(covProduct, &v, &eigenvalue),
+                              true,
+                              "The power iteration failed");
+        NS_TEST_ASSERT_MSG_EQ_TOL(eigenvalue, norm, 1e-12, "Wrong eigenvalue with " << attribute);
+        for (size_t i = 0; i < 2; i++)
+        {
+            NS_TEST_ASSERT_MSG_EQ_TOL(std::abs(v[i] - av0[i] / norm),
+                                      0,
+                                      1e-12,
+                                      "Wrong vector with " << attribute);
+        }
+    }
+
+    // More iterations than one get closer to the dominant eigenvector
+    algorithm = CreateObject<OptimalCovMatrixBeamforming>();
+    algorithm->SetAttribute("MaxIterations", UintegerValue(3));
+    algorithm->SetAttribute("Tolerance", DoubleValue(0.0));
+    v = v0;
+    algorithm->PowerIteration(covProduct, &v, &eigenvalue);
+    double threeIterations = gain(v);
+    NS_TEST_ASSERT_MSG_GT(threeIterations,
+                          gain({av0[0] / norm, av0[1] / norm}),
+                          "The gain should grow with the iterations");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(threeIterations,
+                                bestGain * (1 + 1e-9),
+                                "The gain can not exceed the dominant eigenvalue");
+
+    // A null matrix, or a null starting vector, are detected
+    v = {0.0, 0.0};
+    NS_TEST_ASSERT_MSG_EQ(algorithm->PowerIteration(covProduct, &v, &eigenvalue),
+                          false,
+                          "A null starting vector should fail");
+    v = v0;
+    NS_TEST_ASSERT_MSG_EQ(
+        algorithm->PowerIteration([](const Vec& x) { return Vec(x.size(), 0.0); },
+                                  &v,
+                                  &eigenvalue),
+        false,
+        "A null matrix should fail");
+}
+
+class NrOptimalCovMatrixBeamformingTestSuite : public TestSuite
+{
+  public:
+    NrOptimalCovMatrixBeamformingTestSuite()
+        : TestSuite("nr-test-optimal-cov-matrix-beamforming", UNIT)
+    {
+        AddTestCase(new NrOptimalCovMatrixBeamformingTestCase(), QUICK);
+    }
+};
+
+static NrOptimalCovMatrixBeamformingTestSuite
+    nrOptimalCovMatrixBeamformingTestSuite; //!< OptimalCovMatrixBeamforming test suite
+
+} // namespace ns3
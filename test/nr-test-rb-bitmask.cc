@@ -0,0 +1,97 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-rb-bitmask.h>
+#include <ns3/test.h>
+
+/**
+ * \file nr-test-rb-bitmask.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrRbBitmask. The test builds a mask from a
+ * vector of 0/1 values and checks that count, iteration, merge and the
+ * conversion back to a vector match the vector semantics, for sizes that
+ * fit in the inline storage and for sizes that need the heap.
+ */
+namespace ns3
+{
+
+class TestRbBitmaskTestCase : public TestCase
+{
+  public:
+    TestRbBitmaskTestCase(uint32_t size, const std::string& name)
+        : TestCase(name),
+          m_size(size)
+    {
+    }
+
+  private:
+    void DoRun() override;
+    uint32_t m_size{0};
+};
+
+void
+TestRbBitmaskTestCase::DoRun()
+{
+    std::vector<uint8_t> vector(m_size, 0);
+    std::vector<int> indexes;
+    for (uint32_t i = 0; i < m_size; ++i)
+    {
+        if (i % 3 == 0 || i == m_size - 1)
+        {
+            vector[i] = 1;
+            indexes.push_back(static_cast<int>(i));
+        }
+    }
+
+    NrRbBitmask mask(vector);
+    NS_TEST_ASSERT_MSG_EQ(mask.GetSize(), m_size, "Wrong size");
+    NS_TEST_ASSERT_MSG_EQ(mask.Count(), indexes.size(), "Wrong count");
+    NS_TEST_ASSERT_MSG_EQ(mask.Any(), true, "Mask should not be empty");
+    NS_TEST_ASSERT_MSG_EQ((mask.GetSetIndexes() == indexes), true, "Wrong set indexes");
+    NS_TEST_ASSERT_MSG_EQ((mask.ToVector() == vector), true, "Wrong conversion to vector");
+
+    NrRbBitmask full(m_size, true);
+    NS_TEST_ASSERT_MSG_EQ(full.Count(), m_size, "Full mask should have all the elements set");
+
+    NrRbBitmask empty(m_size);
+    NS_TEST_ASSERT_MSG_EQ(empty.Any(), false, "Empty mask should have no elements set");
+
+    // The complement of the mask, merged with the mask, gives the full mask
+    NrRbBitmask complement(m_size);
+    for (uint32_t i = 0; i < m_size; ++i)
+    {
+        if (!mask.Test(i))
+        {
+            complement.Set(i);
+        }
+    }
+    NS_TEST_ASSERT_MSG_EQ(complement.Count(), m_size - indexes.size(), "Wrong complement");
+    complement |= mask;
+    NS_TEST_ASSERT_MSG_EQ((complement == full), true, "Merge should give the full mask");
+
+    mask.Reset(m_size - 1);
+    NS_TEST_ASSERT_MSG_EQ(mask.Test(m_size - 1), false, "Reset did not clear the element");
+    NS_TEST_ASSERT_MSG_EQ(mask.Count(), indexes.size() - 1, "Wrong count after reset");
+}
+
+class TestRbBitmask : public TestSuite
+{
+  public:
+    TestRbBitmask()
+        : TestSuite("nr-test-rb-bitmask", UNIT)
+    {
+        AddTestCase(new TestRbBitmaskTestCase(1, "RB bitmask with 1 element"), QUICK);
+        AddTestCase(new TestRbBitmaskTestCase(64, "RB bitmask with 64 elements"), QUICK);
+        AddTestCase(new TestRbBitmaskTestCase(275, "RB bitmask with 275 elements"), QUICK);
+        AddTestCase(new TestRbBitmaskTestCase(320, "RB bitmask with 320 elements"), QUICK);
+        AddTestCase(new TestRbBitmaskTestCase(555, "RB bitmask with 555 elements"), QUICK);
+    }
+};
+
+static TestRbBitmask testRbBitmask; //!< NrRbBitmask test
+
+} // namespace ns3
@@ -0,0 +1,102 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-rem-binary-file.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <sstream>
+
+/**
+ * \file nr-test-rem-binary-file.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrRemBinaryFile. The test creates a file, writes
+ * some columns of the grid, reads it back, and checks the header, the values
+ * (NaN for the points not written) and the text output.
+ */
+namespace ns3
+{
+
+class TestRemBinaryFileTestCase : public TestCase
+{
+  public:
+    TestRemBinaryFileTestCase()
+        : TestCase("REM binary file")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestRemBinaryFileTestCase::DoRun()
+{
+    const float nan = std::nanf("");
+    std::string filename = CreateTempDirFilename("nr-rem-test.bin");
+
+    NrRemBinaryFile::Header header;
+    header.m_xMin = -1;
+    header.m_yMin = 2;
+    header.m_xStep = 0.5;
+    header.m_yStep = 1;
+    header.m_z = 1.5;
+    header.m_numX = 3;
+    header.m_numY = 2;
+    header.m_metrics = {"SNR", "SINR"};
+
+    NrRemBinaryFile writer;
+    NS_TEST_ASSERT_MSG_EQ(writer.Create(filename, header), true, "The file should be created");
+    // The last column is written before the second one, the first is not written
+    writer.WriteColumn(2, 1, {nan, 7});
+    writer.WriteColumn(1, 0, {1.5, nan});
+    writer.WriteColumn(1, 1, {2.5, nan});
+    writer.Close();
+
+    NrRemBinaryFile reader;
+    NS_TEST_ASSERT_MSG_EQ(reader.Open(filename), true, "The file should be read");
+    const NrRemBinaryFile::Header& readHeader = reader.GetHeader();
+    NS_TEST_ASSERT_MSG_EQ(readHeader.m_numX, 3, "Wrong number of columns");
+    NS_TEST_ASSERT_MSG_EQ(readHeader.m_numY, 2, "Wrong number of rows");
+    NS_TEST_ASSERT_MSG_EQ((readHeader.m_metrics == header.m_metrics), true, "Wrong metrics");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetX(2), 0, "Wrong x coordinate");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetY(1), 3, "Wrong y coordinate");
+
+    NS_TEST_ASSERT_MSG_EQ(reader.GetValue(0, 1, 0), 1.5, "Wrong value");
+    NS_TEST_ASSERT_MSG_EQ(reader.GetValue(1, 2, 1), 7, "Wrong value");
+    for (uint32_t yIndex = 0; yIndex < 2; yIndex++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(std::isnan(reader.GetValue(0, 0, yIndex)),
+                              true,
+                              "A column not written should be NaN");
+    }
+
+    std::ostringstream text;
+    reader.PrintText(text);
+    NS_TEST_ASSERT_MSG_EQ(text.str(),
+                          "-0.5\t2\t1.5\t1.5\t2.5\t\n0\t3\t1.5\tnan\t7\t\n",
+                          "Wrong text output: only the points with a value are printed");
+
+    NrRemBinaryFile notRem;
+    NS_TEST_ASSERT_MSG_EQ(notRem.Open(CreateTempDirFilename("missing.bin")),
+                          false,
+                          "A missing file should not be read");
+}
+
+class TestRemBinaryFile : public TestSuite
+{
+  public:
+    TestRemBinaryFile()
+        : TestSuite("nr-test-rem-binary-file", UNIT)
+    {
+        AddTestCase(new TestRemBinaryFileTestCase(), QUICK);
+    }
+};
+
+static TestRemBinaryFile testRemBinaryFile; //!< NrRemBinaryFile test
+
+} // namespace ns3
@@ -0,0 +1,93 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-rem-checkpoint-file.h>
+#include <ns3/test.h>
+
+#include <fstream>
+
+/**
+ * \file nr-test-rem-checkpoint-file.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrRemCheckpointFile. The test saves some REM points,
+ * interrupts the file in the middle of a record, and checks that the points
+ * saved are resumed only with the same configuration, and that the new points
+ * are appended to them.
+ */
+namespace ns3
+{
+
+class TestRemCheckpointFileTestCase : public TestCase
+{
+  public:
+    TestRemCheckpointFileTestCase()
+        : TestCase("REM checkpoint file")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestRemCheckpointFileTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("nr-rem-test.checkpoint");
+
+    NrRemCheckpointFile checkpoint;
+    NS_TEST_ASSERT_MSG_EQ(checkpoint.Open(filename, 42, 10, 2), true, "Should be created");
+    NS_TEST_ASSERT_MSG_EQ(checkpoint.GetResumedRecords().empty(), true, "Nothing to resume");
+    checkpoint.Append(3, {1, 2});
+    checkpoint.Save();
+    checkpoint.Append(7, {3, 4});
+    checkpoint.Close();
+
+    // A record interrupted while it was being saved
+    std::ofstream partial(filename.c_str(), std::ios_base::app | std::ios_base::binary);
+    partial.write("abc", 3);
+    partial.close();
+
+    NrRemCheckpointFile resumed;
+    NS_TEST_ASSERT_MSG_EQ(resumed.Open(filename, 42, 10, 2), true, "Should be opened");
+    const auto& records = resumed.GetResumedRecords();
+    NS_TEST_ASSERT_MSG_EQ(records.size(), 2, "The incomplete record should be ignored");
+    NS_TEST_ASSERT_MSG_EQ(records[0].m_index, 3, "Wrong index");
+    NS_TEST_ASSERT_MSG_EQ(records[1].m_index, 7, "Wrong index");
+    NS_TEST_ASSERT_MSG_EQ(records[1].m_values[1], 4, "Wrong value");
+    resumed.Append(9, {5, 6});
+    resumed.Close();
+
+    NrRemCheckpointFile appended;
+    appended.Open(filename, 42, 10, 2);
+    NS_TEST_ASSERT_MSG_EQ(appended.GetResumedRecords().size(), 3, "The record was not appended");
+    NS_TEST_ASSERT_MSG_EQ(appended.GetResumedRecords()[2].m_index, 9, "Wrong index");
+    appended.Close();
+
+    // Another configuration starts from scratch, and overwrites the checkpoint
+    NrRemCheckpointFile other;
+    other.Open(filename, 43, 10, 2);
+    NS_TEST_ASSERT_MSG_EQ(other.GetResumedRecords().empty(), true, "Different configuration");
+    other.Close();
+    NrRemCheckpointFile overwritten;
+    overwritten.Open(filename, 42, 10, 2);
+    NS_TEST_ASSERT_MSG_EQ(overwritten.GetResumedRecords().empty(), true, "Should be overwritten");
+    overwritten.Close();
+}
+
+class TestRemCheckpointFile : public TestSuite
+{
+  public:
+    TestRemCheckpointFile()
+        : TestSuite("nr-test-rem-checkpoint-file", UNIT)
+    {
+        AddTestCase(new TestRemCheckpointFileTestCase(), QUICK);
+    }
+};
+
+static TestRemCheckpointFile testRemCheckpointFile; //!< NrRemCheckpointFile test
+
+} // namespace ns3
@@ -0,0 +1,252 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/beamforming-vector.h>
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/nr-rem-engine.h>
+#include <ns3/node-list.h>
+#include <ns3/nr-spectrum-value-helper.h>
+#include <ns3/pointer.h>
+#include <ns3/propagation-loss-model.h>
+#include <ns3/test.h>
+#include <ns3/three-gpp-antenna-model.h>
+#include <ns3/uinteger.h>
+
+#include <cmath>
+
+/**
+ * \file nr-test-rem-engine.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrRemEngine. The test evaluates a scenario of two
+ * transmitters with the Friis path loss, and checks the powers, the SNR and the
+ * SINR of a point, the change of the TX powers of a configuration, and the gain
+ * of a beam towards the point. A second test changes the downtilt of a 3GPP
+ * antenna element, and checks the change of its gain towards the point.
+ */
+namespace ns3
+{
+
+class TestRemEngineTestCase : public TestCase
+{
+  public:
+    TestRemEngineTestCase()
+        : TestCase("REM engine")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Creates an antenna of isotropic elements
+     * \param numRows the number of rows
+     * \param numColumns the number of columns
+     * \return The antenna
+     */
+    static Ptr<UniformPlanarArray> CreateAntenna(uint32_t numRows, uint32_t numColumns);
+
+    /**
+     * \brief Creates a mobility model at a position
+     * \param position the position
+     * \return The mobility model
+     */
+    static Ptr<MobilityModel> CreateMobility(const Vector& position);
+};
+
+Ptr<UniformPlanarArray>
+TestRemEngineTestCase::CreateAntenna(uint32_t numRows, uint32_t numColumns)
+{
+    Ptr<UniformPlanarArray> antenna = CreateObject<UniformPlanarArray>();
+    antenna->SetAttribute("NumRows", UintegerValue(numRows));
+    antenna->SetAttribute("NumColumns", UintegerValue(numColumns));
+    return antenna;
+}
+
+Ptr<MobilityModel>
+TestRemEngineTestCase::CreateMobility(const Vector& position)
+{
+    Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+    mob->SetPosition(position);
+    return mob;
+}
+
+void
+TestRemEngineTestCase::DoRun()
+{
+    double frequency = 28e9;
+    double noiseFigure = 7;
+    Vector gnb0(0, 0, 10);
+    Vector gnb1(100, 0, 10);
+    Vector point(20, 0, 1.5);
+
+    ObjectFactory propagationLossModelFactory;
+    propagationLossModelFactory.SetTypeId("ns3::FriisPropagationLossModel");
+    propagationLossModelFactory.Set("Frequency", DoubleValue(frequency));
+    Ptr<const SpectrumModel> sm = NrSpectrumValueHelper::GetSpectrumModel(66, frequency, 120e3);
+
+    uint32_t numNodes = NodeList::GetNNodes();
+    NrRemEngine engine;
+    engine.SetPropagationModels(propagationLossModelFactory, ObjectFactory());
+    engine.SetSpectrum(sm, noiseFigure);
+    engine.AddTransmitter(gnb0, CreateAntenna(1, 1), 30);
+    engine.AddTransmitter(gnb1, CreateAntenna(1, 1), 30);
+    engine.SetPoints({point});
+    engine.AssignStreams(1);
+    engine.Precompute();
+    engine.Precompute();
+    NS_TEST_ASSERT_MSG_EQ(NodeList::GetNNodes(),
+                          numNodes + 3,
+                          "The engine should add a node per transmitter and one for the receiver");
+
+    Ptr<PropagationLossModel> friis =
+        propagationLossModelFactory.Create<PropagationLossModel>();
+    double rx0 = friis->CalcRxPower(30, CreateMobility(gnb0), CreateMobility(point));
+    double rx1 = friis->CalcRxPower(30, CreateMobility(gnb1), CreateMobility(point));
+    double noise =
+        Integral(*NrSpectrumValueHelper::CreateNoisePowerSpectralDensity(noiseFigure, sm));
+    double p0 = std::pow(10, (rx0 - 30) / 10);
+    double p1 = std::pow(10, (rx1 - 30) / 10);
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(engine.GetPathGain(0, 0), rx0 - 30, 1e-9, "Wrong path gain");
+
+    std::vector<NrRemEngine::PointResult> results = engine.Evaluate({});
+    NS_TEST_ASSERT_MSG_EQ(results.size(), 1, "There should be a result for each point");
+    NS_TEST_ASSERT_MSG_EQ(results[0].bestServer, 0, "The nearest gNB should be the best server");
+    NS_TEST_ASSERT_MSG_EQ_TOL(results[0].rxPowerDbm,
+                              10 * std::log10(p0 + p1) + 30,
+                              1e-6,
+                              "Wrong received power");
+    NS_TEST_ASSERT_MSG_EQ_TOL(results[0].snrDb, 10 * std::log10(p0 / noise), 1e-6, "Wrong SNR");
+    NS_TEST_ASSERT_MSG_EQ_TOL(results[0].sinrDb,
+                              10 * std::log10(p0 / (p1 + noise)),
+                              1e-6,
+                              "Wrong SINR");
+
+    NrRemEngine::Configuration louder;
+    louder.txPowers = {30, 60};
+    std::vector<NrRemEngine::PointResult> louderResults = engine.Evaluate(louder);
+    NS_TEST_ASSERT_MSG_EQ(louderResults[0].bestServer,
+                          1,
+                          "The TX power of the configuration should change the best server");
+    NS_TEST_ASSERT_MSG_EQ_TOL(louderResults[0].snrDb,
+                              10 * std::log10(1000 * p1 / noise),
+                              1e-6,
+                              "Wrong SNR of the configuration");
+
+    // A beam of a 4x4 antenna of isotropic elements towards the point has a
+    // gain of 16 (12.04 dB) over the single element
+    NrRemEngine beamEngine;
+    beamEngine.SetPropagationModels(propagationLossModelFactory, ObjectFactory());
+    beamEngine.SetSpectrum(sm, noiseFigure);
+    Ptr<UniformPlanarArray> array = CreateAntenna(4, 4);
+    beamEngine.AddTransmitter(gnb0, array, 30);
+    beamEngine.SetPoints({point});
+    beamEngine.AssignStreams(1);
+    beamEngine.Precompute();
+
+    NrRemEngine::Configuration beam;
+    beam.beams = {CreateDirectPathBfv(CreateMobility(gnb0), CreateMobility(point), array)};
+    std::vector<NrRemEngine::PointResult> beamResults = beamEngine.Evaluate(beam);
+    NS_TEST_ASSERT_MSG_EQ_TOL(beamResults[0].snrDb - 10 * std::log10(p0 / noise),
+                              10 * std::log10(16.0),
+                              1e-6,
+                              "Wrong gain of the beam");
+}
+
+class TestRemEngineDowntiltTestCase : public TestCase
+{
+  public:
+    TestRemEngineDowntiltTestCase()
+        : TestCase("REM engine downtilt")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestRemEngineDowntiltTestCase::DoRun()
+{
+    double frequency = 28e9;
+    Vector gnb(0, 0, 10);
+    Vector point(20, 0, 1.5);
+
+    ObjectFactory propagationLossModelFactory;
+    propagationLossModelFactory.SetTypeId("ns3::FriisPropagationLossModel");
+    propagationLossModelFactory.Set("Frequency", DoubleValue(frequency));
+
+    Ptr<UniformPlanarArray> antenna = CreateObject<UniformPlanarArray>();
+    antenna->SetAttribute("NumRows", UintegerValue(1));
+    antenna->SetAttribute("NumColumns", UintegerValue(1));
+    antenna->SetAttribute("AntennaElement", PointerValue(CreateObject<ThreeGppAntennaModel>()));
+
+    NrRemEngine engine;
+    engine.SetPropagationModels(propagationLossModelFactory, ObjectFactory());
+    engine.SetSpectrum(NrSpectrumValueHelper::GetSpectrumModel(66, frequency, 120e3), 7);
+    engine.AddTransmitter(gnb, antenna, 30);
+    engine.SetPoints({point});
+    engine.AssignStreams(1);
+    engine.Precompute();
+
+    // The boresight of the element tilted down by the elevation of the point
+    // points to it. Without tilt, the vertical pattern of the element (65 degrees
+    // of beamwidth) attenuates the signal by 12 * (elevation / 65)^2 dB.
+    double elevation = std::atan2(gnb.z - point.z, point.x - gnb.x);
+    double attenuation = 12 * std::pow(elevation * 180 / M_PI / 65, 2);
+
+    double untilted = engine.Evaluate({})[0].snrDb;
+    NrRemEngine::Configuration tilted;
+    tilted.downTilts = {elevation};
+    double tiltedSnr = engine.Evaluate(tilted)[0].snrDb;
+    NS_TEST_ASSERT_MSG_EQ_TOL(tiltedSnr - untilted,
+                              attenuation,
+                              1e-6,
+                              "The downtilt towards the point should remove the attenuation");
+
+    // The antenna of the scenario is not changed, and the cached gains are the
+    // ones of each downtilt
+    NS_TEST_ASSERT_MSG_EQ_TOL(engine.Evaluate({})[0].snrDb,
+                              untilted,
+                              1e-12,
+                              "The downtilt of a configuration should not change the scenario");
+    NS_TEST_ASSERT_MSG_EQ_TOL(engine.Evaluate(tilted)[0].snrDb,
+                              tiltedSnr,
+                              1e-12,
+                              "The cached gains should be the ones of the downtilt");
+
+    // The same downtilt set on the antenna of the scenario gives the same map
+    Ptr<UniformPlanarArray> tiltedAntenna = Copy(antenna);
+    tiltedAntenna->SetAttribute("DowntiltAngle", DoubleValue(elevation));
+    NrRemEngine tiltedEngine;
+    tiltedEngine.SetPropagationModels(propagationLossModelFactory, ObjectFactory());
+    tiltedEngine.SetSpectrum(NrSpectrumValueHelper::GetSpectrumModel(66, frequency, 120e3), 7);
+    tiltedEngine.AddTransmitter(gnb, tiltedAntenna, 30);
+    tiltedEngine.SetPoints({point});
+    tiltedEngine.AssignStreams(1);
+    tiltedEngine.Precompute();
+    NS_TEST_ASSERT_MSG_EQ_TOL(tiltedEngine.Evaluate({})[0].snrDb,
+                              tiltedSnr,
+                              1e-9,
+                              "The downtilt of the configuration and of the antenna should match");
+}
+
+class TestRemEngine : public TestSuite
+{
+  public:
+    TestRemEngine()
+        : TestSuite("nr-test-rem-engine", UNIT)
+    {
+        AddTestCase(new TestRemEngineTestCase(), QUICK);
+        AddTestCase(new TestRemEngineDowntiltTestCase(), QUICK);
+    }
+};
+
+static TestRemEngine testRemEngine; //!< NrRemEngine test
+
+} // namespace ns3
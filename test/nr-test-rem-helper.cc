@@ -0,0 +1,407 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/antenna-module.h>
+#include <ns3/mobility-module.h>
+#include <ns3/nr-module.h>
+#include <ns3/rng-seed-manager.h>
+#include <ns3/test.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <string>
+
+/**
+ * \file nr-test-rem-helper.cc
+ * \ingroup test
+ *
+ * \brief System-testing for NrRadioEnvironmentMapHelper. The tests generate the
+ * REM of a scenario of two gNBs and a UE, and compare the maps generated with
+ * different configurations of the helper: the map calculated by a single worker
+ * and by several worker processes must be the same, and the points calculated by
+ * the adaptive sampling must be equal to the ones of the full map, also in the
+ * cells that contain a gNB and in a map of a single row. The last test checks
+ * that the scalar calculation of PathlossOnly gives the same values as the
+ * calculation with PSDs.
+ */
+namespace ns3
+{
+
+/**
+ * \brief Base class of the REM helper tests, that generates the REM of the
+ * test scenario and reads it back
+ */
+class NrRemHelperTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the test case
+     */
+    NrRemHelperTestCase(const std::string& name)
+        : TestCase(name)
+    {
+    }
+
+  protected:
+    /**
+     * \brief The values of a REM point, as written in the REM file: x, y, z,
+     * SNR, SINR, RX power and SIR
+     */
+    using RemRow = std::vector<double>;
+
+    /**
+     * \brief Generates the DL REM of the test scenario
+     * \param simTag the tag of the REM files, which are removed afterwards
+     * \param configure function that configures the REM helper
+     * \param samples if not nullptr, the points calculated by the adaptive sampling
+     * \param inspect if not empty, function called with the REM helper when the REM
+     * is complete, before the simulation is destroyed
+     * \return the points of the map, in the order of the REM file
+     */
+    std::vector<RemRow> RunRem(
+        const std::string& simTag,
+        const std::function<void(Ptr<NrRadioEnvironmentMapHelper>)>& configure,
+        std::vector<RemRow>* samples = nullptr,
+        const std::function<void(Ptr<NrRadioEnvironmentMapHelper>)>& inspect = {});
+
+    /**
+     * \brief Reads the points of a REM file
+     * \param fileName the name of the file
+     * \return the points of the file
+     */
+    std::vector<RemRow> ReadRemFile(const std::string& fileName);
+};
+
+std::vector<NrRemHelperTestCase::RemRow>
+NrRemHelperTestCase::ReadRemFile(const std::string& fileName)
+{
+    std::vector<RemRow> rows;
+    std::ifstream remFile(fileName);
+    NS_TEST_EXPECT_MSG_EQ(remFile.is_open(), true, "The file " << fileName << " was not written");
+    std::string line;
+    while (std::getline(remFile, line))
+    {
+        // std::stod, unlike the stream extraction, reads also inf and nan
+        std::istringstream iss(line);
+        RemRow row;
+        std::string value;
+        while (iss >> value)
+        {
+            row.push_back(std::stod(value));
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+std::vector<NrRemHelperTestCase::RemRow>
+NrRemHelperTestCase::RunRem(const std::string& simTag,
+                            const std::function<void(Ptr<NrRadioEnvironmentMapHelper>)>& configure,
+                            std::vector<RemRow>* samples,
+                            const std::function<void(Ptr<NrRadioEnvironmentMapHelper>)>& inspect)
+{
+    RngSeedManager::SetSeed(1);
+    RngSeedManager::SetRun(1);
+    RngSeedManager::ResetNextStreamIndex();
+
+    NodeContainer gnbNodes;
+    NodeContainer ueNodes;
+    gnbNodes.Create(2);
+    ueNodes.Create(1);
+
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.Install(gnbNodes);
+    mobility.Install(ueNodes);
+    gnbNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(0, 0, 10));
+    gnbNodes.Get(1)->GetObject<MobilityModel>()->SetPosition(Vector(40, 0, 10));
+    ueNodes.Get(0)->GetObject<MobilityModel>()->SetPosition(Vector(10, 10, 1.5));
+
+    Ptr<NrPointToPointEpcHelper> epcHelper = CreateObject<NrPointToPointEpcHelper>();
+    Ptr<IdealBeamformingHelper> idealBeamformingHelper = CreateObject<IdealBeamformingHelper>();
+    Ptr<NrHelper> nrHelper = CreateObject<NrHelper>();
+    nrHelper->SetBeamformingHelper(idealBeamformingHelper);
+    nrHelper->SetEpcHelper(epcHelper);
+
+    CcBwpCreator ccBwpCreator;
+    CcBwpCreator::SimpleOperationBandConf bandConf(28e9,
+                                                   20e6,
+                                                   1,
+                                                   BandwidthPartInfo::UMi_StreetCanyon_LoS);
+    OperationBandInfo band = ccBwpCreator.CreateOperationBandContiguousCc(bandConf);
+    Config::SetDefault("ns3::ThreeGppChannelModel::UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetChannelConditionModelAttribute("UpdatePeriod", TimeValue(MilliSeconds(0)));
+    nrHelper->SetPathlossAttribute("ShadowingEnabled", BooleanValue(false));
+    nrHelper->InitializeOperationBand(&band);
+    BandwidthPartInfoPtrVector allBwps = CcBwpCreator::GetAllBwps({band});
+
+    nrHelper->SetUeAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetUeAntennaAttribute("AntennaElement",
+                                    PointerValue(CreateObject<IsotropicAntennaModel>()));
+    nrHelper->SetGnbAntennaAttribute("NumRows", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("NumColumns", UintegerValue(2));
+    nrHelper->SetGnbAntennaAttribute("AntennaElement",
+                                     PointerValue(CreateObject<IsotropicAntennaModel>()));
+
+    NetDeviceContainer gnbNetDev = nrHelper->InstallGnbDevice(gnbNodes, allBwps);
+    NetDeviceContainer ueNetDev = nrHelper->InstallUeDevice(ueNodes, allBwps);
+    int64_t stream = 1;
+    stream += nrHelper->AssignStreams(gnbNetDev, stream);
+    nrHelper->AssignStreams(ueNetDev, stream);
+    for (uint32_t i = 0; i < gnbNetDev.GetN(); i++)
+    {
+        Ptr<NrGnbNetDevice> gnbDev = DynamicCast<NrGnbNetDevice>(gnbNetDev.Get(i));
+        gnbDev->UpdateConfig();
+        gnbDev->GetPhy(0)->GetSpectrumPhy()->GetBeamManager()->ChangeToQuasiOmniBeamformingVector();
+    }
+    Ptr<NrUeNetDevice> ueDev = DynamicCast<NrUeNetDevice>(ueNetDev.Get(0));
+    ueDev->UpdateConfig();
+    ueDev->GetPhy(0)->GetSpectrumPhy()->GetBeamManager()->ChangeToQuasiOmniBeamformingVector();
+
+    Ptr<NrRadioEnvironmentMapHelper> remHelper = CreateObject<NrRadioEnvironmentMapHelper>();
+    remHelper->SetMinX(-20);
+    remHelper->SetMaxX(60);
+    remHelper->SetResX(8);
+    remHelper->SetMinY(-20);
+    remHelper->SetMaxY(20);
+    remHelper->SetResY(4);
+    remHelper->SetZ(1.5);
+    remHelper->SetSimTag(simTag);
+    remHelper->SetRemMode(NrRadioEnvironmentMapHelper::BEAM_SHAPE);
+    configure(remHelper);
+    remHelper->CreateRem(gnbNetDev, ueDev, 0);
+
+    Simulator::Stop(MilliSeconds(100));
+    Simulator::Run();
+    if (inspect)
+    {
+        inspect(remHelper);
+    }
+    Simulator::Destroy();
+
+    std::string prefix = "nr-rem-" + simTag;
+    std::vector<RemRow> rows = ReadRemFile(prefix + ".out");
+    if (samples != nullptr)
+    {
+        *samples = ReadRemFile(prefix + "-samples.out");
+    }
+
+    for (const auto& suffix : {".out",
+                               "-ues.txt",
+                               "-gnbs.txt",
+                               "-buildings.txt",
+                               "-plot-rem.gnuplot",
+                               "-samples.out",
+                               "-summary.txt",
+                               "-best-server.out",
+                               ".checkpoint",
+                               ".bin"})
+    {
+        std::remove((prefix + suffix).c_str());
+    }
+    return rows;
+}
+
+/**
+ * \brief Checks that the map calculated by several worker processes is the same
+ * as the map calculated by a single worker
+ */
+class NrRemHelperWorkersTestCase : public NrRemHelperTestCase
+{
+  public:
+    NrRemHelperWorkersTestCase()
+        : NrRemHelperTestCase("REM helper: the map does not depend on the number of workers")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrRemHelperWorkersTestCase::DoRun()
+{
+    std::vector<RemRow> serial =
+        RunRem("test-workers-1", [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetNumWorkers(1);
+        });
+    std::vector<RemRow> parallel =
+        RunRem("test-workers-3", [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetNumWorkers(3);
+        });
+
+    NS_TEST_ASSERT_MSG_EQ(serial.size(), 9 * 5, "Unexpected number of REM points");
+    NS_TEST_ASSERT_MSG_EQ(parallel.size(), serial.size(), "Different number of REM points");
+    for (size_t i = 0; i < serial.size(); i++)
+    {
+        NS_TEST_ASSERT_MSG_EQ(serial[i].size(), 7, "Unexpected number of values of a REM point");
+        NS_TEST_ASSERT_MSG_EQ((parallel[i] == serial[i]),
+                              true,
+                              "The REM point " << i << " changes with the number of workers");
+    }
+}
+
+/**
+ * \brief Checks that the points calculated by the adaptive sampling are equal
+ * to the ones of the full map, that the cells that contain a gNB are split
+ * even if their corners are uniform, and that a map of a single row is sampled
+ */
+class NrRemHelperAdaptiveTestCase : public NrRemHelperTestCase
+{
+  public:
+    NrRemHelperAdaptiveTestCase()
+        : NrRemHelperTestCase("REM helper: adaptive sampling")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+NrRemHelperAdaptiveTestCase::DoRun()
+{
+    std::vector<RemRow> full =
+        RunRem("test-adaptive-full", [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetAdaptiveLevels(0);
+        });
+    // With this threshold the corners of every cell are uniform, and only the
+    // cells that contain a gNB are split
+    std::vector<RemRow> samples;
+    std::vector<RemRow> adaptive = RunRem(
+        "test-adaptive",
+        [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetAdaptiveLevels(2);
+            remHelper->SetAdaptiveThreshold(1000);
+        },
+        &samples);
+
+    NS_TEST_ASSERT_MSG_EQ(adaptive.size(), full.size(), "Different number of REM points");
+    NS_TEST_ASSERT_MSG_GT(samples.size(), 0, "No REM points calculated");
+    bool gnbNeighborSampled = false;
+    for (const RemRow& sample : samples)
+    {
+        auto it = std::find_if(full.begin(), full.end(), [&sample](const RemRow& row) {
+            return row[0] == sample[0] && row[1] == sample[1];
+        });
+        NS_TEST_ASSERT_MSG_EQ((it != full.end()), true, "A sample is not a point of the map");
+        NS_TEST_ASSERT_MSG_EQ((*it == sample),
+                              true,
+                              "The sample at (" << sample[0] << ", " << sample[1]
+                                                << ") differs from the full map");
+        // The gNB at (0, 0) is inside the first coarse cell, not at its corners
+        gnbNeighborSampled |= (sample[0] == 10 && sample[1] == 0);
+    }
+    NS_TEST_ASSERT_MSG_EQ(gnbNeighborSampled,
+                          true,
+                          "The cell that contains a gNB should be split");
+
+    // A single row (resolution 0 along y): with threshold 0 every point is calculated
+    std::vector<RemRow> fullRow =
+        RunRem("test-adaptive-row-full", [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetResY(0);
+            remHelper->SetAdaptiveLevels(0);
+        });
+    std::vector<RemRow> adaptiveRow = RunRem(
+        "test-adaptive-row",
+        [](Ptr<NrRadioEnvironmentMapHelper> remHelper) {
+            remHelper->SetResY(0);
+            remHelper->SetAdaptiveLevels(2);
+            remHelper->SetAdaptiveThreshold(0);
+        },
+        &samples);
+    NS_TEST_ASSERT_MSG_EQ(fullRow.size(), 9, "Unexpected number of REM points");
+    NS_TEST_ASSERT_MSG_EQ(samples.size(), fullRow.size(), "Every point should be calculated");
+    NS_TEST_ASSERT_MSG_EQ((adaptiveRow == fullRow), true, "The sampled row differs");
+}
+
+/**
+ * \brief Checks that the REM points calculated with PathlossOnly with scalar
+ * powers have the same SNR, SINR, RX power and SIR as the ones calculated with
+ * the PSDs, and that they are finite
+ */
+class NrRemHelperScalarTestCase : public NrRemHelperTestCase
+{
+  public:
+    NrRemHelperScalarTestCase()
+        : NrRemHelperTestCase("REM helper: scalar and PSD calculations")
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Calculates again the points of a complete REM with the PSDs, and
+     * compares them with the scalar ones
+     * \param remHelper the REM helper
+     */
+    void CheckPsdCalculation(Ptr<NrRadioEnvironmentMapHelper> remHelper);
+};
+
+void
+NrRemHelperScalarTestCase::CheckPsdCalculation(Ptr<NrRadioEnvironmentMapHelper> remHelper)
+{
+    NS_TEST_ASSERT_MSG_EQ(remHelper->m_scalarCalc, true, "The REM should be scalar");
+    std::vector<NrRadioEnvironmentMapHelper::RemPoint> scalar = remHelper->m_rem;
+    remHelper->m_scalarCalc = false;
+    for (size_t index = 0; index < scalar.size(); index++)
+    {
+        remHelper->CalcRemPoint(&NrRadioEnvironmentMapHelper::CalcBeamShapeRemPoint, index);
+        const NrRadioEnvironmentMapHelper::RemPoint& psd = remHelper->m_rem[index];
+        for (const auto& [name, value] :
+             {std::make_pair("SNR", &NrRadioEnvironmentMapHelper::RemPoint::avgSnrDb),
+              std::make_pair("SINR", &NrRadioEnvironmentMapHelper::RemPoint::avgSinrDb),
+              std::make_pair("RX power", &NrRadioEnvironmentMapHelper::RemPoint::avRxPowerDbm),
+              std::make_pair("SIR", &NrRadioEnvironmentMapHelper::RemPoint::avgSirDb)})
+        {
+            NS_TEST_ASSERT_MSG_EQ(std::isfinite(psd.*value),
+                                  true,
+                                  "The " << name << " of the REM point " << index
+                                         << " is not finite");
+            NS_TEST_ASSERT_MSG_EQ_TOL(psd.*value,
+                                      scalar[index].*value,
+                                      1e-6,
+                                      "The scalar " << name << " of the REM point " << index
+                                                    << " differs");
+        }
+    }
+}
+
+void
+NrRemHelperScalarTestCase::DoRun()
+{
+    RunRem(
+        "test-scalar",
+        [](Ptr<NrRadioEnvironmentMapHelper> remHelper) { remHelper->SetPathlossOnly(true); },
+        nullptr,
+        [this](Ptr<NrRadioEnvironmentMapHelper> remHelper) { CheckPsdCalculation(remHelper); });
+}
+
+/**
+ * \brief The test suite of NrRadioEnvironmentMapHelper
+ */
+class NrRemHelperTestSuite : public TestSuite
+{
+  public:
+    NrRemHelperTestSuite()
+        : TestSuite("nr-test-rem-helper", SYSTEM)
+    {
+        AddTestCase(new NrRemHelperWorkersTestCase(), QUICK);
+        AddTestCase(new NrRemHelperAdaptiveTestCase(), QUICK);
+        AddTestCase(new NrRemHelperScalarTestCase(), QUICK);
+    }
+};
+
+static NrRemHelperTestSuite nrRemHelperTestSuite; //!< REM helper test
+
+} // namespace ns3
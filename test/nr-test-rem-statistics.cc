@@ -0,0 +1,122 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/nr-rem-statistics.h>
+#include <ns3/test.h>
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+
+/**
+ * \file nr-test-rem-statistics.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrRemStatistics. The test adds some values of two
+ * metrics and some best servers, and checks the histograms, the coverage, and
+ * the lines of the summary. A third metric has infinite values, which are
+ * counted but are not part of the mean.
+ */
+namespace ns3
+{
+
+class TestRemStatisticsTestCase : public TestCase
+{
+  public:
+    TestRemStatisticsTestCase()
+        : TestCase("REM statistics")
+    {
+    }
+
+  private:
+    void DoRun() override;
+};
+
+void
+TestRemStatisticsTestCase::DoRun()
+{
+    NrRemStatistics stats;
+    stats.SetBinWidth(0.5);
+    size_t sinr = stats.AddMetric("SINR", {0, 10});
+    size_t rxPower = stats.AddMetric("RxPower", {-80});
+
+    for (double value : {-3.2, -0.1, 0.0, 0.4, 12.0, std::numeric_limits<double>::quiet_NaN()})
+    {
+        stats.AddValue(sinr, value);
+    }
+    stats.AddValue(rxPower, -90);
+    stats.AddValue(rxPower, -70);
+    stats.AddBestServer(2);
+    stats.AddBestServer(0);
+    stats.AddBestServer(2);
+
+    NS_TEST_ASSERT_MSG_EQ(stats.GetCount(sinr), 5, "NaN values should be ignored");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetMin(sinr), -3.2, 1e-12, "Wrong min");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetMax(sinr), 12.0, 1e-12, "Wrong max");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetMean(sinr), 9.1 / 5, 1e-12, "Wrong mean");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetCoverage(sinr, 0), 0.6, 1e-12, "Wrong coverage");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetCoverage(sinr, 1), 0.2, 1e-12, "Wrong coverage");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetCoverage(rxPower, 0), 0.5, 1e-12, "Wrong coverage");
+
+    const auto& bins = stats.GetHistogram(sinr);
+    NS_TEST_ASSERT_MSG_EQ(bins.size(), 4, "Only the bins with values should be kept");
+    NS_TEST_ASSERT_MSG_EQ(bins.at(-7), 1, "-3.2 should be in [-3.5, -3)");
+    NS_TEST_ASSERT_MSG_EQ(bins.at(-1), 1, "-0.1 should be in [-0.5, 0)");
+    NS_TEST_ASSERT_MSG_EQ(bins.at(0), 2, "0 and 0.4 should be in [0, 0.5)");
+    NS_TEST_ASSERT_MSG_EQ(bins.at(24), 1, "12 should be in [12, 12.5)");
+
+    const auto& servers = stats.GetBestServerCounts();
+    NS_TEST_ASSERT_MSG_EQ(servers.size(), 3, "Wrong number of RTDs");
+    NS_TEST_ASSERT_MSG_EQ(servers[0], 1, "Wrong points of RTD 0");
+    NS_TEST_ASSERT_MSG_EQ(servers[1], 0, "Wrong points of RTD 1");
+    NS_TEST_ASSERT_MSG_EQ(servers[2], 2, "Wrong points of RTD 2");
+
+    std::ostringstream oss;
+    stats.Print(oss);
+    std::string summary = oss.str();
+    NS_TEST_ASSERT_MSG_NE(summary.find("coverage\tSINR\t10\t0.2\n"),
+                          std::string::npos,
+                          "Missing coverage line");
+    NS_TEST_ASSERT_MSG_NE(summary.find("histogram\tSINR\t12\t12.5\t1\t1\n"),
+                          std::string::npos,
+                          "The CDF of the last bin should be 1");
+    NS_TEST_ASSERT_MSG_NE(summary.find("server\t2\t2\t"),
+                          std::string::npos,
+                          "Missing best server line");
+
+    size_t snr = stats.AddMetric("SNR", {0});
+    for (double value : {10.0,
+                         -std::numeric_limits<double>::infinity(),
+                         20.0,
+                         std::numeric_limits<double>::infinity()})
+    {
+        stats.AddValue(snr, value);
+    }
+    NS_TEST_ASSERT_MSG_EQ(stats.GetCount(snr), 4, "Infinite values should be counted");
+    NS_TEST_ASSERT_MSG_EQ(stats.GetInfiniteCount(snr), 2, "Wrong number of infinite values");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetMean(snr), 15, 1e-12, "Mean of the finite values");
+    NS_TEST_ASSERT_MSG_EQ(std::isinf(stats.GetMin(snr)), true, "The min should be -inf");
+    NS_TEST_ASSERT_MSG_EQ_TOL(stats.GetCoverage(snr, 0), 0.75, 1e-12, "Wrong coverage");
+    oss.str("");
+    stats.Print(oss);
+    NS_TEST_ASSERT_MSG_NE(oss.str().find("metric\tSNR\t4\t-inf\tinf\t15\t2\n"),
+                          std::string::npos,
+                          "Wrong metric line with infinite values");
+}
+
+class TestRemStatistics : public TestSuite
+{
+  public:
+    TestRemStatistics()
+        : TestSuite("nr-test-rem-statistics", UNIT)
+    {
+        AddTestCase(new TestRemStatisticsTestCase(), QUICK);
+    }
+};
+
+static TestRemStatistics testRemStatistics; //!< NrRemStatistics test
+
+} // namespace ns3
@@ -0,0 +1,126 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <ns3/constant-position-mobility-model.h>
+#include <ns3/double.h>
+#include <ns3/nr-spatial-grid-index.h>
+#include <ns3/test.h>
+
+#include <cmath>
+
+/**
+ * \file nr-test-spatial-grid-index.cc
+ * \ingroup test
+ *
+ * \brief Unit-testing for NrSpatialGridIndex. The test places a set of nodes
+ * and checks that the pairs within a distance, and the nodes within a
+ * distance from a position, are the same that a brute force search finds,
+ * also after moving some of the nodes to other cells.
+ */
+namespace ns3
+{
+
+class TestSpatialGridIndexTestCase : public TestCase
+{
+  public:
+    TestSpatialGridIndexTestCase(double cellSize, const std::string& name)
+        : TestCase(name),
+          m_cellSize(cellSize)
+    {
+    }
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the index against a brute force search
+     * \param index the index
+     * \param nodes the mobility models of the nodes
+     * \param distance the distance
+     */
+    void Check(const Ptr<NrSpatialGridIndex>& index,
+               const std::vector<Ptr<MobilityModel>>& nodes,
+               double distance);
+
+    double m_cellSize{100.0};
+};
+
+void
+TestSpatialGridIndexTestCase::Check(const Ptr<NrSpatialGridIndex>& index,
+                                    const std::vector<Ptr<MobilityModel>>& nodes,
+                                    double distance)
+{
+    for (const auto& a : nodes)
+    {
+        size_t expectedNear = 0;
+        for (const auto& b : nodes)
+        {
+            bool near = a->GetDistanceFrom(b) <= distance;
+            expectedNear += near ? 1 : 0;
+            NS_TEST_ASSERT_MSG_EQ(index->IsWithinDistance(a, b, distance),
+                                  near,
+                                  "Wrong distance check");
+        }
+        std::vector<Ptr<const MobilityModel>> found =
+            index->GetWithinDistance(a->GetPosition(), distance);
+        NS_TEST_ASSERT_MSG_EQ(found.size(), expectedNear, "Wrong number of near nodes");
+        for (const auto& b : found)
+        {
+            NS_TEST_ASSERT_MSG_LT_OR_EQ(a->GetDistanceFrom(b), distance, "Node too far");
+        }
+    }
+}
+
+void
+TestSpatialGridIndexTestCase::DoRun()
+{
+    Ptr<NrSpatialGridIndex> index = CreateObject<NrSpatialGridIndex>();
+    index->SetAttribute("CellSize", DoubleValue(m_cellSize));
+
+    std::vector<Ptr<MobilityModel>> nodes;
+    for (uint32_t i = 0; i < 60; i++)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        // Positions spread over 1 km, also with negative coordinates
+        mobility->SetPosition(Vector(std::fmod(i * 137.0, 1000.0) - 500.0,
+                                     std::fmod(i * 291.0, 1000.0) - 500.0,
+                                     (i % 3 == 0) ? 25.0 : 1.5));
+        index->Add(mobility);
+        nodes.push_back(mobility);
+    }
+    NS_TEST_ASSERT_MSG_EQ(index->GetN(), nodes.size(), "Wrong number of nodes");
+
+    Check(index, nodes, 150.0);
+    Check(index, nodes, 400.0);
+
+    // Move some nodes: the index follows their course changes
+    for (uint32_t i = 0; i < nodes.size(); i += 4)
+    {
+        Vector position = nodes[i]->GetPosition();
+        nodes[i]->SetPosition(Vector(-position.y, position.x + 230.0, position.z));
+    }
+    Check(index, nodes, 150.0);
+    Check(index, nodes, 400.0);
+
+    index->Dispose();
+}
+
+class TestSpatialGridIndex : public TestSuite
+{
+  public:
+    TestSpatialGridIndex()
+        : TestSuite("nr-test-spatial-grid-index", UNIT)
+    {
+        AddTestCase(new TestSpatialGridIndexTestCase(50.0, "Spatial grid index, 50 m cells"),
+                    QUICK);
+        AddTestCase(new TestSpatialGridIndexTestCase(500.0, "Spatial grid index, 500 m cells"),
+                    QUICK);
+    }
+};
+
+static TestSpatialGridIndex testSpatialGridIndex; //!< NrSpatialGridIndex test
+
+} // namespace ns3
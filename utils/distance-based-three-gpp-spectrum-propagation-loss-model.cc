@@ -7,6 +7,7 @@
 
 #include "distance-based-three-gpp-spectrum-propagation-loss-model.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/node.h"
@@ -50,7 +51,33 @@ DistanceBasedThreeGppSpectrumPropagationLossModel::GetTypeId()
                 MakeDoubleAccessor(
                     &DistanceBasedThreeGppSpectrumPropagationLossModel::SetMaxDistance,
                     &DistanceBasedThreeGppSpectrumPropagationLossModel::GetMaxDistance),
-                MakeDoubleChecker<double>());
+                MakeDoubleChecker<double>())
+            .AddAttribute(
+                "FarPairsPathlossOnly",
+                "If true, the signals among nodes farther than MaxDistance are returned without "
+                "fast fading and beamforming gain (i.e., only with the path loss), instead of "
+                "with 0 PSD.",
+                BooleanValue(false),
+                MakeBooleanAccessor(
+                    &DistanceBasedThreeGppSpectrumPropagationLossModel::m_farPairsPathlossOnly),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "DropFarPairs",
+                "If true, NrHelper installs in the spectrum channel a filter that drops the "
+                "signals among nodes farther than MaxDistance, before computing any "
+                "propagation loss.",
+                BooleanValue(false),
+                MakeBooleanAccessor(
+                    &DistanceBasedThreeGppSpectrumPropagationLossModel::m_dropFarPairs),
+                MakeBooleanChecker())
+            .AddAttribute(
+                "SpatialIndex",
+                "The spatial index used to check the distance among the nodes. It can be "
+                "shared among models. If not set, the distance is computed for each signal.",
+                PointerValue(),
+                MakePointerAccessor(
+                    &DistanceBasedThreeGppSpectrumPropagationLossModel::m_spatialIndex),
+                MakePointerChecker<NrSpatialGridIndex>());
     return tid;
 }
 
@@ -66,6 +93,24 @@ DistanceBasedThreeGppSpectrumPropagationLossModel::GetMaxDistance() const
     return m_maxDistance;
 }
 
+bool
+DistanceBasedThreeGppSpectrumPropagationLossModel::GetDropFarPairs() const
+{
+    return m_dropFarPairs;
+}
+
+bool
+DistanceBasedThreeGppSpectrumPropagationLossModel::IsWithinMaxDistance(
+    Ptr<const MobilityModel> a,
+    Ptr<const MobilityModel> b) const
+{
+    if (m_spatialIndex != nullptr)
+    {
+        return m_spatialIndex->IsWithinDistance(a, b, m_maxDistance);
+    }
+    return a->GetDistanceFrom(b) <= m_maxDistance;
+}
+
 Ptr<SpectrumValue>
 DistanceBasedThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     Ptr<const SpectrumSignalParameters> params,
@@ -79,8 +124,16 @@ DistanceBasedThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     uint32_t bId = b->GetObject<Node>()->GetId(); // id of the node b
 
     Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(params->psd);
-    if (a->GetDistanceFrom(b) > m_maxDistance)
+    if (!IsWithinMaxDistance(a, b))
     {
+        if (m_farPairsPathlossOnly)
+        {
+            NS_LOG_LOGIC("Distance between a: "
+                         << aId << "and  node b: " << bId
+                         << " is higher than max allowed distance. Return the PSD without "
+                            "fast fading and beamforming gain.");
+            return rxPsd;
+        }
         NS_LOG_LOGIC("Distance between a: "
                      << aId << "and  node b: " << bId
                      << " is higher than max allowed distance. Return 0 PSD.");
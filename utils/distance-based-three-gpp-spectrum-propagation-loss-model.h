@@ -8,6 +8,8 @@
 #ifndef DISTANCE_BASED_THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 #define DISTANCE_BASED_THREE_GPP_SPECTRUM_PROPAGATION_LOSS_H
 
+#include "nr-spatial-grid-index.h"
+
 #include "ns3/three-gpp-spectrum-propagation-loss-model.h"
 
 namespace ns3
@@ -23,6 +25,14 @@ namespace ns3
  * max allowed distance that can be configured
  * through the attribute of this class.
  *
+ * The signals among farther nodes are returned with 0 PSD or, if
+ * FarPairsPathlossOnly is true, without fast fading and beamforming gain
+ * (i.e., only with the path loss). With DropFarPairs, NrHelper installs in
+ * the spectrum channel a NrDistanceSpectrumTransmitFilter, that drops them
+ * before any propagation loss is computed. The distance check can use a
+ * NrSpatialGridIndex (attribute SpatialIndex), that reads the position of
+ * each node once per time instant instead of once per pair of nodes.
+ *
  * \see ThreeGppSpectrumPropagationLossModel
  */
 class DistanceBasedThreeGppSpectrumPropagationLossModel
@@ -55,6 +65,20 @@ class DistanceBasedThreeGppSpectrumPropagationLossModel
      */
     double GetMaxDistance() const;
 
+    /**
+     * \brief Check if the distance between two nodes is not higher than MaxDistance
+     * \param a first node mobility model
+     * \param b second node mobility model
+     * \return true if the fast fading and the beamforming gain are computed for a and b
+     */
+    bool IsWithinMaxDistance(Ptr<const MobilityModel> a, Ptr<const MobilityModel> b) const;
+
+    /**
+     * \return true if the signals among the nodes farther than MaxDistance
+     * should be dropped by the spectrum channel
+     */
+    bool GetDropFarPairs() const;
+
     /**
      * \brief Computes the received PSD.
      *
@@ -79,6 +103,9 @@ class DistanceBasedThreeGppSpectrumPropagationLossModel
   private:
     double m_maxDistance{1000}; //!< the maximum distance of the nodes a and b in order to calcluate
                                 //!< fast fading and the beamforming gain
+    bool m_farPairsPathlossOnly{false};     //!< the FarPairsPathlossOnly attribute
+    bool m_dropFarPairs{false};             //!< the DropFarPairs attribute
+    Ptr<NrSpatialGridIndex> m_spatialIndex; //!< the SpatialIndex attribute (can be nullptr)
 };
 } // namespace ns3
 
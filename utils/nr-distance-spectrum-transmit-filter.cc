@@ -0,0 +1,69 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-distance-spectrum-transmit-filter.h"
+
+#include <ns3/log.h>
+#include <ns3/spectrum-phy.h>
+#include <ns3/spectrum-signal-parameters.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrDistanceSpectrumTransmitFilter");
+NS_OBJECT_ENSURE_REGISTERED(NrDistanceSpectrumTransmitFilter);
+
+NrDistanceSpectrumTransmitFilter::NrDistanceSpectrumTransmitFilter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+NrDistanceSpectrumTransmitFilter::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrDistanceSpectrumTransmitFilter")
+                            .SetParent<SpectrumTransmitFilter>()
+                            .SetGroupName("Nr")
+                            .AddConstructor<NrDistanceSpectrumTransmitFilter>();
+    return tid;
+}
+
+void
+NrDistanceSpectrumTransmitFilter::SetPropagationLossModel(
+    const Ptr<const DistanceBasedThreeGppSpectrumPropagationLossModel>& model)
+{
+    NS_LOG_FUNCTION(this << model);
+    m_model = model;
+}
+
+void
+NrDistanceSpectrumTransmitFilter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_model = nullptr;
+    SpectrumTransmitFilter::DoDispose();
+}
+
+bool
+NrDistanceSpectrumTransmitFilter::DoFilter(Ptr<const SpectrumSignalParameters> params,
+                                           Ptr<const SpectrumPhy> receiverPhy)
+{
+    NS_LOG_FUNCTION(this << params << receiverPhy);
+    NS_ASSERT_MSG(m_model != nullptr, "Set the propagation loss model first");
+    if (params->txPhy == nullptr)
+    {
+        return false;
+    }
+    Ptr<const MobilityModel> txMobility = params->txPhy->GetMobility();
+    Ptr<const MobilityModel> rxMobility = receiverPhy->GetMobility();
+    if (txMobility == nullptr || rxMobility == nullptr)
+    {
+        return false;
+    }
+    return !m_model->IsWithinMaxDistance(txMobility, rxMobility);
+}
+
+} // namespace ns3
@@ -0,0 +1,61 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_DISTANCE_SPECTRUM_TRANSMIT_FILTER_H
+#define NR_DISTANCE_SPECTRUM_TRANSMIT_FILTER_H
+
+#include "distance-based-three-gpp-spectrum-propagation-loss-model.h"
+
+#include <ns3/spectrum-transmit-filter.h>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr-utils
+ * \brief Spectrum transmit filter that drops the signals among the nodes
+ * farther than the MaxDistance of a DistanceBasedThreeGppSpectrumPropagationLossModel
+ *
+ * The spectrum channel calls the filter for each receiver of a signal, before
+ * computing the propagation loss, so the far receivers cost only the distance
+ * check (done with the spatial index of the propagation loss model, if any).
+ * NrHelper installs it when the DropFarPairs attribute of the model is true.
+ */
+class NrDistanceSpectrumTransmitFilter : public SpectrumTransmitFilter
+{
+  public:
+    /**
+     * \brief NrDistanceSpectrumTransmitFilter constructor
+     */
+    NrDistanceSpectrumTransmitFilter();
+
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Set the propagation loss model that defines the far nodes
+     * \param model the propagation loss model
+     */
+    void SetPropagationLossModel(
+        const Ptr<const DistanceBasedThreeGppSpectrumPropagationLossModel>& model);
+
+  protected:
+    void DoDispose() override;
+
+    bool DoFilter(Ptr<const SpectrumSignalParameters> params,
+                  Ptr<const SpectrumPhy> receiverPhy) override;
+
+  private:
+    Ptr<const DistanceBasedThreeGppSpectrumPropagationLossModel>
+        m_model; //!< The propagation loss model that defines the far nodes
+};
+
+} // namespace ns3
+
+#endif /* NR_DISTANCE_SPECTRUM_TRANSMIT_FILTER_H */
@@ -0,0 +1,108 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-lru-cache-tracker.h"
+
+#include <ns3/log.h>
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrLruCacheTracker");
+
+NrLruCacheTracker::NrLruCacheTracker(size_t maxBytes)
+    : m_maxBytes(maxBytes)
+{
+}
+
+void
+NrLruCacheTracker::SetMaxBytes(size_t maxBytes)
+{
+    m_maxBytes = maxBytes;
+}
+
+size_t
+NrLruCacheTracker::GetMaxBytes() const
+{
+    return m_maxBytes;
+}
+
+std::vector<uint64_t>
+NrLruCacheTracker::Access(uint64_t key, size_t bytes, bool hit)
+{
+    NS_LOG_FUNCTION(this << key << bytes << hit);
+    if (hit)
+    {
+        m_stats.m_hits++;
+    }
+    else
+    {
+        m_stats.m_misses++;
+    }
+
+    auto it = m_entries.find(key);
+    if (it == m_entries.end())
+    {
+        m_recency.push_front(key);
+        m_entries[key] = {m_recency.begin(), bytes};
+    }
+    else
+    {
+        m_recency.splice(m_recency.begin(), m_recency, it->second.m_position);
+        m_stats.m_bytes -= it->second.m_bytes;
+        it->second.m_bytes = bytes;
+    }
+    m_stats.m_bytes += bytes;
+    m_stats.m_peakBytes = std::max(m_stats.m_peakBytes, m_stats.m_bytes);
+
+    std::vector<uint64_t> evicted;
+    while (m_maxBytes > 0 && m_stats.m_bytes > m_maxBytes && m_recency.size() > 1)
+    {
+        uint64_t oldest = m_recency.back();
+        NS_LOG_LOGIC("Evicting entry " << oldest);
+        m_stats.m_bytes -= m_entries.at(oldest).m_bytes;
+        m_entries.erase(oldest);
+        m_recency.pop_back();
+        m_stats.m_evictions++;
+        evicted.push_back(oldest);
+    }
+    m_stats.m_entries = m_entries.size();
+    return evicted;
+}
+
+void
+NrLruCacheTracker::Remove(uint64_t key)
+{
+    NS_LOG_FUNCTION(this << key);
+    auto it = m_entries.find(key);
+    if (it != m_entries.end())
+    {
+        m_stats.m_bytes -= it->second.m_bytes;
+        m_recency.erase(it->second.m_position);
+        m_entries.erase(it);
+        m_stats.m_entries = m_entries.size();
+    }
+}
+
+void
+NrLruCacheTracker::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_recency.clear();
+    m_entries.clear();
+    m_stats.m_bytes = 0;
+    m_stats.m_entries = 0;
+}
+
+const NrLruCacheTracker::Stats&
+NrLruCacheTracker::GetStats() const
+{
+    return m_stats;
+}
+
+} // namespace ns3
@@ -0,0 +1,107 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_LRU_CACHE_TRACKER_H
+#define NR_LRU_CACHE_TRACKER_H
+
+#include <cstddef>
+#include <list>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr-utils
+ * \brief Bookkeeping of a memory-bounded cache with least recently used eviction
+ *
+ * The tracker does not store the cached objects: the owner of the cache
+ * reports each access to an entry, with its size in bytes, and the tracker
+ * returns the keys of the least recently used entries that the owner has to
+ * evict to keep the total size within the limit. The entry just accessed is
+ * never evicted, even if it is larger than the limit. A limit of 0 bytes
+ * means no limit. The tracker keeps the statistics of the cache.
+ */
+class NrLruCacheTracker
+{
+  public:
+    /**
+     * \brief Statistics of the cache
+     */
+    struct Stats
+    {
+        uint64_t m_hits{0};      //!< Accesses to an entry that was in the cache
+        uint64_t m_misses{0};    //!< Accesses that created (or re-created) the entry
+        uint64_t m_evictions{0}; //!< Entries evicted
+        size_t m_bytes{0};       //!< Current size of the cache, in bytes
+        size_t m_peakBytes{0};   //!< Maximum size reached by the cache, in bytes
+        size_t m_entries{0};     //!< Current number of entries
+    };
+
+    /**
+     * \brief Create a tracker
+     * \param maxBytes the maximum size of the cache, in bytes (0 for no limit)
+     */
+    explicit NrLruCacheTracker(size_t maxBytes = 0);
+
+    /**
+     * \brief Set the maximum size of the cache. The entries in excess are
+     * evicted at the next access
+     * \param maxBytes the maximum size, in bytes (0 for no limit)
+     */
+    void SetMaxBytes(size_t maxBytes);
+
+    /**
+     * \return the maximum size of the cache, in bytes (0 for no limit)
+     */
+    size_t GetMaxBytes() const;
+
+    /**
+     * \brief Report an access to an entry, which becomes the most recently used
+     * \param key the key of the entry
+     * \param bytes the current size of the entry, in bytes
+     * \param hit true if the entry was found in the cache, false if it was created
+     * \return the keys of the entries to evict, from the least recently used
+     */
+    std::vector<uint64_t> Access(uint64_t key, size_t bytes, bool hit);
+
+    /**
+     * \brief Remove an entry that the owner removed from the cache (not an eviction)
+     * \param key the key of the entry
+     */
+    void Remove(uint64_t key);
+
+    /**
+     * \brief Remove all the entries
+     */
+    void Clear();
+
+    /**
+     * \return the statistics of the cache
+     */
+    const Stats& GetStats() const;
+
+  private:
+    /**
+     * \brief An entry of the cache
+     */
+    struct Entry
+    {
+        std::list<uint64_t>::iterator m_position; //!< Position in the recency list
+        size_t m_bytes{0};                        //!< Size of the entry
+    };
+
+    size_t m_maxBytes{0};                          //!< Maximum size of the cache (0: no limit)
+    std::list<uint64_t> m_recency;                 //!< Keys, from the most recently used
+    std::unordered_map<uint64_t, Entry> m_entries; //!< The entries, by key
+    Stats m_stats;                                 //!< Statistics of the cache
+};
+
+} // namespace ns3
+
+#endif /* NR_LRU_CACHE_TRACKER_H */
@@ -0,0 +1,202 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include "nr-spatial-grid-index.h"
+
+#include <ns3/double.h>
+#include <ns3/log.h>
+#include <ns3/simulator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("NrSpatialGridIndex");
+NS_OBJECT_ENSURE_REGISTERED(NrSpatialGridIndex);
+
+NrSpatialGridIndex::NrSpatialGridIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NrSpatialGridIndex::~NrSpatialGridIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TypeId
+NrSpatialGridIndex::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::NrSpatialGridIndex")
+                            .SetParent<Object>()
+                            .SetGroupName("Nr")
+                            .AddConstructor<NrSpatialGridIndex>()
+                            .AddAttribute("CellSize",
+                                          "Size in meters of the (square) cells of the grid",
+                                          DoubleValue(100.0),
+                                          MakeDoubleAccessor(&NrSpatialGridIndex::m_cellSize),
+                                          MakeDoubleChecker<double>(1e-3));
+    return tid;
+}
+
+void
+NrSpatialGridIndex::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& it : m_entries)
+    {
+        ConstCast<MobilityModel>(it.second.m_mobility)
+            ->TraceDisconnectWithoutContext("CourseChange",
+                                            MakeCallback(&NrSpatialGridIndex::CourseChanged, this));
+    }
+    m_entries.clear();
+    m_cells.clear();
+    Object::DoDispose();
+}
+
+void
+NrSpatialGridIndex::Add(const Ptr<const MobilityModel>& mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    GetEntry(mobility);
+}
+
+size_t
+NrSpatialGridIndex::GetN() const
+{
+    return m_entries.size();
+}
+
+bool
+NrSpatialGridIndex::IsWithinDistance(const Ptr<const MobilityModel>& a,
+                                     const Ptr<const MobilityModel>& b,
+                                     double distance)
+{
+    NS_LOG_FUNCTION(this << a << b << distance);
+    const Entry& entryA = GetEntry(a);
+    const Entry& entryB = GetEntry(b);
+
+    // Nodes whose cells are farther than the reach are farther than the distance,
+    // without computing it
+    int64_t reach = GetReach(distance);
+    if (std::abs(entryA.m_cell.first - entryB.m_cell.first) > reach ||
+        std::abs(entryA.m_cell.second - entryB.m_cell.second) > reach)
+    {
+        return false;
+    }
+    return CalculateDistance(entryA.m_position, entryB.m_position) <= distance;
+}
+
+std::vector<Ptr<const MobilityModel>>
+NrSpatialGridIndex::GetWithinDistance(const Vector& position, double distance)
+{
+    NS_LOG_FUNCTION(this << position << distance);
+    for (auto& it : m_entries)
+    {
+        Update(&it.second);
+    }
+
+    std::vector<Ptr<const MobilityModel>> result;
+    Cell center = GetCell(position);
+    int64_t reach = GetReach(distance);
+    for (int64_t x = center.first - reach; x <= center.first + reach; x++)
+    {
+        auto it = m_cells.lower_bound(std::make_pair(x, center.second - reach));
+        for (; it != m_cells.end() && it->first.first == x &&
+               it->first.second <= center.second + reach;
+             ++it)
+        {
+            for (const MobilityModel* mobility : it->second)
+            {
+                const Entry& entry = m_entries.at(mobility);
+                if (CalculateDistance(entry.m_position, position) <= distance)
+                {
+                    result.push_back(entry.m_mobility);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+NrSpatialGridIndex::Entry&
+NrSpatialGridIndex::GetEntry(const Ptr<const MobilityModel>& mobility)
+{
+    auto it = m_entries.find(PeekPointer(mobility));
+    if (it != m_entries.end())
+    {
+        Update(&it->second);
+        return it->second;
+    }
+
+    NS_LOG_LOGIC("Adding mobility model " << mobility);
+    Entry& entry = m_entries[PeekPointer(mobility)];
+    entry.m_mobility = mobility;
+    entry.m_position = mobility->GetPosition();
+    entry.m_cell = GetCell(entry.m_position);
+    entry.m_updateTime = Simulator::Now();
+    m_cells[entry.m_cell].push_back(PeekPointer(mobility));
+    ConstCast<MobilityModel>(mobility)->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeCallback(&NrSpatialGridIndex::CourseChanged, this));
+    return entry;
+}
+
+void
+NrSpatialGridIndex::Update(Entry* entry)
+{
+    if (entry->m_updateTime == Simulator::Now())
+    {
+        return;
+    }
+    entry->m_updateTime = Simulator::Now();
+    entry->m_position = entry->m_mobility->GetPosition();
+    Cell cell = GetCell(entry->m_position);
+    if (cell == entry->m_cell)
+    {
+        return;
+    }
+
+    std::vector<const MobilityModel*>& oldCell = m_cells[entry->m_cell];
+    oldCell.erase(std::find(oldCell.begin(), oldCell.end(), PeekPointer(entry->m_mobility)));
+    if (oldCell.empty())
+    {
+        m_cells.erase(entry->m_cell);
+    }
+    entry->m_cell = cell;
+    m_cells[cell].push_back(PeekPointer(entry->m_mobility));
+}
+
+void
+NrSpatialGridIndex::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_entries.find(PeekPointer(mobility));
+    if (it != m_entries.end())
+    {
+        // The position may change more than once at the same time
+        it->second.m_updateTime = Time::Min();
+        Update(&it->second);
+    }
+}
+
+NrSpatialGridIndex::Cell
+NrSpatialGridIndex::GetCell(const Vector& position) const
+{
+    return std::make_pair(static_cast<int64_t>(std::floor(position.x / m_cellSize)),
+                          static_cast<int64_t>(std::floor(position.y / m_cellSize)));
+}
+
+int64_t
+NrSpatialGridIndex::GetReach(double distance) const
+{
+    return static_cast<int64_t>(std::ceil(distance / m_cellSize));
+}
+
+} // namespace ns3
@@ -0,0 +1,148 @@
+/* -*-  Mode: C++; c-file-style: "gnu"; indent-tabs-mode:nil; -*- */
+
+// Copyright (c) 2024 Centre Tecnologic de Telecomunicacions de Catalunya (CTTC)
+//
+// SPDX-License-Identifier: GPL-2.0-only
+
+#ifndef NR_SPATIAL_GRID_INDEX_H
+#define NR_SPATIAL_GRID_INDEX_H
+
+#include <ns3/mobility-model.h>
+#include <ns3/nstime.h>
+#include <ns3/object.h>
+#include <ns3/vector.h>
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup nr-utils
+ * \brief Spatial index of the positions of a set of mobility models
+ *
+ * The horizontal plane is divided in square cells of CellSize meters, and
+ * each mobility model is stored in the cell of its position. The index
+ * answers whether two nodes are within a distance, checking first their
+ * cells and then the (3D) distance, and which nodes are within a distance
+ * from a position, visiting only the cells around it.
+ *
+ * The position of a mobility model is updated on its CourseChange trace,
+ * and when it is used at a simulation time later than the last update (for
+ * the models that move without notifying, e.g., constant velocity). So, the
+ * position of each model is read at most once per time instant, instead of
+ * once per pair of nodes. The mobility models are added with Add, or the
+ * first time that they are used.
+ */
+class NrSpatialGridIndex : public Object
+{
+  public:
+    /**
+     * \brief NrSpatialGridIndex constructor
+     */
+    NrSpatialGridIndex();
+
+    /**
+     * \brief ~NrSpatialGridIndex destructor
+     */
+    ~NrSpatialGridIndex() override;
+
+    /**
+     * \brief Get the type ID
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Add a mobility model to the index (nothing happens if it is already there)
+     * \param mobility the mobility model
+     */
+    void Add(const Ptr<const MobilityModel>& mobility);
+
+    /**
+     * \brief Check if the distance between two mobility models is not higher
+     * than a value
+     * \param a the first mobility model
+     * \param b the second mobility model
+     * \param distance the distance, in meters
+     * \return true if a and b are within the distance
+     */
+    bool IsWithinDistance(const Ptr<const MobilityModel>& a,
+                          const Ptr<const MobilityModel>& b,
+                          double distance);
+
+    /**
+     * \brief Get the mobility models of the index within a distance from a position
+     * \param position the position
+     * \param distance the distance, in meters
+     * \return the mobility models within the distance, in no particular order
+     */
+    std::vector<Ptr<const MobilityModel>> GetWithinDistance(const Vector& position,
+                                                            double distance);
+
+    /**
+     * \return the number of mobility models in the index
+     */
+    size_t GetN() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    using Cell = std::pair<int64_t, int64_t>; //!< Cell of the grid (x, y)
+
+    /**
+     * \brief A mobility model in the index
+     */
+    struct Entry
+    {
+        Ptr<const MobilityModel> m_mobility; //!< The mobility model
+        Vector m_position;                   //!< The last position read
+        Cell m_cell;                         //!< The cell of m_position
+        Time m_updateTime;                   //!< The time at which m_position was read
+    };
+
+    /**
+     * \brief Get the entry of a mobility model, adding it if needed, with its
+     * position updated to the current time
+     * \param mobility the mobility model
+     * \return the entry
+     */
+    Entry& GetEntry(const Ptr<const MobilityModel>& mobility);
+
+    /**
+     * \brief Read the position of an entry, and move it to its new cell
+     * \param entry the entry
+     */
+    void Update(Entry* entry);
+
+    /**
+     * \brief Get the cell of a position
+     * \param position the position
+     * \return the cell
+     */
+    Cell GetCell(const Vector& position) const;
+
+    /**
+     * \brief Get the number of cells that a distance can span
+     * \param distance the distance, in meters
+     * \return the number of cells
+     */
+    int64_t GetReach(double distance) const;
+
+    /**
+     * \brief Called on the CourseChange of a mobility model of the index
+     * \param mobility the mobility model
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+
+    double m_cellSize{100.0};                                   //!< Cell size (attribute)
+    std::unordered_map<const MobilityModel*, Entry> m_entries; //!< The entries
+    std::map<Cell, std::vector<const MobilityModel*>> m_cells; //!< The models in each cell
+};
+
+} // namespace ns3
+
+#endif /* NR_SPATIAL_GRID_INDEX_H */
@@ -17,10 +17,12 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
 #include <random>
+#include <vector>
 
 namespace ns3
 {
@@ -43,6 +45,8 @@ ThreeGppChannelModelParam::~ThreeGppChannelModelParam()
 void
 ThreeGppChannelModelParam::DoDispose()
 {
+    m_cacheTracker.Clear();
+    m_paramsTracker.Clear();
     ThreeGppChannelModel::DoDispose();
 }
 
@@ -67,6 +71,24 @@ ThreeGppChannelModelParam::GetTypeId()
                 BooleanValue(true),
                 MakeBooleanAccessor(&ThreeGppChannelModelParam::m_parametrizedCorrelation),
                 MakeBooleanChecker())
+            .AddAttribute("MaxCacheBytes",
+                          "Maximum memory (in bytes) of the channel matrices kept for the pairs "
+                          "of antenna arrays. When exceeded, the least recently used matrices "
+                          "are evicted, and regenerated from the same channel parameters if "
+                          "needed again. 0 means no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModelParam::SetMaxCacheBytes,
+                                               &ThreeGppChannelModelParam::GetMaxCacheBytes),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("MaxChannelParams",
+                          "Maximum number of pairs of nodes whose channel parameters are kept. "
+                          "When exceeded, the parameters of the least recently used pairs are "
+                          "evicted together with their channel matrices, and a new channel "
+                          "realization is generated if the pair is used again. 0 means no limit.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModelParam::SetMaxChannelParams,
+                                               &ThreeGppChannelModelParam::GetMaxChannelParams),
+                          MakeUintegerChecker<uint64_t>())
 
         ;
     return tid;
@@ -78,6 +100,108 @@ ThreeGppChannelModelParam::SetRo(double ro)
     m_Ro = ro;
 }
 
+void
+ThreeGppChannelModelParam::SetMaxCacheBytes(uint64_t maxBytes)
+{
+    m_cacheTracker.SetMaxBytes(maxBytes);
+}
+
+uint64_t
+ThreeGppChannelModelParam::GetMaxCacheBytes() const
+{
+    return m_cacheTracker.GetMaxBytes();
+}
+
+void
+ThreeGppChannelModelParam::SetMaxChannelParams(uint64_t maxParams)
+{
+    m_paramsTracker.SetMaxBytes(maxParams);
+}
+
+uint64_t
+ThreeGppChannelModelParam::GetMaxChannelParams() const
+{
+    return m_paramsTracker.GetMaxBytes();
+}
+
+const NrLruCacheTracker::Stats&
+ThreeGppChannelModelParam::GetCacheStats() const
+{
+    return m_cacheTracker.GetStats();
+}
+
+const NrLruCacheTracker::Stats&
+ThreeGppChannelModelParam::GetParamsCacheStats() const
+{
+    return m_paramsTracker.GetStats();
+}
+
+void
+ThreeGppChannelModelParam::ReleaseChannelMatrix(uint64_t channelMatrixKey)
+{
+    NS_LOG_FUNCTION(this << channelMatrixKey);
+    auto it = m_channelMatrixMap.find(channelMatrixKey);
+    if (it == m_channelMatrixMap.end())
+    {
+        return;
+    }
+    // The matrix is not modified, since it may still be used by whoever got it
+    // from GetChannel (e.g., a prepared beamforming task): its memory is freed
+    // when the last reference to it is dropped
+    m_channelMatrixMap.erase(it);
+}
+
+Ptr<const MatrixBasedChannelModel::ChannelMatrix>
+ThreeGppChannelModelParam::GetChannel(Ptr<const MobilityModel> aMob,
+                                      Ptr<const MobilityModel> bMob,
+                                      Ptr<const PhasedArrayModel> aAntenna,
+                                      Ptr<const PhasedArrayModel> bAntenna)
+{
+    NS_LOG_FUNCTION(this);
+    // The parameters are stored by pair of nodes, as in ThreeGppChannelModel
+    uint64_t channelParamsKey =
+        GetKey(aMob->GetObject<Node>()->GetId(), bMob->GetObject<Node>()->GetId());
+    bool paramsFound = m_channelParamsMap.find(channelParamsKey) != m_channelParamsMap.end();
+
+    m_newChannelGenerated = false;
+    Ptr<const ChannelMatrix> channelMatrix =
+        ThreeGppChannelModel::GetChannel(aMob, bMob, aAntenna, bAntenna);
+
+    // The matrices are stored by pair of antenna arrays, as in ThreeGppChannelModel
+    uint64_t channelMatrixKey = GetKey(aAntenna->GetId(), bAntenna->GetId());
+    size_t bytes = sizeof(ChannelMatrix) + channelMatrix->m_channel.GetNumRows() *
+                                               channelMatrix->m_channel.GetNumCols() *
+                                               channelMatrix->m_channel.GetNumPages() *
+                                               sizeof(std::complex<double>);
+    for (uint64_t evictedKey :
+         m_cacheTracker.Access(channelMatrixKey, bytes, !m_newChannelGenerated))
+    {
+        NS_LOG_LOGIC("Evicting the channel matrix with key " << evictedKey);
+        ReleaseChannelMatrix(evictedKey);
+    }
+
+    for (uint64_t evictedKey : m_paramsTracker.Access(channelParamsKey, 1, paramsFound))
+    {
+        NS_LOG_LOGIC("Evicting the channel parameters with key " << evictedKey);
+        m_channelParamsMap.erase(evictedKey);
+        // The matrices of the pair can not be regenerated without the parameters
+        std::vector<uint64_t> matrixKeys;
+        for (const auto& [key, matrix] : m_channelMatrixMap)
+        {
+            if (GetKey(matrix->m_nodeIds.first, matrix->m_nodeIds.second) == evictedKey)
+            {
+                matrixKeys.push_back(key);
+            }
+        }
+        for (uint64_t key : matrixKeys)
+        {
+            m_cacheTracker.Remove(key);
+            ReleaseChannelMatrix(key);
+        }
+    }
+    return channelMatrix;
+}
+
 Ptr<MatrixBasedChannelModel::ChannelMatrix>
 ThreeGppChannelModelParam::GetNewChannel(Ptr<const ThreeGppChannelParams> channelParams,
                                          Ptr<const ParamsTable> table3gpp,
@@ -90,6 +214,8 @@ ThreeGppChannelModelParam::GetNewChannel(Ptr<const ThreeGppChannelParams> channe
 
     NS_ASSERT_MSG(m_frequency > 0.0, "Set the operating frequency first!");
 
+    m_newChannelGenerated = true;
+
     // create a channel matrix instance
     Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix>();
     channelMatrix->m_generatedTime = Simulator::Now();
@@ -250,110 +376,141 @@ ThreeGppChannelModelParam::GetNewChannel(Ptr<const ThreeGppChannelParams> channe
         }
     }
 
-    // The following for loops computes the channel coefficients
+    // The location of the antenna elements does not depend on the cluster
+    std::vector<Vector> uLoc(uSize);
+    std::vector<Vector> sLoc(sSize);
+    for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+        uLoc[uIndex] = uAntenna->GetElementLocation(uIndex);
+    }
+    for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+        sLoc[sIndex] = sAntenna->GetElementLocation(sIndex);
+    }
+
+    // The coefficient of a ray is the product of a term that depends on the u-element
+    // only and a term that depends on the s-element only. For each cluster, the rx
+    // steering phasors (including the polarization term raysPreComp) and the tx steering
+    // phasors are computed once per element and ray, and the coefficient of each element
+    // pair is the dot product of the two, over the rays of each sub-cluster. The phasors
+    // are stored as separate real and imaginary parts, with the rays of an element
+    // contiguous and ordered by sub-cluster
+    uint8_t numRays = table3gpp->m_raysPerCluster;
+    std::vector<double> rxRe(uSize * numRays);
+    std::vector<double> rxIm(uSize * numRays);
+    std::vector<double> txRe(sSize * numRays);
+    std::vector<double> txIm(sSize * numRays);
+    std::vector<uint8_t> rayOrder;
+    std::vector<size_t> subClusterStart;
+
+    // Sub-cluster of each ray of the 2 strongest clusters (7.5-28)
+    auto getSubCluster = [](uint8_t mIndex) -> uint8_t {
+        switch (mIndex)
+        {
+        case 9:
+        case 10:
+        case 11:
+        case 12:
+        case 17:
+        case 18:
+            return 1;
+        case 13:
+        case 14:
+        case 15:
+        case 16:
+            return 2;
+        default: // case 1,2,3,4,5,6,7,8,19,20
+            return 0;
+        }
+    };
+
     // Keeps track of how many sub-clusters have been added up to now
     uint8_t numSubClustersAdded = 0;
     for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
     {
+        // Compute the N-2 weakest cluster, assuming 0 slant angle and a
+        // polarization slant angle configured in the array (7.5-22), as a single
+        // sub-cluster; the 2 strongest ones are divided into 3 sub-clusters (7.5-28)
+        bool isStrongest =
+            (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd);
+        uint8_t numSubClusters = isStrongest ? 3 : 1;
+        rayOrder.clear();
+        subClusterStart.assign(1, 0);
+        for (uint8_t subCluster = 0; subCluster < numSubClusters; subCluster++)
+        {
+            for (uint8_t mIndex = 0; mIndex < numRays; mIndex++)
+            {
+                if (!isStrongest || getSubCluster(mIndex) == subCluster)
+                {
+                    rayOrder.push_back(mIndex);
+                }
+            }
+            subClusterStart.push_back(rayOrder.size());
+        }
+
+        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
+            for (size_t i = 0; i < numRays; i++)
+            {
+                uint8_t mIndex = rayOrder[i];
+                double rxPhaseDiff = 2 * M_PI *
+                                     (sinCosA[nIndex][mIndex] * uLoc[uIndex].x +
+                                      sinSinA[nIndex][mIndex] * uLoc[uIndex].y +
+                                      cosZoA[nIndex][mIndex] * uLoc[uIndex].z);
+                std::complex<double> rxPhasor =
+                    raysPreComp(nIndex, mIndex) *
+                    std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
+                rxRe[uIndex * numRays + i] = rxPhasor.real();
+                rxIm[uIndex * numRays + i] = rxPhasor.imag();
+            }
+        }
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            for (size_t i = 0; i < numRays; i++)
+            {
+                uint8_t mIndex = rayOrder[i];
+                double txPhaseDiff = 2 * M_PI *
+                                     (sinCosD[nIndex][mIndex] * sLoc[sIndex].x +
+                                      sinSinD[nIndex][mIndex] * sLoc[sIndex].y +
+                                      cosZoD[nIndex][mIndex] * sLoc[sIndex].z);
+                txRe[sIndex * numRays + i] = cos(txPhaseDiff);
+                txIm[sIndex * numRays + i] = sin(txPhaseDiff);
+            }
+        }
 
+        // NOTE Doppler is computed in the CalcBeamformingGain function and is
+        // simplified to only account for the center angle of each cluster.
+        double scale = sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
+        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
+            const double* uRe = &rxRe[uIndex * numRays];
+            const double* uIm = &rxIm[uIndex * numRays];
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
-                // polarization slant angle configured in the array (7.5-22)
-                if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+                const double* sRe = &txRe[sIndex * numRays];
+                const double* sIm = &txIm[sIndex * numRays];
+                for (uint8_t subCluster = 0; subCluster < numSubClusters; subCluster++)
                 {
-                    std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                    double re = 0;
+                    double im = 0;
+                    for (size_t i = subClusterStart[subCluster];
+                         i < subClusterStart[subCluster + 1];
+                         i++)
                     {
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        // NOTE Doppler is computed in the CalcBeamformingGain function and is
-                        // simplified to only account for the center angle of each cluster.
-                        rays += raysPreComp(nIndex, mIndex) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                        re += uRe[i] * sRe[i] - uIm[i] * sIm[i];
+                        im += uRe[i] * sIm[i] + uIm[i] * sRe[i];
                     }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = rays;
-                }
-                else //(7.5-28)
-                {
-                    std::complex<double> raysSub1(0, 0);
-                    std::complex<double> raysSub2(0, 0);
-                    std::complex<double> raysSub3(0, 0);
-
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
-                    {
-                        // ZML:Just remind me that the angle offsets for the 3 subclusters were not
-                        // generated correctly.
-                        double rxPhaseDiff =
-                            2 * M_PI *
-                            (sinCosA[nIndex][mIndex] * uLoc.x + sinSinA[nIndex][mIndex] * uLoc.y +
-                             cosZoA[nIndex][mIndex] * uLoc.z);
-
-                        double txPhaseDiff =
-                            2 * M_PI *
-                            (sinCosD[nIndex][mIndex] * sLoc.x + sinSinD[nIndex][mIndex] * sLoc.y +
-                             cosZoD[nIndex][mIndex] * sLoc.z);
-
-                        std::complex<double> raySub =
-                            raysPreComp(nIndex, mIndex) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                        switch (mIndex)
-                        {
-                        case 9:
-                        case 10:
-                        case 11:
-                        case 12:
-                        case 17:
-                        case 18:
-                            raysSub2 += raySub;
-                            break;
-                        case 13:
-                        case 14:
-                        case 15:
-                        case 16:
-                            raysSub3 += raySub;
-                            break;
-                        default: // case 1,2,3,4,5,6,7,8,19,20
-                            raysSub1 += raySub;
-                            break;
-                        }
-                    }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn(uIndex, sIndex, nIndex) = raysSub1;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded) = raysSub2;
-                    hUsn(uIndex,
-                         sIndex,
-                         channelParams->m_reducedClusterNumber + numSubClustersAdded + 1) =
-                        raysSub3;
+                    // the first sub-cluster keeps the index of the cluster, the other
+                    // two are appended after the reduced clusters
+                    uint16_t page = (subCluster == 0) ? nIndex
+                                                      : channelParams->m_reducedClusterNumber +
+                                                            numSubClustersAdded + subCluster - 1;
+                    hUsn(uIndex, sIndex, page) = std::complex<double>(re, im) * scale;
                 }
             }
         }
-        if (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd)
+        if (isStrongest)
         {
             numSubClustersAdded += 2;
         }
@@ -374,34 +531,42 @@ ThreeGppChannelModelParam::GetNewChannel(Ptr<const ThreeGppChannelParams> channe
         const double sinSAngleAz = sin(sAngle.GetAzimuth());
         const double cosSAngleAz = cos(sAngle.GetAzimuth());
 
+        // The LOS ray is separable as well: the field patterns and the phase due to
+        // the distance are accounted in the rx phasors
+        auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
+            Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
+        auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
+            Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
+        std::complex<double> losTerm =
+            (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi) *
+            phaseDiffDueToDistance;
+
+        std::vector<std::complex<double>> rxLos(uSize);
+        std::vector<std::complex<double>> txLos(sSize);
         for (size_t uIndex = 0; uIndex < uSize; uIndex++)
         {
-            Vector uLoc = uAntenna->GetElementLocation(uIndex);
-            double rxPhaseDiff = 2 * M_PI *
-                                 (sinUAngleIncl * cosUAngleAz * uLoc.x +
-                                  sinUAngleIncl * sinUAngleAz * uLoc.y + cosUAngleIncl * uLoc.z);
+            double rxPhaseDiff =
+                2 * M_PI *
+                (sinUAngleIncl * cosUAngleAz * uLoc[uIndex].x +
+                 sinUAngleIncl * sinUAngleAz * uLoc[uIndex].y + cosUAngleIncl * uLoc[uIndex].z);
+            rxLos[uIndex] = losTerm * std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff));
+        }
+        for (size_t sIndex = 0; sIndex < sSize; sIndex++)
+        {
+            double txPhaseDiff =
+                2 * M_PI *
+                (sinSAngleIncl * cosSAngleAz * sLoc[sIndex].x +
+                 sinSAngleIncl * sinSAngleAz * sLoc[sIndex].y + cosSAngleIncl * sLoc[sIndex].z);
+            txLos[sIndex] = std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+        }
 
+        double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+        for (size_t uIndex = 0; uIndex < uSize; uIndex++)
+        {
             for (size_t sIndex = 0; sIndex < sSize; sIndex++)
             {
-                Vector sLoc = sAntenna->GetElementLocation(sIndex);
-                std::complex<double> ray(0, 0);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sinSAngleIncl * cosSAngleAz * sLoc.x + sinSAngleIncl * sinSAngleAz * sLoc.y +
-                     cosSAngleIncl * sLoc.z);
-
-                auto [rxFieldPatternPhi, rxFieldPatternTheta] = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
-                auto [txFieldPatternPhi, txFieldPatternTheta] = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      phaseDiffDueToDistance *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
-
-                double kLinear = pow(10, channelParams->m_K_factor / 10.0);
+                std::complex<double> ray = rxLos[uIndex] * txLos[sIndex];
+
                 // the LOS path should be attenuated if blockage is enabled.
                 hUsn(uIndex, sIndex, 0) =
                     sqrt(1.0 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
@@ -10,6 +10,8 @@
 #ifndef THREE_GPP_CHANNEL_PARAM_H
 #define THREE_GPP_CHANNEL_PARAM_H
 
+#include "nr-lru-cache-tracker.h"
+
 #include "ns3/angles.h"
 #include <ns3/boolean.h>
 #include <ns3/channel-condition-model.h>
@@ -33,6 +35,26 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * The channel matrices can be kept within a memory limit (attribute
+ * MaxCacheBytes): when the matrices of all the pairs of antenna arrays exceed
+ * it, the least recently used ones are evicted. The channel parameters of the
+ * pairs of nodes are kept, so an evicted matrix that is needed again is
+ * regenerated from the same parameters, without drawing new random numbers,
+ * and it is equal to the evicted one (unless it had to be updated anyway).
+ *
+ * An evicted matrix is only removed from the map, and it is never modified,
+ * since the matrices returned by GetChannel may still be in use (e.g., by the
+ * beamforming tasks prepared by IdealBeamformingHelper). Its memory is freed
+ * when the last reference to it is dropped: the long-term components of
+ * ThreeGppSpectrumPropagationLossModel keep a reference to the matrix they were
+ * computed from until the pair is used again, so the memory actually used can
+ * exceed the limit by the matrices of the pairs not used since their eviction.
+ *
+ * The channel parameters can also be bounded (attribute MaxChannelParams, in
+ * number of pairs of nodes). The least recently used parameters are evicted
+ * together with the matrices generated from them, and a pair whose parameters
+ * were evicted gets a new channel realization when it is used again.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModelParam : public ThreeGppChannelModel
@@ -58,6 +80,34 @@ class ThreeGppChannelModelParam : public ThreeGppChannelModel
 
     void SetRo(double ro);
 
+    /**
+     * Get the channel matrix between a and b, as ThreeGppChannelModel::GetChannel,
+     * and keep the channel matrices within the memory limit
+     * \param aMob mobility model of the a device
+     * \param bMob mobility model of the b device
+     * \param aAntenna antenna of the a device
+     * \param bAntenna antenna of the b device
+     * \return the channel realization
+     */
+    Ptr<const ChannelMatrix> GetChannel(Ptr<const MobilityModel> aMob,
+                                        Ptr<const MobilityModel> bMob,
+                                        Ptr<const PhasedArrayModel> aAntenna,
+                                        Ptr<const PhasedArrayModel> bAntenna) override;
+
+    /**
+     * Get the statistics of the channel matrix cache: hits (matrix reused), misses
+     * (matrix generated or regenerated), evictions, and bytes of the cached matrices
+     * \return the statistics
+     */
+    const NrLruCacheTracker::Stats& GetCacheStats() const;
+
+    /**
+     * Get the statistics of the channel parameters cache, in which each pair of
+     * nodes counts as one byte
+     * \return the statistics
+     */
+    const NrLruCacheTracker::Stats& GetParamsCacheStats() const;
+
   private:
     /**
      * Compute the channel matrix between two devices using the procedure
@@ -77,9 +127,43 @@ class ThreeGppChannelModelParam : public ThreeGppChannelModel
                                      Ptr<const PhasedArrayModel> sAntenna,
                                      Ptr<const PhasedArrayModel> uAntenna) const override;
 
+    /**
+     * Set the maximum memory used by the channel matrices
+     * \param maxBytes the maximum memory, in bytes (0 for no limit)
+     */
+    void SetMaxCacheBytes(uint64_t maxBytes);
+
+    /**
+     * Get the maximum memory used by the channel matrices
+     * \return the maximum memory, in bytes (0 for no limit)
+     */
+    uint64_t GetMaxCacheBytes() const;
+
+    /**
+     * Set the maximum number of pairs of nodes whose channel parameters are kept
+     * \param maxParams the maximum number of pairs (0 for no limit)
+     */
+    void SetMaxChannelParams(uint64_t maxParams);
+
+    /**
+     * Get the maximum number of pairs of nodes whose channel parameters are kept
+     * \return the maximum number of pairs (0 for no limit)
+     */
+    uint64_t GetMaxChannelParams() const;
+
+    /**
+     * Remove a channel matrix from the map, without modifying it, since it may
+     * still be referenced by the callers of GetChannel
+     * \param channelMatrixKey the key of the matrix
+     */
+    void ReleaseChannelMatrix(uint64_t channelMatrixKey);
+
     double m_Ro{1.0}; //!< cross polarization correlation parameter
     double m_parametrizedCorrelation{
         true}; //!< whether the parameter Ro will be used as correlation term
+    NrLruCacheTracker m_cacheTracker;          //!< Bookkeeping of the channel matrices in memory
+    NrLruCacheTracker m_paramsTracker;         //!< Bookkeeping of the channel parameters
+    mutable bool m_newChannelGenerated{false}; //!< GetNewChannel was called by the last GetChannel
 };
 } // namespace ns3
 